@@ -2,6 +2,7 @@
 
 #include "Audio/Audio.h"
 #include "Audio/AudioConstants.h"
+#include "Audio/AudioStream.h"
 #include "System/System.h"
 
 #include "Assets/SoundWave.h"
@@ -28,6 +29,87 @@ static bool sLoop[AUDIO_MAX_VOICES] = { };
 static void* sSoundData[AUDIO_MAX_VOICES] = { };
 static uint32_t sSoundSizes[AUDIO_MAX_VOICES] = { };
 
+// Streamed voices alternate between two buffers, refilled from the queue callback.
+#define AUDIO_STREAM_QUEUE_BUFFERS 2
+#define AUDIO_STREAM_SILENCE_FRAMES 256
+static AudioStream* sStreams[AUDIO_MAX_VOICES] = { };
+static uint8_t* sStreamBuffers[AUDIO_MAX_VOICES][AUDIO_STREAM_QUEUE_BUFFERS] = { };
+static uint32_t sStreamBufferIndices[AUDIO_MAX_VOICES] = { };
+static MutexObject* sStreamMutex = nullptr;
+
+static void EnqueueStreamBuffer(int32_t index)
+{
+    AudioStream* stream = sStreams[index];
+    uint32_t bufferIndex = sStreamBufferIndices[index];
+    uint8_t* buffer = sStreamBuffers[index][bufferIndex];
+    uint32_t numFrames = stream->Read(buffer, AUDIO_STREAM_CHUNK_FRAMES);
+
+    if (numFrames == 0)
+    {
+        if (stream->IsFinished())
+        {
+            return;
+        }
+
+        // The stream thread fell behind. Keep the queue going with a little silence.
+        numFrames = AUDIO_STREAM_SILENCE_FRAMES;
+        memset(buffer, 0, numFrames * 4);
+    }
+    else if (stream->GetNumChannels() != 2 ||
+        stream->GetBytesPerSample() != 2)
+    {
+        // Same conversion to 16 bit stereo as AUD_ProcessWaveBuffer(), in place and
+        // working backwards so we don't overwrite samples.
+        uint32_t numChannels = stream->GetNumChannels();
+        uint32_t bytesPerSample = stream->GetBytesPerSample();
+        uint32_t bytesPerFrame = stream->GetBytesPerFrame();
+
+        for (int32_t i = int32_t(numFrames) - 1; i >= 0; --i)
+        {
+            int16_t samples[2] = { 0, 0 };
+
+            for (uint32_t c = 0; c < numChannels; ++c)
+            {
+                uint8_t* src = buffer + i * bytesPerFrame + c * bytesPerSample;
+
+                if (bytesPerSample == 1)
+                {
+                    samples[c] = int16_t(*src) * 256 - 32767;
+                }
+                else
+                {
+                    memcpy(&samples[c], src, sizeof(int16_t));
+                }
+            }
+
+            if (numChannels == 1)
+            {
+                samples[1] = samples[0];
+            }
+
+            memcpy(buffer + i * 4, samples, 4);
+        }
+    }
+
+    (*(sBufferQueues[index]))->Enqueue(sBufferQueues[index], buffer, numFrames * 4);
+    sStreamBufferIndices[index] = (bufferIndex + 1) % AUDIO_STREAM_QUEUE_BUFFERS;
+}
+
+static void ReleaseStream(uint32_t voiceIndex)
+{
+    if (sStreams[voiceIndex] != nullptr)
+    {
+        AUD_CloseStream(sStreams[voiceIndex]);
+        sStreams[voiceIndex] = nullptr;
+
+        for (uint32_t i = 0; i < AUDIO_STREAM_QUEUE_BUFFERS; ++i)
+        {
+            delete [] sStreamBuffers[voiceIndex][i];
+            sStreamBuffers[voiceIndex][i] = nullptr;
+        }
+    }
+}
+
 
 static void QueueCallback(SLBufferQueueItf caller, void *pContext)
 {
@@ -35,7 +117,13 @@ static void QueueCallback(SLBufferQueueItf caller, void *pContext)
 
     if (index >= 0 && index < AUDIO_MAX_VOICES)
     {
-        if (sLoop[index])
+        SCOPED_LOCK(sStreamMutex);
+
+        if (sStreams[index] != nullptr)
+        {
+            EnqueueStreamBuffer(index);
+        }
+        else if (sLoop[index])
         {
             // Resubmit the same sound buffer
             (*(sBufferQueues[index]))->Clear(sBufferQueues[index]);
@@ -62,6 +150,8 @@ void AUD_Initialize()
 
         LogDebug("Initializing Android Audio.");
 
+        sStreamMutex = SYS_CreateMutex();
+
         SLresult result;
         const SLuint32      engineMixIIDCount = 1;
         const SLInterfaceID engineMixIIDs[] = { SL_IID_ENGINE };
@@ -129,7 +219,7 @@ void AUD_Initialize()
         // Now to create buffer queues for loading sound to be played.
         SLDataLocator_AndroidSimpleBufferQueue dataLocatorIn;
         dataLocatorIn.locatorType = SL_DATALOCATOR_ANDROIDSIMPLEBUFFERQUEUE;
-        dataLocatorIn.numBuffers = 1;
+        dataLocatorIn.numBuffers = AUDIO_STREAM_QUEUE_BUFFERS;
 
         SLDataFormat_PCM dataFormat;
         dataFormat.formatType = SL_DATAFORMAT_PCM;
@@ -257,8 +347,13 @@ void AUD_Shutdown()
                 sPlayers[i] = 0;
                 sBufferQueues[i] = 0;
             }
+
+            ReleaseStream(i);
         }
 
+        SYS_DestroyMutex(sStreamMutex);
+        sStreamMutex = nullptr;
+
         if (sOutputMixObj != 0)
         {
             (*sOutputMixObj)->Destroy(sOutputMixObj);
@@ -325,6 +420,38 @@ void AUD_Play(
             return;
         }
 
+        if (soundWave->IsStreamed())
+        {
+            SCOPED_LOCK(sStreamMutex);
+            ReleaseStream(voiceIndex);
+            sStreams[voiceIndex] = AUD_OpenStream(soundWave, loop, startTime);
+
+            if (sStreams[voiceIndex] == nullptr)
+            {
+                return;
+            }
+
+            // Buffers hold a chunk converted to 16 bit stereo.
+            for (uint32_t i = 0; i < AUDIO_STREAM_QUEUE_BUFFERS; ++i)
+            {
+                sStreamBuffers[voiceIndex][i] = new uint8_t[AUDIO_STREAM_CHUNK_FRAMES * 4];
+            }
+
+            sStreamBufferIndices[voiceIndex] = 0;
+            sLoop[voiceIndex] = false;
+            sSoundData[voiceIndex] = nullptr;
+            sSoundSizes[voiceIndex] = 0;
+
+            for (uint32_t i = 0; i < AUDIO_STREAM_QUEUE_BUFFERS; ++i)
+            {
+                EnqueueStreamBuffer(voiceIndex);
+            }
+
+            AUD_SetVolume(voiceIndex, volume, volume);
+            AUD_SetPitch(voiceIndex, pitch);
+            return;
+        }
+
         sLoop[voiceIndex] = loop;
         sSoundData[voiceIndex] = soundWave->GetWaveData();
         sSoundSizes[voiceIndex] = soundWave->GetWaveDataSize();
@@ -347,7 +474,9 @@ void AUD_Play(
 
 void AUD_Stop(uint32_t voiceIndex)
 {
+    SCOPED_LOCK(sStreamMutex);
     SLresult result = (*(sBufferQueues[voiceIndex]))->Clear(sBufferQueues[voiceIndex]);
+    ReleaseStream(voiceIndex);
 
     sLoop[voiceIndex] = false;
     sSoundData[voiceIndex] = nullptr;
@@ -373,6 +502,12 @@ bool AUD_IsPlaying(uint32_t voiceIndex)
     else
     {
         playing = (queueState.count > 0);
+
+        SCOPED_LOCK(sStreamMutex);
+        if (sStreams[voiceIndex] != nullptr)
+        {
+            playing = playing || !sStreams[voiceIndex]->IsFinished();
+        }
     }
 
     return playing;
@@ -512,4 +647,10 @@ void AUD_ProcessWaveBuffer(SoundWave* soundWave)
     }
 }
 
+bool AUD_CanStream(SoundWave* soundWave)
+{
+    // Streamed chunks are converted to 16 bit stereo as they're queued, but not resampled.
+    return (soundWave->GetSampleRate() == 44100);
+}
+
 #endif
@@ -5,6 +5,7 @@
 class Stream;
 class SoundWave;
 class Audio3D;
+class AudioStream;
 
 struct PcmFormat
 {
@@ -34,7 +35,12 @@ void AUD_SetPitch(uint32_t voiceIndex, float pitch);
 uint8_t* AUD_AllocWaveBuffer(uint32_t size);
 void AUD_FreeWaveBuffer(void* buffer);
 void AUD_ProcessWaveBuffer(SoundWave* soundWave);
+bool AUD_CanStream(SoundWave* soundWave);
 
 // Platform Independent
 void AUD_EncodeVorbis(Stream& inStream, Stream& outStream, PcmFormat format);
 void AUD_DecodeVorbis(Stream& inStream, Stream& outStream, PcmFormat format);
+
+AudioStream* AUD_OpenStream(SoundWave* soundWave, bool loop, float startTime);
+void AUD_CloseStream(AudioStream* stream);
+void AUD_ShutdownStreams();
@@ -6,4 +6,7 @@
 #define AUDIO_MAX_VOICES 8
 #elif PLATFORM_ANDROID
 #define AUDIO_MAX_VOICES 8
-#endif
\ No newline at end of file
+#endif
+
+// Compressed sound waves that would decode to more than this many bytes are streamed instead.
+#define AUDIO_STREAMING_THRESHOLD (1024 * 1024)
@@ -0,0 +1,495 @@
+#include "Audio/AudioStream.h"
+#include "Audio/Audio.h"
+
+#include "Assets/SoundWave.h"
+#include "System/System.h"
+#include "Log.h"
+#include "Maths.h"
+
+#include <vector>
+#include <algorithm>
+#include <string.h>
+#include <math.h>
+
+static ThreadObject* sStreamThread = nullptr;
+static MutexObject* sStreamMutex = nullptr;
+static std::vector<AudioStream*> sStreams;
+static bool sStreamThreadExit = false;
+
+VorbisDecoder::~VorbisDecoder()
+{
+    Close();
+}
+
+bool VorbisDecoder::Open(const uint8_t* data, uint32_t size, uint32_t bytesPerSample)
+{
+    Close();
+
+    mData = data;
+    mSize = size;
+    mReadPos = 0;
+    mBytesPerSample = bytesPerSample;
+    mEndOfStream = false;
+
+    ogg_sync_init(&mSync);
+    vorbis_info_init(&mInfo);
+    vorbis_comment_init(&mComment);
+    mOpen = true;
+
+    // The identification, comment and codebook headers come first, possibly spanning several pages.
+    uint32_t numHeaders = 0;
+    while (numHeaders < 3)
+    {
+        ogg_packet packet;
+        int result = mStreamInit ? ogg_stream_packetout(&mStream, &packet) : 0;
+
+        if (result < 0)
+        {
+            LogError("Corrupt Vorbis header.");
+            Close();
+            return false;
+        }
+        else if (result == 0)
+        {
+            if (!ReadPage())
+            {
+                LogError("End of stream before finding all Vorbis headers.");
+                Close();
+                return false;
+            }
+        }
+        else
+        {
+            if (vorbis_synthesis_headerin(&mInfo, &mComment, &packet) < 0)
+            {
+                LogError("Ogg bitstream does not contain Vorbis audio data.");
+                Close();
+                return false;
+            }
+
+            numHeaders++;
+        }
+    }
+
+    if (vorbis_synthesis_init(&mDsp, &mInfo) != 0)
+    {
+        LogError("Failed to initialize Vorbis decoder.");
+        Close();
+        return false;
+    }
+
+    vorbis_block_init(&mDsp, &mBlock);
+    mDecoding = true;
+
+    return true;
+}
+
+void VorbisDecoder::Close()
+{
+    if (mDecoding)
+    {
+        vorbis_block_clear(&mBlock);
+        vorbis_dsp_clear(&mDsp);
+        mDecoding = false;
+    }
+
+    if (mStreamInit)
+    {
+        ogg_stream_clear(&mStream);
+        mStreamInit = false;
+    }
+
+    if (mOpen)
+    {
+        vorbis_comment_clear(&mComment);
+        vorbis_info_clear(&mInfo);
+        ogg_sync_clear(&mSync);
+        mOpen = false;
+    }
+}
+
+bool VorbisDecoder::Rewind()
+{
+    // Setting the decoder up again is cheap next to decoding, and it only happens once per loop.
+    return Open(mData, mSize, mBytesPerSample);
+}
+
+uint32_t VorbisDecoder::Decode(uint8_t* dst, uint32_t maxFrames)
+{
+    uint32_t frames = 0;
+
+    while (mDecoding && frames < maxFrames)
+    {
+        float** pcm = nullptr;
+        int samples = vorbis_synthesis_pcmout(&mDsp, &pcm);
+
+        if (samples > 0)
+        {
+            uint32_t count = glm::min(uint32_t(samples), maxFrames - frames);
+
+            if (dst != nullptr)
+            {
+                uint32_t numChannels = uint32_t(mInfo.channels);
+                uint8_t* out = dst + frames * numChannels * mBytesPerSample;
+
+                // Same conversion as AUD_DecodeVorbis(), so streamed and fully decoded waves match.
+                for (uint32_t f = 0; f < count; ++f)
+                {
+                    for (uint32_t c = 0; c < numChannels; ++c)
+                    {
+                        int32_t val = (int32_t)floor(pcm[c][f] * 32767.f + .5f);
+                        val = glm::clamp(val, -32768, 32767);
+
+                        if (mBytesPerSample == 1)
+                        {
+                            *out = (uint8_t)((val + 32768) >> 8);
+                        }
+                        else
+                        {
+                            int16_t sample = (int16_t)val;
+                            memcpy(out, &sample, sizeof(int16_t));
+                        }
+
+                        out += mBytesPerSample;
+                    }
+                }
+            }
+
+            vorbis_synthesis_read(&mDsp, int(count));
+            frames += count;
+        }
+        else
+        {
+            ogg_packet packet;
+            int result = ogg_stream_packetout(&mStream, &packet);
+
+            if (result > 0)
+            {
+                if (vorbis_synthesis(&mBlock, &packet) == 0)
+                {
+                    vorbis_synthesis_blockin(&mDsp, &mBlock);
+                }
+            }
+            else if (result == 0 &&
+                !ReadPage())
+            {
+                break;
+            }
+
+            // result < 0 means a page was missing. Carry on with the next packet.
+        }
+    }
+
+    return frames;
+}
+
+bool VorbisDecoder::IsOpen() const
+{
+    return mDecoding;
+}
+
+uint32_t VorbisDecoder::GetNumChannels() const
+{
+    return mDecoding ? uint32_t(mInfo.channels) : 0;
+}
+
+uint32_t VorbisDecoder::GetSampleRate() const
+{
+    return mDecoding ? uint32_t(mInfo.rate) : 0;
+}
+
+bool VorbisDecoder::ReadPage()
+{
+    while (!mEndOfStream)
+    {
+        ogg_page page;
+        int result = ogg_sync_pageout(&mSync, &page);
+
+        if (result > 0)
+        {
+            if (!mStreamInit)
+            {
+                ogg_stream_init(&mStream, ogg_page_serialno(&page));
+                mStreamInit = true;
+            }
+
+            ogg_stream_pagein(&mStream, &page);
+            mEndOfStream = (ogg_page_eos(&page) != 0);
+            return true;
+        }
+        else if (result == 0)
+        {
+            if (mReadPos >= mSize)
+            {
+                mEndOfStream = true;
+                break;
+            }
+
+            uint32_t bytes = glm::min<uint32_t>(4096, mSize - mReadPos);
+            char* buffer = ogg_sync_buffer(&mSync, bytes);
+            memcpy(buffer, mData + mReadPos, bytes);
+            ogg_sync_wrote(&mSync, bytes);
+            mReadPos += bytes;
+        }
+
+        // result < 0 means bytes were skipped looking for the next page.
+    }
+
+    return false;
+}
+
+AudioStream::AudioStream(SoundWave* soundWave, bool loop, float startTime) :
+    mReadFrame(0),
+    mWriteFrame(0),
+    mDecoderFinished(false)
+{
+    mNumChannels = soundWave->GetNumChannels();
+    mBytesPerSample = soundWave->GetBitsPerSample() / 8;
+    mSampleRate = soundWave->GetSampleRate();
+    mLoop = loop;
+
+    uint32_t numFrames = soundWave->GetNumSamples() / glm::max<uint32_t>(mNumChannels, 1);
+    mSkipFrames = glm::min(uint32_t(glm::max(startTime, 0.0f) * mSampleRate), numFrames);
+
+    if (!mDecoder.Open(soundWave->GetCompressedData(), soundWave->GetCompressedDataSize(), mBytesPerSample))
+    {
+        LogError("Failed to open audio stream for %s", soundWave->GetName().c_str());
+    }
+    else if (mDecoder.GetNumChannels() != mNumChannels)
+    {
+        LogError("Audio stream for %s has %d channels, expected %d", soundWave->GetName().c_str(), mDecoder.GetNumChannels(), mNumChannels);
+        mDecoder.Close();
+    }
+    else
+    {
+        mBuffer = new uint8_t[AUDIO_STREAM_BUFFER_FRAMES * GetBytesPerFrame()];
+    }
+
+    if (!mDecoder.IsOpen())
+    {
+        mDecoderFinished = true;
+    }
+}
+
+AudioStream::~AudioStream()
+{
+    delete [] mBuffer;
+    mBuffer = nullptr;
+}
+
+bool AudioStream::IsValid() const
+{
+    return (mBuffer != nullptr);
+}
+
+uint32_t AudioStream::Read(uint8_t* dst, uint32_t maxFrames)
+{
+    uint32_t readFrame = mReadFrame.load(std::memory_order_relaxed);
+    uint32_t writeFrame = mWriteFrame.load(std::memory_order_acquire);
+    uint32_t frames = glm::min(maxFrames, writeFrame - readFrame);
+
+    uint32_t bytesPerFrame = GetBytesPerFrame();
+    uint32_t index = readFrame & (AUDIO_STREAM_BUFFER_FRAMES - 1);
+    uint32_t firstFrames = glm::min(frames, AUDIO_STREAM_BUFFER_FRAMES - index);
+
+    memcpy(dst, mBuffer + index * bytesPerFrame, firstFrames * bytesPerFrame);
+    memcpy(dst + firstFrames * bytesPerFrame, mBuffer, (frames - firstFrames) * bytesPerFrame);
+
+    mReadFrame.store(readFrame + frames, std::memory_order_release);
+
+    return frames;
+}
+
+bool AudioStream::IsFinished() const
+{
+    return mDecoderFinished.load(std::memory_order_acquire) &&
+        mReadFrame.load(std::memory_order_relaxed) == mWriteFrame.load(std::memory_order_relaxed);
+}
+
+uint32_t AudioStream::GetNumChannels() const
+{
+    return mNumChannels;
+}
+
+uint32_t AudioStream::GetBytesPerSample() const
+{
+    return mBytesPerSample;
+}
+
+uint32_t AudioStream::GetSampleRate() const
+{
+    return mSampleRate;
+}
+
+uint32_t AudioStream::GetBytesPerFrame() const
+{
+    return mNumChannels * mBytesPerSample;
+}
+
+bool AudioStream::Fill()
+{
+    if (mDecoderFinished.load(std::memory_order_relaxed))
+    {
+        return false;
+    }
+
+    uint8_t* dst = nullptr;
+    uint32_t frames = 0;
+
+    if (mSkipFrames > 0)
+    {
+        // Seeking to the start time by decoding, Vorbis packets can't be decoded on their own.
+        frames = glm::min<uint32_t>(mSkipFrames, AUDIO_STREAM_CHUNK_FRAMES);
+    }
+    else
+    {
+        uint32_t writeFrame = mWriteFrame.load(std::memory_order_relaxed);
+        uint32_t readFrame = mReadFrame.load(std::memory_order_acquire);
+        uint32_t index = writeFrame & (AUDIO_STREAM_BUFFER_FRAMES - 1);
+
+        frames = AUDIO_STREAM_BUFFER_FRAMES - (writeFrame - readFrame);
+        frames = glm::min<uint32_t>(frames, AUDIO_STREAM_CHUNK_FRAMES);
+        frames = glm::min<uint32_t>(frames, AUDIO_STREAM_BUFFER_FRAMES - index);
+        dst = mBuffer + index * GetBytesPerFrame();
+
+        if (frames == 0)
+        {
+            return false;
+        }
+    }
+
+    uint32_t decoded = mDecoder.Decode(dst, frames);
+
+    if (dst == nullptr)
+    {
+        mSkipFrames -= decoded;
+    }
+    else
+    {
+        mWriteFrame.store(mWriteFrame.load(std::memory_order_relaxed) + decoded, std::memory_order_release);
+    }
+
+    if (decoded > 0)
+    {
+        mRewound = false;
+    }
+
+    if (decoded < frames)
+    {
+        // Reached the end. A looping stream that ends right after rewinding has nothing to play.
+        mSkipFrames = 0;
+
+        if (mLoop &&
+            !mRewound &&
+            mDecoder.Rewind())
+        {
+            mRewound = true;
+        }
+        else
+        {
+            mDecoderFinished.store(true, std::memory_order_release);
+        }
+    }
+
+    return true;
+}
+
+static ThreadFuncRet StreamThreadFunc(void* arg)
+{
+    bool exit = false;
+
+    while (!exit)
+    {
+        bool filled = false;
+
+        {
+            // Each stream gets one chunk per pass so that a stream that was just started
+            // can't starve the others, and so AUD_CloseStream() never waits long.
+            SCOPED_LOCK(sStreamMutex);
+            exit = sStreamThreadExit;
+
+            for (uint32_t i = 0; i < sStreams.size(); ++i)
+            {
+                filled = sStreams[i]->Fill() || filled;
+            }
+        }
+
+        if (!filled &&
+            !exit)
+        {
+            SYS_Sleep(AUDIO_STREAM_SLEEP_MS);
+        }
+    }
+
+    THREAD_RETURN();
+}
+
+AudioStream* AUD_OpenStream(SoundWave* soundWave, bool loop, float startTime)
+{
+    AudioStream* stream = new AudioStream(soundWave, loop, startTime);
+
+    if (!stream->IsValid())
+    {
+        delete stream;
+        return nullptr;
+    }
+
+    // Decode the first chunk right away so the voice doesn't start with a gap.
+    stream->Fill();
+
+    if (sStreamThread == nullptr)
+    {
+        sStreamMutex = SYS_CreateMutex();
+        sStreamThreadExit = false;
+        sStreamThread = SYS_CreateThread(StreamThreadFunc, nullptr);
+    }
+
+    SCOPED_LOCK(sStreamMutex);
+    sStreams.push_back(stream);
+
+    return stream;
+}
+
+void AUD_CloseStream(AudioStream* stream)
+{
+    if (stream == nullptr)
+        return;
+
+    if (sStreamMutex != nullptr)
+    {
+        SCOPED_LOCK(sStreamMutex);
+        auto it = std::find(sStreams.begin(), sStreams.end(), stream);
+
+        if (it != sStreams.end())
+        {
+            sStreams.erase(it);
+        }
+    }
+
+    delete stream;
+}
+
+void AUD_ShutdownStreams()
+{
+    if (sStreamThread != nullptr)
+    {
+        {
+            SCOPED_LOCK(sStreamMutex);
+            sStreamThreadExit = true;
+        }
+
+        SYS_JoinThread(sStreamThread);
+        SYS_DestroyThread(sStreamThread);
+        sStreamThread = nullptr;
+
+        SYS_DestroyMutex(sStreamMutex);
+        sStreamMutex = nullptr;
+    }
+
+    for (uint32_t i = 0; i < sStreams.size(); ++i)
+    {
+        delete sStreams[i];
+    }
+
+    sStreams.clear();
+}
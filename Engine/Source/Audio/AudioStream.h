@@ -0,0 +1,106 @@
+#pragma once
+
+#include "EngineTypes.h"
+
+#include <atomic>
+
+#include <vorbis/codec.h>
+
+class SoundWave;
+
+// Long compressed sound waves (music, ambience) are not decoded when they load. They keep their
+// Vorbis data and each voice playing them gets an AudioStream, which a background thread keeps
+// filled a little ahead of the voice. Short sounds stay fully decoded, see AUDIO_STREAMING_THRESHOLD.
+//
+// Streamed PCM uses the sound wave's own format (sample size, channels and rate), same as the
+// fully decoded wave data, so backends convert it the same way.
+
+// Frames of PCM kept ahead of each streaming voice. Must be a power of two.
+#define AUDIO_STREAM_BUFFER_FRAMES 32768
+
+// Frames decoded at a time by the stream thread, before it moves on to the next stream.
+#define AUDIO_STREAM_CHUNK_FRAMES 4096
+
+#define AUDIO_STREAM_SLEEP_MS 5
+
+// Pull based decoder for an in memory Ogg Vorbis stream.
+class VorbisDecoder
+{
+public:
+
+    ~VorbisDecoder();
+
+    bool Open(const uint8_t* data, uint32_t size, uint32_t bytesPerSample);
+    void Close();
+    bool Rewind();
+
+    // Decodes up to maxFrames interleaved frames into dst, or skips them if dst is null.
+    // Returns fewer than maxFrames only at the end of the stream.
+    uint32_t Decode(uint8_t* dst, uint32_t maxFrames);
+
+    bool IsOpen() const;
+    uint32_t GetNumChannels() const;
+    uint32_t GetSampleRate() const;
+
+protected:
+
+    bool ReadPage();
+
+    const uint8_t* mData = nullptr;
+    uint32_t mSize = 0;
+    uint32_t mReadPos = 0;
+    uint32_t mBytesPerSample = 2;
+    bool mOpen = false;
+    bool mStreamInit = false;
+    bool mDecoding = false;
+    bool mEndOfStream = false;
+
+    ogg_sync_state mSync = {};
+    ogg_stream_state mStream = {};
+    vorbis_info mInfo = {};
+    vorbis_comment mComment = {};
+    vorbis_dsp_state mDsp = {};
+    vorbis_block mBlock = {};
+};
+
+// Ring buffer between the stream thread (the only writer) and a voice (the only reader).
+class AudioStream
+{
+public:
+
+    AudioStream(SoundWave* soundWave, bool loop, float startTime);
+    ~AudioStream();
+
+    bool IsValid() const;
+
+    // Called by the voice. Returns the number of frames copied to dst, which can be fewer than
+    // maxFrames if the stream thread fell behind or the sound ended.
+    uint32_t Read(uint8_t* dst, uint32_t maxFrames);
+
+    // True once every frame of a non-looping sound has been read.
+    bool IsFinished() const;
+
+    uint32_t GetNumChannels() const;
+    uint32_t GetBytesPerSample() const;
+    uint32_t GetSampleRate() const;
+    uint32_t GetBytesPerFrame() const;
+
+    // Called by the stream thread. Returns false if there was nothing to do.
+    bool Fill();
+
+protected:
+
+    VorbisDecoder mDecoder;
+    uint8_t* mBuffer = nullptr;
+    uint32_t mNumChannels = 2;
+    uint32_t mBytesPerSample = 2;
+    uint32_t mSampleRate = 44100;
+    uint32_t mSkipFrames = 0;
+    bool mLoop = false;
+    bool mRewound = false;
+
+    // Frame counters only ever increase. They wrap around together with the buffer index.
+    std::atomic<uint32_t> mReadFrame;
+    std::atomic<uint32_t> mWriteFrame;
+    std::atomic<bool> mDecoderFinished;
+};
@@ -2,6 +2,7 @@
 
 #include "Audio/Audio.h"
 #include "Audio/AudioConstants.h"
+#include "Audio/AudioStream.h"
 #include "System/System.h"
 
 #include "Assets/SoundWave.h"
@@ -29,8 +30,49 @@ struct SoundVoice
     uint32_t mBytesPerSample = 2;
     bool mLoop = false;
     bool mActive = false;
+
+    // Streamed voices mix out of a small window of frames read from their stream each update.
+    AudioStream* mStream = nullptr;
+    uint8_t* mStreamBuffer = nullptr;
 };
 
+// Source frames a streamed voice can hold, enough for a full mix buffer at 4x pitch.
+#define AUDIO_STREAM_WINDOW_FRAMES 16384
+
+static void ReadStreamWindow(SoundVoice& voice, float srcFramesNeeded)
+{
+    uint32_t bytesPerFrame = voice.mBytesPerSample * voice.mNumChannels;
+
+    // Drop the frames that have already been mixed, keeping the one being interpolated from.
+    uint32_t consumed = glm::min(uint32_t(voice.mCurFrame), voice.mSrcFrames);
+    memmove(voice.mStreamBuffer, voice.mStreamBuffer + consumed * bytesPerFrame, (voice.mSrcFrames - consumed) * bytesPerFrame);
+    voice.mSrcFrames -= consumed;
+
+    // If the stream fell behind, the voice picks up where the stream is rather than skipping ahead.
+    voice.mCurFrame = glm::min(voice.mCurFrame - float(consumed), float(voice.mSrcFrames));
+
+    uint32_t wantedFrames = glm::min(uint32_t(voice.mCurFrame + srcFramesNeeded) + 2, uint32_t(AUDIO_STREAM_WINDOW_FRAMES));
+
+    if (wantedFrames > voice.mSrcFrames)
+    {
+        voice.mSrcFrames += voice.mStream->Read(
+            voice.mStreamBuffer + voice.mSrcFrames * bytesPerFrame,
+            wantedFrames - voice.mSrcFrames);
+    }
+}
+
+static void ReleaseVoiceStream(SoundVoice& voice)
+{
+    if (voice.mStream != nullptr)
+    {
+        AUD_CloseStream(voice.mStream);
+        voice.mStream = nullptr;
+    }
+
+    delete [] voice.mStreamBuffer;
+    voice.mStreamBuffer = nullptr;
+}
+
 static SoundVoice sVoices[AUDIO_MAX_VOICES];
 
 void AUD_Initialize()
@@ -102,6 +144,11 @@ void AUD_Initialize()
 
 void AUD_Shutdown()
 {
+    for (uint32_t i = 0; i < AUDIO_MAX_VOICES; ++i)
+    {
+        ReleaseVoiceStream(sVoices[i]);
+    }
+
     delete [] sMixBuffer;
     sMixBuffer = nullptr;
 
@@ -130,7 +177,6 @@ void AUD_Update()
             if (sVoices[i].mActive)
             {
                 SoundVoice& voice = sVoices[i];
-                OCT_ASSERT(voice.mSrcFrames > 0);
 
                 // If the voice is active, that means we need to mix *frames* number of frames
                 // into the mix buffer. The src voice may move at a faster or slower pace based on the 
@@ -139,6 +185,15 @@ void AUD_Update()
                 // TODO: Handle pitch
                 float srcDeltaFrame = 1 * voice.mPitch * (voice.mSampleRate / 44100.0f);
 
+                if (voice.mStream != nullptr)
+                {
+                    ReadStreamWindow(voice, frames * srcDeltaFrame);
+                }
+                else
+                {
+                    OCT_ASSERT(voice.mSrcFrames > 0);
+                }
+
                 for (int32_t dstFrame = 0; dstFrame < frames; ++dstFrame)
                 {
                     float srcFrameFloat = voice.mCurFrame + (dstFrame * srcDeltaFrame);
@@ -223,7 +278,7 @@ void AUD_Update()
 
                 voice.mCurFrame += (frames * srcDeltaFrame);
 
-                if (voice.mLoop)
+                if (voice.mLoop && voice.mSrcFrames > 0)
                 {
                     voice.mCurFrame = fmod(voice.mCurFrame, (float) voice.mSrcFrames);
                 }
@@ -272,6 +327,24 @@ void AUD_Play(
     int32_t bytesPerFrame = sVoices[voiceIndex].mBytesPerSample * sVoices[voiceIndex].mNumChannels;
     sVoices[voiceIndex].mSrcFrames = sVoices[voiceIndex].mSrcBufferLen / bytesPerFrame;
 
+    if (soundWave->IsStreamed())
+    {
+        // The stream loops by itself, the window of frames it fills never wraps.
+        sVoices[voiceIndex].mStream = AUD_OpenStream(soundWave, loop, startTime);
+        sVoices[voiceIndex].mStreamBuffer = new uint8_t[AUDIO_STREAM_WINDOW_FRAMES * bytesPerFrame];
+        sVoices[voiceIndex].mSrcBuffer = sVoices[voiceIndex].mStreamBuffer;
+        sVoices[voiceIndex].mSrcBufferLen = AUDIO_STREAM_WINDOW_FRAMES * bytesPerFrame;
+        sVoices[voiceIndex].mSrcFrames = 0;
+        sVoices[voiceIndex].mLoop = false;
+
+        if (sVoices[voiceIndex].mStream == nullptr)
+        {
+            ReleaseVoiceStream(sVoices[voiceIndex]);
+            sVoices[voiceIndex].mActive = false;
+            return;
+        }
+    }
+
     OCT_ASSERT(sVoices[voiceIndex].mSrcBufferLen % bytesPerFrame == 0);
     OCT_ASSERT(bytesPerFrame > 0 &&
            bytesPerFrame <= 4);
@@ -280,10 +353,18 @@ void AUD_Play(
 void AUD_Stop(uint32_t voiceIndex)
 {
     sVoices[voiceIndex].mActive = false;
+    ReleaseVoiceStream(sVoices[voiceIndex]);
 }
 
 bool AUD_IsPlaying(uint32_t voiceIndex)
 {
+    if (sVoices[voiceIndex].mActive &&
+        sVoices[voiceIndex].mStream != nullptr)
+    {
+        return !sVoices[voiceIndex].mStream->IsFinished() ||
+               sVoices[voiceIndex].mCurFrame < sVoices[voiceIndex].mSrcFrames;
+    }
+
     return sVoices[voiceIndex].mActive &&
            sVoices[voiceIndex].mCurFrame < sVoices[voiceIndex].mSrcFrames;
 }
@@ -314,4 +395,9 @@ void AUD_ProcessWaveBuffer(SoundWave* soundWave)
 
 }
 
+bool AUD_CanStream(SoundWave* soundWave)
+{
+    return true;
+}
+
 #endif
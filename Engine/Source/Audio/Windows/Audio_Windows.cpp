@@ -2,6 +2,7 @@
 
 #include "Audio/Audio.h"
 #include "Audio/AudioConstants.h"
+#include "Audio/AudioStream.h"
 #include "System/System.h"
 
 #include "Assets/SoundWave.h"
@@ -15,6 +16,12 @@ static IXAudio2SourceVoice* sSourceVoices[AUDIO_MAX_VOICES] = { };
 static XAUDIO2_BUFFER sSourceBuffers[AUDIO_MAX_VOICES] = { };
 static uint8_t* sStereoConvertedBuffers[AUDIO_MAX_VOICES] = { };
 
+// Streamed voices rotate through a few chunk sized buffers, refilled from AUD_Update().
+#define AUDIO_STREAM_QUEUE_BUFFERS 3
+static AudioStream* sStreams[AUDIO_MAX_VOICES] = { };
+static uint8_t* sStreamBuffers[AUDIO_MAX_VOICES][AUDIO_STREAM_QUEUE_BUFFERS] = { };
+static uint32_t sStreamBufferIndices[AUDIO_MAX_VOICES] = { };
+
 // An attempt to reuse source voices?
 //struct WaveFormat
 //{
@@ -24,6 +31,66 @@ static uint8_t* sStereoConvertedBuffers[AUDIO_MAX_VOICES] = { };
 //};
 //static WaveFormat sLastWaveFormats[AUDIO_MAX_VOICES] = {};
 
+static void SubmitStreamBuffers(uint32_t voiceIndex)
+{
+    AudioStream* stream = sStreams[voiceIndex];
+
+    XAUDIO2_VOICE_STATE state;
+    sSourceVoices[voiceIndex]->GetState(&state, XAUDIO2_VOICE_NOSAMPLESPLAYED);
+    uint32_t buffersQueued = state.BuffersQueued;
+
+    while (buffersQueued < AUDIO_STREAM_QUEUE_BUFFERS)
+    {
+        uint32_t bufferIndex = sStreamBufferIndices[voiceIndex];
+        uint8_t* buffer = sStreamBuffers[voiceIndex][bufferIndex];
+        uint32_t numFrames = stream->Read(buffer, AUDIO_STREAM_CHUNK_FRAMES);
+
+        if (numFrames == 0)
+        {
+            break;
+        }
+
+        uint32_t numBytes = numFrames * stream->GetBytesPerFrame();
+
+        if (stream->GetNumChannels() == 1)
+        {
+            // Duplicate to stereo in place, working backwards so we don't overwrite samples.
+            uint32_t sampleSize = stream->GetBytesPerSample();
+
+            for (int32_t i = int32_t(numFrames) - 1; i >= 0; --i)
+            {
+                memcpy(buffer + (i * 2 + 1) * sampleSize, buffer + i * sampleSize, sampleSize);
+                memcpy(buffer + (i * 2 + 0) * sampleSize, buffer + i * sampleSize, sampleSize);
+            }
+
+            numBytes *= 2;
+        }
+
+        XAUDIO2_BUFFER sourceBuffer = {};
+        sourceBuffer.AudioBytes = numBytes;
+        sourceBuffer.pAudioData = buffer;
+        sSourceVoices[voiceIndex]->SubmitSourceBuffer(&sourceBuffer);
+
+        sStreamBufferIndices[voiceIndex] = (bufferIndex + 1) % AUDIO_STREAM_QUEUE_BUFFERS;
+        buffersQueued++;
+    }
+}
+
+static void ReleaseStream(uint32_t voiceIndex)
+{
+    if (sStreams[voiceIndex] != nullptr)
+    {
+        AUD_CloseStream(sStreams[voiceIndex]);
+        sStreams[voiceIndex] = nullptr;
+
+        for (uint32_t i = 0; i < AUDIO_STREAM_QUEUE_BUFFERS; ++i)
+        {
+            delete [] sStreamBuffers[voiceIndex][i];
+            sStreamBuffers[voiceIndex][i] = nullptr;
+        }
+    }
+}
+
 void AUD_Initialize()
 {
     if (XAudio2Create(&sXAudio2, 0, XAUDIO2_DEFAULT_PROCESSOR) < 0)
@@ -50,6 +117,8 @@ void AUD_Shutdown()
             // TODO: Do we need to call delete??
             sSourceVoices[i] = nullptr;
         }
+
+        ReleaseStream(i);
     }
     sMasterVoice->DestroyVoice();
     sXAudio2->Release();
@@ -57,7 +126,14 @@ void AUD_Shutdown()
 
 void AUD_Update()
 {
-
+    for (uint32_t i = 0; i < AUDIO_MAX_VOICES; ++i)
+    {
+        if (sStreams[i] != nullptr &&
+            sSourceVoices[i] != nullptr)
+        {
+            SubmitStreamBuffers(i);
+        }
+    }
 }
 
 void AUD_Play(
@@ -71,8 +147,30 @@ void AUD_Play(
 {
     OCT_ASSERT(sSourceVoices[voiceIndex] == nullptr);
 
+    bool streamed = soundWave->IsStreamed();
+    if (streamed)
+    {
+        OCT_ASSERT(sStreams[voiceIndex] == nullptr);
+        sStreams[voiceIndex] = AUD_OpenStream(soundWave, loop, startTime);
+
+        if (sStreams[voiceIndex] == nullptr)
+        {
+            return;
+        }
+
+        // Room for a chunk after it's converted to stereo.
+        uint32_t bufferSize = AUDIO_STREAM_CHUNK_FRAMES * 2 * sStreams[voiceIndex]->GetBytesPerSample();
+
+        for (uint32_t i = 0; i < AUDIO_STREAM_QUEUE_BUFFERS; ++i)
+        {
+            sStreamBuffers[voiceIndex][i] = new uint8_t[bufferSize];
+        }
+
+        sStreamBufferIndices[voiceIndex] = 0;
+    }
+
     bool monoInput = (soundWave->GetNumChannels() == 1);
-    if (monoInput)
+    if (monoInput && !streamed)
     {
         OCT_ASSERT(sStereoConvertedBuffers[voiceIndex] == nullptr);
         sStereoConvertedBuffers[voiceIndex] = new uint8_t[soundWave->GetWaveDataSize() * 2];
@@ -127,7 +225,14 @@ void AUD_Play(
 
     if (sXAudio2->CreateSourceVoice(&sSourceVoices[voiceIndex], &waveFormat) >= 0)
     {
-        sSourceVoices[voiceIndex]->SubmitSourceBuffer(&sSourceBuffers[voiceIndex]);
+        if (streamed)
+        {
+            SubmitStreamBuffers(voiceIndex);
+        }
+        else
+        {
+            sSourceVoices[voiceIndex]->SubmitSourceBuffer(&sSourceBuffers[voiceIndex]);
+        }
 
         // Spatial sounds will update their volume every frame.
         sSourceVoices[voiceIndex]->SetVolume(spatial ? 0.0f : volume);
@@ -154,6 +259,8 @@ void AUD_Stop(uint32_t voiceIndex)
         delete sStereoConvertedBuffers[voiceIndex];
         sStereoConvertedBuffers[voiceIndex] = nullptr;
     }
+
+    ReleaseStream(voiceIndex);
 }
 
 bool AUD_IsPlaying(uint32_t voiceIndex)
@@ -161,6 +268,13 @@ bool AUD_IsPlaying(uint32_t voiceIndex)
     OCT_ASSERT(sSourceVoices[voiceIndex] != nullptr);
     XAUDIO2_VOICE_STATE state;
     sSourceVoices[voiceIndex]->GetState(&state, XAUDIO2_VOICE_NOSAMPLESPLAYED);
+
+    if (sStreams[voiceIndex] != nullptr)
+    {
+        // Queued buffers can run dry for a moment if the stream thread falls behind.
+        return (state.BuffersQueued != 0) || !sStreams[voiceIndex]->IsFinished();
+    }
+
     return (state.BuffersQueued != 0);
 }
 
@@ -198,4 +312,9 @@ void AUD_ProcessWaveBuffer(SoundWave* soundWave)
 
 }
 
+bool AUD_CanStream(SoundWave* soundWave)
+{
+    return true;
+}
+
 #endif
@@ -13,6 +13,7 @@
 #include <unordered_map>
 #include <string>
 #include <functional>
+#include <map>
 #include <algorithm>
 
 #include "Log.h"
@@ -31,6 +32,7 @@
 #include "Assets/SoundWave.h"
 #include "Assets/Font.h"
 #include "AssetDir.h"
+#include "AssetPak.h"
 #include "EmbeddedFile.h"
 #include "Utilities.h"
 #include "EditorUtils.h"
@@ -49,6 +51,7 @@
 #include "Nodes/3D/Audio3d.h"
 #include "Nodes/3D/ShadowMesh3d.h"
 #include "Nodes/3D/TextMesh3d.h"
+#include "Nodes/3D/Camera3d.h"
 
 #include "System/System.h"
 
@@ -149,6 +152,17 @@ void ActionManager::BuildData(Platform platform, bool embedded)
     CreateDir(packagedDir.c_str());
 
     // (2) Iterate over AssetDirs and save each file (platform-specific save) to the Packaged folder.
+    // Desktop builds pack all of the cooked assets into pak archives in the project folder.
+    // Embedded builds and platforms that use the asset registry still need loose .oct files.
+    bool packAssets = !embedded && (platform == Platform::Windows || platform == Platform::Linux);
+    AssetPakWriter pakWriter;
+
+    if (packAssets)
+    {
+        CreateDir((packagedDir + projectName + "/").c_str());
+        packAssets = pakWriter.Begin(packagedDir + projectName + "/");
+    }
+
     std::function<void(AssetDir*, bool)> saveDir = [&](AssetDir* dir, bool engine)
     {
         std::string packDir;
@@ -163,7 +177,8 @@ void ActionManager::BuildData(Platform platform, bool embedded)
             packDir = packagedDir + projectName + "/" + packDir;
         }
 
-        if (!DoesDirExist(packDir.c_str()))
+        if (!packAssets &&
+            !DoesDirExist(packDir.c_str()))
         {
             CreateDir(packDir.c_str());
         }
@@ -179,8 +194,25 @@ void ActionManager::BuildData(Platform platform, bool embedded)
                 AssetManager::Get()->LoadAsset(*stub);
             }
 
-            std::string packFile = packDir + stub->mAsset->GetName() + ".oct";
-            stub->mAsset->SaveFile(packFile.c_str(), platform);
+            if (packAssets)
+            {
+                Stream cookStream;
+                stub->mAsset->SaveStream(cookStream, platform);
+                pakWriter.AddEntry(stub->mAsset->GetName(), stub->mType, engine ? AssetPakEngine : 0, cookStream.GetData(), cookStream.GetSize());
+            }
+            else
+            {
+                std::string packFile = packDir + stub->mAsset->GetName() + ".oct";
+                stub->mAsset->SaveFile(packFile.c_str(), platform);
+
+                // Currently either embed everything or embed nothing...
+                // Embed flag on Asset does nothing, but if we want to keep that feature, then 
+                // we need to load the asset if it's not loaded, add to embedded list if it's flagged and then probably unload it after.
+                if (embedded)
+                {
+                    embeddedAssets.push_back({ stub, packFile });
+                }
+            }
 
             if (true)
             {
@@ -188,14 +220,6 @@ void ActionManager::BuildData(Platform platform, bool embedded)
                 AssetManager::Get()->SaveAsset(*stub);
             }
 
-            // Currently either embed everything or embed nothing...
-            // Embed flag on Asset does nothing, but if we want to keep that feature, then 
-            // we need to load the asset if it's not loaded, add to embedded list if it's flagged and then probably unload it after.
-            if (embedded)
-            {
-                embeddedAssets.push_back({ stub, packFile });
-            }
-
             if (!alreadyLoaded)
             {
                 AssetManager::Get()->UnloadAsset(*stub);
@@ -219,13 +243,37 @@ void ActionManager::BuildData(Platform platform, bool embedded)
     saveDir(engineAssetDir, true);
     saveDir(projectAssetDir, false);
 
+    if (packAssets &&
+        pakWriter.End())
+    {
+        LogDebug("Packed %d assets into %d pak archive(s)", pakWriter.GetNumEntries(), pakWriter.GetNumArchives());
+
+        const std::unordered_map<TypeId, AssetPakTypeStats>& cookStats = pakWriter.GetCookStats();
+        for (auto it = cookStats.begin(); it != cookStats.end(); ++it)
+        {
+            const AssetPakTypeStats& stats = it->second;
+            double ratio = (stats.mStoredBytes > 0) ? double(stats.mUncompressedBytes) / double(stats.mStoredBytes) : 1.0;
+            LogDebug("  %s: %d assets, %.2f MB -> %.2f MB (%.2fx) in %.2f ms",
+                Asset::GetNameFromTypeId(it->first),
+                stats.mCount,
+                stats.mUncompressedBytes / (1024.0 * 1024.0),
+                stats.mStoredBytes / (1024.0 * 1024.0),
+                ratio,
+                stats.mTimeUs / 1000.0);
+        }
+    }
+
     // (3) Generate .cpp / .h files (empty if not embedded) using the .oct files in the Packaged folder.
     // (4) Create and save an asset registry file with simple list of asset paths into Packaged folder.
+    // Pak builds find their assets through the archive toc, so they don't need a registry.
     std::unordered_map<std::string, AssetStub*>& assetMap = AssetManager::Get()->GetAssetMap();
     FILE* registryFile = nullptr;
 
-    std::string registryFileName = packagedDir + projectName + "/AssetRegistry.txt";
-    registryFile = fopen(registryFileName.c_str(), "w");
+    if (!packAssets)
+    {
+        std::string registryFileName = packagedDir + projectName + "/AssetRegistry.txt";
+        registryFile = fopen(registryFileName.c_str(), "w");
+    }
 
     for (auto pair : assetMap)
     {
@@ -1971,7 +2019,206 @@ void ActionManager::ResaveAllAssets()
     }
 
     // Refsweep afterwards to 
-    AssetManager::Get()->RefSweep();
+    AssetManager::Get()->RefSweep(true);
+}
+
+void ActionManager::PartitionScene(float cellSize)
+{
+    Scene* scene = GetPartitionEditScene();
+    Node* rootNode = GetWorld()->GetRootNode();
+
+    if (scene == nullptr)
+        return;
+
+    if (cellSize <= 0.0f)
+    {
+        LogWarning("Partition cell size must be greater than 0");
+        return;
+    }
+
+    AssetStub* sceneStub = AssetManager::Get()->GetAssetStub(scene->GetName());
+    OCT_ASSERT(sceneStub != nullptr);
+
+    // Bring back the current cells first so a scene can be repartitioned with a different cell size.
+    std::vector<std::string> oldCellNames;
+    MergePartitionCells(scene, rootNode, oldCellNames);
+
+    // Group the root's children by cell. Nodes that every host or every cell may need
+    // (replicated nodes, cameras, directional lights) stay in the root scene.
+    std::map<std::pair<int32_t, int32_t>, std::vector<Node*>> cellNodes;
+    const std::vector<Node*>& children = rootNode->GetChildren();
+
+    for (uint32_t i = 0; i < children.size(); ++i)
+    {
+        Node3D* node3d = children[i]->As<Node3D>();
+
+        if (node3d == nullptr ||
+            node3d->IsTransient() ||
+            node3d->IsReplicated() ||
+            node3d->As<Camera3D>() != nullptr ||
+            node3d->As<DirectionalLight3D>() != nullptr)
+        {
+            continue;
+        }
+
+        glm::ivec2 coord = GetPartitionCellCoord(node3d->GetAbsolutePosition(), cellSize);
+        cellNodes[{ coord.x, coord.y }].push_back(node3d);
+    }
+
+    std::vector<ScenePartitionCell> cells;
+
+    for (auto& pair : cellNodes)
+    {
+        ScenePartitionCell cell;
+        cell.mX = pair.first.first;
+        cell.mZ = pair.first.second;
+        cell.mSceneName = scene->GetName() + "_Cell_" + std::to_string(cell.mX) + "_" + std::to_string(cell.mZ);
+
+        AssetStub* cellStub = AssetManager::Get()->GetAssetStub(cell.mSceneName);
+        if (cellStub == nullptr)
+        {
+            cellStub = AssetManager::Get()->CreateAndRegisterAsset(Scene::GetStaticType(), sceneStub->mDirectory, cell.mSceneName, false);
+        }
+        else if (cellStub->mAsset == nullptr)
+        {
+            AssetManager::Get()->LoadAsset(*cellStub);
+        }
+
+        if (cellStub == nullptr ||
+            cellStub->mType != Scene::GetStaticType())
+        {
+            LogError("Failed to create partition cell %s", cell.mSceneName.c_str());
+            continue;
+        }
+
+        // The cell root sits at the world root's origin, so nodes keep their local transforms.
+        Node* cellRoot = Node::Construct(Node3D::GetStaticType());
+        cellRoot->SetName(cell.mSceneName);
+
+        for (uint32_t i = 0; i < pair.second.size(); ++i)
+        {
+            pair.second[i]->Attach(cellRoot);
+        }
+
+        Scene* cellScene = static_cast<Scene*>(cellStub->mAsset);
+        cellScene->Capture(cellRoot);
+        AssetManager::Get()->SaveAsset(*cellStub);
+
+        Node::Destruct(cellRoot);
+        cellRoot = nullptr;
+
+        cells.push_back(cell);
+    }
+
+    DeletePartitionCells(oldCellNames, cells);
+
+    scene->SetPartitionCellSize(cellSize);
+    scene->SetPartitionCells(cells);
+
+    // Partitioned nodes were destroyed, so undo history may point at them.
+    GetEditorState()->SetSelectedNode(nullptr);
+    ResetUndoRedo();
+
+    GetEditorState()->CaptureAndSaveScene(sceneStub, rootNode);
+
+    LogDebug("Partitioned %s into %d cells", scene->GetName().c_str(), int32_t(cells.size()));
+}
+
+void ActionManager::UnpartitionScene()
+{
+    Scene* scene = GetPartitionEditScene();
+    Node* rootNode = GetWorld()->GetRootNode();
+
+    if (scene == nullptr)
+        return;
+
+    if (!scene->IsPartitioned())
+    {
+        LogWarning("Scene %s is not partitioned", scene->GetName().c_str());
+        return;
+    }
+
+    std::vector<std::string> oldCellNames;
+    MergePartitionCells(scene, rootNode, oldCellNames);
+    DeletePartitionCells(oldCellNames, {});
+
+    scene->SetPartitionCellSize(0.0f);
+    scene->SetPartitionCells({});
+
+    GetEditorState()->SetSelectedNode(nullptr);
+    ResetUndoRedo();
+
+    AssetStub* sceneStub = AssetManager::Get()->GetAssetStub(scene->GetName());
+    GetEditorState()->CaptureAndSaveScene(sceneStub, rootNode);
+}
+
+Scene* ActionManager::GetPartitionEditScene()
+{
+    EditScene* editScene = GetEditorState()->GetEditScene();
+
+    if (GetEditorState()->mPlayInEditor)
+    {
+        LogWarning("Can't partition a scene while playing in editor");
+        return nullptr;
+    }
+
+    if (editScene == nullptr ||
+        editScene->mSceneAsset == nullptr ||
+        GetWorld()->GetRootNode() == nullptr)
+    {
+        LogWarning("Save the scene before partitioning it");
+        return nullptr;
+    }
+
+    return editScene->mSceneAsset.Get<Scene>();
+}
+
+void ActionManager::MergePartitionCells(Scene* scene, Node* rootNode, std::vector<std::string>& outCellNames)
+{
+    const std::vector<ScenePartitionCell>& cells = scene->GetPartitionCells();
+
+    for (uint32_t i = 0; i < cells.size(); ++i)
+    {
+        outCellNames.push_back(cells[i].mSceneName);
+
+        Scene* cellScene = LoadAsset<Scene>(cells[i].mSceneName);
+        Node* cellRoot = cellScene ? cellScene->Instantiate() : nullptr;
+
+        if (cellRoot == nullptr)
+        {
+            LogWarning("Missing partition cell %s", cells[i].mSceneName.c_str());
+            continue;
+        }
+
+        while (cellRoot->GetNumChildren() > 0)
+        {
+            cellRoot->GetChild(0)->Attach(rootNode);
+        }
+
+        Node::Destruct(cellRoot);
+    }
+}
+
+void ActionManager::DeletePartitionCells(const std::vector<std::string>& cellNames, const std::vector<ScenePartitionCell>& keepCells)
+{
+    for (uint32_t i = 0; i < cellNames.size(); ++i)
+    {
+        bool keep = false;
+        for (uint32_t k = 0; k < keepCells.size(); ++k)
+        {
+            if (keepCells[k].mSceneName == cellNames[i])
+            {
+                keep = true;
+                break;
+            }
+        }
+
+        AssetStub* stub = keep ? nullptr : AssetManager::Get()->GetAssetStub(cellNames[i]);
+        if (stub != nullptr)
+        {
+            DeleteAsset(stub);
+        }
+    }
 }
 
 void ActionManager::DeleteAsset(AssetStub* stub)
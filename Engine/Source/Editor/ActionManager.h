@@ -10,6 +10,7 @@
 #include "Nodes/Node.h"
 
 class Node3D;
+struct ScenePartitionCell;
 
 class Action
 {
@@ -88,6 +89,10 @@ protected:
     std::vector<Action*> mActionFuture;
     std::vector<Node*> mExiledNodes;
 
+    Scene* GetPartitionEditScene();
+    void MergePartitionCells(Scene* scene, Node* rootNode, std::vector<std::string>& outCellNames);
+    void DeletePartitionCells(const std::vector<std::string>& cellNames, const std::vector<ScenePartitionCell>& keepCells);
+
 public:
 
     // Actions
@@ -107,6 +112,8 @@ public:
     void DeleteAllNodes();
     void RecaptureAndSaveAllScenes();
     void ResaveAllAssets();
+    void PartitionScene(float cellSize);
+    void UnpartitionScene();
     void DeleteAsset(AssetStub* stub);
     void DeleteAssetDir(AssetDir* dir);
     void DuplicateNodes(std::vector<Node*> nodes);
@@ -78,6 +78,8 @@ static bool sFileBrowserNeedsRefresh = false;
 
 static bool sObjectTabOpen = false;
 
+static float sPartitionCellSize = 64.0f;
+
 static void PopulateFileBrowserDirs()
 {
     sFileBrowserDoubleClickBlock = 0.2f;
@@ -719,6 +721,49 @@ static void DrawPropertyList(RTTI* owner, std::vector<Property>& props)
                         am->EXE_EditProperty(owner, ownerType, prop.mName, i, propVal);
                     }
                 }
+                else if (prop.mExtra == int32_t(IntegerExtra::FlagWidget))
+                {
+                    // 32 bit flags are drawn as 4 rows of 8. The first row matches the byte flag widget (bits 7..0).
+                    ImVec2 itemSpacing = ImGui::GetStyle().ItemSpacing;
+                    itemSpacing.x = 2.0f;
+                    ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, itemSpacing);
+
+                    for (uint32_t f = 0; f < 32; ++f)
+                    {
+                        if (f % 8 != 0)
+                            ImGui::SameLine();
+
+                        ImGui::PushID(f);
+
+                        int32_t bit = int32_t(f / 8) * 8 + (7 - int32_t(f % 8));
+                        bool bitSet = (uint32_t(propVal) >> bit) & 1;
+
+                        ImVec4* imColors = ImGui::GetStyle().Colors;
+
+                        if (bitSet)
+                        {
+                            ImGui::PushStyleColor(ImGuiCol_Button, kSelectedColor);
+                        }
+                        else
+                        {
+                            ImGui::PushStyleColor(ImGuiCol_Button, imColors[ImGuiCol_Button]);
+                        }
+
+                        if (ImGui::Button("", ImVec2(16.0f, 16.0f)))
+                        {
+                            uint32_t newBitMask = uint32_t(propVal) ^ (1u << bit);
+                            propVal = int32_t(newBitMask);
+
+                            am->EXE_EditProperty(owner, ownerType, prop.mName, i, propVal);
+                        }
+
+                        ImGui::PopStyleColor();
+
+                        ImGui::PopID();
+                    }
+
+                    ImGui::PopStyleVar();
+                }
                 else
                 {
                     ImGui::DragInt("", &propVal);
@@ -2387,6 +2432,15 @@ static void DrawViewportPanel()
             am->RecaptureAndSaveAllScenes();
         if (ImGui::Selectable("Resave All Assets"))
             am->ResaveAllAssets();
+        if (editScene && ImGui::BeginMenu("World Partition"))
+        {
+            ImGui::DragFloat("Cell Size", &sPartitionCellSize, 1.0f, 1.0f, 100000.0f, "%.0f");
+            if (ImGui::Selectable("Partition Scene"))
+                am->PartitionScene(sPartitionCellSize);
+            if (ImGui::Selectable("Unpartition Scene"))
+                am->UnpartitionScene();
+            ImGui::EndMenu();
+        }
         if (ImGui::Selectable("Reload All Scripts"))
             ReloadAllScripts();
         //if (ImGui::Selectable("Import Scene"))
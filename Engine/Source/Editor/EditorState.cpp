@@ -495,6 +495,9 @@ void EditorState::BeginPlayInEditor()
     {
         Node* clonedRoot = editScene->mRootNode->Clone(true, false);
         GetWorld()->SetRootNode(clonedRoot);
+
+        // The clone isn't linked to the scene, so tell the partition which cells to stream.
+        GetWorld()->GetWorldPartition()->SetScene(editScene->mSceneAsset.Get<Scene>());
     }
 }
 
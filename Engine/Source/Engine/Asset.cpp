@@ -2,6 +2,7 @@
 #include "Stream.h"
 #include "Property.h"
 #include "AssetDir.h"
+#include "AssetPak.h"
 #include "Engine.h"
 #include "AssetManager.h"
 #include "Log.h"
@@ -161,7 +162,7 @@ void Asset::LoadFile(const char* path, AsyncLoadRequest* request)
 
     Stream stream;
     stream.SetAsyncRequest(request);
-    stream.ReadFile(path, true);
+    stream.MapFile(path, true);
     LoadStream(stream, GetPlatform());
 
     // Only "finish" the load if not async.
@@ -198,10 +199,51 @@ void Asset::LoadEmbedded(const EmbeddedFile* embeddedAsset, AsyncLoadRequest* re
     LogDebug("Asset loaded: %s", mName.c_str());
 }
 
+void Asset::LoadPak(const AssetPak* pak, uint32_t entryIndex, AsyncLoadRequest* request)
+{
+    if (IsLoaded())
+        return;
+
+    const AssetPakEntry& entry = pak->GetEntry(entryIndex);
+    pak->PrefetchEntry(entryIndex);
+
+    if (entry.mFlags & AssetPakCompressed)
+    {
+        // Decompressed straight into the stream's buffer.
+        Stream stream;
+        stream.SetSize(entry.mUncompressedSize);
+
+        if (!pak->DecompressEntry(entryIndex, stream.GetData()))
+        {
+            LogError("Failed to decompress asset: %s", pak->GetEntryName(entryIndex));
+            return;
+        }
+
+        stream.SetAsyncRequest(request);
+        LoadStream(stream, GetPlatform());
+    }
+    else
+    {
+        // Parsed in place, the archive stays mapped for the lifetime of the AssetManager.
+        Stream stream(pak->GetEntryData(entryIndex), entry.mSize);
+        stream.SetAsyncRequest(request);
+        LoadStream(stream, GetPlatform());
+    }
+
+    // Only "finish" the load if not async.
+    if (request == nullptr)
+    {
+        Create();
+    }
+
+    LogDebug("Asset loaded: %s", mName.c_str());
+}
+
 void Asset::LoadStream(Stream& stream, Platform platform)
 {
     AssetHeader header = ReadHeader(stream);
     mVersion = header.mVersion;
+    stream.SetAssetVersion(mVersion);
     mType = header.mType;
     mEmbedded = header.mEmbedded;
     mOldType = header.mOldType;
@@ -247,6 +289,16 @@ bool Asset::IsTransient() const
     return false;
 }
 
+uint64_t Asset::GetCpuMemorySize()
+{
+    return 0;
+}
+
+uint64_t Asset::GetGpuMemorySize()
+{
+    return 0;
+}
+
 AssetHeader Asset::ReadHeader(Stream& stream)
 {
     AssetHeader header;
@@ -13,9 +13,17 @@
 class Stream;
 class Property;
 class AssetDir;
+class AssetPak;
+struct AsyncLoadRequest;
 
 #define ASSET_MAGIC_NUMBER 0x4f435421
-#define ASSET_CURRENT_VERSION 1
+#define ASSET_VERSION_BASE 1
+#define ASSET_VERSION_BULK_ARRAYS 2
+#define ASSET_VERSION_TRIANGLE_BVH 3
+#define ASSET_VERSION_TEXTURE_MIPS 4
+#define ASSET_VERSION_WORLD_PARTITION 5
+#define ASSET_VERSION_COLLISION_LAYERS 6
+#define ASSET_CURRENT_VERSION ASSET_VERSION_COLLISION_LAYERS
 
 #define DECLARE_ASSET(Base, Parent) DECLARE_FACTORY(Base, Asset); DECLARE_RTTI(Base, Parent);
 #define DEFINE_ASSET(Base) DEFINE_FACTORY(Base, Asset); DEFINE_RTTI(Base);
@@ -46,10 +54,21 @@ struct AssetStub
 {
     Asset* mAsset = nullptr;
     const EmbeddedFile* mEmbeddedData = nullptr;
+    const AssetPak* mPak = nullptr;
+    int32_t mPakEntry = -1;
     std::string mPath;
     TypeId mType = INVALID_TYPE_ID;
     bool mEngineAsset = false;
 
+    // The async load in flight for this asset, if any. Guarded by the AssetManager's mutex.
+    AsyncLoadRequest* mLoadRequest = nullptr;
+
+    // Memory accounting, refreshed by the AssetManager every few frames. mLastUsedFrame is
+    // the last update where the asset was referenced, or 0 if it never was.
+    uint64_t mCpuBytes = 0;
+    uint64_t mGpuBytes = 0;
+    uint32_t mLastUsedFrame = 0;
+
 #if EDITOR
     std::string mName;
     AssetDir* mDirectory = nullptr;
@@ -100,6 +119,7 @@ public:
 
     void LoadFile(const char* path, AsyncLoadRequest* request = nullptr);
     void LoadEmbedded(const EmbeddedFile* embeddedAsset, AsyncLoadRequest* request = nullptr);
+    void LoadPak(const AssetPak* pak, uint32_t entryIndex, AsyncLoadRequest* request = nullptr);
     void SaveFile(const char* path, Platform platform);
 
     virtual void LoadStream(Stream& stream, Platform platform);
@@ -112,6 +132,10 @@ public:
     virtual const char* GetTypeImportExt();
     virtual bool IsTransient() const;
 
+    // Approximate bytes held in system memory and on the GPU while loaded.
+    virtual uint64_t GetCpuMemorySize();
+    virtual uint64_t GetGpuMemorySize();
+
     static AssetHeader ReadHeader(Stream& stream);
     void WriteHeader(Stream& stream);
 
@@ -1,6 +1,7 @@
 #include "AssetManager.h"
 #include "Asset.h"
 #include "AssetDir.h"
+#include "AssetPak.h"
 #include "Engine.h"
 #include "Stream.h"
 #include "Log.h"
@@ -8,6 +9,7 @@
 #include "Utilities.h"
 #include "EmbeddedFile.h"
 #include "Renderer.h"
+#include "Profiler.h"
 
 #include "Assets/Scene.h"
 #include "Assets/Texture.h"
@@ -24,15 +26,28 @@
 
 #include <string>
 #include <functional>
+#include <algorithm>
+#include <unordered_set>
+#include <thread>
 
 #if EDITOR
 #include "Editor/EditorState.h"
 #endif
 
 #define ASYNC_REQUEUE_LIMIT 30
+#define ASYNC_LOAD_MAX_THREADS 4
+#define ASYNC_FINALIZE_BUDGET_US 2000
+#define DISCOVERY_CACHE_MAGIC 0x4f434443 // "OCDC"
+#define DISCOVERY_CACHE_VERSION 1
 
 AssetManager* AssetManager::sInstance = nullptr;
 
+// INT32_MAX is a valid priority, so dependencies saturate instead of overflowing.
+static int32_t GetDependencyPriority(int32_t parentPriority)
+{
+    return (parentPriority == INT32_MAX) ? parentPriority : parentPriority + 1;
+}
+
 Asset* FetchAsset(const std::string& name)
 {
     return AssetManager::Get()->GetAsset(name);
@@ -90,16 +105,29 @@ AssetManager::~AssetManager()
     Purge(true);
 
     SYS_LockMutex(mMutex);
-    // Flag that we are destructing so that the async load thread can exit.
+    // Flag that we are destructing so that the async load threads can exit.
     mDestructing = true;
     SYS_UnlockMutex(mMutex);
 
-    SYS_JoinThread(mAsyncLoadThread);
-    SYS_DestroyThread(mAsyncLoadThread);
-    mAsyncLoadThread = nullptr;
+    for (uint32_t i = 0; i < mAsyncLoadThreads.size(); ++i)
+    {
+        SYS_JoinThread(mAsyncLoadThreads[i]);
+        SYS_DestroyThread(mAsyncLoadThreads[i]);
+    }
+
+    mAsyncLoadThreads.clear();
 
     SYS_DestroyMutex(mMutex);
     mMutex = nullptr;
+
+    // Closed last, the async load threads may have been reading from them.
+    for (uint32_t i = 0; i < mAssetPaks.size(); ++i)
+    {
+        mAssetPaks[i]->LogStats();
+        delete mAssetPaks[i];
+    }
+
+    mAssetPaks.clear();
 }
 
 void AssetManager::Initialize()
@@ -107,12 +135,45 @@ void AssetManager::Initialize()
     mRootDirectory = new AssetDir("Root", "", nullptr);
 
     mMutex = SYS_CreateMutex();
-    mAsyncLoadThread = SYS_CreateThread(AsyncLoadThreadFunc, this);
+
+    // Leave a core for the main thread.
+    uint32_t numCores = std::thread::hardware_concurrency();
+    uint32_t numThreads = glm::clamp<uint32_t>((numCores > 1) ? numCores - 1 : 1, 1, ASYNC_LOAD_MAX_THREADS);
+
+    for (uint32_t i = 0; i < numThreads; ++i)
+    {
+        mAsyncLoadThreads.push_back(SYS_CreateThread(AsyncLoadThreadFunc, this));
+    }
 }
 
 void AssetManager::Update(float deltaTime)
 {
     UpdateEndLoadQueue();
+
+    if (mCacheFrame % ASSET_CACHE_UPDATE_FRAMES == 0)
+    {
+        SCOPED_FRAME_STAT("Asset Cache");
+
+        UpdateMemoryStats();
+
+#if !EDITOR
+        // The editor keeps raw pointers to inspected and selected assets, so it only unloads on RefSweep().
+        if (TrimAssetCache(false, true) > 0)
+        {
+            UpdateMemoryStats();
+        }
+#endif
+    }
+
+    mCacheFrame++;
+
+    SET_FRAME_COUNTER("Asset CPU KB", uint32_t(mCpuMemoryUsage / 1024));
+    SET_FRAME_COUNTER("Asset GPU KB", uint32_t(mGpuMemoryUsage / 1024));
+    SET_FRAME_COUNTER("Cached Assets", mNumCachedAssets);
+
+#if EDITOR
+    UpdateFileWatcher();
+#endif
 }
 
 AssetStub* AssetManager::RegisterAsset(const std::string& filename, TypeId type, AssetDir* directory, EmbeddedFile* embeddedAsset, bool engineAsset)
@@ -200,7 +261,224 @@ bool AssetManager::IsPurging() const
     return mPurging;
 }
 
-void AssetManager::Discover(const char* directoryName, const char* directoryPath)
+void AssetManager::SetMemoryBudget(uint64_t cpuBytes, uint64_t gpuBytes)
+{
+    mCpuMemoryBudget = cpuBytes;
+    mGpuMemoryBudget = gpuBytes;
+}
+
+uint64_t AssetManager::GetCpuMemoryBudget() const
+{
+    return mCpuMemoryBudget;
+}
+
+uint64_t AssetManager::GetGpuMemoryBudget() const
+{
+    return mGpuMemoryBudget;
+}
+
+uint64_t AssetManager::GetCpuMemoryUsage() const
+{
+    return mCpuMemoryUsage;
+}
+
+uint64_t AssetManager::GetGpuMemoryUsage() const
+{
+    return mGpuMemoryUsage;
+}
+
+const std::vector<AssetMemoryStats>& AssetManager::GetMemoryStats() const
+{
+    return mMemoryStats;
+}
+
+void AssetManager::UpdateMemoryStats()
+{
+    mMemoryStats.clear();
+    mCpuMemoryUsage = 0;
+    mGpuMemoryUsage = 0;
+    mNumCachedAssets = 0;
+
+    for (auto it = mAssetMap.begin(); it != mAssetMap.end(); ++it)
+    {
+        AssetStub* stub = it->second;
+        Asset* asset = stub->mAsset;
+
+        if (asset == nullptr ||
+            !asset->IsLoaded())
+        {
+            stub->mCpuBytes = 0;
+            stub->mGpuBytes = 0;
+            continue;
+        }
+
+        stub->mCpuBytes = asset->GetCpuMemorySize();
+        stub->mGpuBytes = asset->GetGpuMemorySize();
+
+        bool cached = asset->IsRefCounted() && asset->GetRefCount() == 0;
+        if (!cached)
+        {
+            stub->mLastUsedFrame = mCacheFrame;
+        }
+
+        AssetMemoryStats* stats = nullptr;
+        for (uint32_t i = 0; i < mMemoryStats.size(); ++i)
+        {
+            if (mMemoryStats[i].mType == stub->mType)
+            {
+                stats = &mMemoryStats[i];
+                break;
+            }
+        }
+
+        if (stats == nullptr)
+        {
+            mMemoryStats.push_back(AssetMemoryStats());
+            stats = &mMemoryStats.back();
+            stats->mType = stub->mType;
+        }
+
+        stats->mNumLoaded++;
+        stats->mCpuBytes += stub->mCpuBytes;
+        stats->mGpuBytes += stub->mGpuBytes;
+
+        if (cached)
+        {
+            stats->mNumCached++;
+            stats->mCachedCpuBytes += stub->mCpuBytes;
+            stats->mCachedGpuBytes += stub->mGpuBytes;
+            mNumCachedAssets++;
+        }
+
+        mCpuMemoryUsage += stub->mCpuBytes;
+        mGpuMemoryUsage += stub->mGpuBytes;
+    }
+}
+
+void AssetManager::LogMemoryStats()
+{
+    const float kMB = 1024.0f * 1024.0f;
+
+    UpdateMemoryStats();
+
+    std::sort(mMemoryStats.begin(), mMemoryStats.end(), [](const AssetMemoryStats& a, const AssetMemoryStats& b)
+    {
+        return (a.mCpuBytes + a.mGpuBytes) > (b.mCpuBytes + b.mGpuBytes);
+    });
+
+    LogDebug("----- Asset Memory -----");
+
+    for (uint32_t i = 0; i < mMemoryStats.size(); ++i)
+    {
+        const AssetMemoryStats& stats = mMemoryStats[i];
+        const char* typeName = Asset::GetNameFromTypeId(stats.mType);
+
+        LogDebug("%s: %d loaded (%d cached), CPU %.2f MB (%.2f cached), GPU %.2f MB (%.2f cached)",
+            typeName ? typeName : "Unknown",
+            stats.mNumLoaded,
+            stats.mNumCached,
+            stats.mCpuBytes / kMB,
+            stats.mCachedCpuBytes / kMB,
+            stats.mGpuBytes / kMB,
+            stats.mCachedGpuBytes / kMB);
+    }
+
+    LogDebug("Total: CPU %.2f / %.2f MB, GPU %.2f / %.2f MB",
+        mCpuMemoryUsage / kMB,
+        mCpuMemoryBudget / kMB,
+        mGpuMemoryUsage / kMB,
+        mGpuMemoryBudget / kMB);
+
+    LogDebug("------------------------");
+}
+
+uint32_t AssetManager::TrimAssetCache(bool flush, bool automatic)
+{
+    mEvictOrder.clear();
+    mEvictedAssets.clear();
+
+    {
+        // Loader threads hand out already loaded dependencies under the mutex, so the ref
+        // counts are checked and the assets taken out of the map while holding it.
+        SCOPED_LOCK(mMutex);
+
+        for (auto it = mAssetMap.begin(); it != mAssetMap.end(); ++it)
+        {
+            AssetStub* stub = it->second;
+
+            if (stub->mAsset == nullptr ||
+                !stub->mAsset->IsLoaded() ||
+                stub->mAsset->GetRefCount() != 0 ||
+                stub->mLoadRequest != nullptr)
+            {
+                continue;
+            }
+
+#if EDITOR
+            // Don't ref sweep engine assets. They might not be saved as an OCT file yet.
+            if (stub->mEngineAsset)
+                continue;
+#endif
+
+            // Engine assets and assets that were never referenced may be held by raw pointers.
+            if (automatic &&
+                (stub->mEngineAsset || stub->mLastUsedFrame == 0 || !stub->mAsset->IsRefCounted()))
+            {
+                continue;
+            }
+
+            mEvictOrder.push_back(stub);
+        }
+
+        std::sort(mEvictOrder.begin(), mEvictOrder.end(), [](const AssetStub* a, const AssetStub* b)
+        {
+            return a->mLastUsedFrame < b->mLastUsedFrame;
+        });
+
+        for (uint32_t i = 0; i < mEvictOrder.size(); ++i)
+        {
+            if (!flush &&
+                mCpuMemoryUsage <= mCpuMemoryBudget &&
+                mGpuMemoryUsage <= mGpuMemoryBudget)
+            {
+                break;
+            }
+
+            AssetStub* stub = mEvictOrder[i];
+
+            // Only evict assets that free memory in a budget that is actually over.
+            if (!flush &&
+                (mCpuMemoryUsage <= mCpuMemoryBudget || stub->mCpuBytes == 0) &&
+                (mGpuMemoryUsage <= mGpuMemoryBudget || stub->mGpuBytes == 0))
+            {
+                continue;
+            }
+
+            mCpuMemoryUsage -= glm::min(stub->mCpuBytes, mCpuMemoryUsage);
+            mGpuMemoryUsage -= glm::min(stub->mGpuBytes, mGpuMemoryUsage);
+
+            mEvictedAssets.push_back(stub->mAsset);
+            stub->mAsset = nullptr;
+            stub->mCpuBytes = 0;
+            stub->mGpuBytes = 0;
+            stub->mLastUsedFrame = 0;
+        }
+    }
+
+    // Destroying an asset releases its own refs, which can end up back in the AssetManager.
+    for (uint32_t i = 0; i < mEvictedAssets.size(); ++i)
+    {
+        mEvictedAssets[i]->Destroy();
+        delete mEvictedAssets[i];
+    }
+
+    uint32_t numEvicted = uint32_t(mEvictedAssets.size());
+    mEvictedAssets.clear();
+
+    return numEvicted;
+}
+
+void AssetManager::Discover(const char* directoryName, const char* directoryPath, const char* cachePath)
 {
     SCOPED_STAT("DiscoverAssets")
 
@@ -215,60 +493,230 @@ void AssetManager::Discover(const char* directoryName, const char* directoryPath
     bool isEngineDir = (strcmp(directoryName, "Engine") == 0);
     newDir->mEngineDir = isEngineDir;
 
-    // Recursively iterate through Asset directory and find any .oct asset
-    // and register an Asset to the map. At this point, we also want to read the oct 
-    // header and determine the asset type so we can instantiate the correct Asset derived class.
+    // Headers are only read for files that changed since the cache was written.
+    DiscoveryCache oldCache;
+    DiscoveryCache newCache;
+    uint32_t numHeadersRead = 0;
 
-    std::function<void(AssetDir*, bool)> searchDirectory = [&](AssetDir* directory, bool engineDir)
+    if (cachePath != nullptr)
     {
+        LoadDiscoveryCache(cachePath, oldCache);
+    }
+
+    DiscoverDirectory(newDir, &oldCache, &newCache, numHeadersRead);
+
+    if (cachePath != nullptr &&
+        (numHeadersRead > 0 || newCache.size() != oldCache.size()))
+    {
+        SaveDiscoveryCache(cachePath, newCache);
+    }
 
-        std::vector<std::string> subDirectories;
-        DirEntry dirEntry = { };
+    LogDebug("Discovered %d assets in %s (%d headers read)", int32_t(newCache.size()), directoryName, numHeadersRead);
+}
+
+void AssetManager::DiscoverDirectory(AssetDir* directory, const DiscoveryCache* oldCache, DiscoveryCache* newCache, uint32_t& numHeadersRead)
+{
+    // Recursively iterate through Asset directory and find any .oct asset
+    // and register an Asset to the map. At this point, we also want to read the oct 
+    // header and determine the asset type so we can instantiate the correct Asset derived class.
+    std::vector<std::string> subDirectories;
+    DirEntry dirEntry = { };
 
-        SYS_OpenDirectory(directory->mPath, dirEntry);
+    SYS_OpenDirectory(directory->mPath, dirEntry);
 
-        while (dirEntry.mValid)
+    while (dirEntry.mValid)
+    {
+        if (dirEntry.mDirectory)
         {
-            if (dirEntry.mDirectory)
+            // Ignore this directory and parent directory.
+            if (dirEntry.mFilename[0] != '.')
             {
-                // Ignore this directory and parent directory.
-                if (dirEntry.mFilename[0] != '.')
-                {
-                    subDirectories.push_back(dirEntry.mFilename);
-                }
+                subDirectories.push_back(dirEntry.mFilename);
             }
-            else
+        }
+        else
+        {
+            const char* extension = strrchr(dirEntry.mFilename, '.');
+
+            if (extension != nullptr &&
+                strcmp(extension, ".oct") == 0)
             {
-                // TODO: Read the asset header to check the asset type.
-                const char* extension = strrchr(dirEntry.mFilename, '.');
+                std::string path = directory->mPath + dirEntry.mFilename;
+                TypeId type = INVALID_TYPE_ID;
+
+                if (oldCache != nullptr)
+                {
+                    auto it = oldCache->find(path);
+                    if (it != oldCache->end() &&
+                        it->second.mModifiedTime == dirEntry.mModifiedTime &&
+                        it->second.mSize == dirEntry.mSize)
+                    {
+                        type = it->second.mType;
+                    }
+                }
 
-                if (extension != nullptr &&
-                    strcmp(extension, ".oct") == 0)
+                if (type == INVALID_TYPE_ID)
                 {
-                    Stream stream;
-                    std::string path = directory->mPath + dirEntry.mFilename;
-                    stream.ReadFile(path.c_str(), true, sizeof(AssetHeader));
+                    type = ReadAssetType(path);
+                    numHeadersRead++;
+                }
 
-                    AssetHeader header = Asset::ReadHeader(stream);
-                    RegisterAsset(dirEntry.mFilename, header.mType, directory, nullptr, engineDir);
+                if (newCache != nullptr)
+                {
+                    DiscoveryCacheEntry& entry = (*newCache)[path];
+                    entry.mModifiedTime = dirEntry.mModifiedTime;
+                    entry.mSize = dirEntry.mSize;
+                    entry.mType = type;
                 }
-            }
 
-            SYS_IterateDirectory(dirEntry);
+                RegisterAsset(dirEntry.mFilename, type, directory, nullptr, directory->mEngineDir);
+            }
         }
 
-        SYS_CloseDirectory(dirEntry);
+        SYS_IterateDirectory(dirEntry);
+    }
+
+    SYS_CloseDirectory(dirEntry);
+
+#if EDITOR
+    // Keep stubs up to date with changes made outside of the editor.
+    SYS_WatchDirectory(directory->mPath.c_str());
+#endif
+
+    // Discover assets of subdirectories.
+    for (uint32_t i = 0; i < subDirectories.size(); ++i)
+    {
+        std::string dirPath = directory->mPath + subDirectories[i] + "/";
+        AssetDir* subDir = new AssetDir(subDirectories[i], dirPath, directory);
+        DiscoverDirectory(subDir, oldCache, newCache, numHeadersRead);
+    }
+}
+
+TypeId AssetManager::ReadAssetType(const std::string& path)
+{
+    Stream stream;
+    stream.ReadFile(path.c_str(), true, sizeof(AssetHeader));
 
-        // Discover assets of subdirectories.
-        for (uint32_t i = 0; i < subDirectories.size(); ++i)
+    AssetHeader header = Asset::ReadHeader(stream);
+    return header.mType;
+}
+
+bool AssetManager::LoadDiscoveryCache(const char* path, DiscoveryCache& outCache)
+{
+    if (!SYS_DoesFileExist(path, false))
+    {
+        return false;
+    }
+
+    Stream stream;
+    stream.ReadFile(path, false);
+
+    if (stream.GetSize() < 12 ||
+        stream.ReadUint32() != DISCOVERY_CACHE_MAGIC ||
+        stream.ReadUint32() != DISCOVERY_CACHE_VERSION)
+    {
+        LogWarning("Ignoring out of date asset discovery cache: %s", path);
+        return false;
+    }
+
+    // Each entry is a length prefixed path followed by five uint32 fields.
+    const uint32_t kEntryFieldsSize = 5 * sizeof(uint32_t);
+    const uint32_t kMinEntrySize = STREAM_STRING_LEN_BYTES + kEntryFieldsSize;
+
+    uint32_t numEntries = stream.ReadUint32();
+
+    if (numEntries > (stream.GetSize() - stream.GetPos()) / kMinEntrySize)
+    {
+        LogWarning("Ignoring corrupt asset discovery cache: %s", path);
+        return false;
+    }
+
+    outCache.reserve(numEntries);
+
+    std::string entryPath;
+    for (uint32_t i = 0; i < numEntries; ++i)
+    {
+        // A truncated cache (e.g. the editor was killed while saving) must not read past the end.
+        uint32_t remaining = stream.GetSize() - stream.GetPos();
+        uint32_t pathSize = (remaining >= kMinEntrySize) ? stream.ReadUint32() : UINT32_MAX;
+
+        if (pathSize > remaining - kMinEntrySize)
         {
-            std::string dirPath = directory->mPath + subDirectories[i] + "/";
-            AssetDir* subDir = new AssetDir(subDirectories[i], dirPath, directory);
-            searchDirectory(subDir, engineDir);
+            LogWarning("Ignoring corrupt asset discovery cache: %s", path);
+            outCache.clear();
+            return false;
         }
-    };
 
-    searchDirectory(newDir, isEngineDir);
+        entryPath.assign(stream.GetData() + stream.GetPos(), pathSize);
+        stream.SetPos(stream.GetPos() + pathSize);
+
+        DiscoveryCacheEntry& entry = outCache[entryPath];
+        entry.mModifiedTime = uint64_t(stream.ReadUint32());
+        entry.mModifiedTime |= uint64_t(stream.ReadUint32()) << 32;
+        entry.mSize = uint64_t(stream.ReadUint32());
+        entry.mSize |= uint64_t(stream.ReadUint32()) << 32;
+        entry.mType = stream.ReadUint32();
+    }
+
+    return true;
+}
+
+void AssetManager::SaveDiscoveryCache(const char* path, const DiscoveryCache& cache)
+{
+    Stream stream;
+    stream.WriteUint32(DISCOVERY_CACHE_MAGIC);
+    stream.WriteUint32(DISCOVERY_CACHE_VERSION);
+    stream.WriteUint32(uint32_t(cache.size()));
+
+    for (auto it = cache.begin(); it != cache.end(); ++it)
+    {
+        stream.WriteString(it->first);
+        stream.WriteUint32(uint32_t(it->second.mModifiedTime));
+        stream.WriteUint32(uint32_t(it->second.mModifiedTime >> 32));
+        stream.WriteUint32(uint32_t(it->second.mSize));
+        stream.WriteUint32(uint32_t(it->second.mSize >> 32));
+        stream.WriteUint32(it->second.mType);
+    }
+
+    std::string cacheDir = path;
+    size_t slash = cacheDir.find_last_of('/');
+    cacheDir = (slash != std::string::npos) ? cacheDir.substr(0, slash) : "";
+
+    if (cacheDir != "" &&
+        !DoesDirExist(cacheDir.c_str()))
+    {
+        CreateDir(cacheDir.c_str());
+    }
+
+    // The cache is optional, so don't go through Stream::WriteFile() which asserts on failure.
+    // It's written to a temp file first so a crash mid-write never leaves a truncated cache behind.
+    std::string tempPath = std::string(path) + ".tmp";
+    FILE* file = fopen(tempPath.c_str(), "wb");
+    bool success = (file != nullptr);
+
+    if (file != nullptr)
+    {
+        success = (fwrite(stream.GetData(), stream.GetSize(), 1, file) == 1);
+        success = (fclose(file) == 0) && success;
+    }
+
+    if (success &&
+        !SYS_Rename(tempPath.c_str(), path))
+    {
+        // rename() won't replace an existing file on Windows.
+        SYS_RemoveFile(path);
+        success = SYS_Rename(tempPath.c_str(), path);
+    }
+
+    if (!success)
+    {
+        LogWarning("Failed to write asset discovery cache: %s", path);
+
+        if (file != nullptr)
+        {
+            SYS_RemoveFile(tempPath.c_str());
+        }
+    }
 }
 
 void AssetManager::DiscoverAssetRegistry(const char* registryPath)
@@ -317,6 +765,62 @@ void AssetManager::DiscoverAssetRegistry(const char* registryPath)
     }
 }
 
+bool AssetManager::DiscoverAssetPaks(const char* directoryPath)
+{
+    SCOPED_STAT("DiscoverAssetPaks");
+
+    std::string dirPath = directoryPath;
+    if (dirPath.size() > 0 && dirPath[dirPath.size() - 1] != '/')
+    {
+        dirPath += '/';
+    }
+
+    // Archives are numbered consecutively from 0. Registering an asset only needs the toc,
+    // so no asset data is touched here.
+    uint32_t numPaks = 0;
+
+    while (true)
+    {
+        std::string pakPath = AssetPak::GetArchivePath(dirPath, numPaks);
+
+        if (!SYS_DoesFileExist(pakPath.c_str(), true))
+        {
+            break;
+        }
+
+        AssetPak* pak = new AssetPak();
+
+        if (!pak->Open(pakPath.c_str()))
+        {
+            delete pak;
+            break;
+        }
+
+        mAssetPaks.push_back(pak);
+        numPaks++;
+
+        uint32_t numEntries = pak->GetNumEntries();
+        mAssetMap.reserve(mAssetMap.size() + numEntries);
+
+        for (uint32_t i = 0; i < numEntries; ++i)
+        {
+            const AssetPakEntry& entry = pak->GetEntry(i);
+            AssetStub* stub = RegisterAsset(pak->GetEntryName(i), entry.mType, nullptr, nullptr, false);
+
+            if (stub != nullptr)
+            {
+                stub->mPak = pak;
+                stub->mPakEntry = int32_t(i);
+                stub->mEngineAsset = (entry.mFlags & AssetPakEngine) != 0;
+            }
+        }
+
+        LogDebug("Discovered %d assets in %s", numEntries, pakPath.c_str());
+    }
+
+    return (numPaks > 0);
+}
+
 void AssetManager::DiscoverEmbeddedAssets(EmbeddedFile* assets, uint32_t numAssets)
 {
     SCOPED_STAT("DiscoverEmbeddedAssets");
@@ -427,7 +931,7 @@ bool AssetManager::PurgeAsset(const char* name)
     return purged;
 }
 
-void AssetManager::RefSweep()
+void AssetManager::RefSweep(bool flushCache)
 {
     // Iterate several times until no assets are unloaded.
     uint32_t iter = 0;
@@ -437,26 +941,10 @@ void AssetManager::RefSweep()
     while (iter == 0 || (iter < 10 && numAssetsUnloaded != 0))
     {
         totalAssetsUnloaded += numAssetsUnloaded;
-        numAssetsUnloaded = 0;
-
-        for (auto it = mAssetMap.begin(); it != mAssetMap.end(); ++it)
-        {
-#if EDITOR
-            // Don't ref sweep engine assets. They might not be saved as an OCT file yet.
-            if (it->second->mEngineAsset)
-                continue;
-#endif
 
-            if (it->second->mAsset != nullptr &&
-                it->second->mAsset->IsLoaded() &&
-                it->second->mAsset->GetRefCount() == 0)
-            {
-                it->second->mAsset->Destroy();
-                delete it->second->mAsset;
-                it->second->mAsset = nullptr;
-                ++numAssetsUnloaded;
-            }
-        }
+        // Unloading an asset can release the last reference to others.
+        UpdateMemoryStats();
+        numAssetsUnloaded = TrimAssetCache(flushCache, false);
 
         for (int32_t i = int32_t(mTransientAssets.size()) - 1; i >= 0; --i)
         {
@@ -473,7 +961,9 @@ void AssetManager::RefSweep()
     }
 
     totalAssetsUnloaded += numAssetsUnloaded;
-    LogDebug("%d assets swept", totalAssetsUnloaded);
+    UpdateMemoryStats();
+
+    LogDebug("%d assets swept, %d kept in cache", totalAssetsUnloaded, mNumCachedAssets);
 }
 
 void AssetManager::LoadAll()
@@ -483,8 +973,7 @@ void AssetManager::LoadAll()
         AssetStub* stub = it->second;
         if (stub->mAsset == nullptr)
         {
-            stub->mAsset = Asset::CreateInstance(stub->mType);
-            stub->mAsset->LoadFile(stub->mPath.c_str());
+            LoadAsset(*stub);
         }
     }
 }
@@ -635,65 +1124,262 @@ AssetStub* AssetManager::GetAssetStub(const std::string& name)
     return stub;
 }
 
-Asset* AssetManager::GetAsset(const std::string& name)
-{
-    Asset* asset = nullptr;
-    auto itr = mAssetMap.find(name);
-    asset = (itr != mAssetMap.end()) ? itr->second->mAsset : nullptr;
-    return asset;
+Asset* AssetManager::GetAsset(const std::string& name)
+{
+    Asset* asset = nullptr;
+    auto itr = mAssetMap.find(name);
+    asset = (itr != mAssetMap.end()) ? itr->second->mAsset : nullptr;
+    return asset;
+}
+
+Asset* AssetManager::LoadAsset(const std::string& name)
+{
+    Asset* retAsset = nullptr;
+    auto it = mAssetMap.find(name);
+
+    if (it != mAssetMap.end())
+    {
+        retAsset = LoadAsset(*it->second);
+    }
+
+    return retAsset;
+}
+
+Asset* AssetManager::LoadAsset(AssetStub& stub)
+{
+    if (stub.mAsset == nullptr)
+    {
+        stub.mAsset = Asset::CreateInstance(stub.mType);
+
+        if (stub.mEmbeddedData != nullptr)
+        {
+            stub.mAsset->LoadEmbedded(stub.mEmbeddedData);
+        }
+        else if (stub.mPak != nullptr)
+        {
+            stub.mAsset->LoadPak(stub.mPak, uint32_t(stub.mPakEntry));
+        }
+        else
+        {
+            stub.mAsset->LoadFile(stub.mPath.c_str());
+        }
+    }
+
+    return stub.mAsset;
+}
+
+void AssetManager::AsyncLoadAsset(const std::string& name, AssetRef* targetRef)
+{
+    SCOPED_LOCK(mMutex);
+
+    AssetStub* stub = GetAssetStub(name);
+    if (stub == nullptr)
+    {
+        LogError("AsyncLoadAsset failed, asset %s does not exist in map", name.c_str());
+        return;
+    }
+
+    // Without a handle there is no way to cancel this request.
+    AsyncLoadRequest* request = QueueAsyncLoad(stub, name, targetRef, 0);
+
+    if (request != nullptr)
+    {
+        request->mPinned = true;
+        UpdateRequestPriority(request);
+    }
+}
+
+AsyncLoadHandle AssetManager::AsyncLoadAsset(const std::string& name, AssetRef* targetRef, int32_t priority, AsyncLoadCallbackFP callback, void* userData)
+{
+    AsyncLoadTicket ticket;
+    ticket.mPriority = priority;
+    ticket.mCallback.mFuncPointer = callback;
+    ticket.mUserData = userData;
+
+    return QueueAsyncLoadTicket(name, targetRef, ticket);
+}
+
+AsyncLoadHandle AssetManager::AsyncLoadAsset(const std::string& name, AssetRef* targetRef, int32_t priority, const ScriptFunc& scriptCallback)
+{
+    AsyncLoadTicket ticket;
+    ticket.mPriority = priority;
+    ticket.mCallback.mScriptFunc = scriptCallback;
+
+    return QueueAsyncLoadTicket(name, targetRef, ticket);
+}
+
+static void CallAsyncLoadCallback(const AsyncLoadTicket& ticket, Asset* asset)
+{
+    if (ticket.mCallback.mFuncPointer != nullptr)
+    {
+        ticket.mCallback.mFuncPointer(asset, ticket.mUserData);
+    }
+
+    if (ticket.mCallback.mScriptFunc.IsValid())
+    {
+        Datum assetParam(asset);
+        ticket.mCallback.mScriptFunc.Call(1, &assetParam);
+    }
+}
+
+AsyncLoadHandle AssetManager::QueueAsyncLoadTicket(const std::string& name, AssetRef* targetRef, AsyncLoadTicket& ticket)
+{
+    AsyncLoadHandle handle = INVALID_ASYNC_LOAD_HANDLE;
+    Asset* loadedAsset = nullptr;
+
+    {
+        SCOPED_LOCK(mMutex);
+
+        AssetStub* stub = GetAssetStub(name);
+        AsyncLoadRequest* request = nullptr;
+
+        if (stub == nullptr)
+        {
+            LogError("AsyncLoadAsset failed, asset %s does not exist in map", name.c_str());
+        }
+        else
+        {
+            request = QueueAsyncLoad(stub, name, targetRef, ticket.mPriority);
+            loadedAsset = stub->mAsset;
+        }
+
+        if (request != nullptr)
+        {
+            handle = mNextLoadHandle++;
+            if (mNextLoadHandle == INVALID_ASYNC_LOAD_HANDLE)
+            {
+                mNextLoadHandle++;
+            }
+
+            ticket.mRequest = request;
+            ticket.mTargetRef = targetRef;
+            mLoadHandles[handle] = ticket;
+
+            request->mHandles.push_back(handle);
+            UpdateRequestPriority(request);
+        }
+    }
+
+    // Nothing to wait for (already loaded or missing), so report back right away.
+    if (handle == INVALID_ASYNC_LOAD_HANDLE)
+    {
+        CallAsyncLoadCallback(ticket, loadedAsset);
+    }
+
+    return handle;
 }
 
-Asset* AssetManager::LoadAsset(const std::string& name)
+void AssetManager::AsyncLoadDependency(const std::string& name, AssetRef* targetRef, AsyncLoadRequest* parentRequest)
 {
-    Asset* retAsset = nullptr;
-    auto it = mAssetMap.find(name);
+    SCOPED_LOCK(mMutex);
 
-    if (it != mAssetMap.end())
+    // Don't start on the dependencies of an asset that is going to be thrown away.
+    if (parentRequest->mCancelled)
     {
-        retAsset = LoadAsset(*it->second);
+        return;
     }
 
-    return retAsset;
-}
+    AssetStub* stub = GetAssetStub(name);
+    if (stub == nullptr)
+    {
+        LogWarning("Could not find asset %s", name.c_str());
+        return;
+    }
 
-Asset* AssetManager::LoadAsset(AssetStub& stub)
-{
-    if (stub.mAsset == nullptr)
+    AsyncLoadRequest* request = QueueAsyncLoad(stub, name, targetRef, GetDependencyPriority(parentRequest->mPriority));
+
+    // The parent can't be finished on the main thread until this dependency is.
+    if (request != nullptr)
     {
-        stub.mAsset = Asset::CreateInstance(stub.mType);
+        auto it = std::find(parentRequest->mDependentAssets.begin(), parentRequest->mDependentAssets.end(), stub);
 
-        if (stub.mEmbeddedData != nullptr)
+        if (it == parentRequest->mDependentAssets.end())
         {
-            stub.mAsset->LoadEmbedded(stub.mEmbeddedData);
+            parentRequest->mDependentAssets.push_back(stub);
+            parentRequest->mDependencyIds.push_back(request->mId);
+            request->mParents.push_back(parentRequest);
         }
         else
         {
-            stub.mAsset->LoadFile(stub.mPath.c_str());
+            // Register with the stub's current request if the one we were registered with is gone.
+            uint32_t index = uint32_t(it - parentRequest->mDependentAssets.begin());
+
+            if (parentRequest->mDependencyIds[index] != request->mId)
+            {
+                parentRequest->mDependencyIds[index] = request->mId;
+                request->mParents.push_back(parentRequest);
+            }
         }
     }
 
-    return stub.mAsset;
+    // Dependencies jump ahead of the asset that needs them, so a whole tree of assets
+    // finishes before unrelated requests are started.
+    if (request != nullptr)
+    {
+        UpdateRequestPriority(request);
+    }
 }
 
-void AssetManager::AsyncLoadAsset(const std::string& name, AssetRef* targetRef)
+void AssetManager::SetAsyncLoadPriority(AsyncLoadHandle handle, int32_t priority)
 {
     SCOPED_LOCK(mMutex);
-    // (1) Check to see if an asset stub exists at all, if not, then log an error and return.
-    AssetStub* stub = GetAssetStub(name);
-    if (stub == nullptr)
+
+    auto it = mLoadHandles.find(handle);
+    if (it != mLoadHandles.end())
+    {
+        it->second.mPriority = priority;
+        UpdateRequestPriority(it->second.mRequest);
+    }
+}
+
+void AssetManager::CancelAsyncLoad(AsyncLoadHandle handle)
+{
+    SCOPED_LOCK(mMutex);
+
+    auto it = mLoadHandles.find(handle);
+    if (it == mLoadHandles.end())
     {
-        LogError("AsyncLoadAsset failed, asset %s does not exist in map", name.c_str());
         return;
     }
 
+    AsyncLoadTicket ticket = it->second;
+    AsyncLoadRequest* request = ticket.mRequest;
+    mLoadHandles.erase(it);
+
+    request->mHandles.erase(std::remove(request->mHandles.begin(), request->mHandles.end(), handle), request->mHandles.end());
+
+    if (ticket.mTargetRef != nullptr &&
+        ticket.mTargetRef->mLoadRequest == request)
+    {
+        RemoveAsyncLoadRef(*ticket.mTargetRef);
+    }
+
+    if (IsRequestWanted(request))
+    {
+        UpdateRequestPriority(request);
+    }
+    else
+    {
+        CancelRequest(request);
+    }
+}
+
+bool AssetManager::IsAsyncLoadPending(AsyncLoadHandle handle)
+{
+    SCOPED_LOCK(mMutex);
+    return (mLoadHandles.find(handle) != mLoadHandles.end());
+}
+
+AsyncLoadRequest* AssetManager::QueueAsyncLoad(AssetStub* stub, const std::string& name, AssetRef* targetRef, int32_t priority)
+{
     // Erase ref from current pending request
     if (targetRef != nullptr &&
         targetRef->mLoadRequest != nullptr)
     {
-        EraseAsyncLoadRef(*targetRef);
+        RemoveAsyncLoadRef(*targetRef);
     }
 
-    // (2) Check to see if the asset is already loaded. If so, assign the target ref immediately.
+    // If the asset is already loaded, assign the target ref immediately.
     if (stub->mAsset != nullptr)
     {
         if (targetRef != nullptr)
@@ -701,47 +1387,184 @@ void AssetManager::AsyncLoadAsset(const std::string& name, AssetRef* targetRef)
             *targetRef = stub->mAsset;
         }
 
-        return;
+        return nullptr;
+    }
+
+    // Reuse the request if one is already in flight, the caller updates its priority.
+    AsyncLoadRequest* request = stub->mLoadRequest;
+
+    if (request == nullptr)
+    {
+        request = new AsyncLoadRequest();
+        request->mName = name;
+        request->mPath = stub->mPath;
+        request->mType = stub->mType;
+        request->mEmbeddedData = stub->mEmbeddedData;
+        request->mPak = stub->mPak;
+        request->mPakEntry = stub->mPakEntry;
+        request->mPriority = priority;
+        request->mId = mNextRequestId++;
+
+        stub->mLoadRequest = request;
+        mBeginLoadQueue.insert(request);
+    }
+
+    if (targetRef != nullptr)
+    {
+        request->mTargetRefs.push_back(targetRef);
+        targetRef->mLoadRequest = request;
+    }
+
+    return request;
+}
+
+int32_t AssetManager::ComputeRequestPriority(AsyncLoadRequest* request)
+{
+    int32_t priority = request->mPinned ? 0 : INT32_MIN;
+
+    for (uint32_t i = 0; i < request->mHandles.size(); ++i)
+    {
+        priority = glm::max(priority, mLoadHandles[request->mHandles[i]].mPriority);
+    }
+
+    // Dependencies jump ahead of the asset that needs them, so a whole tree of assets
+    // finishes before unrelated requests are started.
+    for (uint32_t i = 0; i < request->mParents.size(); ++i)
+    {
+        priority = glm::max(priority, GetDependencyPriority(request->mParents[i]->mPriority));
+    }
+
+    return priority;
+}
+
+AsyncLoadRequest* AssetManager::GetDependencyRequest(AsyncLoadRequest* request, uint32_t index) const
+{
+    // Only the request this one was registered with counts, not a newer request for the same asset.
+    AsyncLoadRequest* dependency = request->mDependentAssets[index]->mLoadRequest;
+
+    if (dependency != nullptr &&
+        dependency->mId == request->mDependencyIds[index])
+    {
+        return dependency;
     }
 
-    // (3) Check to see if an AsyncLoadRequest is already in flight (in begin/end queues) and if so, add this ref to the list.
-    for (uint32_t i = 0; i < mBeginLoadQueue.size(); ++i)
+    return nullptr;
+}
+
+void AssetManager::UpdateRequestPriority(AsyncLoadRequest* request)
+{
+    // Walked with a worklist, dependencies can form cycles (A -> B -> A) and each request is
+    // only updated once per call.
+    std::vector<AsyncLoadRequest*> pending;
+    std::unordered_set<AsyncLoadRequest*> visited;
+    pending.push_back(request);
+
+    while (pending.size() > 0)
     {
-        if (mBeginLoadQueue[i]->mName == name)
+        AsyncLoadRequest* current = pending.back();
+        pending.pop_back();
+
+        if (!visited.insert(current).second)
+        {
+            continue;
+        }
+
+        int32_t priority = ComputeRequestPriority(current);
+
+        if (priority == current->mPriority ||
+            current->mCancelled)
+        {
+            continue;
+        }
+
+        // Requests that a loader thread has already picked up are no longer in the queue.
+        // The queue is ordered by priority, so it has to be removed before the priority changes.
+        bool queued = (mBeginLoadQueue.erase(current) > 0);
+        current->mPriority = priority;
+
+        if (queued)
+        {
+            mBeginLoadQueue.insert(current);
+        }
+
+        // Dependencies follow the asset that needs them, both up and down.
+        for (uint32_t i = 0; i < current->mDependentAssets.size(); ++i)
         {
-            mBeginLoadQueue[i]->mTargetRefs.push_back(targetRef);
-            return;
+            AsyncLoadRequest* dependency = GetDependencyRequest(current, i);
+
+            if (dependency != nullptr &&
+                visited.find(dependency) == visited.end())
+            {
+                pending.push_back(dependency);
+            }
         }
     }
+}
+
+void AssetManager::CancelRequest(AsyncLoadRequest* request)
+{
+    // The request itself is deleted by whoever pops it off a queue next. If a loader thread is
+    // working on it, the partially loaded asset is thrown away in UpdateEndLoadQueue().
+    request->mCancelled = true;
+
+    AssetStub* stub = GetAssetStub(request->mName);
+    if (stub != nullptr &&
+        stub->mLoadRequest == request)
+    {
+        stub->mLoadRequest = nullptr;
+    }
 
-    for (uint32_t i = 0; i < mEndLoadQueue.size(); ++i)
+    for (uint32_t i = 0; i < request->mTargetRefs.size(); ++i)
     {
-        if (mEndLoadQueue[i]->mName == name)
+        if (request->mTargetRefs[i] != nullptr)
         {
-            mEndLoadQueue[i]->mTargetRefs.push_back(targetRef);
-            return;
+            request->mTargetRefs[i]->mLoadRequest = nullptr;
         }
     }
-    
-    // (4) Otherwise, malloc and enqueue a new AsyncLoadRequest to the BeginLoadQueue
-    AsyncLoadRequest* newRequest = new AsyncLoadRequest();
-    mBeginLoadQueue.push_back(newRequest);
 
-    // (5) Set the data on the request, including the targetRef.
-    newRequest->mName = name;
-    newRequest->mPath = stub->mPath;
-    newRequest->mType = stub->mType;
-    newRequest->mEmbeddedData = stub->mEmbeddedData;
+    request->mTargetRefs.clear();
 
-    if (targetRef != nullptr)
+    for (uint32_t i = 0; i < request->mHandles.size(); ++i)
+    {
+        mLoadHandles.erase(request->mHandles[i]);
+    }
+
+    request->mHandles.clear();
+
+    // Drop dependencies that nothing else is waiting on, and demote the rest.
+    RemoveDependencyParent(request);
+}
+
+void AssetManager::RemoveDependencyParent(AsyncLoadRequest* request)
+{
+    for (uint32_t i = 0; i < request->mDependentAssets.size(); ++i)
     {
-        newRequest->mTargetRefs.push_back(targetRef);
+        AsyncLoadRequest* dependency = GetDependencyRequest(request, i);
 
-        // (6) Set the request pointer on the AssetRef.
-        targetRef->mLoadRequest = newRequest;
+        if (dependency != nullptr)
+        {
+            std::vector<AsyncLoadRequest*>& parents = dependency->mParents;
+            parents.erase(std::remove(parents.begin(), parents.end(), request), parents.end());
+
+            if (!IsRequestWanted(dependency))
+            {
+                CancelRequest(dependency);
+            }
+            else
+            {
+                UpdateRequestPriority(dependency);
+            }
+        }
     }
 }
 
+bool AssetManager::IsRequestWanted(AsyncLoadRequest* request) const
+{
+    return (request->mPinned ||
+        request->mHandles.size() > 0 ||
+        request->mParents.size() > 0);
+}
+
 void AssetManager::SaveAsset(const std::string& name)
 {
     auto it = mAssetMap.find(name);
@@ -833,27 +1656,38 @@ bool AssetManager::UnloadAsset(AssetStub& stub)
 void AssetManager::EraseAsyncLoadRef(AssetRef& assetRef)
 {
     SCOPED_LOCK(mMutex);
+    RemoveAsyncLoadRef(assetRef);
+}
 
-    auto eraseRef = [](std::deque<AsyncLoadRequest*>& queue, AssetRef& ref)
+void AssetManager::RemoveAsyncLoadRef(AssetRef& assetRef)
+{
+    AsyncLoadRequest* request = assetRef.mLoadRequest;
+
+    if (request != nullptr)
     {
-        for (uint32_t i = 0; i < queue.size(); ++i)
-        {
-            std::vector<AssetRef*>& refs = queue[i]->mTargetRefs;
+        std::vector<AssetRef*>& refs = request->mTargetRefs;
+        refs.erase(std::remove(refs.begin(), refs.end(), &assetRef), refs.end());
+    }
 
-            for (int32_t r = int32_t(refs.size()) - 1; r >= 0; --r)
-            {
-                if (refs[r] == &ref)
-                {
-                    refs.erase(refs.begin() + r);
-                }
-            }
-        }
-    };
+    assetRef.mLoadRequest = nullptr;
+}
+
+bool AssetManager::IsWaitingOnLoad(AsyncLoadRequest* request)
+{
+    // True if a dependency is still queued or being loaded by a loader thread.
+    for (uint32_t i = 0; i < request->mDependentAssets.size(); ++i)
+    {
+        AssetStub* dependency = request->mDependentAssets[i];
 
-    eraseRef(mBeginLoadQueue, assetRef);
-    eraseRef(mEndLoadQueue, assetRef);
+        if (dependency->mAsset == nullptr &&
+            dependency->mLoadRequest != nullptr &&
+            dependency->mLoadRequest->mAsset == nullptr)
+        {
+            return true;
+        }
+    }
 
-    assetRef.mLoadRequest = nullptr;
+    return false;
 }
 
 bool AssetManager::DoesAssetExist(const std::string& name)
@@ -1021,13 +1855,20 @@ ThreadFuncRet AssetManager::AsyncLoadThreadFunc(void* in)
     {
         AsyncLoadRequest* request = nullptr;
 
-        // Pop off the next request from the queue.
+        // Pop off the highest priority request from the queue. Cancelled requests are left in
+        // the queue when cancelled and deleted here instead.
         SYS_LockMutex(am.mMutex);
-        bool exit = am.mDestructing;
-        if (am.mBeginLoadQueue.size() > 0)
+        exit = am.mDestructing;
+        while (request == nullptr && am.mBeginLoadQueue.size() > 0)
         {
-            request = am.mBeginLoadQueue.front();
-            am.mBeginLoadQueue.pop_front();
+            request = *am.mBeginLoadQueue.begin();
+            am.mBeginLoadQueue.erase(am.mBeginLoadQueue.begin());
+
+            if (request->mCancelled)
+            {
+                delete request;
+                request = nullptr;
+            }
         }
         SYS_UnlockMutex(am.mMutex);
 
@@ -1045,21 +1886,25 @@ ThreadFuncRet AssetManager::AsyncLoadThreadFunc(void* in)
 
             // (2) Load the file into a stream
             // (3) Call asset->LoadStream()
+            // Any dependencies found while loading are queued right away so other loader threads can start on them.
             // The call to Asset::Create() is made on the main thread, that's why we queue it up on the EndLoadQueue
             if (request->mEmbeddedData != nullptr)
             {
                 newAsset->LoadEmbedded(request->mEmbeddedData, request);
             }
+            else if (request->mPak != nullptr)
+            {
+                newAsset->LoadPak(request->mPak, uint32_t(request->mPakEntry), request);
+            }
             else
             {
                 newAsset->LoadFile(request->mPath.c_str(), request);
             }
 
-            request->mAsset = newAsset;
-
             // (4) Add the request to the EndLoadQueue
             {
                 SCOPED_LOCK(am.mMutex);
+                request->mAsset = newAsset;
                 am.mEndLoadQueue.push_back(request);
             }
         }
@@ -1075,26 +1920,36 @@ ThreadFuncRet AssetManager::AsyncLoadThreadFunc(void* in)
 
 void AssetManager::UpdateEndLoadQueue()
 {
-    SCOPED_LOCK(mMutex);
-
-    const uint32_t maxIterations = 3;
-    uint32_t numIterations = 0;
+    // Callbacks and deleting cancelled assets can both end up back in the AssetManager,
+    // so they are handled after the mutex is released.
+    std::vector<Asset*> cancelledAssets;
+    std::vector<std::pair<AsyncLoadTicket, Asset*> > callbacks;
 
-    bool handled = false;
-
-    do
     {
-        handled = false;
-        AsyncLoadRequest* loadRequest = (mEndLoadQueue.size() > 0) ? mEndLoadQueue.front() : nullptr;
+        SCOPED_LOCK(mMutex);
+
+        // Finishing a load (Create() / GPU upload) happens on the main thread, so cap how long
+        // we spend on it each frame. At least one request is always handled.
+        uint64_t startTime = SYS_GetTimeMicroseconds();
+        uint32_t numRequests = uint32_t(mEndLoadQueue.size());
 
-        if (mEndLoadQueue.size() > 0)
+        for (uint32_t r = 0; r < numRequests; ++r)
         {
+            if (r > 0 &&
+                SYS_GetTimeMicroseconds() - startTime >= ASYNC_FINALIZE_BUDGET_US)
+            {
+                break;
+            }
+
+            AsyncLoadRequest* loadRequest = mEndLoadQueue.front();
             mEndLoadQueue.pop_front();
-        }
 
-        if (loadRequest != nullptr)
-        {
-            numIterations++;
+            if (loadRequest->mCancelled)
+            {
+                cancelledAssets.push_back(loadRequest->mAsset);
+                delete loadRequest;
+                continue;
+            }
 
             // Check load dependencies before finish the load
             bool allDependenciesLoaded = true;
@@ -1110,9 +1965,8 @@ void AssetManager::UpdateEndLoadQueue()
 
             if (allDependenciesLoaded)
             {
-                handled = true;
-
                 AssetStub* stub = GetAssetStub(loadRequest->mName);
+                Asset* loadedAsset = nullptr;
 
                 if (stub == nullptr)
                 {
@@ -1121,6 +1975,7 @@ void AssetManager::UpdateEndLoadQueue()
                 else if (stub->mAsset != nullptr)
                 {
                     LogWarning("AsyncLoadRequest not finished because the asset has already been loaded");
+                    loadedAsset = stub->mAsset;
                 }
                 else
                 {
@@ -1130,47 +1985,191 @@ void AssetManager::UpdateEndLoadQueue()
                     OCT_ASSERT(loadRequest->mAsset != nullptr);
                     loadRequest->mAsset->Create();
                     stub->mAsset = loadRequest->mAsset;
+                    loadedAsset = loadRequest->mAsset;
+                }
+
+                if (stub != nullptr &&
+                    stub->mLoadRequest == loadRequest)
+                {
+                    stub->mLoadRequest = nullptr;
+                }
+
+                // Now assign the asset to all of the refs that had requested the load
+                for (uint32_t i = 0; i < loadRequest->mTargetRefs.size(); ++i)
+                {
+                    AssetRef* targetRef = loadRequest->mTargetRefs[i];
 
-                    // Now assign the asset to all of the refs that had requested the load
-                    for (uint32_t i = 0; i < loadRequest->mTargetRefs.size(); ++i)
+                    if (targetRef != nullptr)
                     {
-                        if (loadRequest->mTargetRefs[i] != nullptr)
+                        OCT_ASSERT(targetRef->mLoadRequest == nullptr ||
+                            targetRef->mLoadRequest == loadRequest);
+
+                        if (loadedAsset != nullptr)
                         {
-                            // The load request of the target ref should match this load request but...
-                            // We need to make sure we handle the case where an AssetRef is assigned twice to an async load
-                            // before the first one finishes. Might mean Canceling the request if one already exists in AsyncLoadAsset()
-                            OCT_ASSERT(loadRequest->mTargetRefs[i]->mLoadRequest == nullptr ||
-                                loadRequest->mTargetRefs[i]->mLoadRequest == loadRequest);
-
-                            (*loadRequest->mTargetRefs[i]) = loadRequest->mAsset;
-                            loadRequest->mTargetRefs[i]->mLoadRequest = nullptr;
+                            (*targetRef) = loadedAsset;
                         }
+
+                        targetRef->mLoadRequest = nullptr;
+                    }
+                }
+
+                for (uint32_t i = 0; i < loadRequest->mHandles.size(); ++i)
+                {
+                    auto it = mLoadHandles.find(loadRequest->mHandles[i]);
+                    if (it != mLoadHandles.end())
+                    {
+                        callbacks.push_back(std::make_pair(it->second, loadedAsset));
+                        mLoadHandles.erase(it);
                     }
                 }
 
+                // Dependencies normally finish first, but one may still be in flight if the asset
+                // was loaded some other way. It must not keep a pointer to this request.
+                RemoveDependencyParent(loadRequest);
+
                 delete loadRequest;
                 loadRequest = nullptr;
             }
             else
             {
-                // Still waiting on some dependent assets, so push this on the back of the queue
-                // This might happen several times before the dependent assests make their way to the front
-                // of the mEndLoadQueue.
-                LogWarning("Async load for %s is still waiting on dependencies", loadRequest->mName.c_str());
+                // Still waiting on some dependent assets, so push this on the back of the queue.
                 mEndLoadQueue.push_back(loadRequest);
-                loadRequest->mRequeueCount++;
 
-                if (loadRequest->mRequeueCount >= ASYNC_REQUEUE_LIMIT)
+                // Only count frames where every missing dependency has also finished loading on a
+                // loader thread. A dependency that is merely slow to load isn't a cycle.
+                if (!IsWaitingOnLoad(loadRequest))
                 {
-                    LogWarning("Exceeded requeue limit for %s, possible cyclical dependency. Forcing load.", loadRequest->mName.c_str());
-                    LoadAsset(loadRequest->mName);
+                    loadRequest->mRequeueCount++;
+
+                    if (loadRequest->mRequeueCount >= ASYNC_REQUEUE_LIMIT)
+                    {
+                        LogWarning("Exceeded requeue limit for %s, possible cyclical dependency. Forcing load.", loadRequest->mName.c_str());
+                        LoadAsset(loadRequest->mName);
+                    }
                 }
             }
         }
-    } while (handled && numIterations < maxIterations);
+    }
+
+    // Cancelled assets were never created, so there is nothing to Destroy().
+    for (uint32_t i = 0; i < cancelledAssets.size(); ++i)
+    {
+        delete cancelledAssets[i];
+    }
+
+    for (uint32_t i = 0; i < callbacks.size(); ++i)
+    {
+        CallAsyncLoadCallback(callbacks[i].first, callbacks[i].second);
+    }
 }
 
 #if EDITOR
+void AssetManager::UpdateFileWatcher()
+{
+    std::vector<FileChange> changes;
+    SYS_PollFileChanges(changes);
+
+    for (uint32_t i = 0; i < changes.size(); ++i)
+    {
+        const std::string& path = changes[i].mPath;
+        size_t slash = path.find_last_of('/');
+        std::string dirPath = path.substr(0, slash + 1);
+        std::string filename = path.substr(slash + 1);
+
+        AssetDir* dir = FindDirectoryByPath(mRootDirectory, dirPath);
+
+        // Directories that were unloaded or deleted in the editor may still report changes.
+        if (dir == nullptr)
+            continue;
+
+        if (changes[i].mType == FileChangeType::DirectoryCreated)
+        {
+            bool exists = false;
+            for (uint32_t c = 0; c < dir->mChildDirs.size(); ++c)
+            {
+                if (dir->mChildDirs[c]->mName == filename)
+                {
+                    exists = true;
+                    break;
+                }
+            }
+
+            if (exists)
+            {
+                // Created by the editor, which doesn't watch it yet.
+                SYS_WatchDirectory(path.c_str());
+            }
+            else
+            {
+                uint32_t numHeadersRead = 0;
+                AssetDir* subDir = new AssetDir(filename, path + "/", dir);
+                DiscoverDirectory(subDir, nullptr, nullptr, numHeadersRead);
+            }
+
+            continue;
+        }
+
+        const char* extension = strrchr(filename.c_str(), '.');
+        if (extension == nullptr ||
+            strcmp(extension, ".oct") != 0)
+        {
+            continue;
+        }
+
+        std::string name = Asset::GetNameFromPath(filename);
+        AssetStub* stub = GetAssetStub(name);
+
+        // Loaded assets are owned by the editor, and saving them also triggers these events.
+        if (stub != nullptr &&
+            (stub->mAsset != nullptr || stub->mPath != path))
+        {
+            continue;
+        }
+
+        if (changes[i].mType == FileChangeType::Modified)
+        {
+            TypeId type = ReadAssetType(path);
+
+            if (stub == nullptr)
+            {
+                LogDebug("Discovered new asset: %s", path.c_str());
+                RegisterAsset(filename, type, dir, nullptr, dir->mEngineDir);
+            }
+            else
+            {
+                stub->mType = type;
+            }
+        }
+        else if (changes[i].mType == FileChangeType::Removed &&
+            stub != nullptr &&
+            !SYS_DoesFileExist(path.c_str(), true))
+        {
+            LogDebug("Asset removed: %s", path.c_str());
+            PurgeAsset(name.c_str());
+        }
+    }
+}
+
+AssetDir* AssetManager::FindDirectoryByPath(AssetDir* dir, const std::string& path)
+{
+    if (dir == nullptr ||
+        dir->mPath == path)
+    {
+        return dir;
+    }
+
+    for (uint32_t i = 0; i < dir->mChildDirs.size(); ++i)
+    {
+        AssetDir* found = FindDirectoryByPath(dir->mChildDirs[i], path);
+        if (found != nullptr)
+        {
+            return found;
+        }
+    }
+
+    return nullptr;
+}
+
 glm::vec4 AssetManager::GetEditorAssetColor(TypeId type)
 {
     glm::vec4 retColor = { 0.5f, 0.5f, 0.5f, 1.0f };
@@ -3,28 +3,105 @@
 #include "Asset.h"
 #include "AssetRef.h"
 #include "Log.h"
+#include "ScriptFunc.h"
 
 #include "System/System.h"
 
 #include <string>
 #include <deque>
+#include <set>
 #include <unordered_map>
 
 class Asset;
 class AssetDir;
+class AssetPak;
 class Material;
 class ParticleSystem;
 
+// Cached result of reading an asset header during discovery, keyed on the file path.
+// Entries are reused as long as the file's modified time and size haven't changed.
+struct DiscoveryCacheEntry
+{
+    uint64_t mModifiedTime = 0;
+    uint64_t mSize = 0;
+    TypeId mType = INVALID_TYPE_ID;
+};
+
+typedef std::unordered_map<std::string, DiscoveryCacheEntry> DiscoveryCache;
+
+// Assets that lose their last reference stay loaded as a cache, so an asset that is released
+// and requested again soon after doesn't have to be reloaded. Every ASSET_CACHE_UPDATE_FRAMES
+// the AssetManager refreshes the memory used by each asset, and while the total is over budget
+// it unloads cached assets, least recently referenced first. Assets that were never referenced
+// (only used through raw pointers) are only unloaded by RefSweep().
+#define ASSET_CACHE_UPDATE_FRAMES 30
+#define ASSET_DEFAULT_CPU_BUDGET (512ull * 1024 * 1024)
+#define ASSET_DEFAULT_GPU_BUDGET (512ull * 1024 * 1024)
+
+struct AssetMemoryStats
+{
+    TypeId mType = INVALID_TYPE_ID;
+    uint32_t mNumLoaded = 0;
+    uint32_t mNumCached = 0;
+    uint64_t mCpuBytes = 0;
+    uint64_t mGpuBytes = 0;
+    uint64_t mCachedCpuBytes = 0;
+    uint64_t mCachedGpuBytes = 0;
+};
+
+typedef uint32_t AsyncLoadHandle;
+#define INVALID_ASYNC_LOAD_HANDLE 0
+
+// Called on the main thread once the asset is loaded. asset is nullptr if the load failed.
+// Not called for cancelled loads.
+typedef void(*AsyncLoadCallbackFP)(Asset* asset, void* userData);
+
+struct AsyncLoadTicket
+{
+    AsyncLoadRequest* mRequest = nullptr;
+    AssetRef* mTargetRef = nullptr;
+    int32_t mPriority = 0;
+    ScriptableFP<AsyncLoadCallbackFP> mCallback;
+    void* mUserData = nullptr;
+};
+
 struct AsyncLoadRequest
 {
     std::string mName;
     std::string mPath;
     std::vector<AssetRef*> mTargetRefs;
     std::vector<AssetStub*> mDependentAssets;
+
+    // The id of the request this one was registered as a parent of, per mDependentAssets entry.
+    // The stub may have moved on to a newer request (or the old one was freed) by the time it's used.
+    std::vector<uint64_t> mDependencyIds;
     const EmbeddedFile* mEmbeddedData = nullptr;
+    const AssetPak* mPak = nullptr;
+    int32_t mPakEntry = -1;
     TypeId mType = INVALID_TYPE_ID;
     Asset* mAsset = nullptr;
     int32_t mRequeueCount = 0;
+
+    // A request is cancelled once it has no handles, no in-flight parent requests and was never
+    // requested without a handle (pinned). Its priority is the highest of its handles' priorities,
+    // 0 if it's pinned and one more than each parent's priority. It's recomputed whenever one of those changes.
+    std::vector<AsyncLoadHandle> mHandles;
+    std::vector<AsyncLoadRequest*> mParents;
+    int32_t mPriority = 0;
+    bool mPinned = false;
+    bool mCancelled = false;
+
+    // Unique per request, orders requests of the same priority first come first served.
+    uint64_t mId = 0;
+};
+
+// Highest priority first. A request's priority must not change while it's in a queue using this.
+struct AsyncLoadRequestOrder
+{
+    bool operator()(const AsyncLoadRequest* a, const AsyncLoadRequest* b) const
+    {
+        return (a->mPriority != b->mPriority) ? (a->mPriority > b->mPriority) : (a->mId < b->mId);
+    }
 };
 
 Asset* FetchAsset(const std::string& name);
@@ -75,12 +152,16 @@ public:
 
     void Initialize();
     void Update(float deltaTime);
-    void Discover(const char* directoryName, const char* directoryPath);
+    void Discover(const char* directoryName, const char* directoryPath, const char* cachePath = nullptr);
     void DiscoverAssetRegistry(const char* registryPath);
+    bool DiscoverAssetPaks(const char* directoryPath);
     void DiscoverEmbeddedAssets(struct EmbeddedFile* assets, uint32_t numAssets);
     void Purge(bool purgeEngineAssets);
     bool PurgeAsset(const char* name);
-    void RefSweep();
+
+    // Unloads unreferenced assets. Recently used ones are kept while memory usage is within
+    // budget, unless flushCache is set.
+    void RefSweep(bool flushCache = false);
     void LoadAll();
 
     void RegisterTransientAsset(Asset* asset);
@@ -93,6 +174,12 @@ public:
     Asset* LoadAsset(const std::string& name);
     Asset* LoadAsset(AssetStub& stub);
     void AsyncLoadAsset(const std::string& name, AssetRef* targetRef);
+    AsyncLoadHandle AsyncLoadAsset(const std::string& name, AssetRef* targetRef, int32_t priority, AsyncLoadCallbackFP callback = nullptr, void* userData = nullptr);
+    AsyncLoadHandle AsyncLoadAsset(const std::string& name, AssetRef* targetRef, int32_t priority, const ScriptFunc& scriptCallback);
+    void AsyncLoadDependency(const std::string& name, AssetRef* targetRef, AsyncLoadRequest* parentRequest);
+    void SetAsyncLoadPriority(AsyncLoadHandle handle, int32_t priority);
+    void CancelAsyncLoad(AsyncLoadHandle handle);
+    bool IsAsyncLoadPending(AsyncLoadHandle handle);
     void SaveAsset(const std::string& name);
     void SaveAsset(AssetStub& stub);
     bool UnloadAsset(const std::string& name);
@@ -115,6 +202,17 @@ public:
 
     bool IsPurging() const;
 
+    void SetMemoryBudget(uint64_t cpuBytes, uint64_t gpuBytes);
+    uint64_t GetCpuMemoryBudget() const;
+    uint64_t GetGpuMemoryBudget() const;
+    uint64_t GetCpuMemoryUsage() const;
+    uint64_t GetGpuMemoryUsage() const;
+
+    // Per asset type usage as of the last cache update, including cached assets.
+    const std::vector<AssetMemoryStats>& GetMemoryStats() const;
+    void UpdateMemoryStats();
+    void LogMemoryStats();
+
 protected:
 
     static ThreadFuncRet AsyncLoadThreadFunc(void* in);
@@ -123,22 +221,54 @@ protected:
     AssetManager();
 
     void UpdateEndLoadQueue();
+    void DiscoverDirectory(AssetDir* directory, const DiscoveryCache* oldCache, DiscoveryCache* newCache, uint32_t& numHeadersRead);
+    TypeId ReadAssetType(const std::string& path);
+    static bool LoadDiscoveryCache(const char* path, DiscoveryCache& outCache);
+    static void SaveDiscoveryCache(const char* path, const DiscoveryCache& cache);
+    AsyncLoadRequest* QueueAsyncLoad(AssetStub* stub, const std::string& name, AssetRef* targetRef, int32_t priority);
+    AsyncLoadHandle QueueAsyncLoadTicket(const std::string& name, AssetRef* targetRef, AsyncLoadTicket& ticket);
+    AsyncLoadRequest* GetDependencyRequest(AsyncLoadRequest* request, uint32_t index) const;
+    int32_t ComputeRequestPriority(AsyncLoadRequest* request);
+    void UpdateRequestPriority(AsyncLoadRequest* request);
+    void RemoveDependencyParent(AsyncLoadRequest* request);
+    void CancelRequest(AsyncLoadRequest* request);
+    bool IsRequestWanted(AsyncLoadRequest* request) const;
+    void RemoveAsyncLoadRef(AssetRef& assetRef);
+    bool IsWaitingOnLoad(AsyncLoadRequest* request);
+    uint32_t TrimAssetCache(bool flush, bool automatic);
 
     std::unordered_map<std::string, AssetStub*> mAssetMap;
     std::vector<Asset*> mTransientAssets;
+    std::vector<AssetPak*> mAssetPaks;
     AssetDir* mRootDirectory = nullptr;
     bool mPurging = false;
     bool mDestructing = false;
-    std::deque<AsyncLoadRequest*> mBeginLoadQueue;
+    std::set<AsyncLoadRequest*, AsyncLoadRequestOrder> mBeginLoadQueue;
     std::deque<AsyncLoadRequest*> mEndLoadQueue;
-    ThreadObject* mAsyncLoadThread = {};
+    std::unordered_map<AsyncLoadHandle, AsyncLoadTicket> mLoadHandles;
+    AsyncLoadHandle mNextLoadHandle = 1;
+    uint64_t mNextRequestId = 1;
+    std::vector<ThreadObject*> mAsyncLoadThreads;
     MutexObject* mMutex = {};
 
+    // Memory accounting and the unreferenced asset cache.
+    std::vector<AssetMemoryStats> mMemoryStats;
+    std::vector<AssetStub*> mEvictOrder;
+    std::vector<Asset*> mEvictedAssets;
+    uint64_t mCpuMemoryBudget = ASSET_DEFAULT_CPU_BUDGET;
+    uint64_t mGpuMemoryBudget = ASSET_DEFAULT_GPU_BUDGET;
+    uint64_t mCpuMemoryUsage = 0;
+    uint64_t mGpuMemoryUsage = 0;
+    uint32_t mNumCachedAssets = 0;
+    uint32_t mCacheFrame = 1;
+
 #if EDITOR
 public:
     glm::vec4 GetEditorAssetColor(TypeId type);
     void InitAssetColorMap();
 protected:
+    void UpdateFileWatcher();
+    AssetDir* FindDirectoryByPath(AssetDir* dir, const std::string& path);
     std::unordered_map<TypeId, glm::vec4> mAssetColorMap;
 #endif
 };
\ No newline at end of file
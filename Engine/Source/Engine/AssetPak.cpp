@@ -0,0 +1,433 @@
+#include "AssetPak.h"
+#include "Asset.h"
+#include "Log.h"
+#include "Assertion.h"
+
+#include "System/System.h"
+
+#include <algorithm>
+#include <string.h>
+
+AssetPak::AssetPak()
+{
+    mStatsMutex = SYS_CreateMutex();
+}
+
+AssetPak::~AssetPak()
+{
+    Close();
+
+    SYS_DestroyMutex(mStatsMutex);
+    mStatsMutex = nullptr;
+}
+
+bool AssetPak::Open(const char* path)
+{
+    Close();
+
+    // Assets are fetched in whatever order the game asks for them, so don't read ahead
+    // the whole archive. Fall back to reading it into memory if it can't be mapped.
+    if (SYS_MapFileData(path, true, 0, mData, mSize, false))
+    {
+        mMapped = true;
+    }
+    else
+    {
+        SYS_AcquireFileData(path, true, 0, mData, mSize);
+    }
+
+    if (mData == nullptr)
+    {
+        return false;
+    }
+
+    mPath = path;
+
+    const AssetPakHeader* header = reinterpret_cast<const AssetPakHeader*>(mData);
+
+    if (mSize < sizeof(AssetPakHeader) ||
+        header->mMagic != ASSET_PAK_MAGIC ||
+        header->mVersion != ASSET_PAK_VERSION ||
+        uint64_t(header->mTocOffset) + uint64_t(header->mNumEntries) * sizeof(AssetPakEntry) > mSize ||
+        uint64_t(header->mNamesOffset) + uint64_t(header->mNamesSize) > mSize ||
+        header->mTocOffset % alignof(AssetPakEntry) != 0)
+    {
+        LogError("Invalid asset pak: %s", path);
+        Close();
+        return false;
+    }
+
+    mEntries = reinterpret_cast<const AssetPakEntry*>(mData + header->mTocOffset);
+    mNames = mData + header->mNamesOffset;
+    mNumEntries = header->mNumEntries;
+
+    // Reject archives whose entries point outside the file, so a corrupt pak can't be read out of bounds.
+    bool valid = (header->mNamesSize == 0 || mNames[header->mNamesSize - 1] == 0);
+
+    for (uint32_t i = 0; valid && i < mNumEntries; ++i)
+    {
+        const AssetPakEntry& entry = mEntries[i];
+
+        valid = uint64_t(entry.mOffset) + uint64_t(entry.mSize) <= mSize &&
+            entry.mNameOffset < header->mNamesSize &&
+            ((entry.mFlags & AssetPakCompressed) || entry.mSize == entry.mUncompressedSize);
+    }
+
+    if (!valid)
+    {
+        LogError("Corrupt asset pak: %s", path);
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+void AssetPak::Close()
+{
+    if (mData != nullptr)
+    {
+        if (mMapped)
+        {
+            SYS_UnmapFileData(mData, mSize);
+        }
+        else
+        {
+            SYS_ReleaseFileData(mData);
+        }
+    }
+
+    mPath = "";
+    mData = nullptr;
+    mSize = 0;
+    mMapped = false;
+    mEntries = nullptr;
+    mNames = nullptr;
+    mNumEntries = 0;
+    mDecompressStats.clear();
+}
+
+bool AssetPak::IsOpen() const
+{
+    return (mData != nullptr);
+}
+
+const std::string& AssetPak::GetPath() const
+{
+    return mPath;
+}
+
+uint32_t AssetPak::GetNumEntries() const
+{
+    return mNumEntries;
+}
+
+const AssetPakEntry& AssetPak::GetEntry(uint32_t index) const
+{
+    OCT_ASSERT(index < mNumEntries);
+    return mEntries[index];
+}
+
+const char* AssetPak::GetEntryName(uint32_t index) const
+{
+    OCT_ASSERT(index < mNumEntries);
+    return mNames + mEntries[index].mNameOffset;
+}
+
+const char* AssetPak::GetEntryData(uint32_t index) const
+{
+    OCT_ASSERT(index < mNumEntries);
+    return mData + mEntries[index].mOffset;
+}
+
+void AssetPak::PrefetchEntry(uint32_t index) const
+{
+    // The archive is mapped for random access, so read ahead just this entry once it's needed.
+    if (mMapped)
+    {
+        SYS_PrefetchFileData(GetEntryData(index), mEntries[index].mSize);
+    }
+}
+
+bool AssetPak::DecompressEntry(uint32_t index, char* dst) const
+{
+    const AssetPakEntry& entry = GetEntry(index);
+    uint64_t startTime = SYS_GetTimeMicroseconds();
+    bool success = false;
+
+    if (entry.mFlags & AssetPakCompressed)
+    {
+        success = DecompressBlock(GetEntryData(index), entry.mSize, dst, entry.mUncompressedSize);
+    }
+    else
+    {
+        memcpy(dst, GetEntryData(index), entry.mSize);
+        success = true;
+    }
+
+    uint64_t elapsed = SYS_GetTimeMicroseconds() - startTime;
+
+    {
+        SCOPED_LOCK(mStatsMutex);
+        AssetPakTypeStats& stats = mDecompressStats[entry.mType];
+        stats.mCount++;
+        stats.mUncompressedBytes += entry.mUncompressedSize;
+        stats.mStoredBytes += entry.mSize;
+        stats.mTimeUs += elapsed;
+    }
+
+    return success;
+}
+
+void AssetPak::LogStats() const
+{
+    SCOPED_LOCK(mStatsMutex);
+
+    for (auto it = mDecompressStats.begin(); it != mDecompressStats.end(); ++it)
+    {
+        const AssetPakTypeStats& stats = it->second;
+        LogDebug("%s: decompressed %d assets, %.2f MB -> %.2f MB in %.2f ms",
+            Asset::GetNameFromTypeId(it->first),
+            stats.mCount,
+            stats.mStoredBytes / (1024.0 * 1024.0),
+            stats.mUncompressedBytes / (1024.0 * 1024.0),
+            stats.mTimeUs / 1000.0);
+    }
+}
+
+int32_t AssetPak::FindEntry(const char* name) const
+{
+    uint64_t hash = HashName(name);
+
+    const AssetPakEntry* first = mEntries;
+    const AssetPakEntry* last = mEntries + mNumEntries;
+    const AssetPakEntry* entry = std::lower_bound(first, last, hash,
+        [](const AssetPakEntry& entry, uint64_t hash) { return entry.mNameHash < hash; });
+
+    // Names are compared too, in case two of them share a hash.
+    for (; entry != last && entry->mNameHash == hash; ++entry)
+    {
+        if (strcmp(mNames + entry->mNameOffset, name) == 0)
+        {
+            return int32_t(entry - first);
+        }
+    }
+
+    return -1;
+}
+
+uint64_t AssetPak::HashName(const char* name)
+{
+    // 64-bit FNV-1a. A 32-bit hash would collide too often in projects with tens of thousands of assets.
+    uint64_t hash = 0xcbf29ce484222325ull;
+
+    for (const char* c = name; *c != 0; ++c)
+    {
+        hash ^= uint64_t(uint8_t(*c));
+        hash *= 0x100000001b3ull;
+    }
+
+    return hash;
+}
+
+std::string AssetPak::GetArchivePath(const std::string& directory, uint32_t archiveIndex)
+{
+    return directory + ASSET_PAK_FILE_PREFIX + std::to_string(archiveIndex) + ASSET_PAK_FILE_EXT;
+}
+
+AssetPakWriter::~AssetPakWriter()
+{
+    if (mFile != nullptr)
+    {
+        fclose(mFile);
+        mFile = nullptr;
+    }
+}
+
+bool AssetPakWriter::Begin(const std::string& directory, uint32_t codec)
+{
+    OCT_ASSERT(mFile == nullptr);
+
+    mDirectory = directory;
+    mNumArchives = 0;
+    mTotalEntries = 0;
+    mCodec = codec;
+    mCookStats.clear();
+
+    return OpenArchive();
+}
+
+bool AssetPakWriter::AddEntry(const std::string& name, TypeId type, uint32_t flags, const char* data, uint32_t size)
+{
+    if (mFile == nullptr)
+    {
+        return false;
+    }
+
+    uint64_t startTime = SYS_GetTimeMicroseconds();
+    uint32_t uncompressedSize = size;
+
+    if (mCodec != COMPRESSION_CODEC_NONE &&
+        size > 0)
+    {
+        mCompressBuffer.clear();
+
+        if (CompressBlock(mCodec, data, size, mCompressBuffer) &&
+            mCompressBuffer.size() <= size - size / ASSET_PAK_MIN_SAVINGS_DIVISOR)
+        {
+            data = mCompressBuffer.data();
+            size = uint32_t(mCompressBuffer.size());
+            flags |= AssetPakCompressed;
+        }
+    }
+
+    AssetPakTypeStats& stats = mCookStats[type];
+    stats.mCount++;
+    stats.mUncompressedBytes += uncompressedSize;
+    stats.mStoredBytes += size;
+    stats.mTimeUs += SYS_GetTimeMicroseconds() - startTime;
+
+    uint32_t alignment = (size >= ASSET_PAK_PAGE_SIZE) ? ASSET_PAK_PAGE_SIZE : ASSET_PAK_ALIGNMENT;
+    uint64_t projectedSize = uint64_t(mFileSize) + alignment + size +
+        mNames.size() + name.size() + 1 +
+        (mEntries.size() + 1) * sizeof(AssetPakEntry) + ASSET_PAK_ALIGNMENT;
+
+    if (projectedSize > ASSET_PAK_MAX_ARCHIVE_SIZE)
+    {
+        if (mEntries.size() == 0)
+        {
+            LogError("Asset %s is too large to be packed", name.c_str());
+            return false;
+        }
+
+        if (!CloseArchive() ||
+            !OpenArchive())
+        {
+            return false;
+        }
+    }
+
+    if (!WritePadding(alignment))
+    {
+        return false;
+    }
+
+    AssetPakEntry entry;
+    entry.mNameHash = AssetPak::HashName(name.c_str());
+    entry.mOffset = mFileSize;
+    entry.mSize = size;
+    entry.mType = type;
+    entry.mNameOffset = uint32_t(mNames.size());
+    entry.mFlags = flags;
+    entry.mUncompressedSize = uncompressedSize;
+
+    if (size > 0 &&
+        fwrite(data, size, 1, mFile) != 1)
+    {
+        LogError("Failed to write asset %s to pak", name.c_str());
+        return false;
+    }
+
+    mFileSize += size;
+    mNames.insert(mNames.end(), name.c_str(), name.c_str() + name.size() + 1);
+    mEntries.push_back(entry);
+    mTotalEntries++;
+
+    return true;
+}
+
+bool AssetPakWriter::End()
+{
+    return CloseArchive();
+}
+
+uint32_t AssetPakWriter::GetNumArchives() const
+{
+    return mNumArchives;
+}
+
+uint32_t AssetPakWriter::GetNumEntries() const
+{
+    return mTotalEntries;
+}
+
+const std::unordered_map<TypeId, AssetPakTypeStats>& AssetPakWriter::GetCookStats() const
+{
+    return mCookStats;
+}
+
+bool AssetPakWriter::OpenArchive()
+{
+    std::string path = AssetPak::GetArchivePath(mDirectory, mNumArchives);
+    mFile = fopen(path.c_str(), "wb");
+
+    if (mFile == nullptr)
+    {
+        LogError("Failed to create asset pak: %s", path.c_str());
+        return false;
+    }
+
+    mNumArchives++;
+    mEntries.clear();
+    mNames.clear();
+
+    // The header is rewritten once the toc location is known.
+    AssetPakHeader header;
+    fwrite(&header, sizeof(AssetPakHeader), 1, mFile);
+    mFileSize = sizeof(AssetPakHeader);
+
+    return true;
+}
+
+bool AssetPakWriter::CloseArchive()
+{
+    if (mFile == nullptr)
+    {
+        return false;
+    }
+
+    std::sort(mEntries.begin(), mEntries.end(),
+        [](const AssetPakEntry& a, const AssetPakEntry& b) { return a.mNameHash < b.mNameHash; });
+
+    AssetPakHeader header;
+    header.mNumEntries = uint32_t(mEntries.size());
+    header.mNamesOffset = mFileSize;
+    header.mNamesSize = uint32_t(mNames.size());
+
+    bool success = (mNames.size() == 0 || fwrite(mNames.data(), mNames.size(), 1, mFile) == 1);
+    mFileSize += uint32_t(mNames.size());
+
+    success = success && WritePadding(ASSET_PAK_ALIGNMENT);
+    header.mTocOffset = mFileSize;
+
+    success = success && (mEntries.size() == 0 || fwrite(mEntries.data(), sizeof(AssetPakEntry), mEntries.size(), mFile) == mEntries.size());
+    mFileSize += uint32_t(mEntries.size() * sizeof(AssetPakEntry));
+
+    success = success && (fseek(mFile, 0, SEEK_SET) == 0);
+    success = success && (fwrite(&header, sizeof(AssetPakHeader), 1, mFile) == 1);
+
+    fclose(mFile);
+    mFile = nullptr;
+
+    if (!success)
+    {
+        LogError("Failed to write asset pak: %s", AssetPak::GetArchivePath(mDirectory, mNumArchives - 1).c_str());
+    }
+
+    return success;
+}
+
+bool AssetPakWriter::WritePadding(uint32_t alignment)
+{
+    static const char kZeros[ASSET_PAK_PAGE_SIZE] = {};
+    uint32_t padding = (alignment - (mFileSize % alignment)) % alignment;
+
+    if (padding > 0 &&
+        fwrite(kZeros, padding, 1, mFile) != 1)
+    {
+        return false;
+    }
+
+    mFileSize += padding;
+    return true;
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "EngineTypes.h"
+#include "Constants.h"
+#include "Compression.h"
+
+#include "System/SystemTypes.h"
+
+// Packaged builds store their cooked .oct files in one or a few pak archives instead of
+// thousands of loose files. Each archive is mapped once with a single read-only file mapping
+// and assets are loaded straight out of it.
+//
+// Layout:  [AssetPakHeader] [asset data ...] [name table] [toc]
+// The toc is an array of AssetPakEntry sorted by name hash, so lookups are a binary search.
+// Asset data is aligned so that large assets start on a page boundary.
+// Entries that shrink enough are stored as chunked compressed blocks (see Compression.h).
+
+#define ASSET_PAK_MAGIC 0x4b41504f // "OPAK"
+#define ASSET_PAK_VERSION 2
+#define ASSET_PAK_ALIGNMENT 16
+#define ASSET_PAK_PAGE_SIZE 4096
+#define ASSET_PAK_MAX_ARCHIVE_SIZE (1024 * 1024 * 1024)
+#define ASSET_PAK_FILE_PREFIX "Assets"
+#define ASSET_PAK_FILE_EXT ".pak"
+
+// Entries are only stored compressed if that saves at least 1/ASSET_PAK_MIN_SAVINGS_DIVISOR of their size.
+#define ASSET_PAK_MIN_SAVINGS_DIVISOR 16
+
+enum AssetPakEntryFlags
+{
+    AssetPakEngine = 0x01,
+    AssetPakCompressed = 0x02,
+};
+
+struct AssetPakHeader
+{
+    uint32_t mMagic = ASSET_PAK_MAGIC;
+    uint32_t mVersion = ASSET_PAK_VERSION;
+    uint32_t mNumEntries = 0;
+    uint32_t mTocOffset = 0;
+    uint32_t mNamesOffset = 0;
+    uint32_t mNamesSize = 0;
+    uint32_t mReserved[2] = {};
+};
+
+struct AssetPakEntry
+{
+    uint64_t mNameHash = 0;
+    uint32_t mOffset = 0;
+    uint32_t mSize = 0;
+    TypeId mType = INVALID_TYPE_ID;
+    uint32_t mNameOffset = 0;
+    uint32_t mFlags = 0;
+    uint32_t mUncompressedSize = 0;
+};
+
+// Per asset type totals, gathered when cooking and when loading.
+struct AssetPakTypeStats
+{
+    uint32_t mCount = 0;
+    uint64_t mUncompressedBytes = 0;
+    uint64_t mStoredBytes = 0;
+    uint64_t mTimeUs = 0;
+};
+
+static_assert(sizeof(AssetPakHeader) == 32, "AssetPakHeader layout changed");
+static_assert(sizeof(AssetPakEntry) == 32, "AssetPakEntry layout changed");
+
+class AssetPak
+{
+public:
+
+    AssetPak();
+    ~AssetPak();
+
+    bool Open(const char* path);
+    void Close();
+    bool IsOpen() const;
+
+    const std::string& GetPath() const;
+    uint32_t GetNumEntries() const;
+    const AssetPakEntry& GetEntry(uint32_t index) const;
+    const char* GetEntryName(uint32_t index) const;
+    const char* GetEntryData(uint32_t index) const;
+    void PrefetchEntry(uint32_t index) const;
+
+    // dst must hold the entry's mUncompressedSize bytes. Thread safe.
+    bool DecompressEntry(uint32_t index, char* dst) const;
+    void LogStats() const;
+
+    // Returns -1 if the archive doesn't contain the asset.
+    int32_t FindEntry(const char* name) const;
+
+    static uint64_t HashName(const char* name);
+    static std::string GetArchivePath(const std::string& directory, uint32_t archiveIndex);
+
+protected:
+
+    std::string mPath;
+    char* mData = nullptr;
+    uint32_t mSize = 0;
+    bool mMapped = false;
+
+    const AssetPakEntry* mEntries = nullptr;
+    const char* mNames = nullptr;
+    uint32_t mNumEntries = 0;
+
+    // Decompression totals, entries can be decompressed on any loader thread.
+    MutexObject* mStatsMutex = nullptr;
+    mutable std::unordered_map<TypeId, AssetPakTypeStats> mDecompressStats;
+};
+
+// Writes pak archives while cooking. Asset data is streamed to disk as it is added, and a new
+// archive is started whenever the current one would grow past ASSET_PAK_MAX_ARCHIVE_SIZE.
+class AssetPakWriter
+{
+public:
+
+    ~AssetPakWriter();
+
+    bool Begin(const std::string& directory, uint32_t codec = COMPRESSION_CODEC_ZLIB);
+    bool AddEntry(const std::string& name, TypeId type, uint32_t flags, const char* data, uint32_t size);
+    bool End();
+
+    uint32_t GetNumArchives() const;
+    uint32_t GetNumEntries() const;
+    const std::unordered_map<TypeId, AssetPakTypeStats>& GetCookStats() const;
+
+protected:
+
+    bool OpenArchive();
+    bool CloseArchive();
+    bool WritePadding(uint32_t alignment);
+
+    std::string mDirectory;
+    FILE* mFile = nullptr;
+    uint32_t mFileSize = 0;
+    uint32_t mNumArchives = 0;
+    uint32_t mTotalEntries = 0;
+    uint32_t mCodec = COMPRESSION_CODEC_NONE;
+
+    std::vector<AssetPakEntry> mEntries;
+    std::vector<char> mNames;
+    std::vector<char> mCompressBuffer;
+    std::unordered_map<TypeId, AssetPakTypeStats> mCookStats;
+};
@@ -192,6 +192,17 @@ const char* Font::GetTypeName()
     return "Font";
 }
 
+uint64_t Font::GetCpuMemorySize()
+{
+    // The glyph texture is accounted for on its own.
+    return mCharacters.capacity() * sizeof(Character);
+}
+
+uint64_t Font::GetGpuMemorySize()
+{
+    return 0;
+}
+
 const char* Font::GetTypeImportExt()
 {
     return ".xml";
@@ -33,6 +33,8 @@ public:
     virtual void GatherProperties(std::vector<Property>& outProps) override;
     virtual glm::vec4 GetTypeColor() override;
     virtual const char* GetTypeName() override;
+    virtual uint64_t GetCpuMemorySize() override;
+    virtual uint64_t GetGpuMemorySize() override;
     virtual const char* GetTypeImportExt() override;
 
     int32_t GetSize() const;
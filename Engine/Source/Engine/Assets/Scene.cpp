@@ -580,6 +580,22 @@ void Scene::LoadStream(Stream& stream, Platform platform)
     mFogDensityFunc = (FogDensityFunc)stream.ReadUint8();
     mFogNear = stream.ReadFloat();
     mFogFar = stream.ReadFloat();
+
+    if (mVersion >= ASSET_VERSION_WORLD_PARTITION)
+    {
+        mPartitionCellSize = stream.ReadFloat();
+        mPartitionLoadDistance = stream.ReadFloat();
+        mPartitionUnloadDistance = stream.ReadFloat();
+
+        uint32_t numCells = stream.ReadUint32();
+        mPartitionCells.resize(numCells);
+        for (uint32_t i = 0; i < numCells; ++i)
+        {
+            mPartitionCells[i].mX = stream.ReadInt32();
+            mPartitionCells[i].mZ = stream.ReadInt32();
+            stream.ReadString(mPartitionCells[i].mSceneName);
+        }
+    }
 }
 
 void Scene::SaveStream(Stream& stream, Platform platform)
@@ -617,6 +633,19 @@ void Scene::SaveStream(Stream& stream, Platform platform)
     stream.WriteUint8(uint8_t(mFogDensityFunc));
     stream.WriteFloat(mFogNear);
     stream.WriteFloat(mFogFar);
+
+    // World partition
+    stream.WriteFloat(mPartitionCellSize);
+    stream.WriteFloat(mPartitionLoadDistance);
+    stream.WriteFloat(mPartitionUnloadDistance);
+
+    stream.WriteUint32((uint32_t)mPartitionCells.size());
+    for (uint32_t i = 0; i < mPartitionCells.size(); ++i)
+    {
+        stream.WriteInt32(mPartitionCells[i].mX);
+        stream.WriteInt32(mPartitionCells[i].mZ);
+        stream.WriteString(mPartitionCells[i].mSceneName);
+    }
 }
 
 void Scene::Create()
@@ -644,6 +673,10 @@ void Scene::GatherProperties(std::vector<Property>& outProps)
     outProps.push_back(Property(DatumType::Byte, "Fog Density", this, &mFogDensityFunc, 1, HandlePropChange, 0, int32_t(FogDensityFunc::Count), sFogDensityStrings));
     outProps.push_back(Property(DatumType::Float, "Fog Near", this, &mFogNear, 1, HandlePropChange));
     outProps.push_back(Property(DatumType::Float, "Fog Far", this, &mFogFar, 1, HandlePropChange));
+
+    // Partition cells are written by the editor's Partition Scene action, the cell size is picked there.
+    outProps.push_back(Property(DatumType::Float, "Partition Load Distance", this, &mPartitionLoadDistance));
+    outProps.push_back(Property(DatumType::Float, "Partition Unload Distance", this, &mPartitionUnloadDistance));
 }
 
 glm::vec4 Scene::GetTypeColor()
@@ -860,6 +893,42 @@ void Scene::ApplyRenderSettings(World* world)
     GetWorld()->SetFogSettings(fogSettings);
 }
 
+bool Scene::IsPartitioned() const
+{
+    return mPartitionCellSize > 0.0f;
+}
+
+float Scene::GetPartitionCellSize() const
+{
+    return mPartitionCellSize;
+}
+
+void Scene::SetPartitionCellSize(float cellSize)
+{
+    mPartitionCellSize = glm::max(cellSize, 0.0f);
+}
+
+float Scene::GetPartitionLoadDistance() const
+{
+    return mPartitionLoadDistance;
+}
+
+float Scene::GetPartitionUnloadDistance() const
+{
+    // Unloading closer than the load distance would reload the cell on the next frame.
+    return glm::max(mPartitionUnloadDistance, mPartitionLoadDistance);
+}
+
+const std::vector<ScenePartitionCell>& Scene::GetPartitionCells() const
+{
+    return mPartitionCells;
+}
+
+void Scene::SetPartitionCells(const std::vector<ScenePartitionCell>& cells)
+{
+    mPartitionCells = cells;
+}
+
 //const Property* Scene::GetProperty(const std::string& widgetName, const std::string& propName)
 //{
 //
@@ -19,6 +19,15 @@ struct SceneNodeDef
     bool mExposeVariable = false;
 };
 
+// A grid cell of a partitioned scene. Cells are referenced by name so that loading
+// the scene doesn't load every cell with it. See WorldPartition.h.
+struct ScenePartitionCell
+{
+    int32_t mX = 0;
+    int32_t mZ = 0;
+    std::string mSceneName;
+};
+
 class Scene : public Asset
 {
 public:
@@ -42,6 +51,14 @@ public:
 
     void ApplyRenderSettings(World* world);
 
+    bool IsPartitioned() const;
+    float GetPartitionCellSize() const;
+    void SetPartitionCellSize(float cellSize);
+    float GetPartitionLoadDistance() const;
+    float GetPartitionUnloadDistance() const;
+    const std::vector<ScenePartitionCell>& GetPartitionCells() const;
+    void SetPartitionCells(const std::vector<ScenePartitionCell>& cells);
+
 protected:
 
 #if OCT_SCENE_CONVERSION
@@ -72,4 +89,10 @@ protected:
     FogDensityFunc mFogDensityFunc = FogDensityFunc::Linear;
     float mFogNear = 0.0f;
     float mFogFar = 100.0f;
+
+    // World partition. A cell size of 0 means the scene is not partitioned.
+    float mPartitionCellSize = 0.0f;
+    float mPartitionLoadDistance = 100.0f;
+    float mPartitionUnloadDistance = 150.0f;
+    std::vector<ScenePartitionCell> mPartitionCells;
 };
@@ -4,9 +4,12 @@
 #include "AssetManager.h"
 #include "Log.h"
 #include "Maths.h"
+#include "Utilities.h"
 
 #include "Graphics/Graphics.h"
 
+#include <algorithm>
+
 #if EDITOR
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
@@ -94,6 +97,19 @@ void SkeletalMesh::LoadStream(Stream& stream, Platform platform)
             Channel& channel = animation.mChannels[chanIndex];
             channel.mBoneIndex = stream.ReadInt32();
 
+            if (mVersion >= ASSET_VERSION_BULK_ARRAYS)
+            {
+                channel.mPositionKeys.resize(stream.ReadUint32());
+                stream.ReadArray32(channel.mPositionKeys.data(), uint32_t(channel.mPositionKeys.size()));
+
+                channel.mRotationKeys.resize(stream.ReadUint32());
+                stream.ReadArray32(channel.mRotationKeys.data(), uint32_t(channel.mRotationKeys.size()));
+
+                channel.mScaleKeys.resize(stream.ReadUint32());
+                stream.ReadArray32(channel.mScaleKeys.data(), uint32_t(channel.mScaleKeys.size()));
+                continue;
+            }
+
             uint32_t numPositionKeys = stream.ReadUint32();
             channel.mPositionKeys.resize(numPositionKeys);
             for (uint32_t i = 0; i < numPositionKeys; ++i)
@@ -140,6 +156,35 @@ void SkeletalMesh::LoadStream(Stream& stream, Platform platform)
     }
 
     mVertices.resize(mNumVertices);
+    mIndices.resize(mNumIndices);
+
+    if (mVersion >= ASSET_VERSION_BULK_ARRAYS)
+    {
+        stream.ReadPadding(16);
+        stream.ReadArray32(mVertices.data(), mNumVertices);
+
+#if ENDIAN_SWAP
+        // Bone indices are bytes, so undo the 32 bit swap that was applied to them.
+        for (uint32_t i = 0; i < mNumVertices; ++i)
+        {
+            std::reverse(mVertices[i].mBoneIndices, mVertices[i].mBoneIndices + MAX_BONE_INFLUENCES);
+        }
+#endif
+
+        ReadIndexArray(stream, mIndices.data(), mNumIndices);
+    }
+    else
+    {
+        ReadLegacyVertexData(stream);
+    }
+
+    mBounds.mCenter = stream.ReadVec3();
+    mBounds.mRadius = stream.ReadFloat();
+    mBoundsScale = stream.ReadFloat();
+}
+
+void SkeletalMesh::ReadLegacyVertexData(Stream& stream)
+{
     for (uint32_t i = 0; i < mNumVertices; ++i)
     {
         mVertices[i].mPosition = stream.ReadVec3();
@@ -156,15 +201,10 @@ void SkeletalMesh::LoadStream(Stream& stream, Platform platform)
         mVertices[i].mBoneWeights[3] = stream.ReadFloat();
     }
 
-    mIndices.resize(mNumIndices);
     for (uint32_t i = 0; i < mNumIndices; ++i)
     {
         mIndices[i] = (IndexType) stream.ReadUint32();
     }
-
-    mBounds.mCenter = stream.ReadVec3();
-    mBounds.mRadius = stream.ReadFloat();
-    mBoundsScale = stream.ReadFloat();
 }
 
 void SkeletalMesh::SaveStream(Stream& stream, Platform platform)
@@ -205,25 +245,13 @@ void SkeletalMesh::SaveStream(Stream& stream, Platform platform)
 
 
             stream.WriteUint32((uint32_t)channel.mPositionKeys.size());
-            for (uint32_t i = 0; i < uint32_t(channel.mPositionKeys.size()); ++i)
-            {
-                stream.WriteFloat(channel.mPositionKeys[i].mTime);
-                stream.WriteVec3(channel.mPositionKeys[i].mValue);
-            }
+            stream.WriteArray32(channel.mPositionKeys.data(), uint32_t(channel.mPositionKeys.size()));
 
             stream.WriteUint32((uint32_t)channel.mRotationKeys.size());
-            for (uint32_t i = 0; i < uint32_t(channel.mRotationKeys.size()); ++i)
-            {
-                stream.WriteFloat(channel.mRotationKeys[i].mTime);
-                stream.WriteQuat(channel.mRotationKeys[i].mValue);
-            }
+            stream.WriteArray32(channel.mRotationKeys.data(), uint32_t(channel.mRotationKeys.size()));
 
             stream.WriteUint32((uint32_t)channel.mScaleKeys.size());
-            for (uint32_t i = 0; i < uint32_t(channel.mScaleKeys.size()); ++i)
-            {
-                stream.WriteFloat(channel.mScaleKeys[i].mTime);
-                stream.WriteVec3(channel.mScaleKeys[i].mValue);
-            }
+            stream.WriteArray32(channel.mScaleKeys.data(), uint32_t(channel.mScaleKeys.size()));
         }
 
         uint32_t numEventTracks = (uint32_t)animation.mEventTracks.size();
@@ -246,28 +274,13 @@ void SkeletalMesh::SaveStream(Stream& stream, Platform platform)
         }
     }
 
+    // Vertex and index data are written as contiguous blobs so they can be loaded with a single copy.
     OCT_ASSERT(mNumVertices == mVertices.size());
-    for (uint32_t i = 0; i < mNumVertices; ++i)
-    {
-        stream.WriteVec3(mVertices[i].mPosition);
-        stream.WriteVec2(mVertices[i].mTexcoord0);
-        //stream.WriteVec2(mVertices[i].mTexcoord1);
-        stream.WriteVec3(mVertices[i].mNormal);
-        stream.WriteUint8(mVertices[i].mBoneIndices[0]);
-        stream.WriteUint8(mVertices[i].mBoneIndices[1]);
-        stream.WriteUint8(mVertices[i].mBoneIndices[2]);
-        stream.WriteUint8(mVertices[i].mBoneIndices[3]);
-        stream.WriteFloat(mVertices[i].mBoneWeights[0]);
-        stream.WriteFloat(mVertices[i].mBoneWeights[1]);
-        stream.WriteFloat(mVertices[i].mBoneWeights[2]);
-        stream.WriteFloat(mVertices[i].mBoneWeights[3]);
-    }
+    stream.WritePadding(16);
+    stream.WriteArray32(mVertices.data(), mNumVertices);
 
     OCT_ASSERT(mNumIndices == mIndices.size());
-    for (uint32_t i = 0; i < mNumIndices; ++i)
-    {
-        stream.WriteUint32(mIndices[i]);
-    }
+    WriteIndexArray(stream, mIndices.data(), mNumIndices);
 
     stream.WriteVec3(mBounds.mCenter);
     stream.WriteFloat(mBounds.mRadius);
@@ -351,6 +364,34 @@ const char* SkeletalMesh::GetTypeName()
     return "SkeletalMesh";
 }
 
+uint64_t SkeletalMesh::GetCpuMemorySize()
+{
+    uint64_t size = mVertices.capacity() * sizeof(VertexSkinned) +
+        mIndices.capacity() * sizeof(IndexType) +
+        mBones.capacity() * sizeof(Bone) +
+        mBindPoseMatrices.capacity() * sizeof(glm::mat4);
+
+    for (uint32_t i = 0; i < mAnimations.size(); ++i)
+    {
+        const Animation& anim = mAnimations[i];
+
+        for (uint32_t c = 0; c < anim.mChannels.size(); ++c)
+        {
+            size += anim.mChannels[c].mPositionKeys.capacity() * sizeof(PositionKey) +
+                anim.mChannels[c].mRotationKeys.capacity() * sizeof(RotationKey) +
+                anim.mChannels[c].mScaleKeys.capacity() * sizeof(ScaleKey);
+        }
+    }
+
+    return size;
+}
+
+uint64_t SkeletalMesh::GetGpuMemorySize()
+{
+    return uint64_t(mNumVertices) * sizeof(VertexSkinned) +
+        uint64_t(mNumIndices) * sizeof(IndexType);
+}
+
 const char* SkeletalMesh::GetTypeImportExt()
 {
     return ".glb";
@@ -102,6 +102,8 @@ public:
     virtual void GatherProperties(std::vector<Property>& outProps) override;
     virtual glm::vec4 GetTypeColor() override;
     virtual const char* GetTypeName() override;
+    virtual uint64_t GetCpuMemorySize() override;
+    virtual uint64_t GetGpuMemorySize() override;
     virtual const char* GetTypeImportExt() override;
 
     class Material* GetMaterial();
@@ -143,6 +145,7 @@ private:
 
     void InitBindPose();
     void ComputeBounds();
+    void ReadLegacyVertexData(Stream& stream);
 
     MaterialRef mMaterial;
     SkeletalMeshRef mAnimationLookupMesh;
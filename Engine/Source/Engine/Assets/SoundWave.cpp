@@ -6,6 +6,7 @@
 #include "AudioManager.h"
 
 #include "Audio/Audio.h"
+#include "Audio/AudioConstants.h"
 #include "System/System.h"
 
 FORCE_LINK_DEF(SoundWave);
@@ -68,21 +69,38 @@ void SoundWave::LoadStream(Stream& stream, Platform platform)
 #if EDITOR
         // In Editor, we want to keep the compressed data around so in case we save the file again,
         // we won't be recompressing the sound a second time (adding more artifacts / distortion).
-        mCompressedData = new uint8_t[compressedSize];
-        mCompressedSize = compressedSize;
-        memcpy(mCompressedData, stream.GetData() + stream.GetPos(), compressedSize);
+        // The editor never streams, saving and the LQ console conversion need the decoded wave.
+        mStreamed = false;
+#else
+        // Long sounds like music are decoded a chunk at a time while they play instead.
+        uint32_t decodedSize = mNumSamples * (mBitsPerSample / 8);
+        mStreamed = (decodedSize > AUDIO_STREAMING_THRESHOLD) && AUD_CanStream(this);
+
+        if (mStreamed)
 #endif
+        {
+            mCompressedData = new uint8_t[compressedSize];
+            mCompressedSize = compressedSize;
+            memcpy(mCompressedData, stream.GetData() + stream.GetPos(), compressedSize);
+        }
 
-        Stream outStream;
-        PcmFormat format;
-        format.mBytesPerSample = (mBitsPerSample / 8);
-        format.mNumChannels = mNumChannels;
-        format.mSampleRate = mSampleRate;
-        AUD_DecodeVorbis(stream, outStream, format);
-
-        mWaveDataSize = outStream.GetSize();
-        mWaveData = AUD_AllocWaveBuffer(mWaveDataSize);
-        memcpy(mWaveData, outStream.GetData(), mWaveDataSize);
+        if (mStreamed)
+        {
+            stream.SetPos(stream.GetPos() + compressedSize);
+        }
+        else
+        {
+            Stream outStream;
+            PcmFormat format;
+            format.mBytesPerSample = (mBitsPerSample / 8);
+            format.mNumChannels = mNumChannels;
+            format.mSampleRate = mSampleRate;
+            AUD_DecodeVorbis(stream, outStream, format);
+
+            mWaveDataSize = outStream.GetSize();
+            mWaveData = AUD_AllocWaveBuffer(mWaveDataSize);
+            memcpy(mWaveData, outStream.GetData(), mWaveDataSize);
+        }
     }
     else
     {
@@ -95,7 +113,10 @@ void SoundWave::LoadStream(Stream& stream, Platform platform)
         }
     }
 
-    AUD_ProcessWaveBuffer(this);
+    if (!mStreamed)
+    {
+        AUD_ProcessWaveBuffer(this);
+    }
 }
 
 void SoundWave::SaveStream(Stream& stream, Platform platform)
@@ -286,9 +307,13 @@ void SoundWave::Destroy()
 {
     Asset::Destroy();
 
-    if (mWaveData != nullptr)
+    if (mWaveData != nullptr || mStreamed)
     {
         AudioManager::StopSounds(this);
+    }
+
+    if (mWaveData != nullptr)
+    {
         AUD_FreeWaveBuffer(mWaveData);
         mWaveData = nullptr;
     }
@@ -296,10 +321,12 @@ void SoundWave::Destroy()
     if (mCompressedData != nullptr)
     {
 #if !EDITOR
-        // We should only have compressed data in EDITOR.
-        OCT_ASSERT(0);
+        // Outside of EDITOR, only streamed sounds keep their compressed data.
+        OCT_ASSERT(mStreamed);
 #endif
-        delete mCompressedData;
+        delete [] mCompressedData;
+        mCompressedData = nullptr;
+        mCompressedSize = 0;
     }
 }
 
@@ -387,6 +414,18 @@ const char* SoundWave::GetTypeName()
     return "SoundWave";
 }
 
+uint64_t SoundWave::GetCpuMemorySize()
+{
+    // Streamed waves only keep their compressed data, plus a small buffer per playing voice.
+    return (mWaveData != nullptr ? mWaveDataSize : 0) +
+        (mCompressedData != nullptr ? mCompressedSize : 0);
+}
+
+uint64_t SoundWave::GetGpuMemorySize()
+{
+    return 0;
+}
+
 const char* SoundWave::GetTypeImportExt()
 {
     return ".wav";
@@ -445,6 +484,21 @@ uint32_t SoundWave::GetWaveDataSize() const
     return mWaveDataSize;
 }
 
+const uint8_t* SoundWave::GetCompressedData() const
+{
+    return mCompressedData;
+}
+
+uint32_t SoundWave::GetCompressedDataSize() const
+{
+    return mCompressedSize;
+}
+
+bool SoundWave::IsStreamed() const
+{
+    return mStreamed;
+}
+
 uint32_t SoundWave::GetNumChannels() const
 {
     return mNumChannels;
@@ -19,6 +19,8 @@ public:
     virtual void GatherProperties(std::vector<Property>& outProps) override;
     virtual glm::vec4 GetTypeColor() override;
     virtual const char* GetTypeName() override;
+    virtual uint64_t GetCpuMemorySize() override;
+    virtual uint64_t GetGpuMemorySize() override;
     virtual const char* GetTypeImportExt() override;
 
     void SetPcmData(uint8_t* data, uint32_t size, uint32_t numSamples, uint32_t bitsPerSample, uint32_t numChannels, uint32_t sampleRate);
@@ -34,6 +36,9 @@ public:
 
     uint8_t* GetWaveData() const;
     uint32_t GetWaveDataSize() const;
+    const uint8_t* GetCompressedData() const;
+    uint32_t GetCompressedDataSize() const;
+    bool IsStreamed() const;
     uint32_t GetNumChannels() const;
     uint32_t GetBitsPerSample() const;
     uint32_t GetSampleRate() const;
@@ -53,6 +58,9 @@ protected:
     uint8_t* mCompressedData = nullptr;
     uint32_t mCompressedSize = 0;
 
+    // Streamed sound waves only keep their compressed data, and have no wave data.
+    bool mStreamed = false;
+
     // Properties
     float mVolumeMultiplier = 1.0f;
     float mPitchMultiplier = 1.0f;
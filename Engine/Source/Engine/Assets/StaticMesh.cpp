@@ -4,6 +4,7 @@
 #include "AssetManager.h"
 #include "Utilities.h"
 #include "Log.h"
+#include "CollisionShapeCache.h"
 
 #include "Graphics/Graphics.h"
 
@@ -45,10 +46,14 @@ StaticMesh::StaticMesh() :
     mNumUvMaps(1),
     mVertices(nullptr),
     mIndices(nullptr),
+    mUvDensity(0.0f),
     mCollisionShape(nullptr),
     mTriangleCollisionShape(nullptr),
     mTriangleIndexVertexArray(nullptr),
     mTriangleInfoMap(nullptr),
+    mTriangleBvhData(nullptr),
+    mTriangleBvhSize(0),
+    mTriangleBvh(nullptr),
     mGenerateTriangleCollisionMesh(false),
     mHasVertexColor(false)
 {
@@ -112,35 +117,58 @@ void StaticMesh::LoadStream(Stream& stream, Platform platform)
     mHasVertexColor = stream.ReadBool();
 
     ResizeVertexArray(mNumVertices);
+    ResizeIndexArray(mNumIndices);
 
-    if (mHasVertexColor)
+    if (mVersion >= ASSET_VERSION_BULK_ARRAYS)
     {
-        VertexColor* vertices = GetColorVertices();
-        for (uint32_t i = 0; i < mNumVertices; ++i)
+        stream.ReadPadding(16);
+
+        if (mHasVertexColor)
         {
-            vertices[i].mPosition = stream.ReadVec3();
-            vertices[i].mTexcoord0 = stream.ReadVec2();
-            vertices[i].mTexcoord1 = stream.ReadVec2();
-            vertices[i].mNormal = stream.ReadVec3();
-            vertices[i].mColor = stream.ReadUint32();
+            stream.ReadArray32(GetColorVertices(), mNumVertices);
         }
+        else
+        {
+            stream.ReadArray32(GetVertices(), mNumVertices);
+        }
+
+        ReadIndexArray(stream, mIndices, mNumIndices);
     }
     else
     {
-        Vertex* vertices = GetVertices();
-        for (uint32_t i = 0; i < mNumVertices; ++i)
+        if (mHasVertexColor)
         {
-            vertices[i].mPosition = stream.ReadVec3();
-            vertices[i].mTexcoord0 = stream.ReadVec2();
-            vertices[i].mTexcoord1 = stream.ReadVec2();
-            vertices[i].mNormal = stream.ReadVec3();
+            VertexColor* vertices = GetColorVertices();
+            for (uint32_t i = 0; i < mNumVertices; ++i)
+            {
+                vertices[i].mPosition = stream.ReadVec3();
+                vertices[i].mTexcoord0 = stream.ReadVec2();
+                vertices[i].mTexcoord1 = stream.ReadVec2();
+                vertices[i].mNormal = stream.ReadVec3();
+                vertices[i].mColor = stream.ReadUint32();
+            }
+        }
+        else
+        {
+            Vertex* vertices = GetVertices();
+            for (uint32_t i = 0; i < mNumVertices; ++i)
+            {
+                vertices[i].mPosition = stream.ReadVec3();
+                vertices[i].mTexcoord0 = stream.ReadVec2();
+                vertices[i].mTexcoord1 = stream.ReadVec2();
+                vertices[i].mNormal = stream.ReadVec3();
+            }
+        }
+
+        for (uint32_t i = 0; i < mNumIndices; ++i)
+        {
+            mIndices[i] = (IndexType) stream.ReadUint32();
         }
     }
 
-    ResizeIndexArray(mNumIndices);
-    for (uint32_t i = 0; i < mNumIndices; ++i)
+    if (mVersion >= ASSET_VERSION_TRIANGLE_BVH)
     {
-        mIndices[i] = (IndexType) stream.ReadUint32();
+        ReadTriangleBvh(stream);
     }
 
     // Collision shapes
@@ -230,34 +258,21 @@ void StaticMesh::SaveStream(Stream& stream, Platform platform)
     stream.WriteBool(mGenerateTriangleCollisionMesh);
     stream.WriteBool(mHasVertexColor);
 
+    // Vertex and index data are written as contiguous blobs so they can be loaded with a single copy.
+    stream.WritePadding(16);
+
     if (mHasVertexColor)
     {
-        VertexColor* vertices = GetColorVertices();
-        for (uint32_t i = 0; i < mNumVertices; ++i)
-        {
-            stream.WriteVec3(vertices[i].mPosition);
-            stream.WriteVec2(vertices[i].mTexcoord0);
-            stream.WriteVec2(vertices[i].mTexcoord1);
-            stream.WriteVec3(vertices[i].mNormal);
-            stream.WriteUint32(vertices[i].mColor);
-        }
+        stream.WriteArray32(GetColorVertices(), mNumVertices);
     }
     else
     {
-        Vertex* vertices = GetVertices();
-        for (uint32_t i = 0; i < mNumVertices; ++i)
-        {
-            stream.WriteVec3(vertices[i].mPosition);
-            stream.WriteVec2(vertices[i].mTexcoord0);
-            stream.WriteVec2(vertices[i].mTexcoord1);
-            stream.WriteVec3(vertices[i].mNormal);
-        }
+        stream.WriteArray32(GetVertices(), mNumVertices);
     }
 
-    for (uint32_t i = 0; i < mNumIndices; ++i)
-    {
-        stream.WriteUint32(mIndices[i]);
-    }
+    WriteIndexArray(stream, mIndices, mNumIndices);
+
+    WriteTriangleBvh(stream, platform);
 
     // Collision shapes
     uint32_t numCollisionShapes = 0;
@@ -359,6 +374,8 @@ void StaticMesh::Create()
     Asset::Create();
 
     OCT_ASSERT(mNumVertices <= MAX_MESH_VERTEX_COUNT); // Vertex index must fit into IndexType width.
+    ComputeUvDensity();
+
     GFX_CreateStaticMeshResource(
         this,
         mHasVertexColor,
@@ -389,6 +406,7 @@ void StaticMesh::Destroy()
 
     if (mCollisionShape != nullptr)
     {
+        CollisionShapeCache::Get()->Invalidate(mCollisionShape);
         DestroyCollisionShape(mCollisionShape);
         mCollisionShape = nullptr;
     }
@@ -485,6 +503,20 @@ const char* StaticMesh::GetTypeName()
     return "StaticMesh";
 }
 
+uint64_t StaticMesh::GetCpuMemorySize()
+{
+    // The vertex and index arrays stay in system memory for collision.
+    return uint64_t(mNumVertices) * GetVertexSize() +
+        uint64_t(mNumIndices) * sizeof(IndexType) +
+        mTriangleBvhSize;
+}
+
+uint64_t StaticMesh::GetGpuMemorySize()
+{
+    return uint64_t(mNumVertices) * GetVertexSize() +
+        uint64_t(mNumIndices) * sizeof(IndexType);
+}
+
 const char* StaticMesh::GetTypeImportExt()
 {
     return ".dae";
@@ -532,6 +564,11 @@ Bounds StaticMesh::GetBounds() const
     return mBounds;
 }
 
+float StaticMesh::GetUvDensity() const
+{
+    return mUvDensity;
+}
+
 btBvhTriangleMeshShape* StaticMesh::GetTriangleCollisionShape()
 {
     return mGenerateTriangleCollisionMesh ? mTriangleCollisionShape : nullptr;
@@ -546,6 +583,7 @@ void StaticMesh::SetCollisionShape(btCollisionShape* shape)
 {
     if (mCollisionShape != nullptr)
     {
+        CollisionShapeCache::Get()->Invalidate(mCollisionShape);
         delete mCollisionShape;
         mCollisionShape = nullptr;
     }
@@ -647,7 +685,29 @@ void StaticMesh::CreateTriangleCollisionShape()
     btVector3 aabbMin(-1000, -1000, -1000);
     btVector3 aabbMax( 1000,  1000,  1000);
 
-    mTriangleCollisionShape = new btBvhTriangleMeshShape(mTriangleIndexVertexArray, useQuantizedAabbCompression, aabbMin, aabbMax);
+    if (mTriangleBvhData != nullptr)
+    {
+        OCT_ASSERT(mTriangleBvh == nullptr);
+        mTriangleBvh = btOptimizedBvh::deSerializeInPlace(mTriangleBvhData, mTriangleBvhSize, false);
+
+        if (mTriangleBvh == nullptr)
+        {
+            LogWarning("Invalid triangle collision BVH in %s. Rebuilding.", mName.c_str());
+            FreeTriangleBvhData();
+        }
+    }
+
+    if (mTriangleBvh != nullptr)
+    {
+        // Skip the build and reference the cooked BVH. The shape does not take ownership of it.
+        mTriangleCollisionShape = new btBvhTriangleMeshShape(mTriangleIndexVertexArray, useQuantizedAabbCompression, aabbMin, aabbMax, false);
+        mTriangleCollisionShape->setOptimizedBvh(mTriangleBvh);
+    }
+    else
+    {
+        mTriangleCollisionShape = new btBvhTriangleMeshShape(mTriangleIndexVertexArray, useQuantizedAabbCompression, aabbMin, aabbMax);
+    }
+
     mTriangleInfoMap = new btTriangleInfoMap();
     btGenerateInternalEdgeInfo(mTriangleCollisionShape, mTriangleInfoMap);
 }
@@ -662,6 +722,7 @@ void StaticMesh::DestroyTriangleCollisionShape()
 
     if (mTriangleCollisionShape != nullptr)
     {
+        CollisionShapeCache::Get()->Invalidate(mTriangleCollisionShape);
         delete mTriangleCollisionShape;
         mTriangleCollisionShape = nullptr;
     }
@@ -671,6 +732,79 @@ void StaticMesh::DestroyTriangleCollisionShape()
         delete mTriangleIndexVertexArray;
         mTriangleIndexVertexArray = nullptr;
     }
+
+    // Any edit that rebuilds the shape should not reuse a stale cooked BVH.
+    FreeTriangleBvhData();
+}
+
+void StaticMesh::ReadTriangleBvh(Stream& stream)
+{
+    OCT_ASSERT(mTriangleBvhData == nullptr);
+
+    bool hasBvh = stream.ReadBool();
+
+    if (hasBvh)
+    {
+        uint32_t bvhClassSize = stream.ReadUint32();
+        uint32_t bvhSize = stream.ReadUint32();
+        stream.ReadPadding(16);
+
+        // The BVH is a raw memory image, so it is only usable if it was cooked with a matching layout.
+        if (mGenerateTriangleCollisionMesh &&
+            bvhClassSize == sizeof(btOptimizedBvh))
+        {
+            mTriangleBvhData = (uint8_t*)btAlignedAlloc(bvhSize, 16);
+            mTriangleBvhSize = bvhSize;
+            stream.ReadBytes(mTriangleBvhData, bvhSize);
+        }
+        else
+        {
+            stream.SetPos(stream.GetPos() + bvhSize);
+        }
+    }
+}
+
+void StaticMesh::WriteTriangleBvh(Stream& stream, Platform platform)
+{
+    btOptimizedBvh* bvh = (mTriangleCollisionShape != nullptr) ? mTriangleCollisionShape->getOptimizedBvh() : nullptr;
+
+    // Big endian console builds rebuild the BVH at load time instead.
+    bool writeBvh = bvh != nullptr &&
+        platform != Platform::GameCube &&
+        platform != Platform::Wii &&
+        platform != Platform::N3DS;
+
+    stream.WriteBool(writeBvh);
+
+    if (writeBvh)
+    {
+        uint32_t bvhSize = bvh->calculateSerializeBufferSize();
+        uint8_t* bvhData = (uint8_t*)btAlignedAlloc(bvhSize, 16);
+        bvh->serialize(bvhData, bvhSize, false);
+
+        stream.WriteUint32(uint32_t(sizeof(btOptimizedBvh)));
+        stream.WriteUint32(bvhSize);
+        stream.WritePadding(16);
+        stream.WriteBytes(bvhData, bvhSize);
+
+        btAlignedFree(bvhData);
+    }
+}
+
+void StaticMesh::FreeTriangleBvhData()
+{
+    if (mTriangleBvh != nullptr)
+    {
+        mTriangleBvh->~btOptimizedBvh();
+        mTriangleBvh = nullptr;
+    }
+
+    if (mTriangleBvhData != nullptr)
+    {
+        btAlignedFree(mTriangleBvhData);
+        mTriangleBvhData = nullptr;
+        mTriangleBvhSize = 0;
+    }
 }
 
 void StaticMesh::ResizeVertexArray(uint32_t newSize)
@@ -708,6 +842,34 @@ void StaticMesh::ResizeIndexArray(uint32_t newSize)
     }
 }
 
+void StaticMesh::ComputeUvDensity()
+{
+    bool hasColor = HasVertexColor();
+    double uvArea = 0.0;
+    double area = 0.0;
+
+    for (uint32_t i = 0; i + 2 < mNumIndices; i += 3)
+    {
+        glm::vec3 pos[3];
+        glm::vec2 uv[3];
+
+        for (uint32_t v = 0; v < 3; ++v)
+        {
+            IndexType index = mIndices[i + v];
+            pos[v] = hasColor ? GetColorVertices()[index].mPosition : GetVertices()[index].mPosition;
+            uv[v] = hasColor ? GetColorVertices()[index].mTexcoord0 : GetVertices()[index].mTexcoord0;
+        }
+
+        glm::vec2 uvEdge0 = uv[1] - uv[0];
+        glm::vec2 uvEdge1 = uv[2] - uv[0];
+
+        area += 0.5 * glm::length(glm::cross(pos[1] - pos[0], pos[2] - pos[0]));
+        uvArea += 0.5 * fabs(uvEdge0.x * uvEdge1.y - uvEdge0.y * uvEdge1.x);
+    }
+
+    mUvDensity = (area > 0.0) ? float(sqrt(uvArea / area)) : 0.0f;
+}
+
 void StaticMesh::ComputeBounds()
 {
     if (mNumVertices == 0)
@@ -40,6 +40,8 @@ public:
     virtual void GatherProperties(std::vector<Property>& outProps) override;
     virtual glm::vec4 GetTypeColor() override;
     virtual const char* GetTypeName() override;
+    virtual uint64_t GetCpuMemorySize() override;
+    virtual uint64_t GetGpuMemorySize() override;
     virtual const char* GetTypeImportExt() override;
 
     class Material* GetMaterial();
@@ -56,6 +58,9 @@ public:
 
     Bounds GetBounds() const;
 
+    // Average UV units per object space unit on the first UV map. Used to pick texture mips.
+    float GetUvDensity() const;
+
     btBvhTriangleMeshShape* GetTriangleCollisionShape();
     btCollisionShape* GetCollisionShape();
     void SetCollisionShape(btCollisionShape* shape);
@@ -71,11 +76,15 @@ private:
 
     void CreateTriangleCollisionShape();
     void DestroyTriangleCollisionShape();
+    void ReadTriangleBvh(Stream& stream);
+    void WriteTriangleBvh(Stream& stream, Platform platform);
+    void FreeTriangleBvhData();
 
     void ResizeVertexArray(uint32_t newSize);
     void ResizeIndexArray(uint32_t newSize);
 
     void ComputeBounds();
+    void ComputeUvDensity();
 
     MaterialRef mMaterial;
     uint32_t mNumVertices;
@@ -86,11 +95,17 @@ private:
     IndexType* mIndices;
 
     Bounds mBounds;
+    float mUvDensity;
 
     btCollisionShape* mCollisionShape;
     btBvhTriangleMeshShape* mTriangleCollisionShape;
     btTriangleIndexVertexArray* mTriangleIndexVertexArray;
     btTriangleInfoMap* mTriangleInfoMap;
+
+    // Cooked BVH loaded from the asset. The optimized BVH is deserialized in place inside this buffer.
+    uint8_t* mTriangleBvhData;
+    uint32_t mTriangleBvhSize;
+    btOptimizedBvh* mTriangleBvh;
     bool mGenerateTriangleCollisionMesh;
     bool mHasVertexColor;
 
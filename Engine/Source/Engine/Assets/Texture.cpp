@@ -24,16 +24,29 @@ static const char* sPixelFormatEnumStrings[] =
     "RGB565",
     "RGBA8",
     "CMPR",
-    "RGBA5551"
+    "RGBA5551",
+    "BC3",
+    "BC5",
+    "BC7"
 };
 static_assert(
     uint32_t(PixelFormat::LA4) == 0 &&
     uint32_t(PixelFormat::RGB565) == 1 &&
     uint32_t(PixelFormat::RGBA8) == 2 &&
     uint32_t(PixelFormat::CMPR) == 3 &&
-    uint32_t(PixelFormat::RGBA5551) == 4,
+    uint32_t(PixelFormat::RGBA5551) == 4 &&
+    uint32_t(PixelFormat::BC3) == 5 &&
+    uint32_t(PixelFormat::BC5) == 6 &&
+    uint32_t(PixelFormat::BC7) == 7,
     "Need to update texture asset format string table");
 
+static const char* sCompressionQualityEnumStrings[] =
+{
+    "Fast",
+    "High"
+};
+static_assert(uint32_t(TextureCompressionQuality::Count) == 2, "Need to update compression quality enum string table");
+
 static const char* sFilterEnumStrings[] =
 {
     "Nearest",
@@ -105,6 +118,58 @@ bool UseCookedTextures(Platform platform)
     return cook;
 }
 
+// The pixel format that cooked texture data is stored in for the given platform.
+// Desktop GPUs sample BCn formats directly. Android keeps RGBA8 until there is an ETC2 encoder.
+PixelFormat GetCookedDataFormat(PixelFormat format, Platform platform)
+{
+    PixelFormat dataFormat = PixelFormat::RGBA8;
+
+    if ((platform == Platform::Windows || platform == Platform::Linux) &&
+        IsBlockCompressedFormat(format))
+    {
+        dataFormat = format;
+    }
+
+    return dataFormat;
+}
+
+void CookTextureMips(Texture* texture, Platform platform, const std::vector<uint8_t>& srcPixels, PixelFormat& outFormat, uint32_t& outMipLevels, std::vector<uint8_t>& outData)
+{
+#if EDITOR
+    uint32_t width = texture->GetWidth();
+    uint32_t height = texture->GetHeight();
+
+    outFormat = GetCookedDataFormat(texture->GetFormat(), platform);
+    outMipLevels = 1;
+
+    if (texture->IsMipmapped() &&
+        texture->GetLayers() == 1)
+    {
+        outMipLevels = texture->GetMipLevels();
+    }
+
+    // Mips are generated here instead of on the GPU at load time. Block compressed
+    // formats can't be blitted, so they need the whole chain anyway.
+    std::vector<uint8_t> mips;
+    GenerateMipChain(srcPixels.data(), width, height, outMipLevels, mips);
+
+    if (outFormat == PixelFormat::RGBA8)
+    {
+        outData.swap(mips);
+        return;
+    }
+
+    uint32_t mipOffset = 0;
+    for (uint32_t i = 0; i < outMipLevels; ++i)
+    {
+        uint32_t mipWidth = GetMipDimension(width, i);
+        uint32_t mipHeight = GetMipDimension(height, i);
+        EncodeTexture(outFormat, mips.data() + mipOffset, mipWidth, mipHeight, texture->GetCompressionQuality(), outData);
+        mipOffset += GetTextureDataSize(PixelFormat::RGBA8, mipWidth, mipHeight);
+    }
+#endif
+}
+
 void CookTexture(Texture* texture, Platform platform, const std::vector<uint8_t>& srcPixels, std::vector<uint8_t>& outData)
 {
 #if EDITOR
@@ -138,6 +203,13 @@ void CookTexture(Texture* texture, Platform platform, const std::vector<uint8_t>
     // (2) Exec platform-specific texture converter with relevant args, and output to another temp file in Intermediate.
     std::string cookCmd = "";
 
+    // The desktop BCn formats use each platform's own compressed format.
+    PixelFormat format = texture->GetFormat();
+    if (IsBlockCompressedFormat(format))
+    {
+        format = PixelFormat::CMPR;
+    }
+
     switch (platform)
     {
     case Platform::GameCube:
@@ -155,8 +227,6 @@ void CookTexture(Texture* texture, Platform platform, const std::vector<uint8_t>
         cookCmd += outPath.c_str();
         cookCmd += " colfmt=";
 
-        PixelFormat format = texture->GetFormat();
-
         // Alpha doesn't seem to be working with CMPR textures with gxtexconv, but I think
         // the CMPR does support 1 bit alpha. So I'm not sure what the problem is, but for now we can use a slightly
         // more compressed format for these.
@@ -211,7 +281,7 @@ void CookTexture(Texture* texture, Platform platform, const std::vector<uint8_t>
         cookCmd += outPath.c_str();
         cookCmd += " -f ";
 
-        switch (texture->GetFormat())
+        switch (format)
         {
         case PixelFormat::LA4: cookCmd += "la4"; break;
         case PixelFormat::RGB565: cookCmd += "rgb565"; break;
@@ -257,8 +327,11 @@ Texture::Texture() :
     mFormat(PixelFormat::RGBA8),
     mFilterType(FilterType::Linear),
     mWrapMode(WrapMode::Repeat),
+    mCompressionQuality(TextureCompressionQuality::High),
     mMipmapped(true),
-    mRenderTarget(false)
+    mRenderTarget(false),
+    mDataFormat(PixelFormat::RGBA8),
+    mDataMipLevels(1)
 {
     mType = Texture::GetStaticType();
 }
@@ -288,12 +361,29 @@ void Texture::LoadStream(Stream& stream, Platform platform)
     mMipmapped = stream.ReadBool();
     mRenderTarget = stream.ReadBool();
 
+    mDataFormat = PixelFormat::RGBA8;
+    mDataMipLevels = 1;
+
+    if (mVersion >= ASSET_VERSION_TEXTURE_MIPS)
+    {
+        mCompressionQuality = (TextureCompressionQuality)stream.ReadUint32();
+    }
+
     if (UseCookedTextures(platform))
     {
         uint32_t cookedDataSize = stream.ReadUint32();
         mPixels.resize(cookedDataSize);
         stream.ReadBytes(mPixels.data(), cookedDataSize);
     }
+    else if (mVersion >= ASSET_VERSION_TEXTURE_MIPS)
+    {
+        mDataFormat = (PixelFormat)stream.ReadUint32();
+        mDataMipLevels = stream.ReadUint32();
+
+        uint32_t dataSize = stream.ReadUint32();
+        mPixels.resize(dataSize);
+        stream.ReadBytes(mPixels.data(), dataSize);
+    }
     else
     {
         int32_t size = (mWidth * mHeight * RGBA8_SIZE);
@@ -323,6 +413,10 @@ void Texture::SaveStream(Stream& stream, Platform platform)
 
     stream.WriteBool(mMipmapped);
     stream.WriteBool(mRenderTarget);
+    stream.WriteUint32(uint32_t(mCompressionQuality));
+
+    OCT_ASSERT(mDataFormat == PixelFormat::RGBA8);
+    OCT_ASSERT(mPixels.size() == (mWidth * mHeight * RGBA8_SIZE));
 
     if (UseCookedTextures(platform))
     {
@@ -332,14 +426,25 @@ void Texture::SaveStream(Stream& stream, Platform platform)
         stream.WriteUint32(cookedDataSize);
         stream.WriteBytes(cookedData.data(), cookedDataSize);
     }
+    else if (platform == Platform::Count)
+    {
+        // Source assets keep the raw RGBA8 pixels so they can be edited and recooked without loss.
+        stream.WriteUint32(uint32_t(PixelFormat::RGBA8));
+        stream.WriteUint32(1);
+        stream.WriteUint32((uint32_t)mPixels.size());
+        stream.WriteBytes(mPixels.data(), (uint32_t)mPixels.size());
+    }
     else
     {
-        // If not using an custom formats, just write out the raw RGBA8 pixels, uncompressed.
-        OCT_ASSERT(mPixels.size() == (mWidth * mHeight * RGBA8_SIZE));
-        for (int32_t i = 0; i < int32_t(mPixels.size()); ++i)
-        {
-            stream.WriteUint8(mPixels[i]);
-        }
+        PixelFormat dataFormat = PixelFormat::RGBA8;
+        uint32_t dataMipLevels = 1;
+        std::vector<uint8_t> cookedData;
+        CookTextureMips(this, platform, mPixels, dataFormat, dataMipLevels, cookedData);
+
+        stream.WriteUint32(uint32_t(dataFormat));
+        stream.WriteUint32(dataMipLevels);
+        stream.WriteUint32((uint32_t)cookedData.size());
+        stream.WriteBytes(cookedData.data(), (uint32_t)cookedData.size());
     }
 #endif
 }
@@ -348,14 +453,38 @@ void Texture::Create()
 {
     Asset::Create();
 
+    Renderer* renderer = Renderer::Get();
+    TextureStreamer* streamer = (renderer != nullptr) ? renderer->GetTextureStreamer() : nullptr;
+
+    mStreamingState = TextureStreamingState();
+
+    if (streamer != nullptr &&
+        mPixels.size() > 0 &&
+        streamer->CanStream(this))
+    {
+        // Start out with only the low mips, the streamer brings in the rest once they're needed.
+        mStreamingState.mStreamed = true;
+        mStreamingState.mMinResidentMip = ComputeStreamingMinMip(mWidth, mHeight, mMipLevels);
+        mStreamingState.mResidentMip = mStreamingState.mMinResidentMip;
+    }
+
     GFX_CreateTextureResource(this, mPixels);
 
+    if (mStreamingState.mStreamed)
+    {
+        streamer->AddTexture(this);
+    }
+
 #if !EDITOR
     // This pixel data is transferred to the GPU resource in GFX_CreateTextureResource(), so now 
     // we can clear the mPixels vector and shrink it so to free memory.
     // Keep copy of pixels when in editor so they can be saved without reading from the texture.
-    mPixels.clear();
-    mPixels.shrink_to_fit();
+    // Streamed textures keep their mip chain so mips can be uploaded again after being dropped.
+    if (!mStreamingState.mStreamed)
+    {
+        mPixels.clear();
+        mPixels.shrink_to_fit();
+    }
 #endif
 }
 
@@ -363,6 +492,17 @@ void Texture::Destroy()
 {
     Asset::Destroy();
 
+    if (mStreamingState.mStreamed)
+    {
+        Renderer* renderer = Renderer::Get();
+        if (renderer != nullptr)
+        {
+            renderer->GetTextureStreamer()->RemoveTexture(this);
+        }
+
+        mStreamingState.mStreamed = false;
+    }
+
     GFX_DestroyTextureResource(this);
 }
 
@@ -393,6 +533,8 @@ void Texture::Import(const std::string& path, ImportOptions* options)
     mWidth = texWidth;
     mHeight = texHeight;
     mFormat = format;
+    mDataFormat = PixelFormat::RGBA8;
+    mDataMipLevels = 1;
     mRenderTarget = false;
     mMipmapped = true;
     mMipLevels = mMipmapped ? static_cast<int32_t>(floor(log2(std::max(mWidth, mHeight))) + 1) : 1;
@@ -408,6 +550,16 @@ void Texture::Import(const std::string& path, ImportOptions* options)
                 mMipLevels = 1;
             }
         }
+
+        if (options->HasOption("format"))
+        {
+            mFormat = (PixelFormat)int32_t(options->GetOptionValue("format"));
+        }
+
+        if (options->HasOption("compressionQuality"))
+        {
+            mCompressionQuality = (TextureCompressionQuality)int32_t(options->GetOptionValue("compressionQuality"));
+        }
     }
 
     Create();
@@ -421,7 +573,8 @@ void Texture::GatherProperties(std::vector<Property>& outProps)
     Asset::GatherProperties(outProps);
 
     outProps.push_back(Property(DatumType::Bool, "Mipmapped", this, &mMipmapped));
-    outProps.push_back(Property(DatumType::Integer, "Format", this, &mFormat, 1, Texture::HandlePropChange, 0, 5, sPixelFormatEnumStrings));
+    outProps.push_back(Property(DatumType::Integer, "Format", this, &mFormat, 1, Texture::HandlePropChange, 0, int32_t(PixelFormat::BC7) + 1, sPixelFormatEnumStrings));
+    outProps.push_back(Property(DatumType::Integer, "Compression Quality", this, &mCompressionQuality, 1, Texture::HandlePropChange, 0, int32_t(TextureCompressionQuality::Count), sCompressionQualityEnumStrings));
     outProps.push_back(Property(DatumType::Integer, "Filter Type", this, &mFilterType, 1, Texture::HandlePropChange, 0, int32_t(FilterType::Count), sFilterEnumStrings));
     outProps.push_back(Property(DatumType::Integer, "Wrap Mode", this, &mWrapMode, 1, Texture::HandlePropChange, 0, int32_t(WrapMode::Count), sWrapEnumStrings));
 }
@@ -436,6 +589,17 @@ const char* Texture::GetTypeName()
     return "Texture";
 }
 
+uint64_t Texture::GetCpuMemorySize()
+{
+    return mPixels.capacity();
+}
+
+uint64_t Texture::GetGpuMemorySize()
+{
+    PixelFormat format = mRenderTarget ? mFormat : GetDataFormat();
+    return uint64_t(ComputeMipChainSize(format, mWidth, mHeight, GetResidentMip(), mMipLevels)) * mLayers;
+}
+
 const char* Texture::GetTypeImportExt()
 {
     return ".png";
@@ -449,6 +613,8 @@ void Texture::Init(uint32_t width, uint32_t height, uint8_t* data)
 
     mWidth = width;
     mHeight = height;
+    mDataFormat = PixelFormat::RGBA8;
+    mDataMipLevels = 1;
     
     uint32_t imageSize = width * height * 4;
     mPixels.resize(imageSize);
@@ -504,3 +670,45 @@ WrapMode Texture::GetWrapMode() const
 {
     return mWrapMode;
 }
+
+TextureCompressionQuality Texture::GetCompressionQuality() const
+{
+    return mCompressionQuality;
+}
+
+PixelFormat Texture::GetDataFormat() const
+{
+    return mDataFormat;
+}
+
+uint32_t Texture::GetDataMipLevels() const
+{
+    return mDataMipLevels;
+}
+
+bool Texture::IsStreamed() const
+{
+    return mStreamingState.mStreamed;
+}
+
+uint32_t Texture::GetResidentMip() const
+{
+    return mStreamingState.mStreamed ? mStreamingState.mResidentMip : 0;
+}
+
+void Texture::SetResidentMip(uint32_t mip)
+{
+    OCT_ASSERT(mStreamingState.mStreamed);
+    mip = glm::min(mip, mMipLevels - 1);
+
+    if (mip != mStreamingState.mResidentMip)
+    {
+        mStreamingState.mResidentMip = mip;
+        GFX_UpdateTextureResourceMips(this, mPixels);
+    }
+}
+
+TextureStreamingState& Texture::GetStreamingState()
+{
+    return mStreamingState;
+}
@@ -3,6 +3,8 @@
 #include <string>
 #include "glm/glm.hpp"
 #include "Asset.h"
+#include "TextureCompression.h"
+#include "TextureStreaming.h"
 
 #include "Graphics/GraphicsTypes.h"
 
@@ -27,6 +29,8 @@ public:
     virtual void GatherProperties(std::vector<Property>& outProps) override;
     virtual glm::vec4 GetTypeColor() override;
     virtual const char* GetTypeName() override;
+    virtual uint64_t GetCpuMemorySize() override;
+    virtual uint64_t GetGpuMemorySize() override;
     virtual const char* GetTypeImportExt() override;
 
     void Init(uint32_t width, uint32_t height, uint8_t* data);
@@ -42,6 +46,20 @@ public:
     PixelFormat GetFormat() const;
     FilterType GetFilterType() const;
     WrapMode GetWrapMode() const;
+    TextureCompressionQuality GetCompressionQuality() const;
+
+    // Format and number of mip levels of the data passed to GFX_CreateTextureResource().
+    // In editor this is always a single RGBA8 level. Cooked desktop textures carry their full
+    // mip chain, block compressed if mFormat is one of the BCn formats.
+    PixelFormat GetDataFormat() const;
+    uint32_t GetDataMipLevels() const;
+
+    // Streamed textures keep their cooked mip chain in system memory and only have mips
+    // [GetResidentMip(), GetMipLevels()) on the GPU. Non-streamed textures are always fully resident.
+    bool IsStreamed() const;
+    uint32_t GetResidentMip() const;
+    void SetResidentMip(uint32_t mip);
+    TextureStreamingState& GetStreamingState();
 
     static bool HandlePropChange(class Datum* datum, uint32_t index, const void* newValue);
 
@@ -54,11 +72,17 @@ protected:
     PixelFormat mFormat;
     FilterType mFilterType;
     WrapMode mWrapMode;
+    TextureCompressionQuality mCompressionQuality;
     bool mMipmapped;
     bool mRenderTarget;
 
+    PixelFormat mDataFormat;
+    uint32_t mDataMipLevels;
+
+    TextureStreamingState mStreamingState;
+
     // This pixel array is used as an intermediate storage between LoadStream() and Create()
-    // It is cleared and shrunk within Create() except when compiled for EDITOR
+    // It is cleared and shrunk within Create() except when compiled for EDITOR or when streamed
     std::vector<uint8_t> mPixels;
 
     // Graphics Resource
@@ -0,0 +1,100 @@
+#include "CollisionLayers.h"
+#include "Assertion.h"
+
+#include <glm/glm.hpp>
+
+CollisionLayers::CollisionLayers()
+{
+    Reset();
+}
+
+void CollisionLayers::Reset()
+{
+    for (uint32_t i = 0; i < MAX_COLLISION_LAYERS; ++i)
+    {
+        mLayerMasks[i] = 0xffffffff;
+    }
+
+    mAllLayersInteract = true;
+}
+
+void CollisionLayers::SetLayerMask(uint32_t layer, uint32_t mask)
+{
+    OCT_ASSERT(layer < MAX_COLLISION_LAYERS);
+
+    if (layer < MAX_COLLISION_LAYERS)
+    {
+        mLayerMasks[layer] = mask;
+        UpdateAllLayersInteract();
+    }
+}
+
+uint32_t CollisionLayers::GetLayerMask(uint32_t layer) const
+{
+    OCT_ASSERT(layer < MAX_COLLISION_LAYERS);
+    return (layer < MAX_COLLISION_LAYERS) ? mLayerMasks[layer] : 0;
+}
+
+void CollisionLayers::SetLayersInteract(uint32_t layerA, uint32_t layerB, bool interact)
+{
+    OCT_ASSERT(layerA < MAX_COLLISION_LAYERS && layerB < MAX_COLLISION_LAYERS);
+
+    if (layerA < MAX_COLLISION_LAYERS &&
+        layerB < MAX_COLLISION_LAYERS)
+    {
+        uint32_t bitA = (1u << layerA);
+        uint32_t bitB = (1u << layerB);
+
+        mLayerMasks[layerA] = interact ? (mLayerMasks[layerA] | bitB) : (mLayerMasks[layerA] & ~bitB);
+        mLayerMasks[layerB] = interact ? (mLayerMasks[layerB] | bitA) : (mLayerMasks[layerB] & ~bitA);
+        UpdateAllLayersInteract();
+    }
+}
+
+uint32_t CollisionLayers::GetGroupInteractionMask(uint32_t group) const
+{
+    uint32_t mask = 0;
+
+    while (group != 0)
+    {
+        int32_t layer = glm::findLSB(group);
+        mask |= mLayerMasks[layer];
+        group &= (group - 1);
+    }
+
+    return mask;
+}
+
+bool CollisionLayers::DoGroupsInteract(uint32_t groupA, uint32_t groupB) const
+{
+    if (mAllLayersInteract)
+        return true;
+
+    return (GetGroupInteractionMask(groupA) & groupB) != 0 &&
+        (GetGroupInteractionMask(groupB) & groupA) != 0;
+}
+
+void CollisionLayers::UpdateAllLayersInteract()
+{
+    mAllLayersInteract = true;
+
+    for (uint32_t i = 0; i < MAX_COLLISION_LAYERS; ++i)
+    {
+        if (mLayerMasks[i] != 0xffffffff)
+        {
+            mAllLayersInteract = false;
+            break;
+        }
+    }
+}
+
+uint32_t WidenLegacyCollisionMask(uint32_t mask)
+{
+    return (mask == 0xff) ? 0xffffffff : mask;
+}
+
+CollisionLayers& GetProjectCollisionLayers()
+{
+    static CollisionLayers sProjectLayers;
+    return sProjectLayers;
+}
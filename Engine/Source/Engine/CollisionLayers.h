@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stdint.h>
+
+#define MAX_COLLISION_LAYERS 32
+
+// Collision layer interaction matrix.
+// Each primitive's collision group is a bitmask of the layers it belongs to. Row N of the matrix
+// is the set of layers that layer N is willing to interact with. A pair of primitives only
+// interacts if each side's rows accept the other side's layers, so a rule only needs to be set
+// on one layer to veto the pair (rows don't need to be symmetric).
+// Every World owns a matrix that starts as a copy of the project matrix. It is applied when
+// Bullet creates broadphase pairs, so changes only affect new pairs.
+class CollisionLayers
+{
+public:
+
+    CollisionLayers();
+
+    void Reset();
+
+    void SetLayerMask(uint32_t layer, uint32_t mask);
+    uint32_t GetLayerMask(uint32_t layer) const;
+    void SetLayersInteract(uint32_t layerA, uint32_t layerB, bool interact);
+
+    // Combined row mask for every layer set in the group bitmask.
+    uint32_t GetGroupInteractionMask(uint32_t group) const;
+    bool DoGroupsInteract(uint32_t groupA, uint32_t groupB) const;
+
+protected:
+
+    void UpdateAllLayersInteract();
+
+    uint32_t mLayerMasks[MAX_COLLISION_LAYERS];
+
+    // True while every layer interacts with every other layer, which lets the filter skip the matrix.
+    bool mAllLayersInteract = true;
+};
+
+// Loaded from the collisionLayer<N> entries in the project file.
+CollisionLayers& GetProjectCollisionLayers();
+
+// Collision masks used to be 8 bits, where 0xff meant "collide with everything".
+uint32_t WidenLegacyCollisionMask(uint32_t mask);
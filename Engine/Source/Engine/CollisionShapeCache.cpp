@@ -0,0 +1,285 @@
+#include "CollisionShapeCache.h"
+#include "Utilities.h"
+#include "Assertion.h"
+
+#include "btBulletDynamicsCommon.h"
+
+// Dimensions are snapped to 1/4096 so that nearly identical values share a shape.
+#define COLLISION_SHAPE_QUANTIZE 4096.0f
+
+// Scales are snapped in log2 space instead, so small scales keep the same relative precision
+// as large ones and never collapse to 0. The lowest bit holds the sign.
+#define COLLISION_SCALE_QUANTIZE 4096.0f
+#define COLLISION_SCALE_MIN 0.0001f
+
+static int32_t QuantizeDim(float value)
+{
+    return int32_t(roundf(value * COLLISION_SHAPE_QUANTIZE));
+}
+
+static float DequantizeDim(int32_t value)
+{
+    return float(value) / COLLISION_SHAPE_QUANTIZE;
+}
+
+static int32_t QuantizeScale(float value)
+{
+    float absValue = glm::max(fabsf(value), COLLISION_SCALE_MIN);
+    int32_t logValue = int32_t(roundf(log2f(absValue) * COLLISION_SCALE_QUANTIZE));
+    return logValue * 2 + ((value < 0.0f) ? 1 : 0);
+}
+
+static float DequantizeScale(int32_t value)
+{
+    int32_t sign = value & 1;
+    float absValue = exp2f(float((value - sign) / 2) / COLLISION_SCALE_QUANTIZE);
+    return sign ? -absValue : absValue;
+}
+
+bool CollisionShapeCache::Key::operator==(const Key& other) const
+{
+    return mType == other.mType &&
+        mSource == other.mSource &&
+        mDims[0] == other.mDims[0] &&
+        mDims[1] == other.mDims[1] &&
+        mDims[2] == other.mDims[2] &&
+        mScale[0] == other.mScale[0] &&
+        mScale[1] == other.mScale[1] &&
+        mScale[2] == other.mScale[2];
+}
+
+size_t CollisionShapeCache::KeyHasher::operator()(const Key& key) const
+{
+    uint64_t hash = uint64_t(key.mType) * 0x9E3779B97F4A7C15ull;
+    hash ^= uint64_t(uintptr_t(key.mSource)) + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        hash ^= uint64_t(uint32_t(key.mDims[i])) + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+        hash ^= uint64_t(uint32_t(key.mScale[i])) + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+    }
+
+    return size_t(hash);
+}
+
+CollisionShapeCache* CollisionShapeCache::Get()
+{
+    static CollisionShapeCache sInstance;
+    return &sInstance;
+}
+
+btCollisionShape* CollisionShapeCache::AcquireBox(glm::vec3 halfExtents, glm::vec3 scale)
+{
+    Key key;
+    key.mType = CollisionShape::Box;
+    key.mDims[0] = QuantizeDim(halfExtents.x);
+    key.mDims[1] = QuantizeDim(halfExtents.y);
+    key.mDims[2] = QuantizeDim(halfExtents.z);
+    SetKeyScale(key, scale);
+    return Acquire(key);
+}
+
+btCollisionShape* CollisionShapeCache::AcquireSphere(float radius, glm::vec3 scale)
+{
+    Key key;
+    key.mType = CollisionShape::Sphere;
+    key.mDims[0] = QuantizeDim(radius);
+    SetKeyScale(key, scale);
+    return Acquire(key);
+}
+
+btCollisionShape* CollisionShapeCache::AcquireCapsule(float radius, float height, glm::vec3 scale)
+{
+    Key key;
+    key.mType = CollisionShape::Capsule;
+    key.mDims[0] = QuantizeDim(radius);
+    key.mDims[1] = QuantizeDim(height);
+    SetKeyScale(key, scale);
+    return Acquire(key);
+}
+
+btCollisionShape* CollisionShapeCache::AcquireScaledTriangleMesh(btBvhTriangleMeshShape* meshShape, glm::vec3 scale)
+{
+    OCT_ASSERT(meshShape != nullptr);
+
+    Key key;
+    key.mType = CollisionShape::ScaledTriangleMesh;
+    key.mSource = meshShape;
+    SetKeyScale(key, scale);
+    return Acquire(key);
+}
+
+btCollisionShape* CollisionShapeCache::AcquireMeshCopy(btCollisionShape* meshShape, glm::vec3 scale)
+{
+    OCT_ASSERT(meshShape != nullptr);
+
+    // Copies of a mesh's simple collision are keyed as compound even if there is only one child.
+    Key key;
+    key.mType = CollisionShape::Compound;
+    key.mSource = meshShape;
+    SetKeyScale(key, scale);
+    return Acquire(key);
+}
+
+btCollisionShape* CollisionShapeCache::AcquireRescaled(btCollisionShape* shape, glm::vec3 scale)
+{
+    auto it = mEntryMap.find(shape);
+    OCT_ASSERT(it != mEntryMap.end());
+
+    // Mesh derived shapes can't be rebuilt once their source mesh shape has been invalidated.
+    // Keep the current shape until the owner acquires one from the new mesh.
+    if (!it->second.mValid)
+    {
+        return shape;
+    }
+
+    Key key = it->second.mKey;
+    SetKeyScale(key, scale);
+
+    if (key == it->second.mKey)
+    {
+        return shape;
+    }
+
+    return Acquire(key);
+}
+
+bool CollisionShapeCache::Release(btCollisionShape* shape)
+{
+    auto it = mEntryMap.find(shape);
+
+    if (it == mEntryMap.end())
+    {
+        return false;
+    }
+
+    Entry& entry = it->second;
+    OCT_ASSERT(entry.mRefCount > 0);
+    entry.mRefCount--;
+
+    if (entry.mRefCount == 0)
+    {
+        if (entry.mValid)
+        {
+            mShapeMap.erase(entry.mKey);
+        }
+
+        DestroyCollisionShape(entry.mShape);
+        mEntryMap.erase(it);
+    }
+
+    return true;
+}
+
+bool CollisionShapeCache::IsCached(const btCollisionShape* shape) const
+{
+    return mEntryMap.find(shape) != mEntryMap.end();
+}
+
+void CollisionShapeCache::Invalidate(const btCollisionShape* meshShape)
+{
+    if (meshShape == nullptr)
+        return;
+
+    for (auto it = mEntryMap.begin(); it != mEntryMap.end(); ++it)
+    {
+        Entry& entry = it->second;
+
+        if (entry.mValid &&
+            entry.mKey.mSource == meshShape)
+        {
+            mShapeMap.erase(entry.mKey);
+            entry.mValid = false;
+
+            // Forget the source so nothing can rebuild a shape from the freed mesh shape.
+            entry.mKey.mSource = nullptr;
+        }
+    }
+}
+
+uint32_t CollisionShapeCache::GetNumShapes() const
+{
+    return uint32_t(mEntryMap.size());
+}
+
+btCollisionShape* CollisionShapeCache::Acquire(const Key& key)
+{
+    btCollisionShape* shape = nullptr;
+    auto it = mShapeMap.find(key);
+
+    if (it != mShapeMap.end())
+    {
+        shape = it->second;
+        mEntryMap[shape].mRefCount++;
+    }
+    else
+    {
+        shape = CreateShape(key);
+        mShapeMap.insert({ key, shape });
+
+        Entry& entry = mEntryMap[shape];
+        entry.mShape = shape;
+        entry.mRefCount = 1;
+        entry.mKey = key;
+    }
+
+    return shape;
+}
+
+btCollisionShape* CollisionShapeCache::CreateShape(const Key& key) const
+{
+    btCollisionShape* shape = nullptr;
+    btVector3 scale = btVector3(DequantizeScale(key.mScale[0]), DequantizeScale(key.mScale[1]), DequantizeScale(key.mScale[2]));
+
+    switch (key.mType)
+    {
+    case CollisionShape::Box:
+    {
+        btVector3 halfExtents = btVector3(DequantizeDim(key.mDims[0]), DequantizeDim(key.mDims[1]), DequantizeDim(key.mDims[2]));
+        shape = new btBoxShape(halfExtents);
+        shape->setLocalScaling(scale);
+        break;
+    }
+    case CollisionShape::Sphere:
+    {
+        shape = new btSphereShape(DequantizeDim(key.mDims[0]));
+        shape->setLocalScaling(scale);
+        break;
+    }
+    case CollisionShape::Capsule:
+    {
+        shape = new btCapsuleShape(DequantizeDim(key.mDims[0]), DequantizeDim(key.mDims[1]));
+        shape->setLocalScaling(scale);
+        break;
+    }
+    case CollisionShape::ScaledTriangleMesh:
+    {
+        OCT_ASSERT(key.mSource != nullptr);
+        btBvhTriangleMeshShape* meshShape = (btBvhTriangleMeshShape*)key.mSource;
+        shape = new btScaledBvhTriangleMeshShape(meshShape, scale);
+        break;
+    }
+    case CollisionShape::Compound:
+    {
+        OCT_ASSERT(key.mSource != nullptr);
+        shape = CloneCollisionShape(const_cast<btCollisionShape*>(key.mSource));
+        shape->setLocalScaling(scale);
+        break;
+    }
+    default:
+    {
+        OCT_ASSERT(0);
+        shape = new btEmptyShape();
+        break;
+    }
+    }
+
+    return shape;
+}
+
+void CollisionShapeCache::SetKeyScale(Key& key, glm::vec3 scale) const
+{
+    key.mScale[0] = QuantizeScale(scale.x);
+    key.mScale[1] = QuantizeScale(scale.y);
+    key.mScale[2] = QuantizeScale(scale.z);
+}
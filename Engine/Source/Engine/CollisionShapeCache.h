@@ -0,0 +1,75 @@
+#pragma once
+
+#include <stdint.h>
+#include <unordered_map>
+
+#include "EngineTypes.h"
+#include "Maths.h"
+
+class btCollisionShape;
+class btBvhTriangleMeshShape;
+
+// Reference counted pool of collision shapes shared between primitive nodes.
+// Shapes are keyed on their type, quantized dimensions and local scaling, so identical
+// primitives (e.g. thousands of the same crate) reference a single Bullet shape.
+// Cached shapes must never be modified in place. Acquire a new shape instead.
+class CollisionShapeCache
+{
+public:
+
+    static CollisionShapeCache* Get();
+
+    btCollisionShape* AcquireBox(glm::vec3 halfExtents, glm::vec3 scale);
+    btCollisionShape* AcquireSphere(float radius, glm::vec3 scale);
+    btCollisionShape* AcquireCapsule(float radius, float height, glm::vec3 scale);
+    btCollisionShape* AcquireScaledTriangleMesh(btBvhTriangleMeshShape* meshShape, glm::vec3 scale);
+    btCollisionShape* AcquireMeshCopy(btCollisionShape* meshShape, glm::vec3 scale);
+
+    // Returns a shape matching the given one but with a different scale. If a different shape is
+    // returned, the caller still holds its reference to the old one and must release it once
+    // nothing points at it anymore. Returns the same shape (without a new reference) if the scale
+    // is unchanged, or if the shape was derived from a mesh shape that has since been invalidated.
+    btCollisionShape* AcquireRescaled(btCollisionShape* shape, glm::vec3 scale);
+
+    // Returns false if the shape was not created by the cache.
+    bool Release(btCollisionShape* shape);
+    bool IsCached(const btCollisionShape* shape) const;
+
+    // Stop handing out shapes derived from a mesh shape that is about to be destroyed.
+    // Shapes that are still referenced stay alive until they are released.
+    void Invalidate(const btCollisionShape* meshShape);
+
+    uint32_t GetNumShapes() const;
+
+protected:
+
+    struct Key
+    {
+        CollisionShape mType = CollisionShape::Empty;
+        const btCollisionShape* mSource = nullptr;
+        int32_t mDims[3] = {};
+        int32_t mScale[3] = {};
+
+        bool operator==(const Key& other) const;
+    };
+
+    struct KeyHasher
+    {
+        size_t operator()(const Key& key) const;
+    };
+
+    struct Entry
+    {
+        btCollisionShape* mShape = nullptr;
+        uint32_t mRefCount = 0;
+        bool mValid = true;
+        Key mKey;
+    };
+
+    btCollisionShape* Acquire(const Key& key);
+    btCollisionShape* CreateShape(const Key& key) const;
+    void SetKeyScale(Key& key, glm::vec3 scale) const;
+
+    std::unordered_map<Key, btCollisionShape*, KeyHasher> mShapeMap;
+    std::unordered_map<const btCollisionShape*, Entry> mEntryMap;
+};
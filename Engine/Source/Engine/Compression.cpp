@@ -0,0 +1,173 @@
+#include "Compression.h"
+#include "Log.h"
+#include "Assertion.h"
+#include "Maths.h"
+
+#include "Zlib/zlib.h"
+
+#include <string.h>
+
+static uint32_t ZlibCompressBound(uint32_t srcSize)
+{
+    return uint32_t(compressBound(uLong(srcSize)));
+}
+
+static uint32_t ZlibCompress(const char* src, uint32_t srcSize, char* dst, uint32_t dstCapacity, int32_t level)
+{
+    uLongf dstSize = uLongf(dstCapacity);
+    int32_t zLevel = (level < 0) ? Z_DEFAULT_COMPRESSION : level;
+    int result = compress2((Bytef*)dst, &dstSize, (const Bytef*)src, uLong(srcSize), zLevel);
+    return (result == Z_OK) ? uint32_t(dstSize) : 0;
+}
+
+static bool ZlibDecompress(const char* src, uint32_t srcSize, char* dst, uint32_t dstSize)
+{
+    uLongf outSize = uLongf(dstSize);
+    int result = uncompress((Bytef*)dst, &outSize, (const Bytef*)src, uLong(srcSize));
+    return (result == Z_OK) && (outSize == dstSize);
+}
+
+static CompressionCodec sCodecs[MAX_COMPRESSION_CODECS] =
+{
+    { "None", nullptr, nullptr, nullptr },
+    { "Zlib", ZlibCompressBound, ZlibCompress, ZlibDecompress },
+};
+
+void RegisterCompressionCodec(uint32_t id, const CompressionCodec& codec)
+{
+    if (id == COMPRESSION_CODEC_NONE ||
+        id >= MAX_COMPRESSION_CODECS)
+    {
+        LogError("Invalid compression codec id: %d", id);
+        return;
+    }
+
+    sCodecs[id] = codec;
+}
+
+const CompressionCodec* GetCompressionCodec(uint32_t id)
+{
+    if (id >= MAX_COMPRESSION_CODECS ||
+        sCodecs[id].mDecompress == nullptr)
+    {
+        return nullptr;
+    }
+
+    return &sCodecs[id];
+}
+
+bool CompressBlock(uint32_t codecId, const char* src, uint32_t srcSize, std::vector<char>& outBlock, int32_t level)
+{
+    const CompressionCodec* codec = GetCompressionCodec(codecId);
+
+    if (codec == nullptr ||
+        codec->mCompress == nullptr)
+    {
+        LogError("Compression codec %d is not registered", codecId);
+        return false;
+    }
+
+    CompressedBlockHeader header;
+    header.mUncompressedSize = srcSize;
+    header.mChunkSize = COMPRESSION_CHUNK_SIZE;
+    header.mNumChunks = (srcSize + COMPRESSION_CHUNK_SIZE - 1) / COMPRESSION_CHUNK_SIZE;
+    header.mCodec = codecId;
+
+    size_t headerPos = outBlock.size();
+    size_t tablePos = headerPos + sizeof(CompressedBlockHeader);
+    size_t dataPos = tablePos + header.mNumChunks * sizeof(uint32_t);
+    outBlock.resize(dataPos);
+    memcpy(outBlock.data() + headerPos, &header, sizeof(CompressedBlockHeader));
+
+    std::vector<char> chunkBuffer(codec->mCompressBound(COMPRESSION_CHUNK_SIZE));
+
+    for (uint32_t i = 0; i < header.mNumChunks; ++i)
+    {
+        uint32_t chunkOffset = i * COMPRESSION_CHUNK_SIZE;
+        uint32_t chunkSize = glm::min<uint32_t>(COMPRESSION_CHUNK_SIZE, srcSize - chunkOffset);
+        uint32_t storedSize = codec->mCompress(src + chunkOffset, chunkSize, chunkBuffer.data(), uint32_t(chunkBuffer.size()), level);
+        const char* storedData = chunkBuffer.data();
+
+        if (storedSize == 0 ||
+            storedSize >= chunkSize)
+        {
+            storedSize = chunkSize;
+            storedData = src + chunkOffset;
+        }
+
+        memcpy(outBlock.data() + tablePos + i * sizeof(uint32_t), &storedSize, sizeof(uint32_t));
+        outBlock.insert(outBlock.end(), storedData, storedData + storedSize);
+    }
+
+    return true;
+}
+
+uint32_t GetDecompressedBlockSize(const char* block, uint32_t blockSize)
+{
+    if (blockSize < sizeof(CompressedBlockHeader))
+    {
+        return 0;
+    }
+
+    CompressedBlockHeader header;
+    memcpy(&header, block, sizeof(CompressedBlockHeader));
+    return header.mUncompressedSize;
+}
+
+bool DecompressBlock(const char* block, uint32_t blockSize, char* dst, uint32_t dstSize)
+{
+    if (blockSize < sizeof(CompressedBlockHeader))
+    {
+        LogError("Compressed block is too small");
+        return false;
+    }
+
+    CompressedBlockHeader header;
+    memcpy(&header, block, sizeof(CompressedBlockHeader));
+
+    const CompressionCodec* codec = GetCompressionCodec(header.mCodec);
+    uint64_t tableEnd = sizeof(CompressedBlockHeader) + uint64_t(header.mNumChunks) * sizeof(uint32_t);
+
+    if (codec == nullptr ||
+        header.mUncompressedSize != dstSize ||
+        header.mChunkSize == 0 ||
+        header.mNumChunks != (dstSize + header.mChunkSize - 1) / header.mChunkSize ||
+        tableEnd > blockSize)
+    {
+        LogError("Invalid compressed block (codec %d)", header.mCodec);
+        return false;
+    }
+
+    const char* sizeTable = block + sizeof(CompressedBlockHeader);
+    uint64_t srcOffset = tableEnd;
+
+    for (uint32_t i = 0; i < header.mNumChunks; ++i)
+    {
+        uint32_t storedSize = 0;
+        memcpy(&storedSize, sizeTable + i * sizeof(uint32_t), sizeof(uint32_t));
+
+        if (srcOffset + storedSize > blockSize)
+        {
+            LogError("Compressed block is truncated");
+            return false;
+        }
+
+        uint32_t dstOffset = i * header.mChunkSize;
+        uint32_t chunkSize = glm::min<uint32_t>(header.mChunkSize, header.mUncompressedSize - dstOffset);
+        const char* src = block + srcOffset;
+
+        if (storedSize == chunkSize)
+        {
+            memcpy(dst + dstOffset, src, chunkSize);
+        }
+        else if (!codec->mDecompress(src, storedSize, dst + dstOffset, chunkSize))
+        {
+            LogError("Failed to decompress block (codec %s)", codec->mName);
+            return false;
+        }
+
+        srcOffset += storedSize;
+    }
+
+    return true;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+// Chunked block compression used for cooked asset data.
+//
+// A compressed block is a CompressedBlockHeader, followed by the stored size of every chunk,
+// followed by the chunk data. Chunks are compressed independently and each one is written
+// straight to its place in the destination buffer.
+// Chunks that don't shrink are stored raw (stored size == uncompressed chunk size).
+
+#define COMPRESSION_CODEC_NONE 0
+#define COMPRESSION_CODEC_ZLIB 1
+#define MAX_COMPRESSION_CODECS 8
+
+#define COMPRESSION_CHUNK_SIZE (64 * 1024)
+#define COMPRESSION_DEFAULT_LEVEL -1
+
+// A codec only has to handle a single chunk at a time.
+// Compress returns the compressed size, or 0 if the data didn't fit in dstCapacity.
+struct CompressionCodec
+{
+    const char* mName = nullptr;
+    uint32_t (*mCompressBound)(uint32_t srcSize) = nullptr;
+    uint32_t (*mCompress)(const char* src, uint32_t srcSize, char* dst, uint32_t dstCapacity, int32_t level) = nullptr;
+    bool (*mDecompress)(const char* src, uint32_t srcSize, char* dst, uint32_t dstSize) = nullptr;
+};
+
+struct CompressedBlockHeader
+{
+    uint32_t mUncompressedSize = 0;
+    uint32_t mChunkSize = COMPRESSION_CHUNK_SIZE;
+    uint32_t mNumChunks = 0;
+    uint32_t mCodec = COMPRESSION_CODEC_NONE;
+};
+
+void RegisterCompressionCodec(uint32_t id, const CompressionCodec& codec);
+const CompressionCodec* GetCompressionCodec(uint32_t id);
+
+// Appends a compressed block to outBlock.
+bool CompressBlock(uint32_t codecId, const char* src, uint32_t srcSize, std::vector<char>& outBlock, int32_t level = COMPRESSION_DEFAULT_LEVEL);
+
+// dst must be exactly as large as the uncompressed size recorded in the block header.
+// Runs entirely on the calling thread, assets are already loaded in parallel by the loader threads.
+bool DecompressBlock(const char* block, uint32_t blockSize, char* dst, uint32_t dstSize);
+
+uint32_t GetDecompressedBlockSize(const char* block, uint32_t blockSize);
@@ -1670,7 +1670,16 @@ void Datum::Reserve(uint32_t capacity)
 
         mCapacity = capacity;
         uint32_t typeSize = GetDataTypeSize();
-        mData.vp = SYS_AlignedMalloc(mCapacity * typeSize, 4);
+
+        if (prevData.vp == nullptr &&
+            CanUseInlineStorage(capacity))
+        {
+            mData.vp = mInlineData;
+        }
+        else
+        {
+            mData.vp = SYS_AlignedMalloc(mCapacity * typeSize, 4);
+        }
 
         if (prevData.vp != nullptr)
         {
@@ -1692,12 +1701,32 @@ void Datum::Reserve(uint32_t capacity)
                 memcpy(mData.vp, prevData.vp, typeSize * mCount);
             }
 
-            SYS_AlignedFree(prevData.vp);
+            if (prevData.vp != mInlineData)
+            {
+                SYS_AlignedFree(prevData.vp);
+            }
+
             prevData.vp = nullptr;
         }
     }
 }
 
+bool Datum::CanUseInlineStorage(uint32_t capacity) const
+{
+    bool trivialType =
+        mType != DatumType::String &&
+        mType != DatumType::Asset &&
+        mType != DatumType::Table &&
+        mType != DatumType::Function;
+
+    return trivialType && (capacity * GetDataTypeSize() <= DATUM_INLINE_SIZE);
+}
+
+bool Datum::IsInlineStorage() const
+{
+    return (mData.vp == mInlineData);
+}
+
 void Datum::Destroy()
 {
     // Delete internal memory.
@@ -1712,7 +1741,11 @@ void Datum::Destroy()
             DestructData(mData, i);
         }
 
-        SYS_AlignedFree(mData.vp);
+        if (!IsInlineStorage())
+        {
+            SYS_AlignedFree(mData.vp);
+        }
+
         mData.vp = nullptr;
     }
 
@@ -6,6 +6,10 @@
 
 #include <string>
 
+// Datums with internal storage keep small trivially copyable values (like a float or vec4)
+// inside the Datum itself instead of allocating them on the heap.
+#define DATUM_INLINE_SIZE 16
+
 typedef bool(*DatumChangeHandlerFP)(class Datum* prop, uint32_t index, const void* newValue);
 
 class Asset;
@@ -326,6 +330,8 @@ public:
 protected:
 
     void Reserve(uint32_t capacity);
+    bool CanUseInlineStorage(uint32_t capacity) const;
+    bool IsInlineStorage() const;
 
     void PreSet(uint32_t index, DatumType type);
     void PreSetExternal(DatumType type);
@@ -350,4 +356,5 @@ public:
     DatumChangeHandlerFP mChangeHandler = nullptr;
     uint8_t mCount = 0;
     uint8_t mCapacity = 0;
+    alignas(8) uint8_t mInlineData[DATUM_INLINE_SIZE] = {};
 };
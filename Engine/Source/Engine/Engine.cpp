@@ -8,15 +8,18 @@
 #include "Script.h"
 #include "Assets/Scene.h"
 #include "AssetManager.h"
+#include "AssetPak.h"
 #include "NetworkManager.h"
 #include "AudioManager.h"
 #include "Constants.h"
 #include "Utilities.h"
 #include "Profiler.h"
+#include "FrameAllocator.h"
 #include "Maths.h"
 #include "ScriptAutoReg.h"
 #include "ScriptFunc.h"
 #include "TimerManager.h"
+#include "CollisionLayers.h"
 #include "Nodes/Widgets/TextField.h"
 
 #include "System/System.h"
@@ -59,6 +62,7 @@ void ForceLinkage()
     FORCE_LINK_CALL(Sphere3D);
     FORCE_LINK_CALL(StaticMesh3D);
     FORCE_LINK_CALL(Capsule3D);
+    FORCE_LINK_CALL(CharacterController3D);
     FORCE_LINK_CALL(ShadowMesh3D);
     FORCE_LINK_CALL(TextMesh3D);
 
@@ -162,6 +166,8 @@ bool Initialize(InitOptions& initOptions)
     CreateProfiler();
     SCOPED_STAT("Initialize");
 
+    GetFrameAllocator()->Initialize(FRAME_ALLOCATOR_SIZE);
+
     Renderer::Create();
     AssetManager::Create();
     NetworkManager::Create();
@@ -193,6 +199,28 @@ bool Initialize(InitOptions& initOptions)
 
     AssetManager::Get()->Initialize();
 
+    bool useAssetPak = false;
+
+#if !EDITOR
+    // Packaged builds put all of their assets in pak archives next to the project file.
+    // If they exist, discovery only needs to read their tocs instead of walking directories.
+    if (!initOptions.mUseAssetRegistry)
+    {
+        std::string projectPath = sEngineConfig.mProjectPath;
+
+        if (projectPath == "" &&
+            initOptions.mProjectName != "")
+        {
+            projectPath = initOptions.mProjectName + "/" + initOptions.mProjectName + ".octp";
+        }
+
+        std::string projectDir = projectPath.substr(0, projectPath.find_last_of("/\\") + 1);
+        useAssetPak = (projectPath != "") && SYS_DoesFileExist(AssetPak::GetArchivePath(projectDir, 0).c_str(), true);
+    }
+#endif
+
+    bool discoverAssets = !initOptions.mUseAssetRegistry && !useAssetPak;
+
     if (sEngineConfig.mProjectPath != "")
     {
 #if EDITOR
@@ -203,14 +231,14 @@ bool Initialize(InitOptions& initOptions)
         sEngineState.mProjectDirectory = path.substr(0, path.find_last_of("/\\") + 1);
 #else
         // Editor uses ActionManager::OpenProject()
-        LoadProject(sEngineConfig.mProjectPath, !initOptions.mUseAssetRegistry);
+        LoadProject(sEngineConfig.mProjectPath, discoverAssets);
 #endif
     }
     else if (initOptions.mProjectName != "")
     {
         std::string projectName = initOptions.mProjectName;
         std::string projectPath = projectName + "/" + projectName + ".octp";
-        LoadProject(projectPath, !initOptions.mUseAssetRegistry);
+        LoadProject(projectPath, discoverAssets);
     }
 
 #if !EDITOR
@@ -219,6 +247,12 @@ bool Initialize(InitOptions& initOptions)
     {
         AssetManager::Get()->DiscoverAssetRegistry((GetEngineState()->mProjectDirectory + "AssetRegistry.txt").c_str());
     }
+
+    if (useAssetPak &&
+        !AssetManager::Get()->DiscoverAssetPaks(GetEngineState()->mProjectDirectory.c_str()))
+    {
+        LogError("Failed to open asset paks");
+    }
 #endif
 
     if (initOptions.mEmbeddedAssetCount > 0 &&
@@ -237,9 +271,9 @@ bool Initialize(InitOptions& initOptions)
     // In editor, it's expected that all engine assets are imported manually...
     // At least for now. This is to prevent breaking the editor when a file format changes.
     // Building Data (Ctrl+B) in editor will regenerate .oct files from the source data.
-    if (!initOptions.mUseAssetRegistry)
+    if (discoverAssets)
     {
-        AssetManager::Get()->Discover("Engine", "Engine/Assets/");
+        AssetManager::Get()->Discover("Engine", "Engine/Assets/", "Engine/Intermediate/AssetCache.bin");
     }
 #endif
 
@@ -315,6 +349,7 @@ bool Update()
         return !sEngineState.mQuit;
     }
 
+    GetFrameAllocator()->BeginFrame();
     GetProfiler()->BeginFrame();
 
     BEGIN_FRAME_STAT("Frame");
@@ -421,6 +456,7 @@ void Shutdown()
 
     NET_Shutdown();
     AUD_Shutdown();
+    AUD_ShutdownStreams();
     INP_Shutdown();
     GFX_Shutdown();
     SYS_Shutdown();
@@ -429,6 +465,7 @@ void Shutdown()
     EditorImguiShutdown();
 #endif
 
+    GetFrameAllocator()->Shutdown();
     DestroyProfiler();
 
     LogDebug("Shutdown Complete");
@@ -491,6 +528,8 @@ void LoadProject(const std::string& path, bool discoverAssets)
     sEngineState.mProjectPath = path;
     sEngineState.mProjectDirectory = path.substr(0, path.find_last_of("/\\") + 1);
 
+    GetProjectCollisionLayers().Reset();
+
     Stream projFileStream;
     projFileStream.ReadFile(path.c_str(), true);
 
@@ -513,13 +552,34 @@ void LoadProject(const std::string& path, bool discoverAssets)
             {
                 sEngineState.mSolutionPath = sEngineState.mProjectDirectory + value;
             }
+            else if (strncmp(key, "collisionLayer", strlen("collisionLayer")) == 0)
+            {
+                // collisionLayer<N>=<mask of layers that layer N interacts with>
+                uint32_t layer = uint32_t(atoi(key + strlen("collisionLayer")));
+
+                if (layer < MAX_COLLISION_LAYERS)
+                {
+                    GetProjectCollisionLayers().SetLayerMask(layer, uint32_t(strtoul(value, nullptr, 0)));
+                }
+                else
+                {
+                    LogWarning("Invalid collision layer in project file: %s", key);
+                }
+            }
         }
     }
 
+    // The world is created after the first project load, but the editor can switch projects later.
+    if (sWorld != nullptr)
+    {
+        sWorld->GetCollisionLayers() = GetProjectCollisionLayers();
+    }
+
     if (discoverAssets &&
         sEngineState.mProjectName != "")
     {
-        AssetManager::Get()->Discover(sEngineState.mProjectName.c_str(), (sEngineState.mProjectDirectory + "Assets/").c_str());
+        std::string cachePath = sEngineState.mProjectDirectory + "Intermediate/AssetCache.bin";
+        AssetManager::Get()->Discover(sEngineState.mProjectName.c_str(), (sEngineState.mProjectDirectory + "Assets/").c_str(), cachePath.c_str());
     }
 
     char windowName[1024] = {};
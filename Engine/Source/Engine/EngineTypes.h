@@ -5,6 +5,7 @@
 
 #include "Constants.h"
 #include "Maths.h"
+#include "FrameAllocator.h"
 
 #include "System/SystemTypes.h"
 #include "Graphics/GraphicsTypes.h"
@@ -39,6 +40,7 @@ class btRigidBody;
 class btCollisionShape;
 class btBvhTriangleMeshShape;
 class btTriangleIndexVertexArray;
+class btOptimizedBvh;
 struct btTriangleInfoMap;
 
 enum class CollisionShape : uint32_t
@@ -157,6 +159,28 @@ struct DebugDraw
     float mLife = 0.0f;
 };
 
+enum class PhysicsCommandType
+{
+    AddLinearVelocity,
+    AddAngularVelocity,
+    SetLinearVelocity,
+    SetAngularVelocity,
+    AddForce,
+    AddImpulse,
+    SyncTransform,
+
+    Count
+};
+
+// Rigid body changes made while a pipelined physics step is running.
+// They are applied when the main thread syncs with the physics thread.
+struct PhysicsCommand
+{
+    PhysicsCommandType mType = PhysicsCommandType::Count;
+    Primitive3D* mPrimitive = nullptr;
+    glm::vec3 mValue = {};
+};
+
 struct PrimitivePair
 {
     Primitive3D* mPrimitiveA = nullptr;
@@ -300,6 +324,21 @@ struct RayTestResult
     float mHitFraction = 0.0f;
 };
 
+struct RayTestQuery
+{
+    glm::vec3 mStart = {};
+    glm::vec3 mEnd = {};
+    uint32_t mCollisionMask = 0xffffffff;
+};
+
+struct SweepTestQuery
+{
+    Primitive3D* mPrimitive = nullptr;
+    glm::vec3 mStart = {};
+    glm::vec3 mEnd = {};
+    uint32_t mCollisionMask = 0xffffffff;
+};
+
 struct RayTestMultiResult
 {
     glm::vec3 mStart = {};
@@ -311,6 +350,27 @@ struct RayTestMultiResult
     std::vector<float> mHitFractions;
 };
 
+struct RigidBodySnapshot
+{
+    // Only used to match bodies on restore, never dereferenced.
+    const btCollisionObject* mObject = nullptr;
+    const Primitive3D* mPrimitive = nullptr;
+    glm::vec3 mPosition = {};
+    glm::quat mRotation = {};
+    glm::vec3 mLinearVelocity = {};
+    glm::vec3 mAngularVelocity = {};
+    float mDeactivationTime = 0.0f;
+    int32_t mActivationState = 0;
+};
+
+// Bodies are stored in dynamics world order. Overlaps are pairs of indices into mBodies.
+struct PhysicsSnapshot
+{
+    std::vector<RigidBodySnapshot> mBodies;
+    std::vector<int32_t> mOverlaps;
+    float mLocalTime = 0.0f;
+};
+
 struct SweepTestResult
 {
     glm::vec3 mStart = {};
@@ -349,18 +409,42 @@ struct FogSettings
     float mFar = 100.0f;
 };
 
-enum CollisionGroup
+enum CollisionGroup : uint32_t
 {
-    ColGroup0 = 1,
-    ColGroup1 = 2,
-    ColGroup2 = 4,
-    ColGroup3 = 8,
-    ColGroup4 = 16,
-    ColGroup5 = 32,
-    ColGroup6 = 64,
-    ColGroup7 = 128,
-
-    ColGroupAll = -1
+    ColGroup0 = 1u << 0,
+    ColGroup1 = 1u << 1,
+    ColGroup2 = 1u << 2,
+    ColGroup3 = 1u << 3,
+    ColGroup4 = 1u << 4,
+    ColGroup5 = 1u << 5,
+    ColGroup6 = 1u << 6,
+    ColGroup7 = 1u << 7,
+    ColGroup8 = 1u << 8,
+    ColGroup9 = 1u << 9,
+    ColGroup10 = 1u << 10,
+    ColGroup11 = 1u << 11,
+    ColGroup12 = 1u << 12,
+    ColGroup13 = 1u << 13,
+    ColGroup14 = 1u << 14,
+    ColGroup15 = 1u << 15,
+    ColGroup16 = 1u << 16,
+    ColGroup17 = 1u << 17,
+    ColGroup18 = 1u << 18,
+    ColGroup19 = 1u << 19,
+    ColGroup20 = 1u << 20,
+    ColGroup21 = 1u << 21,
+    ColGroup22 = 1u << 22,
+    ColGroup23 = 1u << 23,
+    ColGroup24 = 1u << 24,
+    ColGroup25 = 1u << 25,
+    ColGroup26 = 1u << 26,
+    ColGroup27 = 1u << 27,
+    ColGroup28 = 1u << 28,
+    ColGroup29 = 1u << 29,
+    ColGroup30 = 1u << 30,
+    ColGroup31 = 1u << 31,
+
+    ColGroupAll = 0xffffffff
 };
 
 enum class AttenuationFunc
@@ -0,0 +1,120 @@
+#include "FrameAllocator.h"
+#include "Assertion.h"
+#include "Log.h"
+
+#include <stdlib.h>
+#include <glm/glm.hpp>
+
+FrameAllocator gFrameAllocator;
+
+FrameAllocator* GetFrameAllocator()
+{
+    return &gFrameAllocator;
+}
+
+void FrameAllocator::Initialize(uint32_t capacity)
+{
+    OCT_ASSERT(mBuffers[0].mData == nullptr);
+    mCapacity = capacity;
+
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        mBuffers[i].mData = (uint8_t*)malloc(capacity);
+        mBuffers[i].mOffset = 0;
+        mBuffers[i].mLastOffset = 0;
+        mBuffers[i].mOverflowAllocs.reserve(64);
+    }
+}
+
+void FrameAllocator::Shutdown()
+{
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        ResetBuffer(mBuffers[i]);
+        free(mBuffers[i].mData);
+        mBuffers[i].mData = nullptr;
+    }
+
+    mCapacity = 0;
+}
+
+void FrameAllocator::BeginFrame()
+{
+    mPeakBytesUsed = glm::max(mPeakBytesUsed, GetBytesUsed());
+
+    // Swap to the older buffer. Anything allocated in it two frames ago is now stale.
+    mBufferIndex = (mBufferIndex + 1) % 2;
+    ResetBuffer(mBuffers[mBufferIndex]);
+}
+
+void* FrameAllocator::Allocate(size_t size, size_t alignment)
+{
+    FrameBuffer& buffer = mBuffers[mBufferIndex];
+    size_t alignedOffset = (buffer.mOffset + (alignment - 1)) & ~(alignment - 1);
+
+    if (buffer.mData != nullptr &&
+        alignedOffset + size <= mCapacity)
+    {
+        buffer.mLastOffset = buffer.mOffset;
+        buffer.mOffset = alignedOffset + size;
+        return buffer.mData + alignedOffset;
+    }
+
+    // Out of frame memory, fall back to the heap. These are released when the buffer is reset.
+    if (buffer.mData != nullptr &&
+        !mOverflowWarned)
+    {
+        LogWarning("FrameAllocator overflow. Consider increasing FRAME_ALLOCATOR_SIZE.");
+        mOverflowWarned = true;
+    }
+
+    void* overflowAlloc = malloc(size);
+    buffer.mOverflowAllocs.push_back(overflowAlloc);
+    return overflowAlloc;
+}
+
+void FrameAllocator::Free(void* pointer, size_t size)
+{
+    // Individual frees are a no-op except for the most recent allocation, which can be
+    // rolled back. This lets a growing vector reuse the space it just released.
+    FrameBuffer& buffer = mBuffers[mBufferIndex];
+
+    if (buffer.mData != nullptr &&
+        pointer != nullptr &&
+        (uint8_t*)pointer + size == buffer.mData + buffer.mOffset)
+    {
+        buffer.mOffset = buffer.mLastOffset;
+    }
+}
+
+uint32_t FrameAllocator::GetCapacity() const
+{
+    return mCapacity;
+}
+
+uint32_t FrameAllocator::GetBytesUsed() const
+{
+    return (uint32_t)mBuffers[mBufferIndex].mOffset;
+}
+
+uint32_t FrameAllocator::GetPeakBytesUsed() const
+{
+    return mPeakBytesUsed;
+}
+
+uint32_t FrameAllocator::GetNumOverflowAllocs() const
+{
+    return (uint32_t)mBuffers[mBufferIndex].mOverflowAllocs.size();
+}
+
+void FrameAllocator::ResetBuffer(FrameBuffer& buffer)
+{
+    for (uint32_t i = 0; i < buffer.mOverflowAllocs.size(); ++i)
+    {
+        free(buffer.mOverflowAllocs[i]);
+    }
+
+    buffer.mOverflowAllocs.clear();
+    buffer.mOffset = 0;
+    buffer.mLastOffset = 0;
+}
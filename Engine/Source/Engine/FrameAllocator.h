@@ -0,0 +1,80 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+#define FRAME_ALLOCATOR_SIZE (2 * 1024 * 1024)
+
+// Linear allocator for temporary data that only needs to live for a frame.
+// There are two buffers. Each frame, the older buffer is reset and becomes the active one,
+// so memory allocated during frame N stays valid until the start of frame N + 2.
+// Not thread safe. Only allocate from the main thread.
+class FrameAllocator
+{
+public:
+
+    void Initialize(uint32_t capacity);
+    void Shutdown();
+
+    void BeginFrame();
+
+    void* Allocate(size_t size, size_t alignment);
+    void Free(void* pointer, size_t size);
+
+    uint32_t GetCapacity() const;
+    uint32_t GetBytesUsed() const;
+    uint32_t GetPeakBytesUsed() const;
+    uint32_t GetNumOverflowAllocs() const;
+
+protected:
+
+    struct FrameBuffer
+    {
+        uint8_t* mData = nullptr;
+        size_t mOffset = 0;
+        size_t mLastOffset = 0;
+        std::vector<void*> mOverflowAllocs;
+    };
+
+    void ResetBuffer(FrameBuffer& buffer);
+
+    FrameBuffer mBuffers[2];
+    uint32_t mBufferIndex = 0;
+    uint32_t mCapacity = 0;
+    uint32_t mPeakBytesUsed = 0;
+    bool mOverflowWarned = false;
+};
+
+FrameAllocator* GetFrameAllocator();
+
+// STL allocator adapter so that standard containers can use the frame allocator.
+template<typename T>
+struct FrameStlAllocator
+{
+    typedef T value_type;
+
+    FrameStlAllocator() = default;
+
+    template<typename U>
+    FrameStlAllocator(const FrameStlAllocator<U>& other) {}
+
+    T* allocate(size_t count)
+    {
+        return reinterpret_cast<T*>(GetFrameAllocator()->Allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* pointer, size_t count)
+    {
+        GetFrameAllocator()->Free(pointer, count * sizeof(T));
+    }
+
+    template<typename U>
+    bool operator==(const FrameStlAllocator<U>& other) const { return true; }
+
+    template<typename U>
+    bool operator!=(const FrameStlAllocator<U>& other) const { return false; }
+};
+
+template<typename T>
+using FrameVector = std::vector<T, FrameStlAllocator<T>>;
@@ -2,8 +2,7 @@
 
 #include "AssetManager.h"
 #include "Renderer.h"
-
-#include "BulletCollision/CollisionShapes/btBoxShape.h"
+#include "CollisionShapeCache.h"
 
 FORCE_LINK_DEF(Box3D);
 DEFINE_NODE(Box3D, Primitive3D);
@@ -75,11 +74,6 @@ void Box3D::GatherProxyDraws(std::vector<DebugDraw>& inoutDraws)
 void Box3D::Create()
 {
     Primitive3D::Create();
-
-    btVector3 halfExtents = btVector3(mExtents.x, mExtents.y, mExtents.z) / 2.0f;
-    btBoxShape* boxShape = new btBoxShape(halfExtents);
-    SetCollisionShape(boxShape);
-
     UpdateRigidBody();
 }
 
@@ -111,17 +105,7 @@ void Box3D::SetExtents(glm::vec3 extents)
 
 void Box3D::UpdateRigidBody()
 {
-    EnableRigidBody(false);
-
-    btBoxShape* boxShape = static_cast<btBoxShape*>(mCollisionShape);
-
-    // Unfortunately there isn't an easy way to reset the safe margins when 
-    // setting the implicit safe dimensions, so I copied the code from the constructor 
-    // basically to ensure the safe margin gets updated.
-    btVector3 halfExtents = btVector3(mExtents.x, mExtents.y, mExtents.z) / 2.0f;
-    boxShape->setSafeMargin(halfExtents);
-    btVector3 margin(boxShape->getMargin(), boxShape->getMargin(), boxShape->getMargin());
-    boxShape->setImplicitShapeDimensions((halfExtents * boxShape->getLocalScaling()) - margin);
-
-    EnableRigidBody(true);
+    // Box shapes are shared between nodes, so grab the one matching the new extents.
+    glm::vec3 halfExtents = mExtents / 2.0f;
+    SetCollisionShape(CollisionShapeCache::Get()->AcquireBox(halfExtents, GetAbsoluteScale()));
 }
\ No newline at end of file
@@ -392,7 +392,7 @@ glm::vec3 Camera3D::ScreenToWorldPosition(int32_t x, int32_t y)
     return worldPos;
 }
 
-glm::vec3 Camera3D::TraceScreenToWorld(int32_t x, int32_t y, uint8_t colMask, Primitive3D** outComp)
+glm::vec3 Camera3D::TraceScreenToWorld(int32_t x, int32_t y, uint32_t colMask, Primitive3D** outComp)
 {
     glm::vec3 worldPos = ScreenToWorldPosition(x, y);
 
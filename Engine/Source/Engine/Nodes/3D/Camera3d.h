@@ -106,7 +106,7 @@ public:
 
     glm::vec3 WorldToScreenPosition(glm::vec3 worldPos);
     glm::vec3 ScreenToWorldPosition(int32_t x, int32_t y);
-    glm::vec3 TraceScreenToWorld(int32_t x, int32_t y, uint8_t colMask, Primitive3D** outComp = nullptr);
+    glm::vec3 TraceScreenToWorld(int32_t x, int32_t y, uint32_t colMask, Primitive3D** outComp = nullptr);
 
 protected:
 
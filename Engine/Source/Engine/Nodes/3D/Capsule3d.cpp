@@ -2,8 +2,7 @@
 
 #include "AssetManager.h"
 #include "Renderer.h"
-
-#include "BulletCollision/CollisionShapes/btBoxShape.h"
+#include "CollisionShapeCache.h"
 
 FORCE_LINK_DEF(Capsule3D);
 DEFINE_NODE(Capsule3D, Primitive3D);
@@ -110,10 +109,6 @@ void Capsule3D::GatherProxyDraws(std::vector<DebugDraw>& inoutDraws)
 void Capsule3D::Create()
 {
     Primitive3D::Create();
-
-    btCapsuleShape* capsuleShape = new btCapsuleShape(mRadius, mHeight);
-    SetCollisionShape(capsuleShape);
-
     UpdateRigidBody();
 }
 
@@ -161,10 +156,5 @@ void Capsule3D::SetRadius(float radius)
 
 void Capsule3D::UpdateRigidBody()
 {
-    EnableRigidBody(false);
-
-    btCapsuleShape* capsuleShape = static_cast<btCapsuleShape*>(mCollisionShape);
-    capsuleShape->setImplicitShapeDimensions({mRadius, 0.5f * mHeight, mRadius});
-
-    EnableRigidBody(true);
+    SetCollisionShape(CollisionShapeCache::Get()->AcquireCapsule(mRadius, mHeight, GetAbsoluteScale()));
 }
\ No newline at end of file
@@ -0,0 +1,330 @@
+#include "Nodes/3D/CharacterController3d.h"
+
+#include "World.h"
+#include "Profiler.h"
+
+FORCE_LINK_DEF(CharacterController3D);
+DEFINE_NODE(CharacterController3D, Capsule3D);
+
+static const glm::vec3 kUp = { 0.0f, 1.0f, 0.0f };
+static const float kMinMove = 0.0001f;
+
+static float GetHorizontalLength(glm::vec3 vec)
+{
+    return glm::length(glm::vec2(vec.x, vec.z));
+}
+
+bool CharacterController3D::HandlePropChange(Datum* datum, uint32_t index, const void* newValue)
+{
+    Property* prop = static_cast<Property*>(datum);
+    OCT_ASSERT(prop != nullptr);
+    CharacterController3D* controller = static_cast<CharacterController3D*>(prop->mOwner);
+    bool success = false;
+
+    if (prop->mName == "Max Slope Angle")
+    {
+        controller->SetMaxSlopeAngle(*(float*)newValue);
+        success = true;
+    }
+    else if (prop->mName == "Max Slide Iterations")
+    {
+        controller->SetMaxSlideIterations(*(int32_t*)newValue);
+        success = true;
+    }
+
+    return success;
+}
+
+CharacterController3D::CharacterController3D()
+{
+    mName = "Character Controller";
+    mRadius = 0.4f;
+    mHeight = 1.0f;
+    mCollisionEnabled = true;
+}
+
+CharacterController3D::~CharacterController3D()
+{
+
+}
+
+const char* CharacterController3D::GetTypeName() const
+{
+    return "CharacterController";
+}
+
+void CharacterController3D::GatherProperties(std::vector<Property>& outProps)
+{
+    Capsule3D::GatherProperties(outProps);
+
+    SCOPED_CATEGORY("Character");
+
+    outProps.push_back(Property(DatumType::Float, "Max Slope Angle", this, &mMaxSlopeAngle, 1, HandlePropChange));
+    outProps.push_back(Property(DatumType::Float, "Step Height", this, &mStepHeight));
+    outProps.push_back(Property(DatumType::Float, "Snap Distance", this, &mSnapDistance));
+    outProps.push_back(Property(DatumType::Float, "Skin Width", this, &mSkinWidth));
+    outProps.push_back(Property(DatumType::Integer, "Max Slide Iterations", this, &mMaxSlideIterations, 1, HandlePropChange));
+    outProps.push_back(Property(DatumType::Bool, "Ride Platforms", this, &mRidePlatforms));
+}
+
+glm::vec3 CharacterController3D::Move(glm::vec3 displacement)
+{
+    SCOPED_FRAME_STAT("Character Move");
+
+    glm::vec3 startPos = GetAbsolutePosition();
+
+    if (GetWorld() == nullptr ||
+        GetRigidBody() == nullptr ||
+        GetCollisionShape() == nullptr)
+    {
+        SetAbsolutePosition(startPos + displacement);
+        return displacement;
+    }
+
+    glm::vec3 pos = startPos;
+    bool wasGrounded = mGrounded;
+    Primitive3D* prevGround = mGroundNode;
+    glm::mat4 prevGroundInvTransform = mGroundInvTransform;
+
+    mGrounded = false;
+    mGroundNode = nullptr;
+    mGroundNormal = kUp;
+
+    SweepTestResult result;
+
+    // (1) Carry the character along with the primitive it was standing on. The old ground pointer
+    // is only trusted if a fresh sweep hits the same primitive again.
+    if (mRidePlatforms &&
+        wasGrounded &&
+        prevGround != nullptr)
+    {
+        glm::vec3 probePos;
+        if (Sweep(pos, pos - kUp * (mSnapDistance + mSkinWidth * 2.0f), result, probePos) &&
+            result.mHitComponent == prevGround &&
+            IsWalkable(result.mHitNormal))
+        {
+            glm::vec3 carriedPos = glm::vec3(prevGround->GetTransform() * prevGroundInvTransform * glm::vec4(pos, 1.0f));
+            pos = SlideMove(pos, carriedPos - pos);
+        }
+    }
+
+    glm::vec3 vertical = kUp * glm::dot(displacement, kUp);
+    glm::vec3 horizontal = displacement - vertical;
+
+    // (2) Horizontal collide and slide. If blocked while grounded, also try stepping up
+    // and over the obstacle and keep whichever result made more progress.
+    if (glm::dot(horizontal, horizontal) > kMinMove * kMinMove)
+    {
+        glm::vec3 slidePos = SlideMove(pos, horizontal);
+        float desiredDist = glm::length(horizontal);
+        float slideDist = GetHorizontalLength(slidePos - pos);
+
+        if (wasGrounded &&
+            mStepHeight > 0.0f &&
+            slideDist < desiredDist * 0.99f)
+        {
+            glm::vec3 raisedPos;
+            Sweep(pos, pos + kUp * mStepHeight, result, raisedPos);
+            float raised = glm::dot(raisedPos - pos, kUp);
+
+            if (raised > kMinMove)
+            {
+                glm::vec3 stepPos = SlideMove(raisedPos, horizontal);
+                glm::vec3 landPos;
+                bool landed = Sweep(stepPos, stepPos - kUp * raised, result, landPos);
+
+                if ((!landed || IsWalkable(result.mHitNormal)) &&
+                    GetHorizontalLength(landPos - pos) > slideDist + kMinMove)
+                {
+                    slidePos = landPos;
+
+                    if (landed)
+                    {
+                        SetGround(result.mHitComponent, result.mHitNormal);
+                    }
+                }
+            }
+        }
+
+        pos = slidePos;
+    }
+
+    // (3) Vertical movement (gravity / jumping). Landing on a walkable surface grounds the character.
+    if (glm::dot(vertical, vertical) > kMinMove * kMinMove)
+    {
+        pos = SlideMove(pos, vertical);
+    }
+
+    // (4) Keep the character glued to the ground when walking down slopes and stairs.
+    if (!mGrounded &&
+        wasGrounded &&
+        mSnapDistance > 0.0f &&
+        glm::dot(displacement, kUp) <= 0.0f)
+    {
+        glm::vec3 snapPos;
+        if (Sweep(pos, pos - kUp * mSnapDistance, result, snapPos) &&
+            IsWalkable(result.mHitNormal))
+        {
+            pos = snapPos;
+            SetGround(result.mHitComponent, result.mHitNormal);
+        }
+    }
+
+    SetAbsolutePosition(pos);
+
+    return pos - startPos;
+}
+
+bool CharacterController3D::IsGrounded() const
+{
+    return mGrounded;
+}
+
+glm::vec3 CharacterController3D::GetGroundNormal() const
+{
+    return mGroundNormal;
+}
+
+float CharacterController3D::GetMaxSlopeAngle() const
+{
+    return mMaxSlopeAngle;
+}
+
+void CharacterController3D::SetMaxSlopeAngle(float degrees)
+{
+    mMaxSlopeAngle = glm::clamp(degrees, 0.0f, 90.0f);
+}
+
+float CharacterController3D::GetStepHeight() const
+{
+    return mStepHeight;
+}
+
+void CharacterController3D::SetStepHeight(float stepHeight)
+{
+    mStepHeight = stepHeight;
+}
+
+float CharacterController3D::GetSnapDistance() const
+{
+    return mSnapDistance;
+}
+
+void CharacterController3D::SetSnapDistance(float snapDistance)
+{
+    mSnapDistance = snapDistance;
+}
+
+float CharacterController3D::GetSkinWidth() const
+{
+    return mSkinWidth;
+}
+
+void CharacterController3D::SetSkinWidth(float skinWidth)
+{
+    mSkinWidth = skinWidth;
+}
+
+int32_t CharacterController3D::GetMaxSlideIterations() const
+{
+    return mMaxSlideIterations;
+}
+
+void CharacterController3D::SetMaxSlideIterations(int32_t iterations)
+{
+    mMaxSlideIterations = glm::max(iterations, 1);
+}
+
+bool CharacterController3D::GetRidePlatforms() const
+{
+    return mRidePlatforms;
+}
+
+void CharacterController3D::SetRidePlatforms(bool ride)
+{
+    mRidePlatforms = ride;
+}
+
+bool CharacterController3D::IsWalkable(glm::vec3 normal) const
+{
+    return glm::dot(normal, kUp) >= cosf(glm::radians(mMaxSlopeAngle)) - 0.0001f;
+}
+
+bool CharacterController3D::Sweep(glm::vec3 start, glm::vec3 end, SweepTestResult& outResult, glm::vec3& outPos)
+{
+    if (start == end)
+    {
+        outPos = end;
+        return false;
+    }
+
+    GetWorld()->SweepTest(this, start, end, GetCollisionMask(), outResult);
+
+    if (outResult.mHitFraction < 1.0f)
+    {
+        // Stop short of the surface by the skin width so the next sweep doesn't start penetrating.
+        outPos = start + (end - start) * outResult.mHitFraction + outResult.mHitNormal * mSkinWidth;
+        return true;
+    }
+
+    outPos = end;
+    return false;
+}
+
+glm::vec3 CharacterController3D::SlideMove(glm::vec3 position, glm::vec3 delta)
+{
+    const glm::vec3 origDelta = delta;
+
+    for (int32_t i = 0; i < mMaxSlideIterations; ++i)
+    {
+        if (glm::dot(delta, delta) <= kMinMove * kMinMove)
+            break;
+
+        SweepTestResult result;
+        glm::vec3 hitPos;
+
+        if (!Sweep(position, position + delta, result, hitPos))
+        {
+            position = hitPos;
+            break;
+        }
+
+        position = hitPos;
+
+        glm::vec3 normal = result.mHitNormal;
+        bool movingDown = glm::dot(delta, kUp) < 0.0f;
+
+        if (IsWalkable(normal))
+        {
+            if (movingDown)
+            {
+                SetGround(result.mHitComponent, normal);
+            }
+        }
+        else if (!movingDown &&
+            glm::dot(normal, kUp) > 0.0f)
+        {
+            // Treat steep slopes as walls so that sliding along them can't be used to climb them.
+            normal.y = 0.0f;
+            float len = glm::length(normal);
+            normal = (len > kMinMove) ? (normal / len) : result.mHitNormal;
+        }
+
+        glm::vec3 remaining = delta * (1.0f - result.mHitFraction);
+        delta = remaining - normal * glm::dot(remaining, normal);
+
+        // Never slide back against the requested direction, that just causes jitter in corners.
+        if (glm::dot(delta, origDelta) <= 0.0f)
+            break;
+    }
+
+    return position;
+}
+
+void CharacterController3D::SetGround(Primitive3D* ground, glm::vec3 normal)
+{
+    mGrounded = true;
+    mGroundNormal = normal;
+    mGroundNode = ground;
+    mGroundInvTransform = (ground != nullptr) ? glm::inverse(ground->GetTransform()) : glm::mat4(1.0f);
+}
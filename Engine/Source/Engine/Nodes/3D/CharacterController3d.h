@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Nodes/3D/Capsule3d.h"
+
+// Kinematic capsule that moves by sweeping through the world (collide and slide).
+// Call Move() with the desired displacement each frame (including gravity).
+// Handles stepping up small ledges, limiting walkable slopes, snapping down to the
+// ground when walking down slopes / stairs, and riding moving primitives it stands on.
+class CharacterController3D : public Capsule3D
+{
+public:
+
+    DECLARE_NODE(CharacterController3D, Capsule3D);
+
+    CharacterController3D();
+    ~CharacterController3D();
+
+    virtual const char* GetTypeName() const override;
+    virtual void GatherProperties(std::vector<Property>& outProps) override;
+
+    // Returns the displacement that was actually applied.
+    glm::vec3 Move(glm::vec3 displacement);
+
+    bool IsGrounded() const;
+    glm::vec3 GetGroundNormal() const;
+
+    float GetMaxSlopeAngle() const;
+    void SetMaxSlopeAngle(float degrees);
+
+    float GetStepHeight() const;
+    void SetStepHeight(float stepHeight);
+
+    float GetSnapDistance() const;
+    void SetSnapDistance(float snapDistance);
+
+    float GetSkinWidth() const;
+    void SetSkinWidth(float skinWidth);
+
+    int32_t GetMaxSlideIterations() const;
+    void SetMaxSlideIterations(int32_t iterations);
+
+    bool GetRidePlatforms() const;
+    void SetRidePlatforms(bool ride);
+
+    static bool HandlePropChange(Datum* datum, uint32_t index, const void* newValue);
+
+protected:
+
+    bool IsWalkable(glm::vec3 normal) const;
+    bool Sweep(glm::vec3 start, glm::vec3 end, SweepTestResult& outResult, glm::vec3& outPos);
+    glm::vec3 SlideMove(glm::vec3 position, glm::vec3 delta);
+    void SetGround(Primitive3D* ground, glm::vec3 normal);
+
+    float mMaxSlopeAngle = 45.0f;
+    float mStepHeight = 0.35f;
+    float mSnapDistance = 0.25f;
+    float mSkinWidth = 0.01f;
+    int32_t mMaxSlideIterations = 4;
+    bool mRidePlatforms = true;
+
+    // Runtime state
+    bool mGrounded = false;
+    glm::vec3 mGroundNormal = { 0.0f, 1.0f, 0.0f };
+
+    // Only compared against freshly swept primitives, never dereferenced across frames,
+    // since the ground may have been destroyed since the last Move().
+    Primitive3D* mGroundNode = nullptr;
+    glm::mat4 mGroundInvTransform = glm::mat4(1.0f);
+};
@@ -1,6 +1,7 @@
 #include "Nodes/3D/Primitive3d.h"
 #include "World.h"
 #include "Utilities.h"
+#include "CollisionShapeCache.h"
 #include "Log.h"
 #include "Maths.h"
 #include "Renderer.h"
@@ -75,14 +76,24 @@ bool Primitive3D::HandlePropChange(Datum* datum, uint32_t index, const void* new
         primComponent->SetAngularFactor(*static_cast<const glm::vec3*>(newValue));
         success = true;
     }
+    else if (prop->mName == "CCD Motion Threshold")
+    {
+        primComponent->SetCcdMotionThreshold(*static_cast<const float*>(newValue));
+        success = true;
+    }
+    else if (prop->mName == "CCD Swept Sphere Radius")
+    {
+        primComponent->SetCcdSweptSphereRadius(*static_cast<const float*>(newValue));
+        success = true;
+    }
     else if (prop->mName == "Collision Group")
     {
-        primComponent->SetCollisionGroup(*static_cast<const uint8_t*>(newValue));
+        primComponent->SetCollisionGroup(*static_cast<const uint32_t*>(newValue));
         success = true;
     }
     else if (prop->mName == "Collision Mask")
     {
-        primComponent->SetCollisionMask(*static_cast<const uint8_t*>(newValue));
+        primComponent->SetCollisionMask(*static_cast<const uint32_t*>(newValue));
         success = true;
     }
     else if (prop->mName == "Overlaps")
@@ -118,12 +129,16 @@ Primitive3D::Primitive3D() :
     mAngularFactor(1.0f, 1.0f, 1.0f),
     mCollisionGroup(ColGroup0),
     mCollisionMask(ColGroupAll),
+    mCcdMotionThreshold(0.0f),
+    mCcdSweptSphereRadius(0.0f),
+    mNumOverlaps(0),
     mPhysicsEnabled(false),
     mCollisionEnabled(false),
     mOverlapsEnabled(false),
     mCastShadows(false),
     mReceiveShadows(true),
-    mReceiveSimpleShadows(true)
+    mReceiveSimpleShadows(true),
+    mTransformPushQueued(false)
     //mBeginOverlapHandler(nullptr),
     //mEndOverlapHandler(nullptr),
     //mCollisionHandler(nullptr)
@@ -152,6 +167,11 @@ void Primitive3D::Destroy()
 {
     Node3D::Destroy();
 
+    if (mTransformPushQueued && GetWorld() != nullptr)
+    {
+        GetWorld()->FlushTransformPushes();
+    }
+
     if (GetWorld() && IsRigidBodyInWorld())
     {
         GetWorld()->GetDynamicsWorld()->removeRigidBody(mRigidBody);
@@ -182,44 +202,6 @@ bool Primitive3D::IsPrimitive3D() const
     return true;
 }
 
-void Primitive3D::Tick(float deltaTime)
-{
-    Node3D::Tick(deltaTime);
-
-    bool gameTickEnabled = IsGameTickEnabled();
-
-    if (gameTickEnabled && mPhysicsEnabled)
-    {
-        if (mTransformDirty)
-        {
-            UpdateTransform(false);
-        }
-        else
-        {
-            // Sync the component transform with the physics transform
-            glm::vec3 worldScale = GetAbsoluteScale();
-            glm::mat4 physTransform(1);
-
-            if (mPhysicsEnabled)
-            {
-                physTransform = mMotionState->GetTransform();
-            }
-            else
-            {
-                mRigidBody->getWorldTransform().getOpenGLMatrix(glm::value_ptr(physTransform));
-            }
-
-            physTransform = glm::scale(physTransform, worldScale);
-
-            // Do not call Primitive3D's SetTransform, because it will
-            // remove / add the rigidbody to the world, which will mess up its velocity/acceleration.
-            // In this case, we just want to update our position/rotation/scale from the new transform
-            // and also dirty child transforms.
-            Node3D::SetTransform(physTransform);
-        }
-    }
-}
-
 void Primitive3D::GatherProperties(std::vector<Property>& outProps)
 {
     Node3D::GatherProperties(outProps);
@@ -242,8 +224,10 @@ void Primitive3D::GatherProperties(std::vector<Property>& outProps)
     outProps.push_back(Property(DatumType::Float, "Angular Damping", this, &mAngularDamping, 1, HandlePropChange));
     outProps.push_back(Property(DatumType::Vector, "Linear Factor", this, &mLinearFactor, 1, HandlePropChange));
     outProps.push_back(Property(DatumType::Vector, "Angular Factor", this, &mAngularFactor, 1, HandlePropChange));
-    outProps.push_back(Property(DatumType::Byte, "Collision Group", this, &mCollisionGroup, 1, HandlePropChange, (int32_t)ByteExtra::FlagWidget));
-    outProps.push_back(Property(DatumType::Byte, "Collision Mask", this, &mCollisionMask, 1, HandlePropChange, (int32_t)ByteExtra::FlagWidget));
+    outProps.push_back(Property(DatumType::Float, "CCD Motion Threshold", this, &mCcdMotionThreshold, 1, HandlePropChange));
+    outProps.push_back(Property(DatumType::Float, "CCD Swept Sphere Radius", this, &mCcdSweptSphereRadius, 1, HandlePropChange));
+    outProps.push_back(Property(DatumType::Integer, "Collision Group", this, &mCollisionGroup, 1, HandlePropChange, (int32_t)IntegerExtra::FlagWidget));
+    outProps.push_back(Property(DatumType::Integer, "Collision Mask", this, &mCollisionMask, 1, HandlePropChange, (int32_t)IntegerExtra::FlagWidget));
 }
 
 void Primitive3D::LoadStream(Stream& stream)
@@ -263,8 +247,17 @@ void Primitive3D::LoadStream(Stream& stream)
     SetAngularDamping(stream.ReadFloat());
     SetLinearFactor(stream.ReadVec3());
     SetAngularFactor(stream.ReadVec3());
-    SetCollisionGroup(stream.ReadUint8());
-    SetCollisionMask(stream.ReadUint8());
+
+    if (stream.GetAssetVersion() >= ASSET_VERSION_COLLISION_LAYERS)
+    {
+        SetCollisionGroup(stream.ReadUint32());
+        SetCollisionMask(stream.ReadUint32());
+    }
+    else
+    {
+        SetCollisionGroup(stream.ReadUint8());
+        SetCollisionMask(WidenLegacyCollisionMask(stream.ReadUint8()));
+    }
 }
 
 void Primitive3D::SaveStream(Stream& stream)
@@ -284,8 +277,8 @@ void Primitive3D::SaveStream(Stream& stream)
     stream.WriteFloat(mAngularDamping);
     stream.WriteVec3(mLinearFactor);
     stream.WriteVec3(mAngularFactor);
-    stream.WriteUint8(mCollisionGroup);
-    stream.WriteUint8(mCollisionMask);
+    stream.WriteUint32(mCollisionGroup);
+    stream.WriteUint32(mCollisionMask);
 }
 
 void Primitive3D::SetWorld(World* world)
@@ -325,7 +318,7 @@ void Primitive3D::UpdateTransform(bool updateChildren)
     
     if (updateRigidBody)
     {
-        FullSyncRigidBodyTransform();
+        QueueTransformPush();
     }
 }
 
@@ -335,7 +328,7 @@ void Primitive3D::SetTransform(const glm::mat4& transform)
 
     if (IsRigidBodyInWorld())
     {
-        FullSyncRigidBodyTransform();
+        QueueTransformPush();
     }
 }
 
@@ -398,6 +391,11 @@ bool Primitive3D::AreOverlapsEnabled() const
     return mOverlapsEnabled;
 }
 
+uint32_t Primitive3D::GetNumOverlaps() const
+{
+    return mNumOverlaps;
+}
+
 float Primitive3D::GetMass() const
 {
     return mMass;
@@ -438,16 +436,26 @@ glm::vec3 Primitive3D::GetAngularFactor() const
     return mAngularFactor;
 }
 
-uint8_t Primitive3D::GetCollisionGroup() const
+uint32_t Primitive3D::GetCollisionGroup() const
 {
     return mCollisionGroup;
 }
 
-uint8_t Primitive3D::GetCollisionMask() const
+uint32_t Primitive3D::GetCollisionMask() const
 {
     return mCollisionMask;
 }
 
+float Primitive3D::GetCcdMotionThreshold() const
+{
+    return mCcdMotionThreshold;
+}
+
+float Primitive3D::GetCcdSweptSphereRadius() const
+{
+    return mCcdSweptSphereRadius;
+}
+
 void Primitive3D::SetMass(float mass)
 {
     if (mass != mMass)
@@ -531,22 +539,48 @@ void Primitive3D::SetAngularFactor(glm::vec3 angularFactor)
     );
 }
 
-void Primitive3D::SetCollisionGroup(uint8_t group)
+void Primitive3D::SetCollisionGroup(uint32_t group)
 {
     EnableRigidBody(false);
     mCollisionGroup = group;
     EnableRigidBody(true);
 }
 
-void Primitive3D::SetCollisionMask(uint8_t mask)
+void Primitive3D::SetCollisionMask(uint32_t mask)
 {
     EnableRigidBody(false);
     mCollisionMask = mask;
     EnableRigidBody(true);
 }
 
+void Primitive3D::SetCcdMotionThreshold(float threshold)
+{
+    threshold = glm::max(threshold, 0.0f);
+
+    UPDATE_RIGID_BODY_PROPERTY
+    (
+        mCcdMotionThreshold,
+        threshold,
+        mRigidBody->setCcdMotionThreshold(threshold)
+    );
+}
+
+void Primitive3D::SetCcdSweptSphereRadius(float radius)
+{
+    radius = glm::max(radius, 0.0f);
+
+    UPDATE_RIGID_BODY_PROPERTY
+    (
+        mCcdSweptSphereRadius,
+        radius,
+        mRigidBody->setCcdSweptSphereRadius(radius)
+    );
+}
+
 glm::vec3 Primitive3D::GetLinearVelocity() const
 {
+    WaitForPhysics();
+
     btVector3 linearVelocity;
     linearVelocity = mRigidBody->getLinearVelocity();
     return { linearVelocity.x(), linearVelocity.y(), linearVelocity.z() };
@@ -554,6 +588,8 @@ glm::vec3 Primitive3D::GetLinearVelocity() const
 
 glm::vec3 Primitive3D::GetAngularVelocity() const
 {
+    WaitForPhysics();
+
     btVector3 angularVelocity;
     angularVelocity = mRigidBody->getAngularVelocity();
     return { angularVelocity.x(), angularVelocity.y(), angularVelocity.z() };
@@ -561,6 +597,9 @@ glm::vec3 Primitive3D::GetAngularVelocity() const
 
 void Primitive3D::AddLinearVelocity(glm::vec3 deltaVelocity)
 {
+    if (QueuePhysicsCommand(PhysicsCommandType::AddLinearVelocity, deltaVelocity))
+        return;
+
     if (mRigidBody)
     {
         btVector3 delta = { deltaVelocity.x, deltaVelocity.y, deltaVelocity.z };
@@ -571,6 +610,9 @@ void Primitive3D::AddLinearVelocity(glm::vec3 deltaVelocity)
 
 void Primitive3D::AddAngularVelocity(glm::vec3 deltaVelocity)
 {
+    if (QueuePhysicsCommand(PhysicsCommandType::AddAngularVelocity, deltaVelocity))
+        return;
+
     if (mRigidBody)
     {
         btVector3 delta = { deltaVelocity.x, deltaVelocity.y, deltaVelocity.z };
@@ -581,6 +623,9 @@ void Primitive3D::AddAngularVelocity(glm::vec3 deltaVelocity)
 
 void Primitive3D::SetLinearVelocity(glm::vec3 linearVelocity)
 {
+    if (QueuePhysicsCommand(PhysicsCommandType::SetLinearVelocity, linearVelocity))
+        return;
+
     if (mRigidBody)
     {
         btVector3 velocity = { linearVelocity.x, linearVelocity.y, linearVelocity.z };
@@ -591,6 +636,9 @@ void Primitive3D::SetLinearVelocity(glm::vec3 linearVelocity)
 
 void Primitive3D::SetAngularVelocity(glm::vec3 angularVelocity)
 {
+    if (QueuePhysicsCommand(PhysicsCommandType::SetAngularVelocity, angularVelocity))
+        return;
+
     if (mRigidBody)
     {
         btVector3 velocity = { angularVelocity.x, angularVelocity.y, angularVelocity.z };
@@ -601,6 +649,9 @@ void Primitive3D::SetAngularVelocity(glm::vec3 angularVelocity)
 
 void Primitive3D::AddForce(glm::vec3 force)
 {
+    if (QueuePhysicsCommand(PhysicsCommandType::AddForce, force))
+        return;
+
     if (mRigidBody)
     {
         btVector3 forceBt = { force.x, force.y, force.z };
@@ -611,6 +662,9 @@ void Primitive3D::AddForce(glm::vec3 force)
 
 void Primitive3D::AddImpulse(glm::vec3 impulse)
 {
+    if (QueuePhysicsCommand(PhysicsCommandType::AddImpulse, impulse))
+        return;
+
     if (mRigidBody)
     {
         btVector3 impulseBt = { impulse.x, impulse.y, impulse.z };
@@ -621,6 +675,8 @@ void Primitive3D::AddImpulse(glm::vec3 impulse)
 
 void Primitive3D::ClearForces()
 {
+    WaitForPhysics();
+
     if (mRigidBody)
     {
         mRigidBody->clearForces();
@@ -640,6 +696,9 @@ void Primitive3D::FullSyncRigidBodyTransform()
 
 void Primitive3D::SyncRigidBodyTransform()
 {
+    if (QueuePhysicsCommand(PhysicsCommandType::SyncTransform))
+        return;
+
     if (GetWorld() != nullptr)
     {
         if (mRigidBody != nullptr)
@@ -677,7 +736,40 @@ void Primitive3D::SyncRigidBodyTransform()
         if (mCollisionShape != nullptr)
         {
             glm::vec3 worldScale = GetAbsoluteScale();
-            mCollisionShape->setLocalScaling(btVector3(worldScale.x, worldScale.y, worldScale.z));
+            CollisionShapeCache* shapeCache = CollisionShapeCache::Get();
+
+            if (shapeCache->IsCached(mCollisionShape))
+            {
+                // Shared shapes can't be scaled in place, so switch to the shape with the new scale.
+                btCollisionShape* oldShape = mCollisionShape;
+                btCollisionShape* newShape = shapeCache->AcquireRescaled(oldShape, worldScale);
+
+                if (newShape != oldShape)
+                {
+                    mCollisionShape = newShape;
+
+                    if (mRigidBody != nullptr)
+                    {
+                        if (mRigidBody->getBroadphaseHandle() != nullptr)
+                        {
+                            // Drop cached collision algorithms that point at the old shape.
+                            btDynamicsWorld* dynamicsWorld = GetWorld()->GetDynamicsWorld();
+                            dynamicsWorld->getBroadphase()->getOverlappingPairCache()->cleanProxyFromPairs(
+                                mRigidBody->getBroadphaseHandle(),
+                                dynamicsWorld->getDispatcher());
+                        }
+
+                        mRigidBody->setCollisionShape(mCollisionShape);
+                    }
+
+                    // Only release the old shape once nothing points at it, it may be destroyed here.
+                    shapeCache->Release(oldShape);
+                }
+            }
+            else
+            {
+                mCollisionShape->setLocalScaling(btVector3(worldScale.x, worldScale.y, worldScale.z));
+            }
         }
     }
 }
@@ -799,7 +891,7 @@ void Primitive3D::SetCollisionShape(btCollisionShape* newShape)
     EnableRigidBody(true);
 }
 
-bool Primitive3D::SweepToWorldPosition(glm::vec3 position, SweepTestResult& outSweepResult, uint8_t mask)
+bool Primitive3D::SweepToWorldPosition(glm::vec3 position, SweepTestResult& outSweepResult, uint32_t mask)
 {
     bool hit = false;
     glm::vec3 startPos = GetAbsolutePosition();
@@ -967,6 +1059,8 @@ void Primitive3D::EnableRigidBody(bool enable)
             mRigidBody->setRollingFriction(mRollingFriction);
             mRigidBody->setLinearFactor({ mLinearFactor.x, mLinearFactor.y, mLinearFactor.z });
             mRigidBody->setAngularFactor({ mAngularFactor.x, mAngularFactor.y, mAngularFactor.z });
+            mRigidBody->setCcdMotionThreshold(mCcdMotionThreshold);
+            mRigidBody->setCcdSweptSphereRadius(mCcdSweptSphereRadius);
         }
 
         if (!IsRigidBodyInWorld())
@@ -983,12 +1077,110 @@ void Primitive3D::EnableRigidBody(bool enable)
     }
 }
 
+bool Primitive3D::QueuePhysicsCommand(PhysicsCommandType type, glm::vec3 value)
+{
+    // While a pipelined physics step is running, rigid bodies in the dynamics world
+    // can't be touched. Defer the change until the world syncs with the physics thread.
+    bool queued = false;
+
+    if (mWorld != nullptr &&
+        mWorld->IsPhysicsStepInFlight() &&
+        IsRigidBodyInWorld())
+    {
+        PhysicsCommand command;
+        command.mType = type;
+        command.mPrimitive = this;
+        command.mValue = value;
+        mWorld->QueuePhysicsCommand(command);
+        queued = true;
+    }
+
+    return queued;
+}
+
+void Primitive3D::WaitForPhysics() const
+{
+    if (mWorld != nullptr)
+    {
+        mWorld->SyncPhysics();
+    }
+}
+
+void Primitive3D::QueueTransformPush()
+{
+    if (!mTransformPushQueued && GetWorld() != nullptr)
+    {
+        mTransformPushQueued = true;
+        GetWorld()->QueueTransformPush(this);
+    }
+}
+
+void Primitive3D::PushTransformToPhysics()
+{
+    mTransformPushQueued = false;
+
+    if (!IsRigidBodyInWorld())
+        return;
+
+    if (mPhysicsEnabled)
+    {
+        FullSyncRigidBodyTransform();
+    }
+    else
+    {
+        // Static and kinematic bodies don't need to be re-added to the world. Updating the
+        // transform and the broadphase bounds is enough and is much cheaper.
+        // Fetching the dynamics world first waits for an in-flight step, the body can't be touched before that.
+        btDynamicsWorld* dynamicsWorld = GetWorld()->GetDynamicsWorld();
+        SyncRigidBodyTransform();
+        mRigidBody->activate(true);
+        dynamicsWorld->updateSingleAabb(mRigidBody);
+    }
+}
+
+void Primitive3D::PullTransformFromPhysics()
+{
+    if (!mPhysicsEnabled ||
+        !IsActive() ||
+        IsPendingDestroy())
+    {
+        return;
+    }
+
+    if (mTransformDirty)
+    {
+        // The node was moved after the step, so its transform wins and is pushed to the body.
+        UpdateTransform(false);
+    }
+    else
+    {
+        // Sync the component transform with the physics transform
+        ApplyPhysicsTransform(mMotionState->GetTransform());
+    }
+}
+
+void Primitive3D::ApplyPhysicsTransform(glm::mat4 physTransform)
+{
+    glm::vec3 worldScale = GetAbsoluteScale();
+    physTransform = glm::scale(physTransform, worldScale);
+
+    // Do not call Primitive3D's SetTransform, because it will
+    // remove / add the rigidbody to the world, which will mess up its velocity/acceleration.
+    // In this case, we just want to update our position/rotation/scale from the new transform
+    // and also dirty child transforms.
+    Node3D::SetTransform(physTransform);
+}
+
 void Primitive3D::DestroyComponentCollisionShape()
 {
     if (mCollisionShape != nullptr &&
         mCollisionShape != GetEmptyCollisionShape())
     {
-        DestroyCollisionShape(mCollisionShape);
+        if (!CollisionShapeCache::Get()->Release(mCollisionShape))
+        {
+            DestroyCollisionShape(mCollisionShape);
+        }
+
         mCollisionShape = nullptr;
     }
 }
@@ -56,7 +56,6 @@ public:
 
     virtual const char* GetTypeName() const override;
     virtual bool IsPrimitive3D() const override;
-    virtual void Tick(float deltaTime) override;
     virtual void GatherProperties(std::vector<Property>& outProps) override;
 
     virtual void LoadStream(Stream& stream) override;
@@ -74,6 +73,7 @@ public:
     bool IsPhysicsEnabled() const;
     bool IsCollisionEnabled() const;
     bool AreOverlapsEnabled() const;
+    uint32_t GetNumOverlaps() const;
 
     float GetMass() const;
     float GetLinearDamping() const;
@@ -83,8 +83,10 @@ public:
     float GetRollingFriction();
     glm::vec3 GetLinearFactor() const;
     glm::vec3 GetAngularFactor() const;
-    uint8_t GetCollisionGroup() const;
-    uint8_t GetCollisionMask() const;
+    uint32_t GetCollisionGroup() const;
+    uint32_t GetCollisionMask() const;
+    float GetCcdMotionThreshold() const;
+    float GetCcdSweptSphereRadius() const;
 
     void SetMass(float mass);
     void SetLinearDamping(float linearDamping);
@@ -94,8 +96,14 @@ public:
     void SetRollingFriction(float rollingFriction);
     void SetLinearFactor(glm::vec3 linearFactor);
     void SetAngularFactor(glm::vec3 angularFactor);
-    void SetCollisionGroup(uint8_t group);
-    void SetCollisionMask(uint8_t mask);
+    void SetCollisionGroup(uint32_t group);
+    void SetCollisionMask(uint32_t mask);
+
+    // Continuous collision detection. When the body moves further than the motion threshold in a
+    // substep, a sphere of the swept radius is swept along the motion to stop it from tunneling.
+    // A threshold of 0 disables CCD. The radius should be a bit smaller than the shape.
+    void SetCcdMotionThreshold(float threshold);
+    void SetCcdSweptSphereRadius(float radius);
 
     glm::vec3 GetLinearVelocity() const;
     glm::vec3 GetAngularVelocity() const;
@@ -130,7 +138,7 @@ public:
     void SetCollisionShape(btCollisionShape* newShape);
 
     // When passing in the mask as 0, it means use the primitive's collision mask
-    bool SweepToWorldPosition(glm::vec3 position, SweepTestResult& outSweepResult, uint8_t mask = 0);
+    bool SweepToWorldPosition(glm::vec3 position, SweepTestResult& outSweepResult, uint32_t mask = 0);
 
     Bounds GetBounds() const;
     virtual Bounds GetLocalBounds() const;
@@ -146,7 +154,13 @@ protected:
 
     bool IsRigidBodyInWorld() const;
     void EnableRigidBody(bool enable);
+    bool QueuePhysicsCommand(PhysicsCommandType type, glm::vec3 value = {});
+    void WaitForPhysics() const;
     void DestroyComponentCollisionShape();
+    void QueueTransformPush();
+    void PushTransformToPhysics();
+    void PullTransformFromPhysics();
+    void ApplyPhysicsTransform(glm::mat4 physTransform);
 
     btRigidBody* mRigidBody;
     OctaveMotionState* mMotionState;
@@ -161,8 +175,14 @@ protected:
     float mAngularDamping;
     glm::vec3 mLinearFactor;
     glm::vec3 mAngularFactor;
-    uint8_t mCollisionGroup;
-    uint8_t mCollisionMask;
+    uint32_t mCollisionGroup;
+    uint32_t mCollisionMask;
+    float mCcdMotionThreshold;
+    float mCcdSweptSphereRadius;
+
+    // Number of primitives currently overlapping this one. Maintained by World.
+    uint32_t mNumOverlaps;
+    friend class World;
 
     bool mPhysicsEnabled;
     bool mCollisionEnabled;
@@ -170,6 +190,7 @@ protected:
     bool mCastShadows;
     bool mReceiveShadows;
     bool mReceiveSimpleShadows;
+    bool mTransformPushQueued;
     //BeginOverlapHandlerFP mBeginOverlapHandler;
     //EndOverlapHandlerFP mEndOverlapHandler;
     //CollisionHandlerFP mCollisionHandler;
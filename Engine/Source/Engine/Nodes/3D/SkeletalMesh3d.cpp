@@ -581,7 +581,7 @@ void SkeletalMesh3D::DetectTriggeredAnimEvents(
     float prevTickTime,
     float tickTime,
     float animationSpeed,
-    std::vector<AnimEvent>& outEvents)
+    FrameVector<AnimEvent>& outEvents)
 {
     const std::vector<AnimEventTrack>& eventTracks = animation.mEventTracks;
 
@@ -877,10 +877,8 @@ void SkeletalMesh3D::UpdateAnimation(float deltaTime, bool updateBones)
     if (mHasAnimatedThisFrame)
         return;
 
-    static std::vector<DecompTransform> sDecompTransforms;
-    static std::vector<AnimEvent> sAnimEvents;
-    sAnimEvents.clear();
-    sDecompTransforms.clear();
+    FrameVector<DecompTransform> decompTransforms;
+    FrameVector<AnimEvent> animEvents;
 
     SkeletalMesh* mesh = mSkeletalMesh.Get<SkeletalMesh>();
 
@@ -924,7 +922,7 @@ void SkeletalMesh3D::UpdateAnimation(float deltaTime, bool updateBones)
         (mActiveAnimations.size() > 0 || mRevertToBindPose))
     {
         uint32_t numBones = GetNumBones();
-        sDecompTransforms.resize(numBones);
+        decompTransforms.resize(numBones);
 
         if (updateBones)
         {
@@ -999,26 +997,26 @@ void SkeletalMesh3D::UpdateAnimation(float deltaTime, bool updateBones)
 
                                     if (bonesUpdated)
                                     {
-                                        sDecompTransforms[boneIndex].mPosition = glm::mix(sDecompTransforms[boneIndex].mPosition, position, weight);
-                                        sDecompTransforms[boneIndex].mRotation = glm::slerp(sDecompTransforms[boneIndex].mRotation, rotation, weight);
-                                        sDecompTransforms[boneIndex].mScale = glm::mix(sDecompTransforms[boneIndex].mScale, scale, weight);
+                                        decompTransforms[boneIndex].mPosition = glm::mix(decompTransforms[boneIndex].mPosition, position, weight);
+                                        decompTransforms[boneIndex].mRotation = glm::slerp(decompTransforms[boneIndex].mRotation, rotation, weight);
+                                        decompTransforms[boneIndex].mScale = glm::mix(decompTransforms[boneIndex].mScale, scale, weight);
                                     }
                                     else
                                     {
                                         // First animation doesn't need lerps.
-                                        sDecompTransforms[boneIndex].mPosition = position;
-                                        sDecompTransforms[boneIndex].mRotation = rotation;
-                                        sDecompTransforms[boneIndex].mScale = scale;
+                                        decompTransforms[boneIndex].mPosition = position;
+                                        decompTransforms[boneIndex].mRotation = rotation;
+                                        decompTransforms[boneIndex].mScale = scale;
                                     }
 
-                                    sDecompTransforms[boneIndex].mValid = true;
+                                    decompTransforms[boneIndex].mValid = true;
                                 }
                             }
                         }
 
                         if (anim->mEventTracks.size() > 0)
                         {
-                            DetectTriggeredAnimEvents(*anim, prevTickTime, tickTime, animationSpeed, sAnimEvents);
+                            DetectTriggeredAnimEvents(*anim, prevTickTime, tickTime, animationSpeed, animEvents);
                         }
 
                         bonesUpdated = true;
@@ -1065,15 +1063,15 @@ void SkeletalMesh3D::UpdateAnimation(float deltaTime, bool updateBones)
                 // Create matrices from lerped pos/rot/scale
                 for (uint32_t i = 0; i < numBones; ++i)
                 {
-                    if (sDecompTransforms[i].mValid)
+                    if (decompTransforms[i].mValid)
                     {
                         glm::mat4& transform = mBoneMatrices[i];
 
                         transform = glm::mat4(1.0f);
 
-                        transform = glm::translate(transform, sDecompTransforms[i].mPosition);
-                        transform *= glm::toMat4(sDecompTransforms[i].mRotation);
-                        transform = glm::scale(transform, sDecompTransforms[i].mScale);
+                        transform = glm::translate(transform, decompTransforms[i].mPosition);
+                        transform *= glm::toMat4(decompTransforms[i].mRotation);
+                        transform = glm::scale(transform, decompTransforms[i].mScale);
                     }
                 }
             }
@@ -1089,24 +1087,24 @@ void SkeletalMesh3D::UpdateAnimation(float deltaTime, bool updateBones)
         // Fire off any events that triggered.
         if (mAnimEventHandler.mFuncPointer != nullptr)
         {
-            for (uint32_t i = 0; i < sAnimEvents.size(); ++i)
+            for (uint32_t i = 0; i < animEvents.size(); ++i)
             {
-                sAnimEvents[i].mNode = this;
-                mAnimEventHandler.mFuncPointer(sAnimEvents[i]);
+                animEvents[i].mNode = this;
+                mAnimEventHandler.mFuncPointer(animEvents[i]);
             }
         }
         if (mAnimEventHandler.mScriptFunc.IsValid())
         {
-            for (uint32_t i = 0; i < sAnimEvents.size(); ++i)
+            for (uint32_t i = 0; i < animEvents.size(); ++i)
             {
-                sAnimEvents[i].mNode = this;
+                animEvents[i].mNode = this;
 
                 Datum animTable;
-                animTable.SetPointerField("node", sAnimEvents[i].mNode);
-                animTable.SetStringField("name", sAnimEvents[i].mName);
-                animTable.SetStringField("animation", sAnimEvents[i].mAnimation);
-                animTable.SetFloatField("time", sAnimEvents[i].mTime);
-                animTable.SetVectorField("value", sAnimEvents[i].mValue);
+                animTable.SetPointerField("node", animEvents[i].mNode);
+                animTable.SetStringField("name", animEvents[i].mName);
+                animTable.SetStringField("animation", animEvents[i].mAnimation);
+                animTable.SetFloatField("time", animEvents[i].mTime);
+                animTable.SetVectorField("value", animEvents[i].mValue);
 
                 mAnimEventHandler.mScriptFunc.Call(animTable);
             }
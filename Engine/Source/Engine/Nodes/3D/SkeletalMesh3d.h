@@ -3,6 +3,7 @@
 #include "Nodes/3D/Mesh3d.h"
 #include "AssetRef.h"
 #include "Vertex.h"
+#include "FrameAllocator.h"
 
 enum class BoneInfluenceMode
 {
@@ -156,7 +157,7 @@ protected:
         float prevTickTime,
         float tickTime,
         float animationSpeed,
-        std::vector<AnimEvent>& outEvents);
+        FrameVector<AnimEvent>& outEvents);
 
     uint32_t FindScaleIndex(float time, const Channel& channel);
     uint32_t FindRotationIndex(float time, const Channel& channel);
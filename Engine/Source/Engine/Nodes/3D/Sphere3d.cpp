@@ -2,8 +2,7 @@
 
 #include "AssetManager.h"
 #include "Renderer.h"
-
-#include "BulletCollision/CollisionShapes/btSphereShape.h"
+#include "CollisionShapeCache.h"
 
 FORCE_LINK_DEF(Sphere3D);
 DEFINE_NODE(Sphere3D, Primitive3D);
@@ -75,7 +74,6 @@ void Sphere3D::GatherProxyDraws(std::vector<DebugDraw>& inoutDraws)
 void Sphere3D::Create()
 {
     Primitive3D::Create();
-    SetCollisionShape(new btSphereShape(mRadius));
     UpdateRigidBody();
 }
 
@@ -107,13 +105,5 @@ void Sphere3D::SetRadius(float radius)
 
 void Sphere3D::UpdateRigidBody()
 {
-    EnableRigidBody(false);
-
-    btSphereShape* sphereShape = static_cast<btSphereShape*>(mCollisionShape);
-
-    // This logic is copied from the btSphereShape constructor
-    sphereShape->setImplicitShapeDimensions({ mRadius, 0.0f, 0.0f });
-    sphereShape->setMargin(mRadius);
-
-    EnableRigidBody(true);
+    SetCollisionShape(CollisionShapeCache::Get()->AcquireSphere(mRadius, GetAbsoluteScale()));
 }
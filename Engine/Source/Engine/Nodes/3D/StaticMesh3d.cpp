@@ -5,6 +5,7 @@
 #include "AssetManager.h"
 #include "Log.h"
 #include "Utilities.h"
+#include "CollisionShapeCache.h"
 
 #include "Graphics/Graphics.h"
 
@@ -380,17 +381,21 @@ void StaticMesh3D::RecreateCollisionShape()
 
     if (staticMesh != nullptr)
     {
+        // Nodes that share a mesh and scale also share the collision shape.
+        CollisionShapeCache* shapeCache = CollisionShapeCache::Get();
+        glm::vec3 scale = GetAbsoluteScale();
+
         if (mUseTriangleCollision && staticMesh->GetTriangleCollisionShape())
         {
-            glm::vec3 scale = GetAbsoluteScale();
-            btVector3 btscale = btVector3(scale.x, scale.y, scale.z);
-            btScaledBvhTriangleMeshShape* scaledTriangleShape = new btScaledBvhTriangleMeshShape(staticMesh->GetTriangleCollisionShape(), btscale);
-            SetCollisionShape(scaledTriangleShape);
+            SetCollisionShape(shapeCache->AcquireScaledTriangleMesh(staticMesh->GetTriangleCollisionShape(), scale));
+        }
+        else if (staticMesh->GetCollisionShape() != nullptr)
+        {
+            SetCollisionShape(shapeCache->AcquireMeshCopy(staticMesh->GetCollisionShape(), scale));
         }
         else
         {
-            btCollisionShape* newShape = CloneCollisionShape(staticMesh->GetCollisionShape());
-            SetCollisionShape(newShape);
+            SetCollisionShape(Primitive3D::GetEmptyCollisionShape());
         }
     }
     else
@@ -297,20 +297,13 @@ void Node::Copy(Node* srcNode, bool recurse)
     std::vector<Property> dstProps;
     GatherProperties(dstProps);
 
+    PropertyMatcher matcher;
+    static const uint32_t sScriptNameId = Property::InternName("Script");
+
     for (uint32_t i = 0; i < srcProps.size(); ++i)
     {
         Property* srcProp = &srcProps[i];
-        Property* dstProp = nullptr;
-
-        for (uint32_t j = 0; j < dstProps.size(); ++j)
-        {
-            if (dstProps[j].mName == srcProp->mName &&
-                dstProps[j].mType == srcProp->mType)
-            {
-                dstProp = &dstProps[j];
-                break;
-            }
-        }
+        Property* dstProp = matcher.Match(dstProps, *srcProp);
 
         if (dstProp != nullptr)
         {
@@ -331,10 +324,11 @@ void Node::Copy(Node* srcNode, bool recurse)
         // that will change the number of properties on the script so we need to regather them.
         // Script component is really the only component that can dynamically change its properties,
         // so I'm adding a hack now just for script component.
-        if (srcProp->mName == "Script")
+        if (srcProp->GetNameId() == sScriptNameId)
         {
             dstProps.clear();
             GatherProperties(dstProps);
+            matcher.Reset();
         }
     }
 
@@ -57,6 +57,12 @@ void Poly::TickCommon(float deltaTime)
 void Poly::Render()
 {
     Widget::Render();
+
+    if (GetTexture() != nullptr)
+    {
+        Renderer::Get()->GetTextureStreamer()->RequestMip(GetTexture(), 0);
+    }
+
     GFX_DrawPoly(this);
 }
 
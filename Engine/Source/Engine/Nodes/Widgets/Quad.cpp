@@ -213,6 +213,13 @@ void Quad::UpdateVertexData()
 void Quad::Render()
 {
     Widget::Render();
+
+    // Widgets are drawn at whatever size they're laid out at, so keep every mip around.
+    if (GetTexture() != nullptr)
+    {
+        Renderer::Get()->GetTextureStreamer()->RequestMip(GetTexture(), 0);
+    }
+
     GFX_DrawQuad(this);
 }
 
@@ -3,6 +3,7 @@
 #include "AssetManager.h"
 #include "Renderer.h"
 #include "Profiler.h"
+#include "FrameAllocator.h"
 #include "Engine.h"
 #include "NetworkManager.h"
 
@@ -47,6 +48,9 @@ void StatsOverlay::TickCommon(float deltaTime)
         numStats = 1;
         break;
     case StatDisplayMode::CpuStatText:
+        numStats = (uint32_t)GetProfiler()->GetCpuFrameStats().size();
+        numStats += (uint32_t)GetProfiler()->GetFrameCounters().size();
+        break;
     case StatDisplayMode::CpuStatBars:
         numStats = (uint32_t)GetProfiler()->GetCpuFrameStats().size();
         break;
@@ -56,10 +60,11 @@ void StatsOverlay::TickCommon(float deltaTime)
         break;
     case StatDisplayMode::AllStatText:
         numStats = (uint32_t)GetProfiler()->GetCpuFrameStats().size();
+        numStats += (uint32_t)GetProfiler()->GetFrameCounters().size();
         numStats += (uint32_t)GetProfiler()->GetGpuStats().size();
         break;
     case StatDisplayMode::Memory:
-        numStats = 1;
+        numStats = 3;
         break;
     case StatDisplayMode::Network:
         numStats = 2;
@@ -107,6 +112,8 @@ void StatsOverlay::TickCommon(float deltaTime)
 #else
         SetStatText(0, "Free Memory", SYS_GetNumBytesFree() / static_cast<float>(1024 * 1024), DEFAULT_STAT_COLOR, statY);
 #endif
+        SetStatText(1, "Heap Allocs", (float)GetProfiler()->GetFrameHeapAllocs(), DEFAULT_STAT_COLOR, statY);
+        SetStatText(2, "Frame Alloc KB", GetFrameAllocator()->GetBytesUsed() / 1024.0f, DEFAULT_STAT_COLOR, statY);
     }
     else if (mDisplayMode == StatDisplayMode::Network)
     {
@@ -118,7 +125,8 @@ void StatsOverlay::TickCommon(float deltaTime)
     {
         const std::vector<CpuStat>& cpuStats = GetProfiler()->GetCpuFrameStats();
         const std::vector<GpuStat>& gpuStats = GetProfiler()->GetGpuStats();
-        OCT_ASSERT(numStats <= (cpuStats.size() + gpuStats.size()));
+        const std::vector<CounterStat>& counters = GetProfiler()->GetFrameCounters();
+        OCT_ASSERT(numStats <= (cpuStats.size() + gpuStats.size() + counters.size()));
         uint32_t uStat = 0;
 
         if (mDisplayMode == StatDisplayMode::CpuStatBars ||
@@ -133,6 +141,17 @@ void StatsOverlay::TickCommon(float deltaTime)
             }
         }
 
+        if (mDisplayMode == StatDisplayMode::CpuStatText ||
+            mDisplayMode == StatDisplayMode::AllStatText)
+        {
+            // Counters after cpu stats
+            for (uint32_t i = 0; i < counters.size(); ++i)
+            {
+                SetStatText(uStat, counters[i].mName, (float)counters[i].mValue, glm::vec4(0.4f, 0.8f, 1.0f, 1.0f), statY);
+                ++uStat;
+            }
+        }
+
         if (mDisplayMode == StatDisplayMode::GpuStatBars ||
             mDisplayMode == StatDisplayMode::GpuStatText ||
             mDisplayMode == StatDisplayMode::AllStatText)
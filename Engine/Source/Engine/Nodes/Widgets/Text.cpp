@@ -620,6 +620,13 @@ void Text::JustifyLine(VertexUI* vertices, Justification just, int32_t& lineVert
 void Text::Render()
 {
     Widget::Render();
+
+    if (GetFont() != nullptr &&
+        GetFont()->GetTexture() != nullptr)
+    {
+        Renderer::Get()->GetTextureStreamer()->RequestMip(GetFont()->GetTexture(), 0);
+    }
+
     GFX_DrawText(this);
 }
 
@@ -0,0 +1,272 @@
+#include "OverlapSet.h"
+#include "Assertion.h"
+
+#include <algorithm>
+
+#define OVERLAP_SET_MIN_CAPACITY 64
+
+bool OverlapSet::Mark(const PrimitivePair& pair, uint32_t generation)
+{
+    OCT_ASSERT(pair.mPrimitiveA != nullptr);
+
+    int32_t slot = FindSlot(pair.mPrimitiveA, pair.mPrimitiveB);
+
+    if (slot != -1)
+    {
+        mEntries[mSlots[slot] - 1].mGeneration = generation;
+        return false;
+    }
+
+    // Keep the load factor at or below 1/2 so probe sequences stay short.
+    if ((mEntries.size() + 1) * 2 > mSlots.size())
+    {
+        Rehash(glm::max<uint32_t>(OVERLAP_SET_MIN_CAPACITY, uint32_t(mSlots.size()) * 2));
+    }
+
+    uint32_t index = uint32_t(mEntries.size());
+    uint32_t mask = uint32_t(mSlots.size()) - 1;
+    uint32_t newSlot = GetHomeSlot(pair.mPrimitiveA, pair.mPrimitiveB);
+
+    while (mSlots[newSlot] != 0)
+    {
+        newSlot = (newSlot + 1) & mask;
+    }
+
+    Entry entry;
+    entry.mPrimitiveA = pair.mPrimitiveA;
+    entry.mPrimitiveB = pair.mPrimitiveB;
+    entry.mGeneration = generation;
+
+    mEntries.push_back(entry);
+    mSlots[newSlot] = index + 1;
+
+    AddPrimPair(pair.mPrimitiveA, index);
+    if (pair.mPrimitiveB != pair.mPrimitiveA)
+    {
+        AddPrimPair(pair.mPrimitiveB, index);
+    }
+
+    return true;
+}
+
+bool OverlapSet::Remove(const PrimitivePair& pair)
+{
+    int32_t slot = FindSlot(pair.mPrimitiveA, pair.mPrimitiveB);
+
+    if (slot == -1)
+    {
+        return false;
+    }
+
+    uint32_t index = mSlots[slot] - 1;
+
+    // Backward shift deletion. Move later slots in the probe chain into the hole
+    // so that lookups never need tombstones.
+    uint32_t mask = uint32_t(mSlots.size()) - 1;
+    uint32_t hole = uint32_t(slot);
+    uint32_t next = hole;
+
+    while (true)
+    {
+        next = (next + 1) & mask;
+
+        if (mSlots[next] == 0)
+        {
+            break;
+        }
+
+        const Entry& nextEntry = mEntries[mSlots[next] - 1];
+        uint32_t home = GetHomeSlot(nextEntry.mPrimitiveA, nextEntry.mPrimitiveB);
+
+        // Distance from home to the current slot vs home to the hole (both wrap around).
+        if (((next - home) & mask) >= ((hole - home) & mask))
+        {
+            mSlots[hole] = mSlots[next];
+            hole = next;
+        }
+    }
+
+    mSlots[hole] = 0;
+
+    RemovePrimPair(pair.mPrimitiveA, index);
+    if (pair.mPrimitiveB != pair.mPrimitiveA)
+    {
+        RemovePrimPair(pair.mPrimitiveB, index);
+    }
+
+    // Keep the entries dense by moving the last one into the removed index.
+    uint32_t lastIndex = uint32_t(mEntries.size()) - 1;
+
+    if (index != lastIndex)
+    {
+        Entry& lastEntry = mEntries[lastIndex];
+        int32_t lastSlot = FindSlot(lastEntry.mPrimitiveA, lastEntry.mPrimitiveB);
+        OCT_ASSERT(lastSlot != -1);
+        mSlots[lastSlot] = index + 1;
+
+        ReplacePrimPair(lastEntry.mPrimitiveA, lastIndex, index);
+        if (lastEntry.mPrimitiveB != lastEntry.mPrimitiveA)
+        {
+            ReplacePrimPair(lastEntry.mPrimitiveB, lastIndex, index);
+        }
+
+        mEntries[index] = lastEntry;
+    }
+
+    mEntries.pop_back();
+
+    // Shrink after a spike of overlaps so lookups and rehashes don't keep paying for it.
+    if (mSlots.size() > OVERLAP_SET_MIN_CAPACITY &&
+        mEntries.size() * 8 < mSlots.size())
+    {
+        Rehash(uint32_t(mSlots.size()) / 2);
+    }
+
+    return true;
+}
+
+bool OverlapSet::Contains(const PrimitivePair& pair) const
+{
+    return FindSlot(pair.mPrimitiveA, pair.mPrimitiveB) != -1;
+}
+
+void OverlapSet::Clear()
+{
+    mEntries.clear();
+    mSlots.clear();
+    mPrimPairs.clear();
+}
+
+void OverlapSet::GatherStalePairs(uint32_t generation, FrameVector<PrimitivePair>& outPairs) const
+{
+    for (uint32_t i = 0; i < mEntries.size(); ++i)
+    {
+        const Entry& entry = mEntries[i];
+
+        if (entry.mGeneration != generation)
+        {
+            outPairs.push_back(PrimitivePair(entry.mPrimitiveA, entry.mPrimitiveB));
+        }
+    }
+}
+
+void OverlapSet::GatherPairs(Primitive3D* prim, FrameVector<PrimitivePair>& outPairs) const
+{
+    auto it = mPrimPairs.find(prim);
+
+    if (it != mPrimPairs.end())
+    {
+        const std::vector<uint32_t>& indices = it->second;
+        outPairs.reserve(outPairs.size() + indices.size());
+
+        for (uint32_t i = 0; i < indices.size(); ++i)
+        {
+            const Entry& entry = mEntries[indices[i]];
+            outPairs.push_back(PrimitivePair(entry.mPrimitiveA, entry.mPrimitiveB));
+        }
+    }
+}
+
+void OverlapSet::GatherAllPairs(FrameVector<PrimitivePair>& outPairs) const
+{
+    outPairs.reserve(outPairs.size() + mEntries.size());
+
+    for (uint32_t i = 0; i < mEntries.size(); ++i)
+    {
+        outPairs.push_back(PrimitivePair(mEntries[i].mPrimitiveA, mEntries[i].mPrimitiveB));
+    }
+}
+
+uint32_t OverlapSet::GetNumPairs() const
+{
+    return uint32_t(mEntries.size());
+}
+
+uint32_t OverlapSet::GetHomeSlot(Primitive3D* primA, Primitive3D* primB) const
+{
+    uint64_t hash = uint64_t(uintptr_t(primA)) * 0x9E3779B97F4A7C15ull;
+    hash ^= uint64_t(uintptr_t(primB)) * 0xC2B2AE3D27D4EB4Full;
+    hash ^= (hash >> 32);
+
+    return uint32_t(hash) & (uint32_t(mSlots.size()) - 1);
+}
+
+int32_t OverlapSet::FindSlot(Primitive3D* primA, Primitive3D* primB) const
+{
+    if (mEntries.empty())
+    {
+        return -1;
+    }
+
+    uint32_t mask = uint32_t(mSlots.size()) - 1;
+    uint32_t slot = GetHomeSlot(primA, primB);
+
+    while (mSlots[slot] != 0)
+    {
+        const Entry& entry = mEntries[mSlots[slot] - 1];
+
+        if (entry.mPrimitiveA == primA &&
+            entry.mPrimitiveB == primB)
+        {
+            return int32_t(slot);
+        }
+
+        slot = (slot + 1) & mask;
+    }
+
+    return -1;
+}
+
+void OverlapSet::Rehash(uint32_t capacity)
+{
+    OCT_ASSERT((capacity & (capacity - 1)) == 0);
+    OCT_ASSERT(mEntries.size() * 2 <= capacity);
+
+    mSlots.assign(capacity, 0);
+
+    uint32_t mask = capacity - 1;
+
+    for (uint32_t i = 0; i < mEntries.size(); ++i)
+    {
+        uint32_t slot = GetHomeSlot(mEntries[i].mPrimitiveA, mEntries[i].mPrimitiveB);
+
+        while (mSlots[slot] != 0)
+        {
+            slot = (slot + 1) & mask;
+        }
+
+        mSlots[slot] = i + 1;
+    }
+}
+
+void OverlapSet::AddPrimPair(Primitive3D* prim, uint32_t index)
+{
+    mPrimPairs[prim].push_back(index);
+}
+
+void OverlapSet::RemovePrimPair(Primitive3D* prim, uint32_t index)
+{
+    auto it = mPrimPairs.find(prim);
+    OCT_ASSERT(it != mPrimPairs.end());
+
+    std::vector<uint32_t>& indices = it->second;
+    auto indexIt = std::find(indices.begin(), indices.end(), index);
+    OCT_ASSERT(indexIt != indices.end());
+
+    *indexIt = indices.back();
+    indices.pop_back();
+
+    // Primitives can be destroyed once they have no overlaps, so don't keep their key around.
+    if (indices.empty())
+    {
+        mPrimPairs.erase(it);
+    }
+}
+
+void OverlapSet::ReplacePrimPair(Primitive3D* prim, uint32_t oldIndex, uint32_t newIndex)
+{
+    std::vector<uint32_t>& indices = mPrimPairs[prim];
+    auto indexIt = std::find(indices.begin(), indices.end(), oldIndex);
+    OCT_ASSERT(indexIt != indices.end());
+    *indexIt = newIndex;
+}
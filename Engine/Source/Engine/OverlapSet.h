@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <unordered_map>
+
+#include "EngineTypes.h"
+#include "FrameAllocator.h"
+
+class Primitive3D;
+
+// Set of overlapping primitive pairs. Live pairs are kept in a dense array, with an
+// open addressing hash table of indices into it and a list of pair indices per primitive.
+// Each pair stores the generation (physics frame) it was last seen in, so the
+// previous and current frame overlaps can be diffed without keeping two lists.
+class OverlapSet
+{
+public:
+
+    // Returns true if the pair was not in the set and has been added.
+    bool Mark(const PrimitivePair& pair, uint32_t generation);
+    bool Remove(const PrimitivePair& pair);
+    bool Contains(const PrimitivePair& pair) const;
+    void Clear();
+
+    void GatherStalePairs(uint32_t generation, FrameVector<PrimitivePair>& outPairs) const;
+    void GatherPairs(Primitive3D* prim, FrameVector<PrimitivePair>& outPairs) const;
+    void GatherAllPairs(FrameVector<PrimitivePair>& outPairs) const;
+
+    uint32_t GetNumPairs() const;
+
+protected:
+
+    struct Entry
+    {
+        Primitive3D* mPrimitiveA = nullptr;
+        Primitive3D* mPrimitiveB = nullptr;
+        uint32_t mGeneration = 0;
+    };
+
+    uint32_t GetHomeSlot(Primitive3D* primA, Primitive3D* primB) const;
+    int32_t FindSlot(Primitive3D* primA, Primitive3D* primB) const;
+    void Rehash(uint32_t capacity);
+    void AddPrimPair(Primitive3D* prim, uint32_t index);
+    void RemovePrimPair(Primitive3D* prim, uint32_t index);
+    void ReplacePrimPair(Primitive3D* prim, uint32_t oldIndex, uint32_t newIndex);
+
+    std::vector<Entry> mEntries;
+
+    // Slot values are an index into mEntries plus one. Zero marks an empty slot.
+    std::vector<uint32_t> mSlots;
+
+    std::unordered_map<Primitive3D*, std::vector<uint32_t>> mPrimPairs;
+};
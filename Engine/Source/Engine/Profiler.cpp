@@ -8,8 +8,175 @@
 
 #include "Graphics/Graphics.h"
 
+#include <atomic>
+#include <new>
+#include <stdlib.h>
+
+#if PLATFORM_WINDOWS
+#include <malloc.h>
+#endif
+
 static Profiler* sProfiler = nullptr;
 
+#if HEAP_ALLOC_TRACKING_ENABLED
+static std::atomic<uint64_t> sNumHeapAllocs(0);
+
+static void* TrackedAlloc(size_t size)
+{
+    sNumHeapAllocs.fetch_add(1, std::memory_order_relaxed);
+    return malloc(size ? size : 1);
+}
+
+static void* TrackedAlignedAlloc(size_t size, size_t alignment)
+{
+    sNumHeapAllocs.fetch_add(1, std::memory_order_relaxed);
+    size = size ? size : 1;
+
+#if PLATFORM_WINDOWS
+    return _aligned_malloc(size, alignment);
+#else
+    void* ret = nullptr;
+    if (posix_memalign(&ret, alignment < sizeof(void*) ? sizeof(void*) : alignment, size) != 0)
+    {
+        ret = nullptr;
+    }
+    return ret;
+#endif
+}
+
+static void TrackedAlignedFree(void* pointer)
+{
+#if PLATFORM_WINDOWS
+    _aligned_free(pointer);
+#else
+    free(pointer);
+#endif
+}
+
+void* operator new(size_t size)
+{
+    void* ret = TrackedAlloc(size);
+
+    if (ret == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+
+    return ret;
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return TrackedAlloc(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return TrackedAlloc(size);
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    void* ret = TrackedAlignedAlloc(size, size_t(alignment));
+
+    if (ret == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+
+    return ret;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return TrackedAlignedAlloc(size, size_t(alignment));
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return TrackedAlignedAlloc(size, size_t(alignment));
+}
+
+void operator delete(void* pointer) noexcept
+{
+    free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    free(pointer);
+}
+
+void operator delete(void* pointer, size_t size) noexcept
+{
+    free(pointer);
+}
+
+void operator delete[](void* pointer, size_t size) noexcept
+{
+    free(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+    free(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+    free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t alignment) noexcept
+{
+    TrackedAlignedFree(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t alignment) noexcept
+{
+    TrackedAlignedFree(pointer);
+}
+
+void operator delete(void* pointer, size_t size, std::align_val_t alignment) noexcept
+{
+    TrackedAlignedFree(pointer);
+}
+
+void operator delete[](void* pointer, size_t size, std::align_val_t alignment) noexcept
+{
+    TrackedAlignedFree(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    TrackedAlignedFree(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    TrackedAlignedFree(pointer);
+}
+#endif
+
+uint64_t GetNumHeapAllocs()
+{
+#if HEAP_ALLOC_TRACKING_ENABLED
+    return sNumHeapAllocs.load(std::memory_order_relaxed);
+#else
+    return 0;
+#endif
+}
+
 void Profiler::BeginFrame()
 {
 #if PROFILING_ENABLED
@@ -20,6 +187,16 @@ void Profiler::BeginFrame()
         mCpuFrameStats[i].mStartTime = 0;
         mCpuFrameStats[i].mEndTime = 0;
     }
+
+    for (uint32_t i = 0; i < mFrameCounters.size(); ++i)
+    {
+        mFrameCounters[i].mValue = 0;
+    }
+
+    // Count how many heap allocations were made since the last frame began.
+    uint64_t heapAllocCount = GetNumHeapAllocs();
+    mFrameHeapAllocs = (uint32_t)(heapAllocCount - mPrevHeapAllocCount);
+    mPrevHeapAllocCount = heapAllocCount;
 #endif
 }
 
@@ -120,6 +297,52 @@ void Profiler::SetGpuStatTime(const char* name, float time)
 #endif
 }
 
+void Profiler::SetFrameCounter(const char* name, uint32_t value)
+{
+#if PROFILING_ENABLED
+    CounterStat* counter = FindFrameCounter(name);
+
+    if (counter == nullptr)
+    {
+        mFrameCounters.push_back(CounterStat());
+        counter = &(mFrameCounters.back());
+        strncpy(counter->mName, name, STAT_NAME_LENGTH);
+    }
+
+    counter->mValue = value;
+#endif
+}
+
+void Profiler::AddFrameCounter(const char* name, uint32_t value)
+{
+#if PROFILING_ENABLED
+    CounterStat* counter = FindFrameCounter(name);
+    uint32_t prevValue = (counter != nullptr) ? counter->mValue : 0;
+    SetFrameCounter(name, prevValue + value);
+#endif
+}
+
+const std::vector<CounterStat>& Profiler::GetFrameCounters() const
+{
+    return mFrameCounters;
+}
+
+CounterStat* Profiler::FindFrameCounter(const char* name)
+{
+    CounterStat* retCounter = nullptr;
+
+    for (uint32_t i = 0; i < mFrameCounters.size(); ++i)
+    {
+        if (strncmp(mFrameCounters[i].mName, name, STAT_NAME_LENGTH) == 0)
+        {
+            retCounter = &mFrameCounters[i];
+            break;
+        }
+    }
+
+    return retCounter;
+}
+
 CpuStat* Profiler::FindCpuStat(const char* name, bool persistent)
 {
     std::vector<CpuStat>& stats = persistent ? mCpuPersistentStats : mCpuFrameStats;
@@ -154,6 +377,11 @@ const std::vector<GpuStat>& Profiler::GetGpuStats() const
     return mGpuStats;
 }
 
+uint32_t Profiler::GetFrameHeapAllocs() const
+{
+    return mFrameHeapAllocs;
+}
+
 void Profiler::LogPersistentStats()
 {
     LogDebug("----- Persistent Stats -----");
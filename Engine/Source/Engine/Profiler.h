@@ -7,6 +7,12 @@
 
 #define PROFILING_ENABLED 1
 
+// Replaces global operator new/delete to count heap allocations per frame.
+// Opt-in only, define to 1 in the build to enable it.
+#ifndef HEAP_ALLOC_TRACKING_ENABLED
+#define HEAP_ALLOC_TRACKING_ENABLED 0
+#endif
+
 #define STAT_NAME_LENGTH 31
 #define STAT_NAME_BUFFER_LENGTH (STAT_NAME_LENGTH + 1)
 
@@ -19,6 +25,12 @@ struct CpuStat
     float mSmoothedTime = 0.0f;
 };
 
+struct CounterStat
+{
+    char mName[STAT_NAME_BUFFER_LENGTH] = {};
+    uint32_t mValue = 0;
+};
+
 struct GpuStat
 {
     char mName[STAT_NAME_BUFFER_LENGTH] = {};
@@ -40,26 +52,42 @@ public:
     void EndGpuStat(const char* name);
     void SetGpuStatTime(const char* name, float time);
 
+    // Counters are reset to 0 at the start of every frame.
+    void SetFrameCounter(const char* name, uint32_t value);
+    void AddFrameCounter(const char* name, uint32_t value);
+    const std::vector<CounterStat>& GetFrameCounters() const;
+
     CpuStat* FindCpuStat(const char* name, bool persistent);
     const std::vector<CpuStat>& GetCpuFrameStats() const;
 
     const std::vector<CpuStat>& GetCpuPersistentStats() const;
     const std::vector<GpuStat>& GetGpuStats() const;
 
+    uint32_t GetFrameHeapAllocs() const;
+
     void LogPersistentStats();
     void DumpPersistentStats();
 
 protected:
 
+    CounterStat* FindFrameCounter(const char* name);
+
     std::vector<CpuStat> mCpuFrameStats;
     std::vector<CpuStat> mCpuPersistentStats;
     std::vector<GpuStat> mGpuStats;
+    std::vector<CounterStat> mFrameCounters;
+
+    uint64_t mPrevHeapAllocCount = 0;
+    uint32_t mFrameHeapAllocs = 0;
 };
 
 void CreateProfiler();
 void DestroyProfiler();
 Profiler* GetProfiler();
 
+// Total number of global operator new calls since startup (0 if tracking is disabled).
+uint64_t GetNumHeapAllocs();
+
 struct ScopedCpuStat
 {
     ScopedCpuStat(const char* name, bool persistent)
@@ -106,6 +134,9 @@ struct ScopedGpuStat
 #define SCOPED_GPU_STAT(name) ScopedGpuStat scopedStat##__LINE__(name);
 #define BEGIN_GPU_STAT(name) GetProfiler()->BeginGpuStat(name);
 #define END_GPU_STAT(name) GetProfiler()->EndGpuStat(name);
+
+#define SET_FRAME_COUNTER(name, value) GetProfiler()->SetFrameCounter(name, value);
+#define ADD_FRAME_COUNTER(name, value) GetProfiler()->AddFrameCounter(name, value);
 #else
 #define SCOPED_FRAME_STAT(name) 
 #define BEGIN_FRAME_STAT(name) 
@@ -118,4 +149,7 @@ struct ScopedGpuStat
 #define SCOPED_GPU_STAT(name) 
 #define BEGIN_GPU_STAT(name) 
 #define END_GPU_STAT(name) 
+
+#define SET_FRAME_COUNTER(name, value)
+#define ADD_FRAME_COUNTER(name, value)
 #endif
@@ -3,11 +3,39 @@
 #include "AssetRef.h"
 #include "Log.h"
 
+#include "System/System.h"
+
+#include <unordered_map>
+#include <string.h>
+
 Property::Property()
 {
     
 }
 
+Property::Property(
+    DatumType type,
+    const char* name,
+    void* owner,
+    void* data,
+    uint32_t count,
+    DatumChangeHandlerFP changeHandler,
+    int32_t extra,
+    int32_t enumCount,
+    const char** enumStrings) :
+    Datum(type, owner, data, count, changeHandler)
+{
+    mName = name;
+    mNameId = InternName(name);
+    mExtra = extra;
+    mEnumCount = enumCount;
+    mEnumStrings = enumStrings;
+
+#if EDITOR
+    mCategory = sCategory;
+#endif
+}
+
 Property::Property(
     DatumType type,
     const std::string& name,
@@ -21,6 +49,7 @@ Property::Property(
     Datum(type, owner, data, count, changeHandler)
 {
     mName = name;
+    mNameId = InternName(name);
     mExtra = extra;
     mEnumCount = enumCount;
     mEnumStrings = enumStrings;
@@ -42,6 +71,7 @@ Property::Property(const Property& src) :
     mMinCount = src.mMinCount;
     mMaxCount = src.mMaxCount;
     mIsVector = src.mIsVector;
+    mNameId = src.mNameId;
 
 #if EDITOR
     mCategory = src.mCategory;
@@ -62,6 +92,7 @@ void Property::ReadStream(Stream& stream, bool external)
 {
     Datum::ReadStream(stream, external);
     stream.ReadString(mName);
+    mNameId = InternName(mName);
     mExtra = stream.ReadInt32();
 
     // We don't really need to write mIsVector since the values are copied
@@ -108,6 +139,7 @@ void Property::DeepCopy(const Datum& src, bool forceInternalStorage)
         mMinCount = srcProp.mMinCount;
         mMaxCount = srcProp.mMaxCount;
         mIsVector = srcProp.mIsVector;
+        mNameId = srcProp.mNameId;
     }
 }
 
@@ -547,6 +579,100 @@ bool Property::IsVector() const
     return mIsVector;
 }
 
+void Property::SetName(const std::string& name)
+{
+    mName = name;
+    mNameId = InternName(name);
+}
+
+uint32_t Property::GetNameId() const
+{
+    return mNameId;
+}
+
+// Interned names are never removed, so the key strings stay valid for the life of the process.
+static std::unordered_map<std::string, uint32_t>& GetNameIds()
+{
+    static std::unordered_map<std::string, uint32_t> sNameIds;
+    return sNameIds;
+}
+
+static MutexObject* GetNameMutex()
+{
+    static MutexObject* sMutex = SYS_CreateMutex();
+    return sMutex;
+}
+
+static uint32_t InternNameLocked(const char* name, const char** outInterned)
+{
+    SCOPED_LOCK(GetNameMutex());
+    std::unordered_map<std::string, uint32_t>& nameIds = GetNameIds();
+
+    auto it = nameIds.find(name);
+    if (it == nameIds.end())
+    {
+        it = nameIds.insert({ name, uint32_t(nameIds.size() + 1) }).first;
+    }
+
+    if (outInterned != nullptr)
+    {
+        *outInterned = it->first.c_str();
+    }
+
+    return it->second;
+}
+
+uint32_t Property::InternName(const std::string& name)
+{
+    return name.empty() ? 0 : InternNameLocked(name.c_str(), nullptr);
+}
+
+uint32_t Property::InternName(const char* name)
+{
+    if (name == nullptr || name[0] == '\0')
+    {
+        return 0;
+    }
+
+    // Property names are almost always string literals, so cache ids by pointer per thread
+    // to skip hashing the string and taking the lock. The strcmp guards against a reused buffer.
+    struct CachedName
+    {
+        uint32_t mId = 0;
+        const char* mInterned = nullptr;
+    };
+
+    thread_local std::unordered_map<const char*, CachedName> tCache;
+
+    // Non-literal buffers would keep adding entries, so don't let the cache grow unbounded.
+    if (tCache.size() >= 4096)
+    {
+        tCache.clear();
+    }
+
+    CachedName& cached = tCache[name];
+    if (cached.mInterned == nullptr || strcmp(cached.mInterned, name) != 0)
+    {
+        cached.mId = InternNameLocked(name, &cached.mInterned);
+    }
+
+    return cached.mId;
+}
+
+uint32_t Property::FindNameId(const std::string& name)
+{
+    if (name.empty())
+    {
+        return 0;
+    }
+
+    SCOPED_LOCK(GetNameMutex());
+    std::unordered_map<std::string, uint32_t>& nameIds = GetNameIds();
+
+    auto it = nameIds.find(name);
+    return (it != nameIds.end()) ? it->second : 0;
+}
+
 bool Property::IsArray() const
 {
     return (IsVector() || mCount > 1);
@@ -563,6 +689,7 @@ void Property::Reset()
     mMinCount = 0;
     mMaxCount = 255;
     mIsVector = false;
+    mNameId = 0;
 }
 
 
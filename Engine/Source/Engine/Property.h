@@ -9,10 +9,26 @@ enum class ByteExtra
     ExclusiveFlagWidget
 };
 
+enum class IntegerExtra
+{
+    None,
+    FlagWidget // 32 bit flags
+};
+
 class Property : public Datum
 {
 public:
     Property();
+    Property(DatumType type,
+        const char* name,
+        void* owner,
+        void* data,
+        uint32_t count = 1,
+        DatumChangeHandlerFP changeHandler = nullptr,
+        int32_t extra = 0,
+        int32_t enumCount = 0,
+        const char** enumStrings = nullptr);
+
     Property(DatumType type,
         const std::string& name,
         void* owner,
@@ -42,6 +58,17 @@ public:
     bool IsVector() const;
     bool IsArray() const;
 
+    void SetName(const std::string& name);
+
+    // Returns an id that is unique to mName. Comparing ids is much cheaper than
+    // comparing name strings when matching up properties. Empty names have id 0.
+    uint32_t GetNameId() const;
+    static uint32_t InternName(const std::string& name);
+    static uint32_t InternName(const char* name);
+
+    // Returns 0 if the name has never been interned, so no property can have it.
+    static uint32_t FindNameId(const std::string& name);
+
 #if EDITOR
     static void SetCategory(const char* category);
     static void ClearCategory();
@@ -55,6 +82,7 @@ public:
 
     static const char* sCategory;
 
+    // Use SetName() to rename a property so that mNameId stays in sync.
     std::string mName;
     int32_t mExtra = 0;
     int32_t mEnumCount = 0;
@@ -63,6 +91,7 @@ public:
     uint8_t mMinCount = 0;
     uint8_t mMaxCount = 255;
     bool mIsVector = false;
+    uint32_t mNameId = 0;
 #if EDITOR
     const char* mCategory = "";
 #endif
@@ -3,6 +3,7 @@
 #include "Utilities.h"
 #include "Engine.h"
 #include "Profiler.h"
+#include "FrameAllocator.h"
 #include "Constants.h"
 #include "Nodes/Widgets/Widget.h"
 #include "Nodes/Widgets/Console.h"
@@ -13,6 +14,7 @@
 #include "Nodes/3D/Particle3d.h"
 #include "Nodes/3D/SkeletalMesh3d.h"
 #include "Nodes/3D/ShadowMesh3d.h"
+#include "Nodes/3D/StaticMesh3d.h"
 #include "Log.h"
 #include "Line.h"
 #include "Maths.h"
@@ -195,6 +197,11 @@ void Renderer::Enable3dRendering(bool enable)
     mEnable3dRendering = enable;
 }
 
+TextureStreamer* Renderer::GetTextureStreamer()
+{
+    return &mTextureStreamer;
+}
+
 bool Renderer::Is3dRenderingEnabled() const
 {
     return mEnable3dRendering;
@@ -680,8 +687,7 @@ static void SetLightData(LightData& lightData, Light3D* comp)
 
 void Renderer::GatherLightData(World* world)
 {
-    static std::vector<LightDistance2> sClosestLights;
-    sClosestLights.clear();
+    FrameVector<LightDistance2> closestLights;
 
     mLightData.clear();
     const std::vector<Light3D*>& lights = world->GetLights();
@@ -709,9 +715,9 @@ void Renderer::GatherLightData(World* world)
 
             float dist2 = directional ? 0.0f : glm::distance2(lightPos, camPos);
 
-            if (sClosestLights.size() < lightLimit)
+            if (closestLights.size() < lightLimit)
             {
-                sClosestLights.push_back({ lights[i], dist2 });
+                closestLights.push_back({ lights[i], dist2 });
             }
             else
             {
@@ -719,40 +725,40 @@ void Renderer::GatherLightData(World* world)
                 int32_t farthestIdx = -1;
                 float farthestDist = 0.0f;
 
-                for (uint32_t j = 0; j < sClosestLights.size(); ++j)
+                for (uint32_t j = 0; j < closestLights.size(); ++j)
                 {
-                    if (sClosestLights[j].mDistance2 > dist2 &&
-                        sClosestLights[j].mDistance2 > farthestDist)
+                    if (closestLights[j].mDistance2 > dist2 &&
+                        closestLights[j].mDistance2 > farthestDist)
                     {
                         farthestIdx = (int32_t)j;
-                        farthestDist = sClosestLights[j].mDistance2;
+                        farthestDist = closestLights[j].mDistance2;
                     }
                 }
 
                 // We found a light to evict.
                 if (farthestIdx >= 0)
                 {
-                    sClosestLights[farthestIdx] = { lights[i], dist2 };
+                    closestLights[farthestIdx] = { lights[i], dist2 };
                 }
             }
         }
 
         // Step 2 - If there is space, add the closest lights to the fading light list (if not already in it).
-        std::sort(sClosestLights.begin(),
-            sClosestLights.end(),
+        std::sort(closestLights.begin(),
+            closestLights.end(),
             [](const LightDistance2& l, const LightDistance2& r)
             {
                 return l.mDistance2 < r.mDistance2;
             });
 
-        for (uint32_t i = 0; i < sClosestLights.size(); ++i)
+        for (uint32_t i = 0; i < closestLights.size(); ++i)
         {
             if (mFadingLights.size() < lightLimit)
             {
                 bool alreadyFading = false;
                 for (uint32_t j = 0; j < mFadingLights.size(); ++j)
                 {
-                    if (mFadingLights[j].mComponent == sClosestLights[i].mComponent)
+                    if (mFadingLights[j].mComponent == closestLights[i].mComponent)
                     {
                         alreadyFading = true;
                         break;
@@ -761,7 +767,7 @@ void Renderer::GatherLightData(World* world)
 
                 if (!alreadyFading)
                 {
-                    mFadingLights.push_back(FadingLight(sClosestLights[i].mComponent));
+                    mFadingLights.push_back(FadingLight(closestLights[i].mComponent));
                 }
             }
             else
@@ -777,11 +783,11 @@ void Renderer::GatherLightData(World* world)
             bool active = false;
             FadingLight& fadingLight = mFadingLights[i];
 
-            for (uint32_t j = 0; j < sClosestLights.size(); ++j)
+            for (uint32_t j = 0; j < closestLights.size(); ++j)
             {
-                if (fadingLight.mComponent == sClosestLights[j].mComponent)
+                if (fadingLight.mComponent == closestLights[j].mComponent)
                 {
-                    Light3D* light = sClosestLights[j].mComponent;
+                    Light3D* light = closestLights[j].mComponent;
 
                     // Ok, this light is still in the closest N lights.
                     active = true;
@@ -954,6 +960,62 @@ void Renderer::FrustumCull(Camera3D* camera)
 #endif
 }
 
+void Renderer::RequestTextureMips(Camera3D* camera)
+{
+    if (camera == nullptr ||
+        mTextureStreamer.GetNumTextures() == 0)
+    {
+        return;
+    }
+
+    float viewportHeight = float(GetSceneViewport().w);
+    TextureStreamingView view;
+
+    if (camera->GetProjectionMode() == ProjectionMode::PERSPECTIVE)
+    {
+        view = MakePerspectiveStreamingView(camera->GetAbsolutePosition(), camera->GetPerspectiveSettings().mFovY, viewportHeight);
+    }
+    else
+    {
+        view = MakeOrthoStreamingView(camera->GetAbsolutePosition(), camera->GetOrthoSettings().mHeight, viewportHeight);
+    }
+
+    RequestTextureMips(view, mOpaqueDraws);
+    RequestTextureMips(view, mPostShadowOpaqueDraws);
+    RequestTextureMips(view, mTranslucentDraws);
+}
+
+void Renderer::RequestTextureMips(const TextureStreamingView& view, const std::vector<DrawData>& drawData)
+{
+    for (uint32_t i = 0; i < drawData.size(); ++i)
+    {
+        const DrawData& draw = drawData[i];
+
+        if (draw.mMaterial == nullptr)
+            continue;
+
+        // Without mesh UVs to go by, assume the texture is stretched once across the bounds.
+        float uvPerUnit = 0.0f;
+        StaticMesh3D* meshNode = draw.mNode->As<StaticMesh3D>();
+        StaticMesh* mesh = (meshNode != nullptr) ? meshNode->GetStaticMesh() : nullptr;
+
+        if (mesh != nullptr &&
+            mesh->GetUvDensity() > 0.0f)
+        {
+            glm::vec3 scale = glm::abs(meshNode->GetAbsoluteScale());
+            float maxScale = glm::max(glm::max(scale.x, scale.y), scale.z);
+            uvPerUnit = (maxScale > 0.0f) ? mesh->GetUvDensity() / maxScale : 0.0f;
+        }
+        else if (draw.mBounds.mRadius > 0.0f)
+        {
+            uvPerUnit = 0.5f / draw.mBounds.mRadius;
+        }
+
+        float distance = ComputeBoundsDistance(view, draw.mBounds);
+        mTextureStreamer.RequestMaterialMips(draw.mMaterial, uvPerUnit, distance, view);
+    }
+}
+
 static inline void HandleCullResult(DrawData& drawData, bool inFrustum)
 {
     if (drawData.mNodeType == SkeletalMesh3D::GetStaticType())
@@ -1171,9 +1233,16 @@ void Renderer::Render(World* world)
             {
                 FrustumCull(activeCamera);
             }
+
+            RequestTextureMips(activeCamera);
         }
     }
 
+    {
+        SCOPED_FRAME_STAT("Texture Streaming");
+        mTextureStreamer.Update();
+    }
+
     // Still update UI and cull when minimized (to update animation and particle simulation)
     if (!GetEngineState()->mWindowMinimized)
     {
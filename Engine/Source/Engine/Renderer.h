@@ -13,6 +13,7 @@
 #include "Constants.h"
 #include "Log.h"
 #include "Profiler.h"
+#include "TextureStreaming.h"
 
 class Widget;
 class Console;
@@ -101,6 +102,8 @@ public:
     void EnablePathTracing(bool enable);
     bool IsPathTracingEnabled() const;
 
+    TextureStreamer* GetTextureStreamer();
+
     Texture* GetBlackTexture();
     Material* GetDefaultMaterial();
 
@@ -191,6 +194,8 @@ private:
     void RenderDraws(const std::vector<DrawData>& drawData, PipelineId pipelineId);
     void RenderDebugDraws(const std::vector<DebugDraw>& draws, PipelineId pipelineId = PipelineId::Count);
     void FrustumCull(Camera3D* camera);
+    void RequestTextureMips(Camera3D* camera);
+    void RequestTextureMips(const TextureStreamingView& view, const std::vector<DrawData>& drawData);
     int32_t FrustumCullDraws(const CameraFrustum& frustum, std::vector<DrawData>& drawData);
     int32_t FrustumCullDraws(const CameraFrustum& frustum, std::vector<DebugDraw>& drawData);
     int32_t FrustumCullLights(const CameraFrustum& frustum, std::vector<LightData>& lightData);
@@ -238,6 +243,8 @@ private:
     float mLightFadeSpeed = 1.0f;
     std::vector<FadingLight> mFadingLights;
 
+    TextureStreamer mTextureStreamer;
+
     // Path tracing
     uint32_t mRaysPerPixel = 4;
     uint32_t mMaxBounces = 4;
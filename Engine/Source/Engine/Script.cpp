@@ -51,7 +51,7 @@ bool Script::HandleForeignScriptPropChange(Datum* datum, uint32_t index, const v
     Property* scriptProp = nullptr;
     for (uint32_t i = 0; i < script->mScriptProps.size(); ++i)
     {
-        if (script->mScriptProps[i].mName == prop->mName)
+        if (script->mScriptProps[i].GetNameId() == prop->GetNameId())
         {
             scriptProp = &script->mScriptProps[i];
             break;
@@ -114,9 +114,11 @@ void Script::UploadScriptProperties()
 
 void Script::SetArrayScriptPropCount(const std::string& name, uint32_t count)
 {
-    for (uint32_t i = 0; i < mScriptProps.size(); ++i)
+    uint32_t nameId = Property::FindNameId(name);
+
+    for (uint32_t i = 0; nameId != 0 && i < mScriptProps.size(); ++i)
     {
-        if (mScriptProps[i].mName == name)
+        if (mScriptProps[i].GetNameId() == nameId)
         {
             mScriptProps[i].SetCount(count);
             break;
@@ -177,7 +179,7 @@ void Script::GatherScriptProperties()
 
                             lua_getfield(L, propIdx, "name");
                             const char* name = lua_isstring(L, -1) ? lua_tostring(L, -1) : "";
-                            newProp.mName = name;
+                            newProp.SetName(name);
                             lua_pop(L, 1);
 
                             lua_getfield(L, propIdx, "type");
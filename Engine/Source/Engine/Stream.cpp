@@ -20,7 +20,9 @@ Stream::Stream() :
     mCapacity(0),
     mPos(0),
     mAsyncRequest(nullptr),
-    mExternal(false)
+    mAssetVersion(ASSET_CURRENT_VERSION),
+    mExternal(false),
+    mMapped(false)
 {
 
 }
@@ -32,14 +34,22 @@ Stream::Stream(const char* externalData, uint32_t externalSize) :
     mCapacity(externalSize),
     mPos(0),
     mAsyncRequest(nullptr),
-    mExternal(true)
+    mAssetVersion(ASSET_CURRENT_VERSION),
+    mExternal(true),
+    mMapped(false)
 {
 
 }
 
 Stream::~Stream()
 {
-    if (!mExternal && mData != nullptr)
+    if (mMapped)
+    {
+        SYS_UnmapFileData(mData, mSize);
+        mData = nullptr;
+        mMapped = false;
+    }
+    else if (!mExternal && mData != nullptr)
     {
         // We need to use free() here because SYS_AcquireFileData() calls malloc().
         // And we use that allocated data directly when ACQUIRE_FILE_DIRECTLY is enabled.
@@ -58,6 +68,12 @@ uint32_t Stream::GetSize() const
     return mSize;
 }
 
+void Stream::SetSize(uint32_t size)
+{
+    Grow(size);
+    mPos = glm::min(mPos, mSize);
+}
+
 uint32_t Stream::GetPos()
 {
     return mPos;
@@ -123,6 +139,32 @@ void Stream::ReadFile(const char* path, bool isAsset, int32_t maxSize)
 #endif
 }
 
+void Stream::MapFile(const char* path, bool isAsset, int32_t maxSize)
+{
+    OCT_ASSERT(!mExternal && mData == nullptr);
+
+    // Map the file read-only so it can be parsed in place without copying it into a heap buffer.
+    // The stream behaves like an external stream and the mapping is released when it is destroyed.
+    // Fall back to a regular read if the platform can't map the file.
+#if EDITOR
+    // Source files can be saved or truncated by the editor while an async load is still
+    // parsing them, which would fault on a mapping. Always take a private copy instead.
+    ReadFile(path, isAsset, maxSize);
+#else
+    if (SYS_MapFileData(path, isAsset, maxSize, mData, mSize))
+    {
+        mCapacity = mSize;
+        mPos = 0;
+        mExternal = true;
+        mMapped = true;
+    }
+    else
+    {
+        ReadFile(path, isAsset, maxSize);
+    }
+#endif
+}
+
 void Stream::WriteFile(const char* path)
 {
     FILE* file = fopen(path, "wb");
@@ -142,6 +184,16 @@ void Stream::SetAsyncRequest(AsyncLoadRequest* request)
     mAsyncRequest = request;
 }
 
+void Stream::SetAssetVersion(uint32_t version)
+{
+    mAssetVersion = version;
+}
+
+uint32_t Stream::GetAssetVersion() const
+{
+    return mAssetVersion;
+}
+
 void Stream::ReadAsset(AssetRef& asset)
 {
     // TODO: Resort to default asset if failed to load?
@@ -159,35 +211,9 @@ void Stream::ReadAsset(AssetRef& asset)
         }
         else
         {
-            AssetStub* stub = AssetManager::Get()->GetAssetStub(assetName);
-
-            if (stub != nullptr)
-            {
-                // The asset does exist, so we need to load it.
-                AsyncLoadAsset(assetName, &asset);
-
-                // But also... we need to make sure that this dependency loads before the current async load asset.
-                // So we can add this asset stub to the list of dependent assets on the AsyncLoadRequest object
-                bool hasDependency = false;
-                for (uint32_t i = 0; i < mAsyncRequest->mDependentAssets.size(); ++i)
-                {
-                    if (mAsyncRequest->mDependentAssets[i] == stub)
-                    {
-                        hasDependency = true;
-                        break;
-                    }
-                }
-
-                if (!hasDependency)
-                {
-                    mAsyncRequest->mDependentAssets.push_back(stub);
-                }
-
-            }
-            else
-            {
-                LogWarning("Could not find asset %s", assetName.c_str());
-            }
+            // The dependency is queued ahead of other requests, and this asset won't be
+            // finished on the main thread until the dependency is.
+            AssetManager::Get()->AsyncLoadDependency(assetName, &asset, mAsyncRequest);
         }
     }
     else
@@ -271,6 +297,22 @@ uint32_t Stream::ReadBytesMax(uint8_t* dst, uint32_t length)
     return 0;
 }
 
+void Stream::ReadPadding(uint32_t alignment)
+{
+    uint32_t alignedPos = (mPos + (alignment - 1)) & ~(alignment - 1);
+    SetPos(alignedPos);
+}
+
+void Stream::WritePadding(uint32_t alignment)
+{
+    uint32_t alignedPos = (mPos + (alignment - 1)) & ~(alignment - 1);
+
+    while (mPos < alignedPos)
+    {
+        WriteUint8(0);
+    }
+}
+
 void Stream::WriteBytes(uint8_t* src, uint32_t length)
 {
     if (mPos + length > mSize)
@@ -567,3 +609,13 @@ void Stream::Reserve(uint32_t capacity)
         mCapacity = capacity;
     }
 }
+
+void Stream::SwapArray32(void* data, uint32_t numWords)
+{
+    uint32_t* words = reinterpret_cast<uint32_t*>(data);
+
+    for (uint32_t i = 0; i < numWords; ++i)
+    {
+        Swap32(words[i]);
+    }
+}
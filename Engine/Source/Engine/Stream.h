@@ -25,14 +25,21 @@ public:
 
     char* GetData();
     uint32_t GetSize() const;
+    void SetSize(uint32_t size);
     uint32_t GetPos();
     void SetPos(uint32_t pos);
 
     void ReadFile(const char* path, bool isAsset, int32_t maxSize = 0);
+    void MapFile(const char* path, bool isAsset, int32_t maxSize = 0);
     void WriteFile(const char* path);
 
     void SetAsyncRequest(AsyncLoadRequest* request);
 
+    // Version of the asset being read, for data that doesn't carry its own version (e.g. node streams).
+    // Defaults to the current asset version.
+    void SetAssetVersion(uint32_t version);
+    uint32_t GetAssetVersion() const;
+
     void ReadAsset(AssetRef& asset);
     void WriteAsset(const AssetRef& asset);
 
@@ -44,6 +51,36 @@ public:
 
     uint32_t ReadBytesMax(uint8_t* dst, uint32_t length);
 
+    void ReadPadding(uint32_t alignment);
+    void WritePadding(uint32_t alignment);
+
+    // Bulk read/write for arrays of plain structs that are made up entirely of 4 byte fields.
+    // The whole array is copied at once and endian swapped in a single pass if needed.
+    template<typename T>
+    void ReadArray32(T* dst, uint32_t count)
+    {
+        static_assert(sizeof(T) % 4 == 0, "ReadArray32() requires 4 byte fields");
+        uint32_t length = uint32_t(sizeof(T) * count);
+        ReadBytes(reinterpret_cast<uint8_t*>(dst), length);
+
+#if ENDIAN_SWAP
+        SwapArray32(dst, length / 4);
+#endif
+    }
+
+    template<typename T>
+    void WriteArray32(const T* src, uint32_t count)
+    {
+        static_assert(sizeof(T) % 4 == 0, "WriteArray32() requires 4 byte fields");
+        uint32_t length = uint32_t(sizeof(T) * count);
+        uint32_t startPos = mPos;
+        WriteBytes((uint8_t*)src, length);
+
+#if ENDIAN_SWAP
+        SwapArray32(mData + startPos, length / 4);
+#endif
+    }
+
     int32_t ReadInt32();
     uint32_t ReadUint32();
     int16_t ReadInt16();
@@ -78,6 +115,7 @@ public:
 private:
 
     void Grow(uint32_t newSize);
+    void SwapArray32(void* data, uint32_t numWords);
     void Reserve(uint32_t capacity);
 
     template<typename T>
@@ -164,5 +202,7 @@ private:
     uint32_t mCapacity;
     uint32_t mPos;
     AsyncLoadRequest* mAsyncRequest;
+    uint32_t mAssetVersion;
     bool mExternal;
+    bool mMapped;
 };
@@ -0,0 +1,1101 @@
+#include "TextureCompression.h"
+#include "Log.h"
+#include "Assertion.h"
+#include "Maths.h"
+
+#include <math.h>
+#include <string.h>
+
+#define BLOCK_DIM 4
+#define BLOCK_PIXELS 16
+
+// Fast finds endpoints once, High refines them against the chosen indices.
+static const uint32_t kRefinePasses[uint32_t(TextureCompressionQuality::Count)] = { 0, 2 };
+static const uint32_t kPowerIterations[uint32_t(TextureCompressionQuality::Count)] = { 2, 6 };
+
+static const int32_t kBC7Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+bool IsBlockCompressedFormat(PixelFormat format)
+{
+    return format == PixelFormat::CMPR ||
+        format == PixelFormat::BC3 ||
+        format == PixelFormat::BC5 ||
+        format == PixelFormat::BC7;
+}
+
+uint32_t GetCompressedBlockBytes(PixelFormat format)
+{
+    return (format == PixelFormat::CMPR) ? 8 : 16;
+}
+
+uint32_t GetMipDimension(uint32_t baseDimension, uint32_t mipLevel)
+{
+    uint32_t dim = baseDimension >> mipLevel;
+    return (dim > 0) ? dim : 1;
+}
+
+uint32_t GetTextureDataSize(PixelFormat format, uint32_t width, uint32_t height)
+{
+    if (IsBlockCompressedFormat(format))
+    {
+        uint32_t blocksX = (width + BLOCK_DIM - 1) / BLOCK_DIM;
+        uint32_t blocksY = (height + BLOCK_DIM - 1) / BLOCK_DIM;
+        return blocksX * blocksY * GetCompressedBlockBytes(format);
+    }
+
+    OCT_ASSERT(format == PixelFormat::RGBA8);
+    return width * height * 4;
+}
+
+void GenerateMipChain(const uint8_t* rgba, uint32_t width, uint32_t height, uint32_t numMips, std::vector<uint8_t>& outMips)
+{
+    size_t levelOffset = outMips.size();
+    outMips.insert(outMips.end(), rgba, rgba + width * height * 4);
+
+    for (uint32_t level = 1; level < numMips; ++level)
+    {
+        uint32_t srcWidth = GetMipDimension(width, level - 1);
+        uint32_t srcHeight = GetMipDimension(height, level - 1);
+        uint32_t dstWidth = GetMipDimension(width, level);
+        uint32_t dstHeight = GetMipDimension(height, level);
+
+        size_t dstOffset = outMips.size();
+        outMips.resize(dstOffset + dstWidth * dstHeight * 4);
+
+        const uint8_t* src = outMips.data() + levelOffset;
+        uint8_t* dst = outMips.data() + dstOffset;
+
+        // 2x2 box filter. Odd dimensions reuse the last row/column.
+        for (uint32_t y = 0; y < dstHeight; ++y)
+        {
+            uint32_t y0 = glm::min(y * 2, srcHeight - 1);
+            uint32_t y1 = glm::min(y * 2 + 1, srcHeight - 1);
+
+            for (uint32_t x = 0; x < dstWidth; ++x)
+            {
+                uint32_t x0 = glm::min(x * 2, srcWidth - 1);
+                uint32_t x1 = glm::min(x * 2 + 1, srcWidth - 1);
+
+                for (uint32_t c = 0; c < 4; ++c)
+                {
+                    uint32_t sum =
+                        src[(y0 * srcWidth + x0) * 4 + c] +
+                        src[(y0 * srcWidth + x1) * 4 + c] +
+                        src[(y1 * srcWidth + x0) * 4 + c] +
+                        src[(y1 * srcWidth + x1) * 4 + c];
+
+                    dst[(y * dstWidth + x) * 4 + c] = uint8_t((sum + 2) / 4);
+                }
+            }
+        }
+
+        levelOffset = dstOffset;
+    }
+}
+
+static void LoadBlock(const uint8_t* rgba, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, uint8_t outBlock[BLOCK_PIXELS][4])
+{
+    for (uint32_t y = 0; y < BLOCK_DIM; ++y)
+    {
+        uint32_t srcY = glm::min(blockY * BLOCK_DIM + y, height - 1);
+
+        for (uint32_t x = 0; x < BLOCK_DIM; ++x)
+        {
+            uint32_t srcX = glm::min(blockX * BLOCK_DIM + x, width - 1);
+            memcpy(outBlock[y * BLOCK_DIM + x], rgba + (srcY * width + srcX) * 4, 4);
+        }
+    }
+}
+
+static void StoreBlock(const uint8_t block[BLOCK_PIXELS][4], uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, uint8_t* rgba)
+{
+    for (uint32_t y = 0; y < BLOCK_DIM; ++y)
+    {
+        uint32_t dstY = blockY * BLOCK_DIM + y;
+
+        for (uint32_t x = 0; x < BLOCK_DIM; ++x)
+        {
+            uint32_t dstX = blockX * BLOCK_DIM + x;
+
+            if (dstX < width && dstY < height)
+            {
+                memcpy(rgba + (dstY * width + dstX) * 4, block[y * BLOCK_DIM + x], 4);
+            }
+        }
+    }
+}
+
+static int32_t ClampByte(int32_t value)
+{
+    return (value < 0) ? 0 : ((value > 255) ? 255 : value);
+}
+
+// Finds the principal axis of the pixels selected by mask, using only the first numChannels channels.
+// Returns false if every selected pixel is the same color.
+static bool FindPrincipalAxis(const uint8_t pixels[BLOCK_PIXELS][4], uint32_t mask, uint32_t numChannels, uint32_t iterations, float outMean[4], float outAxis[4])
+{
+    uint32_t count = 0;
+    float mean[4] = {};
+
+    for (uint32_t i = 0; i < BLOCK_PIXELS; ++i)
+    {
+        if (mask & (1 << i))
+        {
+            for (uint32_t c = 0; c < numChannels; ++c)
+                mean[c] += pixels[i][c];
+            count++;
+        }
+    }
+
+    for (uint32_t c = 0; c < 4; ++c)
+    {
+        outMean[c] = (count > 0 && c < numChannels) ? mean[c] / count : 0.0f;
+        outAxis[c] = 0.0f;
+    }
+
+    float cov[4][4] = {};
+    float minV[4] = { 255.0f, 255.0f, 255.0f, 255.0f };
+    float maxV[4] = {};
+
+    for (uint32_t i = 0; i < BLOCK_PIXELS; ++i)
+    {
+        if ((mask & (1 << i)) == 0)
+            continue;
+
+        float d[4] = {};
+        for (uint32_t c = 0; c < numChannels; ++c)
+        {
+            d[c] = pixels[i][c] - outMean[c];
+            minV[c] = glm::min(minV[c], float(pixels[i][c]));
+            maxV[c] = glm::max(maxV[c], float(pixels[i][c]));
+        }
+
+        for (uint32_t a = 0; a < numChannels; ++a)
+        {
+            for (uint32_t b = a; b < numChannels; ++b)
+            {
+                cov[a][b] += d[a] * d[b];
+            }
+        }
+    }
+
+    for (uint32_t a = 0; a < numChannels; ++a)
+    {
+        for (uint32_t b = 0; b < a; ++b)
+        {
+            cov[a][b] = cov[b][a];
+        }
+    }
+
+    // Power iteration, starting from the bounding box diagonal.
+    float axis[4] = {};
+    for (uint32_t c = 0; c < numChannels; ++c)
+    {
+        axis[c] = maxV[c] - minV[c];
+    }
+
+    for (uint32_t iter = 0; iter < iterations; ++iter)
+    {
+        float next[4] = {};
+        float largest = 0.0f;
+
+        for (uint32_t a = 0; a < numChannels; ++a)
+        {
+            for (uint32_t b = 0; b < numChannels; ++b)
+            {
+                next[a] += cov[a][b] * axis[b];
+            }
+
+            largest = glm::max(largest, fabsf(next[a]));
+        }
+
+        if (largest <= 0.0f)
+            break;
+
+        for (uint32_t c = 0; c < numChannels; ++c)
+        {
+            axis[c] = next[c] / largest;
+        }
+    }
+
+    float lengthSq = 0.0f;
+    for (uint32_t c = 0; c < numChannels; ++c)
+    {
+        lengthSq += axis[c] * axis[c];
+    }
+
+    if (lengthSq <= 0.0f)
+    {
+        return false;
+    }
+
+    float invLength = 1.0f / sqrtf(lengthSq);
+    for (uint32_t c = 0; c < numChannels; ++c)
+    {
+        outAxis[c] = axis[c] * invLength;
+    }
+
+    return true;
+}
+
+// Sets the endpoints to the extreme projections of the selected pixels onto the principal axis.
+static void FindEndpoints(const uint8_t pixels[BLOCK_PIXELS][4], uint32_t mask, uint32_t numChannels, uint32_t iterations, float outEndpoints[2][4])
+{
+    float mean[4];
+    float axis[4];
+
+    if (!FindPrincipalAxis(pixels, mask, numChannels, iterations, mean, axis))
+    {
+        memcpy(outEndpoints[0], mean, sizeof(mean));
+        memcpy(outEndpoints[1], mean, sizeof(mean));
+        return;
+    }
+
+    float minT = 0.0f;
+    float maxT = 0.0f;
+
+    for (uint32_t i = 0; i < BLOCK_PIXELS; ++i)
+    {
+        if ((mask & (1 << i)) == 0)
+            continue;
+
+        float t = 0.0f;
+        for (uint32_t c = 0; c < numChannels; ++c)
+        {
+            t += (pixels[i][c] - mean[c]) * axis[c];
+        }
+
+        minT = glm::min(minT, t);
+        maxT = glm::max(maxT, t);
+    }
+
+    for (uint32_t c = 0; c < 4; ++c)
+    {
+        outEndpoints[0][c] = glm::clamp(mean[c] + axis[c] * minT, 0.0f, 255.0f);
+        outEndpoints[1][c] = glm::clamp(mean[c] + axis[c] * maxT, 0.0f, 255.0f);
+    }
+}
+
+// Least squares fit of both endpoints, given each pixel's weight towards endpoint 1 (0..1).
+// Returns false if the system is degenerate (e.g. every pixel uses the same index).
+static bool RefineEndpoints(const uint8_t pixels[BLOCK_PIXELS][4], uint32_t mask, uint32_t numChannels, const float weights[BLOCK_PIXELS], float outEndpoints[2][4])
+{
+    float aa = 0.0f;
+    float ab = 0.0f;
+    float bb = 0.0f;
+    float ax[4] = {};
+    float bx[4] = {};
+
+    for (uint32_t i = 0; i < BLOCK_PIXELS; ++i)
+    {
+        if ((mask & (1 << i)) == 0)
+            continue;
+
+        float b = weights[i];
+        float a = 1.0f - b;
+
+        aa += a * a;
+        ab += a * b;
+        bb += b * b;
+
+        for (uint32_t c = 0; c < numChannels; ++c)
+        {
+            ax[c] += a * pixels[i][c];
+            bx[c] += b * pixels[i][c];
+        }
+    }
+
+    float det = aa * bb - ab * ab;
+
+    if (fabsf(det) < 1e-6f)
+    {
+        return false;
+    }
+
+    float invDet = 1.0f / det;
+
+    for (uint32_t c = 0; c < numChannels; ++c)
+    {
+        outEndpoints[0][c] = glm::clamp((ax[c] * bb - bx[c] * ab) * invDet, 0.0f, 255.0f);
+        outEndpoints[1][c] = glm::clamp((bx[c] * aa - ax[c] * ab) * invDet, 0.0f, 255.0f);
+    }
+
+    return true;
+}
+
+static uint32_t ColorDistSq(const int32_t a[4], const uint8_t b[4], uint32_t numChannels)
+{
+    uint32_t dist = 0;
+    for (uint32_t c = 0; c < numChannels; ++c)
+    {
+        int32_t d = a[c] - int32_t(b[c]);
+        dist += uint32_t(d * d);
+    }
+    return dist;
+}
+
+// Picks the closest palette entry for every selected pixel. Returns the total squared error.
+static uint32_t SelectIndices(const uint8_t pixels[BLOCK_PIXELS][4], uint32_t mask, const int32_t palette[][4], uint32_t numEntries, uint32_t numChannels, uint8_t outIndices[BLOCK_PIXELS])
+{
+    uint32_t totalError = 0;
+
+    for (uint32_t i = 0; i < BLOCK_PIXELS; ++i)
+    {
+        if ((mask & (1 << i)) == 0)
+            continue;
+
+        uint32_t bestDist = UINT32_MAX;
+        uint8_t bestIndex = 0;
+
+        for (uint32_t p = 0; p < numEntries; ++p)
+        {
+            uint32_t dist = ColorDistSq(palette[p], pixels[i], numChannels);
+            if (dist < bestDist)
+            {
+                bestDist = dist;
+                bestIndex = uint8_t(p);
+            }
+        }
+
+        outIndices[i] = bestIndex;
+        totalError += bestDist;
+    }
+
+    return totalError;
+}
+
+static void WriteUint16(uint8_t* dst, uint16_t value)
+{
+    dst[0] = uint8_t(value & 0xff);
+    dst[1] = uint8_t(value >> 8);
+}
+
+static uint16_t ReadUint16(const uint8_t* src)
+{
+    return uint16_t(src[0] | (src[1] << 8));
+}
+
+//------------------------------------------------------------------------------
+// BC1 color block
+//------------------------------------------------------------------------------
+
+static uint16_t Pack565(const float color[4])
+{
+    int32_t r = int32_t(color[0] * 31.0f / 255.0f + 0.5f);
+    int32_t g = int32_t(color[1] * 63.0f / 255.0f + 0.5f);
+    int32_t b = int32_t(color[2] * 31.0f / 255.0f + 0.5f);
+    return uint16_t((r << 11) | (g << 5) | b);
+}
+
+static void Unpack565(uint16_t packed, int32_t outColor[4])
+{
+    int32_t r = (packed >> 11) & 0x1f;
+    int32_t g = (packed >> 5) & 0x3f;
+    int32_t b = packed & 0x1f;
+    outColor[0] = (r << 3) | (r >> 2);
+    outColor[1] = (g << 2) | (g >> 4);
+    outColor[2] = (b << 3) | (b >> 2);
+    outColor[3] = 255;
+}
+
+static void BuildColorPalette(uint16_t c0, uint16_t c1, bool fourColor, int32_t outPalette[4][4])
+{
+    Unpack565(c0, outPalette[0]);
+    Unpack565(c1, outPalette[1]);
+
+    for (uint32_t c = 0; c < 3; ++c)
+    {
+        if (fourColor)
+        {
+            outPalette[2][c] = (2 * outPalette[0][c] + outPalette[1][c]) / 3;
+            outPalette[3][c] = (outPalette[0][c] + 2 * outPalette[1][c]) / 3;
+        }
+        else
+        {
+            outPalette[2][c] = (outPalette[0][c] + outPalette[1][c]) / 2;
+            outPalette[3][c] = 0;
+        }
+    }
+
+    outPalette[2][3] = 255;
+    outPalette[3][3] = fourColor ? 255 : 0;
+}
+
+// Pixel weights towards endpoint 1 for each index, used to refine endpoints.
+static const float kColorWeights4[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+static const float kColorWeights3[4] = { 0.0f, 1.0f, 0.5f, 0.0f };
+
+// allowTransparent selects the 3 color + transparent mode for blocks with alpha < 128.
+// BC3 color blocks are always decoded in 4 color mode, so they never allow it.
+static void EncodeColorBlock(const uint8_t pixels[BLOCK_PIXELS][4], bool allowTransparent, TextureCompressionQuality quality, uint8_t* dst)
+{
+    uint32_t opaqueMask = 0xffff;
+
+    if (allowTransparent)
+    {
+        for (uint32_t i = 0; i < BLOCK_PIXELS; ++i)
+        {
+            if (pixels[i][3] < 128)
+            {
+                opaqueMask &= ~(1 << i);
+            }
+        }
+    }
+
+    bool fourColor = (opaqueMask == 0xffff);
+    uint32_t numEntries = fourColor ? 4 : 3;
+    const float* weightTable = fourColor ? kColorWeights4 : kColorWeights3;
+
+    uint16_t bestC0 = 0;
+    uint16_t bestC1 = 0;
+    uint8_t bestIndices[BLOCK_PIXELS] = {};
+    uint32_t bestError = UINT32_MAX;
+
+    if (opaqueMask != 0)
+    {
+        float endpoints[2][4];
+        FindEndpoints(pixels, opaqueMask, 3, kPowerIterations[uint32_t(quality)], endpoints);
+
+        for (uint32_t pass = 0; pass <= kRefinePasses[uint32_t(quality)]; ++pass)
+        {
+            uint16_t c0 = Pack565(endpoints[0]);
+            uint16_t c1 = Pack565(endpoints[1]);
+
+            int32_t palette[4][4];
+            uint8_t indices[BLOCK_PIXELS] = {};
+            BuildColorPalette(c0, c1, fourColor, palette);
+            uint32_t error = SelectIndices(pixels, opaqueMask, palette, numEntries, 3, indices);
+
+            if (error < bestError)
+            {
+                bestError = error;
+                bestC0 = c0;
+                bestC1 = c1;
+                memcpy(bestIndices, indices, BLOCK_PIXELS);
+            }
+
+            float weights[BLOCK_PIXELS] = {};
+            for (uint32_t i = 0; i < BLOCK_PIXELS; ++i)
+            {
+                weights[i] = weightTable[indices[i]];
+            }
+
+            if (error == 0 ||
+                !RefineEndpoints(pixels, opaqueMask, 3, weights, endpoints))
+            {
+                break;
+            }
+        }
+    }
+
+    // The endpoint order selects the block mode: c0 > c1 is 4 color, c0 <= c1 is 3 color + transparent.
+    bool swap = fourColor ? (bestC0 < bestC1) : (bestC0 > bestC1);
+
+    if (swap)
+    {
+        uint16_t temp = bestC0;
+        bestC0 = bestC1;
+        bestC1 = temp;
+
+        static const uint8_t kSwap4[4] = { 1, 0, 3, 2 };
+        static const uint8_t kSwap3[4] = { 1, 0, 2, 3 };
+        const uint8_t* swapTable = fourColor ? kSwap4 : kSwap3;
+
+        for (uint32_t i = 0; i < BLOCK_PIXELS; ++i)
+        {
+            bestIndices[i] = swapTable[bestIndices[i]];
+        }
+    }
+
+    if (fourColor && bestC0 == bestC1)
+    {
+        // Equal endpoints decode as 3 color mode, which is fine as long as index 3 isn't used.
+        memset(bestIndices, 0, BLOCK_PIXELS);
+    }
+
+    uint32_t indexBits = 0;
+    for (uint32_t i = 0; i < BLOCK_PIXELS; ++i)
+    {
+        uint32_t index = ((opaqueMask & (1 << i)) != 0) ? bestIndices[i] : 3;
+        indexBits |= (index << (i * 2));
+    }
+
+    WriteUint16(dst + 0, bestC0);
+    WriteUint16(dst + 2, bestC1);
+    dst[4] = uint8_t(indexBits);
+    dst[5] = uint8_t(indexBits >> 8);
+    dst[6] = uint8_t(indexBits >> 16);
+    dst[7] = uint8_t(indexBits >> 24);
+}
+
+static void DecodeColorBlock(const uint8_t* src, bool allowTransparent, uint8_t outPixels[BLOCK_PIXELS][4])
+{
+    uint16_t c0 = ReadUint16(src + 0);
+    uint16_t c1 = ReadUint16(src + 2);
+    uint32_t indexBits = src[4] | (src[5] << 8) | (src[6] << 16) | (uint32_t(src[7]) << 24);
+
+    int32_t palette[4][4];
+    BuildColorPalette(c0, c1, !allowTransparent || c0 > c1, palette);
+
+    for (uint32_t i = 0; i < BLOCK_PIXELS; ++i)
+    {
+        const int32_t* color = palette[(indexBits >> (i * 2)) & 3];
+        outPixels[i][0] = uint8_t(color[0]);
+        outPixels[i][1] = uint8_t(color[1]);
+        outPixels[i][2] = uint8_t(color[2]);
+        outPixels[i][3] = uint8_t(color[3]);
+    }
+}
+
+//------------------------------------------------------------------------------
+// BC4 single channel block (BC3 alpha, BC5 red and green)
+//------------------------------------------------------------------------------
+
+static void BuildChannelPalette(int32_t v0, int32_t v1, int32_t outPalette[8])
+{
+    outPalette[0] = v0;
+    outPalette[1] = v1;
+
+    if (v0 > v1)
+    {
+        for (int32_t i = 2; i < 8; ++i)
+        {
+            outPalette[i] = ((8 - i) * v0 + (i - 1) * v1 + 3) / 7;
+        }
+    }
+    else
+    {
+        for (int32_t i = 2; i < 6; ++i)
+        {
+            outPalette[i] = ((6 - i) * v0 + (i - 1) * v1 + 2) / 5;
+        }
+
+        outPalette[6] = 0;
+        outPalette[7] = 255;
+    }
+}
+
+static uint32_t SelectChannelIndices(const uint8_t values[BLOCK_PIXELS], const int32_t palette[8], uint8_t outIndices[BLOCK_PIXELS])
+{
+    uint32_t totalError = 0;
+
+    for (uint32_t i = 0; i < BLOCK_PIXELS; ++i)
+    {
+        uint32_t bestDist = UINT32_MAX;
+
+        for (uint32_t p = 0; p < 8; ++p)
+        {
+            int32_t d = palette[p] - int32_t(values[i]);
+            uint32_t dist = uint32_t(d * d);
+
+            if (dist < bestDist)
+            {
+                bestDist = dist;
+                outIndices[i] = uint8_t(p);
+            }
+        }
+
+        totalError += bestDist;
+    }
+
+    return totalError;
+}
+
+static uint32_t TryChannelEndpoints(const uint8_t values[BLOCK_PIXELS], int32_t v0, int32_t v1, uint32_t& bestError, int32_t& bestV0, int32_t& bestV1, uint8_t bestIndices[BLOCK_PIXELS], uint8_t outIndices[BLOCK_PIXELS])
+{
+    int32_t palette[8];
+    BuildChannelPalette(v0, v1, palette);
+    uint32_t error = SelectChannelIndices(values, palette, outIndices);
+
+    if (error < bestError)
+    {
+        bestError = error;
+        bestV0 = v0;
+        bestV1 = v1;
+        memcpy(bestIndices, outIndices, BLOCK_PIXELS);
+    }
+
+    return error;
+}
+
+static void EncodeChannelBlock(const uint8_t pixels[BLOCK_PIXELS][4], uint32_t channel, TextureCompressionQuality quality, uint8_t* dst)
+{
+    uint8_t values[BLOCK_PIXELS];
+    int32_t minV = 255;
+    int32_t maxV = 0;
+
+    // Min/max of the values that aren't exactly 0 or 255, for the 6 value mode.
+    int32_t innerMin = 255;
+    int32_t innerMax = 0;
+
+    for (uint32_t i = 0; i < BLOCK_PIXELS; ++i)
+    {
+        values[i] = pixels[i][channel];
+        minV = glm::min(minV, int32_t(values[i]));
+        maxV = glm::max(maxV, int32_t(values[i]));
+
+        if (values[i] != 0 && values[i] != 255)
+        {
+            innerMin = glm::min(innerMin, int32_t(values[i]));
+            innerMax = glm::max(innerMax, int32_t(values[i]));
+        }
+    }
+
+    uint32_t bestError = UINT32_MAX;
+    int32_t bestV0 = maxV;
+    int32_t bestV1 = minV;
+    uint8_t bestIndices[BLOCK_PIXELS] = {};
+    uint8_t indices[BLOCK_PIXELS] = {};
+
+    uint32_t error = TryChannelEndpoints(values, maxV, minV, bestError, bestV0, bestV1, bestIndices, indices);
+
+    if (quality == TextureCompressionQuality::High &&
+        error > 0)
+    {
+        // Refine the 8 value mode endpoints.
+        static const float kWeights8[8] = { 0.0f, 1.0f, 1.0f / 7.0f, 2.0f / 7.0f, 3.0f / 7.0f, 4.0f / 7.0f, 5.0f / 7.0f, 6.0f / 7.0f };
+
+        for (uint32_t pass = 0; pass < kRefinePasses[uint32_t(quality)] && error > 0; ++pass)
+        {
+            float a2 = 0.0f;
+            float ab = 0.0f;
+            float b2 = 0.0f;
+            float ax = 0.0f;
+            float bx = 0.0f;
+
+            for (uint32_t i = 0; i < BLOCK_PIXELS; ++i)
+            {
+                float b = kWeights8[indices[i]];
+                float a = 1.0f - b;
+                a2 += a * a;
+                ab += a * b;
+                b2 += b * b;
+                ax += a * values[i];
+                bx += b * values[i];
+            }
+
+            float det = a2 * b2 - ab * ab;
+            if (fabsf(det) < 1e-6f)
+                break;
+
+            int32_t v0 = ClampByte(int32_t((ax * b2 - bx * ab) / det + 0.5f));
+            int32_t v1 = ClampByte(int32_t((bx * a2 - ax * ab) / det + 0.5f));
+
+            if (v0 <= v1)
+                break;
+
+            error = TryChannelEndpoints(values, v0, v1, bestError, bestV0, bestV1, bestIndices, indices);
+        }
+
+        // The 6 value mode can represent exact 0 and 255, which helps cutout alpha.
+        if (innerMin <= innerMax)
+        {
+            TryChannelEndpoints(values, innerMin, innerMax, bestError, bestV0, bestV1, bestIndices, indices);
+        }
+        else
+        {
+            TryChannelEndpoints(values, 0, 0, bestError, bestV0, bestV1, bestIndices, indices);
+        }
+    }
+
+    dst[0] = uint8_t(bestV0);
+    dst[1] = uint8_t(bestV1);
+
+    uint64_t indexBits = 0;
+    for (uint32_t i = 0; i < BLOCK_PIXELS; ++i)
+    {
+        indexBits |= uint64_t(bestIndices[i]) << (i * 3);
+    }
+
+    for (uint32_t i = 0; i < 6; ++i)
+    {
+        dst[2 + i] = uint8_t(indexBits >> (i * 8));
+    }
+}
+
+static void DecodeChannelBlock(const uint8_t* src, uint32_t channel, uint8_t outPixels[BLOCK_PIXELS][4])
+{
+    int32_t palette[8];
+    BuildChannelPalette(src[0], src[1], palette);
+
+    uint64_t indexBits = 0;
+    for (uint32_t i = 0; i < 6; ++i)
+    {
+        indexBits |= uint64_t(src[2 + i]) << (i * 8);
+    }
+
+    for (uint32_t i = 0; i < BLOCK_PIXELS; ++i)
+    {
+        outPixels[i][channel] = uint8_t(palette[(indexBits >> (i * 3)) & 7]);
+    }
+}
+
+//------------------------------------------------------------------------------
+// BC7, mode 6 only: one subset, RGBA 7.7.7.7 endpoints with a p-bit each, 4 bit indices.
+//------------------------------------------------------------------------------
+
+struct BitWriter
+{
+    uint8_t* mData;
+    uint32_t mPos = 0;
+
+    void Write(uint32_t value, uint32_t numBits)
+    {
+        for (uint32_t i = 0; i < numBits; ++i, ++mPos)
+        {
+            if (value & (1 << i))
+            {
+                mData[mPos >> 3] |= uint8_t(1 << (mPos & 7));
+            }
+        }
+    }
+};
+
+struct BitReader
+{
+    const uint8_t* mData;
+    uint32_t mPos = 0;
+
+    uint32_t Read(uint32_t numBits)
+    {
+        uint32_t value = 0;
+        for (uint32_t i = 0; i < numBits; ++i, ++mPos)
+        {
+            value |= uint32_t((mData[mPos >> 3] >> (mPos & 7)) & 1) << i;
+        }
+        return value;
+    }
+};
+
+static void BuildBC7Palette(const int32_t endpoints[2][4], int32_t outPalette[16][4])
+{
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        for (uint32_t c = 0; c < 4; ++c)
+        {
+            outPalette[i][c] = ((64 - kBC7Weights4[i]) * endpoints[0][c] + kBC7Weights4[i] * endpoints[1][c] + 32) >> 6;
+        }
+    }
+}
+
+// Quantizes an endpoint to 7 bits per channel with the given p-bit.
+static void QuantizeBC7Endpoint(const float endpoint[4], uint32_t pbit, int32_t outQuantized[4], int32_t outExpanded[4])
+{
+    for (uint32_t c = 0; c < 4; ++c)
+    {
+        int32_t q = int32_t((endpoint[c] - float(pbit)) * 0.5f + 0.5f);
+        q = glm::clamp(q, 0, 127);
+        outQuantized[c] = q;
+        outExpanded[c] = (q << 1) | int32_t(pbit);
+    }
+}
+
+static void EncodeBC7Block(const uint8_t pixels[BLOCK_PIXELS][4], TextureCompressionQuality quality, uint8_t* dst)
+{
+    float endpoints[2][4];
+    FindEndpoints(pixels, 0xffff, 4, kPowerIterations[uint32_t(quality)], endpoints);
+
+    int32_t bestQuantized[2][4] = {};
+    uint32_t bestPbits[2] = {};
+    uint8_t bestIndices[BLOCK_PIXELS] = {};
+    uint32_t bestError = UINT32_MAX;
+
+    for (uint32_t pass = 0; pass <= kRefinePasses[uint32_t(quality)]; ++pass)
+    {
+        uint8_t passIndices[BLOCK_PIXELS] = {};
+        uint32_t passError = UINT32_MAX;
+
+        // Fast picks each p-bit by its own rounding error, High tries every combination.
+        uint32_t numCombos = (quality == TextureCompressionQuality::Fast) ? 1 : 4;
+
+        for (uint32_t pbitCombo = 0; pbitCombo < numCombos; ++pbitCombo)
+        {
+            uint32_t pbits[2] = { pbitCombo & 1, pbitCombo >> 1 };
+
+            if (quality == TextureCompressionQuality::Fast)
+            {
+                for (uint32_t e = 0; e < 2; ++e)
+                {
+                    int32_t q[4];
+                    int32_t x0[4];
+                    int32_t x1[4];
+                    QuantizeBC7Endpoint(endpoints[e], 0, q, x0);
+                    QuantizeBC7Endpoint(endpoints[e], 1, q, x1);
+
+                    float err0 = 0.0f;
+                    float err1 = 0.0f;
+                    for (uint32_t c = 0; c < 4; ++c)
+                    {
+                        err0 += (x0[c] - endpoints[e][c]) * (x0[c] - endpoints[e][c]);
+                        err1 += (x1[c] - endpoints[e][c]) * (x1[c] - endpoints[e][c]);
+                    }
+
+                    pbits[e] = (err1 < err0) ? 1 : 0;
+                }
+            }
+
+            int32_t quantized[2][4];
+            int32_t expanded[2][4];
+            QuantizeBC7Endpoint(endpoints[0], pbits[0], quantized[0], expanded[0]);
+            QuantizeBC7Endpoint(endpoints[1], pbits[1], quantized[1], expanded[1]);
+
+            int32_t palette[16][4];
+            uint8_t indices[BLOCK_PIXELS];
+            BuildBC7Palette(expanded, palette);
+            uint32_t error = SelectIndices(pixels, 0xffff, palette, 16, 4, indices);
+
+            if (error < passError)
+            {
+                passError = error;
+                memcpy(passIndices, indices, BLOCK_PIXELS);
+            }
+
+            if (error < bestError)
+            {
+                bestError = error;
+                memcpy(bestQuantized, quantized, sizeof(quantized));
+                bestPbits[0] = pbits[0];
+                bestPbits[1] = pbits[1];
+                memcpy(bestIndices, indices, BLOCK_PIXELS);
+            }
+        }
+
+        if (bestError == 0 ||
+            pass == kRefinePasses[uint32_t(quality)])
+        {
+            break;
+        }
+
+        float weights[BLOCK_PIXELS];
+        for (uint32_t i = 0; i < BLOCK_PIXELS; ++i)
+        {
+            weights[i] = kBC7Weights4[passIndices[i]] / 64.0f;
+        }
+
+        if (!RefineEndpoints(pixels, 0xffff, 4, weights, endpoints))
+        {
+            break;
+        }
+    }
+
+    // The first pixel's index is stored without its top bit, so it has to be < 8.
+    if (bestIndices[0] >= 8)
+    {
+        for (uint32_t c = 0; c < 4; ++c)
+        {
+            int32_t temp = bestQuantized[0][c];
+            bestQuantized[0][c] = bestQuantized[1][c];
+            bestQuantized[1][c] = temp;
+        }
+
+        uint32_t tempPbit = bestPbits[0];
+        bestPbits[0] = bestPbits[1];
+        bestPbits[1] = tempPbit;
+
+        for (uint32_t i = 0; i < BLOCK_PIXELS; ++i)
+        {
+            bestIndices[i] = uint8_t(15 - bestIndices[i]);
+        }
+    }
+
+    memset(dst, 0, 16);
+    BitWriter writer;
+    writer.mData = dst;
+
+    writer.Write(1 << 6, 7);
+
+    for (uint32_t c = 0; c < 4; ++c)
+    {
+        writer.Write(uint32_t(bestQuantized[0][c]), 7);
+        writer.Write(uint32_t(bestQuantized[1][c]), 7);
+    }
+
+    writer.Write(bestPbits[0], 1);
+    writer.Write(bestPbits[1], 1);
+
+    for (uint32_t i = 0; i < BLOCK_PIXELS; ++i)
+    {
+        writer.Write(bestIndices[i], (i == 0) ? 3 : 4);
+    }
+}
+
+static bool DecodeBC7Block(const uint8_t* src, uint8_t outPixels[BLOCK_PIXELS][4])
+{
+    BitReader reader;
+    reader.mData = src;
+
+    if (reader.Read(7) != (1 << 6))
+    {
+        for (uint32_t i = 0; i < BLOCK_PIXELS; ++i)
+        {
+            outPixels[i][0] = 255;
+            outPixels[i][1] = 0;
+            outPixels[i][2] = 255;
+            outPixels[i][3] = 255;
+        }
+        return false;
+    }
+
+    int32_t endpoints[2][4];
+    for (uint32_t c = 0; c < 4; ++c)
+    {
+        endpoints[0][c] = int32_t(reader.Read(7)) << 1;
+        endpoints[1][c] = int32_t(reader.Read(7)) << 1;
+    }
+
+    uint32_t pbit0 = reader.Read(1);
+    uint32_t pbit1 = reader.Read(1);
+
+    for (uint32_t c = 0; c < 4; ++c)
+    {
+        endpoints[0][c] |= int32_t(pbit0);
+        endpoints[1][c] |= int32_t(pbit1);
+    }
+
+    int32_t palette[16][4];
+    BuildBC7Palette(endpoints, palette);
+
+    for (uint32_t i = 0; i < BLOCK_PIXELS; ++i)
+    {
+        const int32_t* color = palette[reader.Read((i == 0) ? 3 : 4)];
+        for (uint32_t c = 0; c < 4; ++c)
+        {
+            outPixels[i][c] = uint8_t(color[c]);
+        }
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+void EncodeTexture(PixelFormat format, const uint8_t* rgba, uint32_t width, uint32_t height, TextureCompressionQuality quality, std::vector<uint8_t>& outData)
+{
+    OCT_ASSERT(IsBlockCompressedFormat(format));
+    OCT_ASSERT(width > 0 && height > 0);
+
+    uint32_t blocksX = (width + BLOCK_DIM - 1) / BLOCK_DIM;
+    uint32_t blocksY = (height + BLOCK_DIM - 1) / BLOCK_DIM;
+    uint32_t blockBytes = GetCompressedBlockBytes(format);
+
+    size_t offset = outData.size();
+    outData.resize(offset + blocksX * blocksY * blockBytes);
+    uint8_t* dst = outData.data() + offset;
+
+    uint8_t pixels[BLOCK_PIXELS][4];
+
+    for (uint32_t by = 0; by < blocksY; ++by)
+    {
+        for (uint32_t bx = 0; bx < blocksX; ++bx)
+        {
+            LoadBlock(rgba, width, height, bx, by, pixels);
+
+            switch (format)
+            {
+            case PixelFormat::CMPR:
+                EncodeColorBlock(pixels, true, quality, dst);
+                break;
+            case PixelFormat::BC3:
+                EncodeChannelBlock(pixels, 3, quality, dst);
+                EncodeColorBlock(pixels, false, quality, dst + 8);
+                break;
+            case PixelFormat::BC5:
+                EncodeChannelBlock(pixels, 0, quality, dst);
+                EncodeChannelBlock(pixels, 1, quality, dst + 8);
+                break;
+            case PixelFormat::BC7:
+                EncodeBC7Block(pixels, quality, dst);
+                break;
+            default:
+                break;
+            }
+
+            dst += blockBytes;
+        }
+    }
+}
+
+bool DecodeTexture(PixelFormat format, const uint8_t* data, uint32_t width, uint32_t height, std::vector<uint8_t>& outRgba)
+{
+    OCT_ASSERT(IsBlockCompressedFormat(format));
+
+    uint32_t blocksX = (width + BLOCK_DIM - 1) / BLOCK_DIM;
+    uint32_t blocksY = (height + BLOCK_DIM - 1) / BLOCK_DIM;
+    uint32_t blockBytes = GetCompressedBlockBytes(format);
+
+    size_t offset = outRgba.size();
+    outRgba.resize(offset + width * height * 4);
+    uint8_t* dst = outRgba.data() + offset;
+
+    bool success = true;
+    uint8_t pixels[BLOCK_PIXELS][4];
+
+    for (uint32_t by = 0; by < blocksY; ++by)
+    {
+        for (uint32_t bx = 0; bx < blocksX; ++bx)
+        {
+            switch (format)
+            {
+            case PixelFormat::CMPR:
+                DecodeColorBlock(data, true, pixels);
+                break;
+            case PixelFormat::BC3:
+                DecodeColorBlock(data + 8, false, pixels);
+                DecodeChannelBlock(data, 3, pixels);
+                break;
+            case PixelFormat::BC5:
+                memset(pixels, 0, sizeof(pixels));
+                DecodeChannelBlock(data, 0, pixels);
+                DecodeChannelBlock(data + 8, 1, pixels);
+                for (uint32_t i = 0; i < BLOCK_PIXELS; ++i)
+                {
+                    pixels[i][3] = 255;
+                }
+                break;
+            case PixelFormat::BC7:
+                success = DecodeBC7Block(data, pixels) && success;
+                break;
+            default:
+                break;
+            }
+
+            StoreBlock(pixels, width, height, bx, by, dst);
+            data += blockBytes;
+        }
+    }
+
+    if (!success)
+    {
+        LogWarning("BC7 texture contains block modes that can't be decoded on the CPU");
+    }
+
+    return success;
+}
+
+float ComputeTexturePSNR(const uint8_t* rgbaA, const uint8_t* rgbaB, uint32_t numPixels, uint32_t channelMask)
+{
+    uint64_t sumSq = 0;
+    uint32_t numChannels = 0;
+
+    for (uint32_t c = 0; c < 4; ++c)
+    {
+        if ((channelMask & (1 << c)) == 0)
+            continue;
+
+        numChannels++;
+
+        for (uint32_t i = 0; i < numPixels; ++i)
+        {
+            int32_t d = int32_t(rgbaA[i * 4 + c]) - int32_t(rgbaB[i * 4 + c]);
+            sumSq += uint64_t(d * d);
+        }
+    }
+
+    if (sumSq == 0 || numChannels == 0)
+    {
+        return 99.0f;
+    }
+
+    double mse = double(sumSq) / (double(numPixels) * numChannels);
+    return float(10.0 * log10((255.0 * 255.0) / mse));
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+#include "Graphics/GraphicsTypes.h"
+
+// CPU side block compression used when cooking textures for desktop platforms.
+//
+// Supported formats are BC1 (PixelFormat::CMPR), BC3, BC5 and BC7. Every format works on 4x4
+// pixel blocks and blocks on the right / bottom edge are padded by repeating the last row/column.
+// Encoding only uses integer and single precision float math in a fixed order, so a given
+// image and quality always produces the same bytes.
+//
+// The decoders are used to fall back to RGBA8 on devices without BCn support, and to measure
+// the encoders. The BC7 decoder only understands the block mode written by EncodeTexture().
+
+enum class TextureCompressionQuality
+{
+    Fast,
+    High,
+
+    Count
+};
+
+bool IsBlockCompressedFormat(PixelFormat format);
+uint32_t GetCompressedBlockBytes(PixelFormat format);
+
+uint32_t GetMipDimension(uint32_t baseDimension, uint32_t mipLevel);
+uint32_t GetTextureDataSize(PixelFormat format, uint32_t width, uint32_t height);
+
+// Appends numMips RGBA8 levels to outMips, starting with a copy of the base level.
+void GenerateMipChain(const uint8_t* rgba, uint32_t width, uint32_t height, uint32_t numMips, std::vector<uint8_t>& outMips);
+
+// Appends one compressed image to outData. rgba is tightly packed RGBA8.
+void EncodeTexture(PixelFormat format, const uint8_t* rgba, uint32_t width, uint32_t height, TextureCompressionQuality quality, std::vector<uint8_t>& outData);
+
+// Appends one decoded RGBA8 image to outRgba. Channels that the format doesn't store are
+// decoded as 0 for color and 255 for alpha.
+bool DecodeTexture(PixelFormat format, const uint8_t* data, uint32_t width, uint32_t height, std::vector<uint8_t>& outRgba);
+
+// Peak signal to noise ratio in dB over the channels set in channelMask (bit 0 = red ... bit 3 = alpha).
+float ComputeTexturePSNR(const uint8_t* rgbaA, const uint8_t* rgbaB, uint32_t numPixels, uint32_t channelMask = 0xf);
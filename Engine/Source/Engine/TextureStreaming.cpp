@@ -0,0 +1,381 @@
+#include "TextureStreaming.h"
+#include "TextureCompression.h"
+#include "Assertion.h"
+#include "Log.h"
+#include "Constants.h"
+
+#include "Assets/Texture.h"
+#include "Assets/Material.h"
+
+#include <algorithm>
+
+TextureStreamingView MakePerspectiveStreamingView(glm::vec3 position, float fovYDegrees, float viewportHeight)
+{
+    TextureStreamingView view;
+    view.mPosition = position;
+    view.mOrtho = false;
+
+    float tanHalfFov = tanf(glm::radians(glm::clamp(fovYDegrees, 1.0f, 179.0f)) * 0.5f);
+    view.mPixelScale = viewportHeight / (2.0f * tanHalfFov);
+
+    return view;
+}
+
+TextureStreamingView MakeOrthoStreamingView(glm::vec3 position, float orthoHeight, float viewportHeight)
+{
+    TextureStreamingView view;
+    view.mPosition = position;
+    view.mOrtho = true;
+    view.mPixelScale = (orthoHeight > 0.0f) ? (viewportHeight / orthoHeight) : 0.0f;
+
+    return view;
+}
+
+float ComputeBoundsDistance(const TextureStreamingView& view, const Bounds& bounds)
+{
+    float distance = glm::length(bounds.mCenter - view.mPosition) - bounds.mRadius;
+    return glm::max(distance, 0.0f);
+}
+
+uint32_t ComputeRequestedMip(
+    uint32_t textureSize,
+    uint32_t numMips,
+    float uvPerUnit,
+    float distance,
+    const TextureStreamingView& view,
+    float bias)
+{
+    OCT_ASSERT(numMips > 0);
+
+    // Anything closer than this is treated as covering the screen.
+    const float kMinDistance = 0.01f;
+
+    float pixelsPerUnit = view.mOrtho ? view.mPixelScale : view.mPixelScale / glm::max(distance, kMinDistance);
+    float texelsPerUnit = uvPerUnit * float(textureSize);
+
+    if (!(pixelsPerUnit > 0.0f) ||
+        !(texelsPerUnit > 0.0f))
+    {
+        return numMips - 1;
+    }
+
+    // The GPU samples mip log2(texels per pixel), blending with the next coarser one.
+    float mip = log2f(texelsPerUnit / pixelsPerUnit) + bias;
+    mip = glm::clamp(floorf(mip), 0.0f, float(numMips - 1));
+
+    return uint32_t(mip);
+}
+
+uint32_t ComputeStreamingMinMip(uint32_t width, uint32_t height, uint32_t numMips, uint32_t minSize)
+{
+    uint32_t mip = 0;
+
+    while (mip + 1 < numMips &&
+        glm::max(GetMipDimension(width, mip), GetMipDimension(height, mip)) > minSize)
+    {
+        ++mip;
+    }
+
+    return mip;
+}
+
+uint32_t ComputeMipChainSize(PixelFormat format, uint32_t width, uint32_t height, uint32_t firstMip, uint32_t numMips)
+{
+    uint32_t size = 0;
+
+    for (uint32_t i = firstMip; i < numMips; ++i)
+    {
+        size += GetTextureDataSize(format, GetMipDimension(width, i), GetMipDimension(height, i));
+    }
+
+    return size;
+}
+
+void TextureStreamer::SetEnabled(bool enabled)
+{
+    mEnabled = enabled;
+}
+
+bool TextureStreamer::IsEnabled() const
+{
+    return mEnabled;
+}
+
+void TextureStreamer::SetBudget(uint64_t bytes)
+{
+    mBudget = bytes;
+}
+
+uint64_t TextureStreamer::GetBudget() const
+{
+    return mBudget;
+}
+
+void TextureStreamer::SetUploadBudget(uint32_t bytesPerFrame)
+{
+    mUploadBudget = bytesPerFrame;
+}
+
+uint32_t TextureStreamer::GetUploadBudget() const
+{
+    return mUploadBudget;
+}
+
+void TextureStreamer::SetMipBias(float bias)
+{
+    mMipBias = bias;
+}
+
+float TextureStreamer::GetMipBias() const
+{
+    return mMipBias;
+}
+
+bool TextureStreamer::CanStream(Texture* texture) const
+{
+    // Only cooked textures carry their mip chain. Editor textures generate mips on the GPU.
+    return mEnabled &&
+        !texture->IsRenderTarget() &&
+        texture->GetLayers() == 1 &&
+        texture->GetDataMipLevels() > 1 &&
+        texture->GetDataMipLevels() == texture->GetMipLevels();
+}
+
+void TextureStreamer::AddTexture(Texture* texture)
+{
+    OCT_ASSERT(std::find(mTextures.begin(), mTextures.end(), texture) == mTextures.end());
+    mTextures.push_back(texture);
+}
+
+void TextureStreamer::RemoveTexture(Texture* texture)
+{
+    auto it = std::find(mTextures.begin(), mTextures.end(), texture);
+
+    if (it != mTextures.end())
+    {
+        *it = mTextures.back();
+        mTextures.pop_back();
+    }
+}
+
+void TextureStreamer::RequestMip(Texture* texture, uint32_t mip)
+{
+    TextureStreamingState& state = texture->GetStreamingState();
+
+    if (!state.mStreamed)
+        return;
+
+    if (state.mRequestFrame != mFrame)
+    {
+        state.mRequestFrame = mFrame;
+        state.mRequestedMip = mip;
+    }
+    else
+    {
+        state.mRequestedMip = glm::min(state.mRequestedMip, mip);
+    }
+}
+
+void TextureStreamer::RequestMaterialMips(Material* material, float uvPerUnit, float distance, const TextureStreamingView& view)
+{
+    if (material == nullptr)
+        return;
+
+    const MaterialParams& params = material->GetParams();
+
+    for (uint32_t i = 0; i < MATERIAL_MAX_TEXTURES; ++i)
+    {
+        Texture* texture = material->GetTexture(TextureSlot(i));
+
+        if (texture == nullptr ||
+            !texture->GetStreamingState().mStreamed)
+        {
+            continue;
+        }
+
+        uint32_t uvMap = glm::min<uint32_t>(params.mUvMaps[i], MAX_UV_MAPS - 1);
+        glm::vec2 uvScale = glm::abs(params.mUvScales[uvMap]);
+        uint32_t textureSize = glm::max(texture->GetWidth(), texture->GetHeight());
+
+        uint32_t mip = ComputeRequestedMip(
+            textureSize,
+            texture->GetMipLevels(),
+            uvPerUnit * glm::max(uvScale.x, uvScale.y),
+            distance,
+            view,
+            mMipBias);
+
+        RequestMip(texture, mip);
+    }
+}
+
+void TextureStreamer::Update()
+{
+    uint32_t numTextures = uint32_t(mTextures.size());
+    uint64_t wantedBytes = 0;
+
+    mWantedMips.resize(numTextures);
+
+    for (uint32_t i = 0; i < numTextures; ++i)
+    {
+        mWantedMips[i] = GetWantedMip(mTextures[i]);
+        wantedBytes += GetResidentSize(mTextures[i], mWantedMips[i]);
+    }
+
+    if (mEnabled &&
+        wantedBytes > mBudget)
+    {
+        // First let go of textures that nothing has asked for lately, least recently used first...
+        mUploadOrder.clear();
+        for (uint32_t i = 0; i < numTextures; ++i)
+        {
+            if (!IsRecentlyRequested(mTextures[i]))
+            {
+                mUploadOrder.push_back(i);
+            }
+        }
+
+        std::sort(mUploadOrder.begin(), mUploadOrder.end(), [this](uint32_t a, uint32_t b)
+        {
+            return mTextures[a]->GetStreamingState().mRequestFrame < mTextures[b]->GetStreamingState().mRequestFrame;
+        });
+
+        for (uint32_t i = 0; i < mUploadOrder.size() && wantedBytes > mBudget; ++i)
+        {
+            uint32_t index = mUploadOrder[i];
+            uint32_t minMip = mTextures[index]->GetStreamingState().mMinResidentMip;
+
+            wantedBytes -= GetResidentSize(mTextures[index], mWantedMips[index]);
+            mWantedMips[index] = glm::max(mWantedMips[index], minMip);
+            wantedBytes += GetResidentSize(mTextures[index], mWantedMips[index]);
+        }
+
+        // ...then drop the finest mip of every visible texture until everything fits.
+        bool changed = true;
+        while (wantedBytes > mBudget && changed)
+        {
+            changed = false;
+            wantedBytes = 0;
+
+            for (uint32_t i = 0; i < numTextures; ++i)
+            {
+                uint32_t minMip = mTextures[i]->GetStreamingState().mMinResidentMip;
+
+                if (mWantedMips[i] < minMip)
+                {
+                    mWantedMips[i]++;
+                    changed = true;
+                }
+
+                wantedBytes += GetResidentSize(mTextures[i], mWantedMips[i]);
+            }
+        }
+    }
+
+    // Evictions are cheap, the smaller image copies the mips it keeps on the GPU.
+    for (uint32_t i = 0; i < numTextures; ++i)
+    {
+        if (mWantedMips[i] > mTextures[i]->GetStreamingState().mResidentMip)
+        {
+            mTextures[i]->SetResidentMip(mWantedMips[i]);
+        }
+    }
+
+    // Uploads go to the textures missing the most mips first, within the per frame upload budget.
+    mUploadOrder.clear();
+    for (uint32_t i = 0; i < numTextures; ++i)
+    {
+        if (mWantedMips[i] < mTextures[i]->GetStreamingState().mResidentMip)
+        {
+            mUploadOrder.push_back(i);
+        }
+    }
+
+    std::sort(mUploadOrder.begin(), mUploadOrder.end(), [this](uint32_t a, uint32_t b)
+    {
+        uint32_t missingA = mTextures[a]->GetStreamingState().mResidentMip - mWantedMips[a];
+        uint32_t missingB = mTextures[b]->GetStreamingState().mResidentMip - mWantedMips[b];
+        return (missingA != missingB) ? (missingA > missingB) : (a < b);
+    });
+
+    uint32_t uploadedBytes = 0;
+
+    for (uint32_t i = 0; i < mUploadOrder.size(); ++i)
+    {
+        uint32_t index = mUploadOrder[i];
+        Texture* texture = mTextures[index];
+        uint32_t residentMip = texture->GetStreamingState().mResidentMip;
+        uint32_t residentSize = GetResidentSize(texture, residentMip);
+        uint32_t remaining = (uploadedBytes < mUploadBudget) ? (mUploadBudget - uploadedBytes) : 0;
+
+        // Step toward the wanted mip as far as the budget allows. Resident mips are copied on the GPU,
+        // so only the new mips count against the budget. The first upload of the frame always gets
+        // at least one more mip so that large textures can't stall forever.
+        uint32_t mip = residentMip - 1;
+        while (mip > mWantedMips[index] &&
+            GetResidentSize(texture, mip - 1) - residentSize <= remaining)
+        {
+            --mip;
+        }
+
+        uint32_t size = GetResidentSize(texture, mip) - residentSize;
+
+        if (size > remaining &&
+            uploadedBytes > 0)
+        {
+            continue;
+        }
+
+        texture->SetResidentMip(mip);
+        uploadedBytes += size;
+    }
+
+    mResidentBytes = 0;
+    for (uint32_t i = 0; i < numTextures; ++i)
+    {
+        mResidentBytes += GetResidentSize(mTextures[i], mTextures[i]->GetStreamingState().mResidentMip);
+    }
+
+    mFrame++;
+}
+
+uint32_t TextureStreamer::GetNumTextures() const
+{
+    return uint32_t(mTextures.size());
+}
+
+uint64_t TextureStreamer::GetResidentBytes() const
+{
+    return mResidentBytes;
+}
+
+uint32_t TextureStreamer::GetWantedMip(Texture* texture) const
+{
+    if (!mEnabled)
+    {
+        return 0;
+    }
+
+    const TextureStreamingState& state = texture->GetStreamingState();
+
+    // Textures that weren't requested lately keep what they have until the budget runs out.
+    return IsRecentlyRequested(texture) ?
+        glm::min(state.mRequestedMip, state.mMinResidentMip) :
+        state.mResidentMip;
+}
+
+bool TextureStreamer::IsRecentlyRequested(Texture* texture) const
+{
+    const TextureStreamingState& state = texture->GetStreamingState();
+    return (state.mRequestFrame != 0) && (mFrame - state.mRequestFrame <= TEXTURE_STREAMING_RETAIN_FRAMES);
+}
+
+uint32_t TextureStreamer::GetResidentSize(Texture* texture, uint32_t firstMip)
+{
+    return ComputeMipChainSize(
+        texture->GetDataFormat(),
+        texture->GetWidth(),
+        texture->GetHeight(),
+        firstMip,
+        texture->GetMipLevels());
+}
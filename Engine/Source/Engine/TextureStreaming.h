@@ -0,0 +1,112 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include "glm/glm.hpp"
+
+#include "EngineTypes.h"
+#include "Graphics/GraphicsTypes.h"
+
+class Texture;
+class Material;
+
+// Cooked textures that carry their whole mip chain are streamed: they are created with only
+// their low mips on the GPU, and the renderer asks for finer mips as objects using them
+// come closer to the camera. The TextureStreamer raises or lowers each texture's first
+// resident mip once per frame, within a GPU memory budget and a per-frame upload budget.
+//
+// The cooked mip chain stays in system memory, so dropping mips never has to reload anything.
+
+#define TEXTURE_STREAMING_MIN_SIZE 64
+#define TEXTURE_STREAMING_RETAIN_FRAMES 60
+#define TEXTURE_STREAMING_DEFAULT_BUDGET (256 * 1024 * 1024)
+#define TEXTURE_STREAMING_DEFAULT_UPLOAD_BUDGET (8 * 1024 * 1024)
+
+struct TextureStreamingView
+{
+    glm::vec3 mPosition = {};
+
+    // Screen pixels covered by one world unit. For perspective views this is at a distance
+    // of one unit, and it shrinks linearly with distance.
+    float mPixelScale = 0.0f;
+    bool mOrtho = false;
+};
+
+struct TextureStreamingState
+{
+    uint32_t mResidentMip = 0;
+    uint32_t mMinResidentMip = 0;
+    uint32_t mRequestedMip = 0;
+    uint32_t mRequestFrame = 0;
+    bool mStreamed = false;
+};
+
+// Mip selection. These don't touch any engine state.
+TextureStreamingView MakePerspectiveStreamingView(glm::vec3 position, float fovYDegrees, float viewportHeight);
+TextureStreamingView MakeOrthoStreamingView(glm::vec3 position, float orthoHeight, float viewportHeight);
+float ComputeBoundsDistance(const TextureStreamingView& view, const Bounds& bounds);
+
+// uvPerUnit is how many UV units one world unit spans on the object. Returns the finest mip
+// the GPU would sample, clamped to [0, numMips - 1]. A positive bias selects coarser mips.
+uint32_t ComputeRequestedMip(
+    uint32_t textureSize,
+    uint32_t numMips,
+    float uvPerUnit,
+    float distance,
+    const TextureStreamingView& view,
+    float bias = 0.0f);
+
+// The coarsest mip a streamed texture keeps resident, the first one that fits in minSize.
+uint32_t ComputeStreamingMinMip(uint32_t width, uint32_t height, uint32_t numMips, uint32_t minSize = TEXTURE_STREAMING_MIN_SIZE);
+
+// Bytes used by mips [firstMip, numMips) of a texture.
+uint32_t ComputeMipChainSize(PixelFormat format, uint32_t width, uint32_t height, uint32_t firstMip, uint32_t numMips);
+
+class TextureStreamer
+{
+public:
+
+    void SetEnabled(bool enabled);
+    bool IsEnabled() const;
+
+    void SetBudget(uint64_t bytes);
+    uint64_t GetBudget() const;
+
+    void SetUploadBudget(uint32_t bytesPerFrame);
+    uint32_t GetUploadBudget() const;
+
+    void SetMipBias(float bias);
+    float GetMipBias() const;
+
+    // Whether a texture that is about to be created should start out with only its low mips.
+    bool CanStream(Texture* texture) const;
+
+    void AddTexture(Texture* texture);
+    void RemoveTexture(Texture* texture);
+
+    void RequestMip(Texture* texture, uint32_t mip);
+    void RequestMaterialMips(Material* material, float uvPerUnit, float distance, const TextureStreamingView& view);
+
+    // Applies this frame's requests. Must be called outside of command buffer recording.
+    void Update();
+
+    uint32_t GetNumTextures() const;
+    uint64_t GetResidentBytes() const;
+
+protected:
+
+    uint32_t GetWantedMip(Texture* texture) const;
+    bool IsRecentlyRequested(Texture* texture) const;
+    static uint32_t GetResidentSize(Texture* texture, uint32_t firstMip);
+
+    std::vector<Texture*> mTextures;
+    std::vector<uint32_t> mWantedMips;
+    std::vector<uint32_t> mUploadOrder;
+
+    uint32_t mFrame = 1;
+    uint64_t mBudget = TEXTURE_STREAMING_DEFAULT_BUDGET;
+    uint32_t mUploadBudget = TEXTURE_STREAMING_DEFAULT_UPLOAD_BUDGET;
+    uint64_t mResidentBytes = 0;
+    float mMipBias = 0.0f;
+    bool mEnabled = true;
+};
@@ -1,6 +1,7 @@
 #include "TimerManager.h"
 
 #include "Nodes/Node.h"
+#include "FrameAllocator.h"
 
 TimerManager gTimerManager;
 
@@ -11,8 +12,7 @@ TimerManager* GetTimerManager()
 
 void TimerManager::Update(float deltaTime)
 {
-    static std::vector<TimerData> sTimersToExecute;
-    sTimersToExecute.clear();
+    FrameVector<TimerData> timersToExecute;
 
     for (int32_t i = 0; i < (int32_t)mTimerData.size(); ++i)
     {
@@ -27,7 +27,7 @@ void TimerManager::Update(float deltaTime)
                 // Add this to the list of timers to execute.
                 // This has to be done after iterating, otherwise these timer
                 // handler functions could add/remove timers from the timer array.
-                sTimersToExecute.push_back(*timer);
+                timersToExecute.push_back(*timer);
 
                 if (timer->mLoop)
                 {
@@ -44,9 +44,9 @@ void TimerManager::Update(float deltaTime)
         }
     }
 
-    for (uint32_t i = 0; i < sTimersToExecute.size(); ++i)
+    for (uint32_t i = 0; i < timersToExecute.size(); ++i)
     {
-        TimerData* timer = &(sTimersToExecute[i]);
+        TimerData* timer = &(timersToExecute[i]);
 
         // Execute callback handler
         switch (timer->mType)
@@ -5,9 +5,11 @@
 #include "Maths.h"
 #include "Engine.h"
 #include "TableDatum.h"
+#include "CollisionLayers.h"
 
 #include <iostream>
 #include <fstream>
+#include <unordered_map>
 #include <ctype.h>
 
 #include <sys/types.h>
@@ -236,10 +238,11 @@ void GatherAllNodeNames(std::vector<std::string>& outNames)
 Property* FindProperty(std::vector<Property>& props, const std::string& name)
 {
     Property* prop = nullptr;
+    uint32_t nameId = Property::FindNameId(name);
 
-    for (uint32_t i = 0; i < props.size(); ++i)
+    for (uint32_t i = 0; nameId != 0 && i < props.size(); ++i)
     {
-        if (props[i].mName == name)
+        if (props[i].GetNameId() == nameId)
         {
             prop = &props[i];
             break;
@@ -249,20 +252,101 @@ Property* FindProperty(std::vector<Property>& props, const std::string& name)
     return prop;
 }
 
+void PropertyMatcher::Reset()
+{
+    mIndexMap.clear();
+    mNextIndex = 0;
+}
+
+Property* PropertyMatcher::Match(std::vector<Property>& dstProps, const Property& srcProp)
+{
+    // Src and dst props are usually gathered from the same node type, so they tend to be in
+    // the same order. Check the next expected dst prop first and only fall back to the
+    // name id lookup table when the order differs.
+    uint32_t srcNameId = srcProp.GetNameId();
+
+    if (mNextIndex < dstProps.size() &&
+        dstProps[mNextIndex].GetNameId() == srcNameId &&
+        dstProps[mNextIndex].mType == srcProp.mType)
+    {
+        return &dstProps[mNextIndex++];
+    }
+
+    uint32_t dstIndex = FindFirstIndex(dstProps, srcNameId);
+
+    // Rare case, a prop with the same name but a different type. Search the rest.
+    while (dstIndex < dstProps.size() &&
+        (dstProps[dstIndex].GetNameId() != srcNameId || dstProps[dstIndex].mType != srcProp.mType))
+    {
+        dstIndex++;
+    }
+
+    if (dstIndex < dstProps.size())
+    {
+        mNextIndex = dstIndex + 1;
+        return &dstProps[dstIndex];
+    }
+
+    return nullptr;
+}
+
+uint32_t PropertyMatcher::FindFirstIndex(std::vector<Property>& dstProps, uint32_t nameId)
+{
+    if (mIndexMap.empty())
+    {
+        mIndexMap.reserve(dstProps.size());
+        for (uint32_t i = 0; i < dstProps.size(); ++i)
+        {
+            mIndexMap.insert({ dstProps[i].GetNameId(), i });
+        }
+    }
+
+    auto it = mIndexMap.find(nameId);
+    return (it != mIndexMap.end()) ? it->second : uint32_t(dstProps.size());
+}
+
 void CopyPropertyValues(std::vector<Property>& dstProps, const std::vector<Property>& srcProps)
 {
+    PropertyMatcher matcher;
+
     for (uint32_t i = 0; i < srcProps.size(); ++i)
     {
         const Property* srcProp = &srcProps[i];
-        Property* dstProp = nullptr;
+        Property* dstProp = matcher.Match(dstProps, *srcProp);
+        Property* widenProp = nullptr;
 
-        for (uint32_t j = 0; j < dstProps.size(); ++j)
+        if (dstProp == nullptr &&
+            (srcProp->mType == DatumType::Byte || srcProp->mType == DatumType::Short))
         {
-            if (dstProps[j].mName == srcProp->mName &&
-                dstProps[j].mType == srcProp->mType)
+            // Props that were widened to Integer (e.g. collision group/mask) still accept old values.
+            for (uint32_t j = matcher.FindFirstIndex(dstProps, srcProp->GetNameId()); j < dstProps.size(); ++j)
             {
-                dstProp = &dstProps[j];
-                break;
+                if (dstProps[j].GetNameId() == srcProp->GetNameId() &&
+                    dstProps[j].mType == DatumType::Integer &&
+                    !dstProps[j].IsVector() &&
+                    dstProps[j].mCount == srcProp->mCount)
+                {
+                    widenProp = &dstProps[j];
+                    break;
+                }
+            }
+        }
+
+        if (widenProp != nullptr)
+        {
+            static const uint32_t sCollisionMaskNameId = Property::InternName("Collision Mask");
+
+            for (uint32_t c = 0; c < srcProp->mCount; ++c)
+            {
+                int32_t value = (srcProp->mType == DatumType::Byte) ? int32_t(srcProp->GetByte(c)) : int32_t(srcProp->GetShort(c));
+
+                if (srcProp->mType == DatumType::Byte &&
+                    srcProp->GetNameId() == sCollisionMaskNameId)
+                {
+                    value = int32_t(WidenLegacyCollisionMask(uint32_t(value)));
+                }
+
+                widenProp->SetInteger(value, c);
             }
         }
 
@@ -287,6 +371,37 @@ uint32_t GetStringSerializationSize(const std::string& str)
     return uint32_t(STREAM_STRING_LEN_BYTES + str.length());
 }
 
+void ReadIndexArray(Stream& stream, IndexType* indices, uint32_t count)
+{
+    // Indices are always serialized as 32 bit so cooked data doesn't depend on the graphics API.
+    if (sizeof(IndexType) == sizeof(uint32_t))
+    {
+        stream.ReadArray32(reinterpret_cast<uint32_t*>(indices), count);
+    }
+    else
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            indices[i] = (IndexType) stream.ReadUint32();
+        }
+    }
+}
+
+void WriteIndexArray(Stream& stream, const IndexType* indices, uint32_t count)
+{
+    if (sizeof(IndexType) == sizeof(uint32_t))
+    {
+        stream.WriteArray32(reinterpret_cast<const uint32_t*>(indices), count);
+    }
+    else
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            stream.WriteUint32(indices[i]);
+        }
+    }
+}
+
 const char* GetPlatformString(Platform platform)
 {
     const char* retString = "Unknown";
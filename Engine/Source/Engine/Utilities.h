@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <string>
+#include <unordered_map>
 
 #include <Bullet/btBulletDynamicsCommon.h>
 
@@ -36,10 +37,29 @@ uint32_t OctHashString(const char* key);
 void GatherAllNodeNames(std::vector<std::string>& outNames);
 
 Property* FindProperty(std::vector<Property>& props, const std::string& name);
+
+// Matches src props to dst props by name id and type. Call Reset() if dstProps is regathered.
+class PropertyMatcher
+{
+public:
+
+    void Reset();
+    Property* Match(std::vector<Property>& dstProps, const Property& srcProp);
+    uint32_t FindFirstIndex(std::vector<Property>& dstProps, uint32_t nameId);
+
+protected:
+
+    std::unordered_map<uint32_t, uint32_t> mIndexMap;
+    uint32_t mNextIndex = 0;
+};
+
 void CopyPropertyValues(std::vector<Property>& dstProps, const std::vector<Property>& srcProps);
 
 uint32_t GetStringSerializationSize(const std::string& str);
 
+void ReadIndexArray(Stream& stream, IndexType* indices, uint32_t count);
+void WriteIndexArray(Stream& stream, const IndexType* indices, uint32_t count);
+
 const char* GetPlatformString(Platform platform);
 
 uint8_t ConvertKeyCodeToChar(uint8_t keyCode, bool shiftDown);
@@ -13,6 +13,7 @@
 #include "Nodes/3D/PointLight3d.h"
 #include "Nodes/3D/Particle3d.h"
 #include "Nodes/3D/Audio3d.h"
+#include "CollisionLayers.h"
 
 #if EDITOR
 #include "Editor/EditorState.h"
@@ -61,6 +62,141 @@ bool ContactAddedHandler(btManifoldPoint& cp,
 #endif
 }
 
+// Closest hit ray callback that can optionally stop at the first hit found.
+// Once m_closestHitFraction is 0, Bullet skips the remaining broadphase candidates.
+struct AnyHitRayResultCallback : public btCollisionWorld::ClosestRayResultCallback
+{
+    AnyHitRayResultCallback(const btVector3& rayFromWorld, const btVector3& rayToWorld, bool anyHit) :
+        btCollisionWorld::ClosestRayResultCallback(rayFromWorld, rayToWorld),
+        mAnyHit(anyHit)
+    {
+
+    }
+
+    virtual btScalar addSingleResult(btCollisionWorld::LocalRayResult& rayResult, bool normalInWorldSpace) override
+    {
+        if (mAnyHit && m_collisionObject != nullptr)
+        {
+            return 0.0f;
+        }
+
+        btScalar fraction = btCollisionWorld::ClosestRayResultCallback::addSingleResult(rayResult, normalInWorldSpace);
+        mHitFraction = fraction;
+
+        if (mAnyHit)
+        {
+            m_closestHitFraction = 0.0f;
+        }
+
+        return m_closestHitFraction;
+    }
+
+    float mHitFraction = 1.0f;
+    bool mAnyHit = false;
+};
+
+// Rejects broadphase pairs whose layers don't interact according to the world's layer matrix.
+// Queries (ray tests and sweeps) don't go through this filter, they only use their collision mask.
+struct CollisionLayerFilterCallback : public btOverlapFilterCallback
+{
+    CollisionLayerFilterCallback(const CollisionLayers* layers) :
+        mLayers(layers)
+    {
+
+    }
+
+    virtual bool needBroadphaseCollision(btBroadphaseProxy* proxy0, btBroadphaseProxy* proxy1) const override
+    {
+        bool collides = (proxy0->m_collisionFilterGroup & proxy1->m_collisionFilterMask) != 0 &&
+            (proxy1->m_collisionFilterGroup & proxy0->m_collisionFilterMask) != 0;
+
+        return collides &&
+            mLayers->DoGroupsInteract(uint32_t(proxy0->m_collisionFilterGroup), uint32_t(proxy1->m_collisionFilterGroup));
+    }
+
+    const CollisionLayers* mLayers = nullptr;
+};
+
+// Exposes state that Bullet keeps protected: the contacts that CCD created during the last
+// substep (for the CCD hit counter) and the leftover fixed step time (for physics snapshots).
+// Also counts the convex sweeps CCD performs, since Bullet only has a process-wide counter.
+class OctaveDynamicsWorld : public btDiscreteDynamicsWorld
+{
+public:
+
+    using btDiscreteDynamicsWorld::btDiscreteDynamicsWorld;
+
+    virtual void createPredictiveContacts(btScalar timeStep) override
+    {
+        mNumCcdSweeps += CountCcdSweeps(timeStep);
+        btDiscreteDynamicsWorld::createPredictiveContacts(timeStep);
+    }
+
+    virtual void integrateTransforms(btScalar timeStep) override
+    {
+        mNumCcdSweeps += CountCcdSweeps(timeStep);
+        btDiscreteDynamicsWorld::integrateTransforms(timeStep);
+    }
+
+    uint32_t GetNumCcdSweeps() const
+    {
+        return mNumCcdSweeps;
+    }
+
+    float GetLocalTime() const
+    {
+        return m_localTime;
+    }
+
+    void SetLocalTime(float localTime)
+    {
+        m_localTime = localTime;
+    }
+
+    int32_t GetNumPredictiveContacts() const
+    {
+        return m_predictiveManifolds.size();
+    }
+
+protected:
+
+    // Same test Bullet uses to decide whether a body gets a convex sweep.
+    uint32_t CountCcdSweeps(btScalar timeStep)
+    {
+        if (!getDispatchInfo().m_useContinuous)
+        {
+            return 0;
+        }
+
+        uint32_t numSweeps = 0;
+        btTransform predictedTrans;
+
+        for (int32_t i = 0; i < m_nonStaticRigidBodies.size(); ++i)
+        {
+            btRigidBody* body = m_nonStaticRigidBodies[i];
+            btScalar threshold = body->getCcdSquareMotionThreshold();
+
+            if (threshold != 0.0f &&
+                body->isActive() &&
+                !body->isStaticOrKinematicObject() &&
+                body->getCollisionShape()->isConvex())
+            {
+                body->predictIntegratedTransform(timeStep, predictedTrans);
+                btScalar squareMotion = (predictedTrans.getOrigin() - body->getWorldTransform().getOrigin()).length2();
+
+                if (threshold < squareMotion)
+                {
+                    numSweeps++;
+                }
+            }
+        }
+
+        return numSweeps;
+    }
+
+    uint32_t mNumCcdSweeps = 0;
+};
+
 World::World() :
     mAmbientLightColor(DEFAULT_AMBIENT_LIGHT_COLOR),
     mShadowColor(DEFAULT_SHADOW_COLOR),
@@ -74,24 +210,32 @@ World::World() :
     mCollisionDispatcher = new btCollisionDispatcher(mCollisionConfig);
     mBroadphase = new btDbvtBroadphase();
     mSolver = new btSequentialImpulseConstraintSolver();
-    mDynamicsWorld = new btDiscreteDynamicsWorld(mCollisionDispatcher, mBroadphase, mSolver, mCollisionConfig);
+    mDynamicsWorld = new OctaveDynamicsWorld(mCollisionDispatcher, mBroadphase, mSolver, mCollisionConfig);
     mDynamicsWorld->setGravity(btVector3(0, -10, 0));
+    mCollisionLayers = GetProjectCollisionLayers();
+    mCollisionLayerFilter = new CollisionLayerFilterCallback(&mCollisionLayers);
+    mDynamicsWorld->getPairCache()->setOverlapFilterCallback(mCollisionLayerFilter);
+    mDynamicsWorld->setInternalTickCallback(PhysicsTickCallback, this);
 }
 
 void World::Destroy()
 {
+    SyncPhysics();
+    StopPhysicsThread();
     DestroyRootNode();
 
     OCT_ASSERT(mRootNode == nullptr);
     mActiveCamera = nullptr;
 
     delete mDynamicsWorld;
+    delete mCollisionLayerFilter;
     delete mSolver;
     delete mBroadphase;
     delete mCollisionDispatcher;
     delete mCollisionConfig;
 
     mDynamicsWorld = nullptr;
+    mCollisionLayerFilter = nullptr;
     mSolver = nullptr;
     mBroadphase = nullptr;
     mCollisionDispatcher = nullptr;
@@ -132,6 +276,8 @@ void World::SetRootNode(Node* node)
             mRootNode->SetWorld(this);
         }
 
+        mWorldPartition.SetScene(mRootNode ? mRootNode->GetScene() : nullptr);
+
         UpdateRenderSettings();
     }
 }
@@ -150,6 +296,11 @@ void World::DestroyRootNode()
     }
 }
 
+WorldPartition* World::GetWorldPartition()
+{
+    return &mWorldPartition;
+}
+
 Node* World::FindNode(const std::string& name)
 {
     Node* ret = nullptr;
@@ -185,15 +336,27 @@ Node* World::GetNetNode(NetId netId)
 
 std::vector<Node*> World::FindNodesWithTag(const char* tag)
 {
-    std::vector<Node*> retNodes;
+    FrameVector<Node*> nodes;
+    FindNodesWithTag(tag, nodes);
+    return std::vector<Node*>(nodes.begin(), nodes.end());
+}
 
+std::vector<Node*> World::FindNodesWithName(const char* name)
+{
+    FrameVector<Node*> nodes;
+    FindNodesWithName(name, nodes);
+    return std::vector<Node*>(nodes.begin(), nodes.end());
+}
+
+void World::FindNodesWithTag(const char* tag, FrameVector<Node*>& outNodes)
+{
     if (mRootNode != nullptr)
     {
         auto gatherNodesWithTag = [&](Node* node) -> bool
         {
             if (node->HasTag(tag))
             {
-                retNodes.push_back(node);
+                outNodes.push_back(node);
             }
 
             return true;
@@ -201,21 +364,17 @@ std::vector<Node*> World::FindNodesWithTag(const char* tag)
 
         mRootNode->Traverse(gatherNodesWithTag);
     }
-
-    return retNodes;
 }
 
-std::vector<Node*> World::FindNodesWithName(const char* name)
+void World::FindNodesWithName(const char* name, FrameVector<Node*>& outNodes)
 {
-    std::vector<Node*> retNodes;
-
     if (mRootNode != nullptr)
     {
         auto gatherNodesWithName = [&](Node* node) -> bool
         {
             if (node->GetName() == name)
             {
-                retNodes.push_back(node);
+                outNodes.push_back(node);
             }
 
             return true;
@@ -223,8 +382,6 @@ std::vector<Node*> World::FindNodesWithName(const char* name)
 
         mRootNode->Traverse(gatherNodesWithName);
     }
-
-    return retNodes;
 }
 
 std::vector<Node*> World::GatherNodes()
@@ -335,6 +492,8 @@ const FogSettings& World::GetFogSettings() const
 
 void World::SetGravity(glm::vec3 gravity)
 {
+    SyncPhysics();
+
     if (mDynamicsWorld)
     {
         btVector3 btGrav = GlmToBullet(gravity);
@@ -356,61 +515,604 @@ glm::vec3 World::GetGravity() const
 
 btDynamicsWorld* World::GetDynamicsWorld()
 {
+    // Anyone touching the dynamics world directly needs the physics thread to be idle.
+    SyncPhysics();
     return mDynamicsWorld;
 }
 
+CollisionLayers& World::GetCollisionLayers()
+{
+    // The filter reads the matrix during the physics step.
+    SyncPhysics();
+    return mCollisionLayers;
+}
+
 btDbvtBroadphase* World::GetBroadphase()
 {
+    SyncPhysics();
     return mBroadphase;
 }
 
 void World::PurgeOverlaps(Primitive3D* prim)
 {
-    for (int32_t i = (int32_t)mCurrentOverlaps.size() - 1; i >= 0; --i)
+    // Most primitives aren't overlapping anything when they are destroyed.
+    if (prim->mNumOverlaps == 0)
+        return;
+
+    FrameVector<PrimitivePair> pairs;
+    mOverlaps.GatherPairs(prim, pairs);
+
+    for (uint32_t i = 0; i < pairs.size(); ++i)
     {
-        Primitive3D* primA = mCurrentOverlaps[i].mPrimitiveA;
-        Primitive3D* primB = mCurrentOverlaps[i].mPrimitiveB;
+        // An earlier EndOverlap() callback may have already purged this pair.
+        if (RemoveOverlap(pairs[i]))
+        {
+            pairs[i].mPrimitiveA->EndOverlap(pairs[i].mPrimitiveA, pairs[i].mPrimitiveB);
+        }
+    }
+}
+
+void World::EnablePipelinedPhysics(bool enable)
+{
+    if (mPipelinedPhysics != enable)
+    {
+        SyncPhysics();
+        mPipelinedPhysics = enable;
 
-        if (primA == prim ||
-            primB == prim)
+        if (!enable)
         {
-            primA->EndOverlap(primA, primB);
-            mCurrentOverlaps.erase(mCurrentOverlaps.begin() + i);
+            StopPhysicsThread();
         }
     }
 }
 
-void World::RayTest(glm::vec3 start, glm::vec3 end, uint8_t collisionMask, RayTestResult& outResult)
+bool World::IsPipelinedPhysicsEnabled() const
 {
-    outResult.mStart = start;
-    outResult.mEnd = end;
+    return mPipelinedPhysics;
+}
 
-    btVector3 fromWorld = btVector3(start.x, start.y, start.z);
-    btVector3 toWorld = btVector3(end.x, end.y, end.z);
+void World::SetPhysicsFixedTimeStep(float timeStep)
+{
+    OCT_ASSERT(timeStep > 0.0f);
+    mPhysicsFixedTimeStep = glm::max(timeStep, 0.0001f);
+}
 
-    btCollisionWorld::ClosestRayResultCallback result(fromWorld, toWorld);
-    result.m_collisionFilterGroup = (short)ColGroupAll;
-    result.m_collisionFilterMask = collisionMask;
+float World::GetPhysicsFixedTimeStep() const
+{
+    return mPhysicsFixedTimeStep;
+}
 
-    //mDynamicsWorld->rayTestSingle()
-    mDynamicsWorld->rayTest(fromWorld, toWorld, result);
+void World::SetPhysicsMaxSubsteps(int32_t maxSubsteps)
+{
+    mPhysicsMaxSubsteps = glm::max(maxSubsteps, 0);
+}
 
-    outResult.mHitPosition = { result.m_hitPointWorld.x(), result.m_hitPointWorld.y(), result.m_hitPointWorld.z() };
-    outResult.mHitNormal = { result.m_hitNormalWorld.x(), result.m_hitNormalWorld.y(), result.m_hitNormalWorld.z() };
-    outResult.mHitFraction = result.m_closestHitFraction;
+int32_t World::GetPhysicsMaxSubsteps() const
+{
+    return mPhysicsMaxSubsteps;
+}
+
+uint32_t World::GetPhysicsSubstepCount() const
+{
+    return mPhysicsSubstepCount;
+}
+
+uint32_t World::GetCcdSweepCount() const
+{
+    return mCcdSweepCount;
+}
+
+uint32_t World::GetCcdHitCount() const
+{
+    return mCcdHitCount;
+}
+
+bool World::IsPhysicsStepInFlight() const
+{
+    return mPhysicsStepInFlight;
+}
+
+void World::QueuePhysicsCommand(const PhysicsCommand& command)
+{
+    OCT_ASSERT(IsPhysicsStepInFlight());
+    mPhysicsCommands.push_back(command);
+}
+
+void World::SyncPhysics()
+{
+    if (mPhysicsStepInFlight)
+    {
+        {
+            SCOPED_FRAME_STAT("Physics Sync");
+            SYS_WaitSemaphore(mPhysicsDoneSemaphore);
+            mPhysicsStepInFlight = false;
+        }
+
+        PublishPhysicsStep();
+
+        // Now that the step is finished, apply the changes that were made while it was running.
+        for (uint32_t i = 0; i < mPhysicsCommands.size(); ++i)
+        {
+            ApplyPhysicsCommand(mPhysicsCommands[i]);
+        }
+
+        mPhysicsCommands.clear();
+    }
+
+    FlushTransformPushes();
+}
+
+void World::QueueTransformPush(Primitive3D* prim)
+{
+    mTransformPushes.push_back(prim);
+}
+
+void World::FlushTransformPushes()
+{
+    if (mTransformPushes.size() == 0)
+        return;
+
+    SCOPED_FRAME_STAT("Transform Push");
+
+    // Pushing a transform can touch the dynamics world, which flushes again.
+    // Swap the list out so that nested flushes only see newly queued primitives.
+    std::vector<Primitive3D*> pushes;
+    pushes.swap(mTransformPushes);
 
-    if (result.m_collisionObject != nullptr)
+    for (uint32_t i = 0; i < pushes.size(); ++i)
     {
-        outResult.mHitComponent = reinterpret_cast<Primitive3D*>(result.m_collisionObject->getUserPointer());
+        pushes[i]->PushTransformToPhysics();
     }
-    else
+
+    // Hand the allocation back so it can be reused next frame.
+    if (mTransformPushes.size() == 0)
     {
-        outResult.mHitComponent = nullptr;
+        pushes.clear();
+        mTransformPushes.swap(pushes);
+    }
+}
+
+void World::CapturePhysicsSnapshot(PhysicsSnapshot& outSnapshot)
+{
+    SCOPED_FRAME_STAT("Physics Snapshot");
+
+    SyncPhysics();
+
+    btCollisionObjectArray& objects = mDynamicsWorld->getCollisionObjectArray();
+    int32_t numObjects = objects.size();
+    outSnapshot.mBodies.resize(numObjects);
+
+    for (int32_t i = 0; i < numObjects; ++i)
+    {
+        const btCollisionObject* object = objects[i];
+        const btRigidBody* body = btRigidBody::upcast(object);
+        const btTransform& transform = object->getWorldTransform();
+        const btVector3& origin = transform.getOrigin();
+        btQuaternion rotation = transform.getRotation();
+
+        RigidBodySnapshot& bodySnapshot = outSnapshot.mBodies[i];
+        bodySnapshot.mObject = object;
+        bodySnapshot.mPrimitive = reinterpret_cast<const Primitive3D*>(object->getUserPointer());
+        bodySnapshot.mPosition = { origin.x(), origin.y(), origin.z() };
+        bodySnapshot.mRotation = glm::quat(rotation.w(), rotation.x(), rotation.y(), rotation.z());
+        bodySnapshot.mDeactivationTime = object->getDeactivationTime();
+        bodySnapshot.mActivationState = object->getActivationState();
+
+        if (body != nullptr)
+        {
+            const btVector3& linearVelocity = body->getLinearVelocity();
+            const btVector3& angularVelocity = body->getAngularVelocity();
+            bodySnapshot.mLinearVelocity = { linearVelocity.x(), linearVelocity.y(), linearVelocity.z() };
+            bodySnapshot.mAngularVelocity = { angularVelocity.x(), angularVelocity.y(), angularVelocity.z() };
+        }
+        else
+        {
+            bodySnapshot.mLinearVelocity = {};
+            bodySnapshot.mAngularVelocity = {};
+        }
+    }
+
+    // Overlapping pairs are stored as body indices so that restoring never has to trust
+    // a primitive pointer that isn't in the dynamics world anymore.
+    FrameVector<PrimitivePair> pairs;
+    mOverlaps.GatherAllPairs(pairs);
+
+    outSnapshot.mOverlaps.clear();
+    outSnapshot.mOverlaps.reserve(pairs.size() * 2);
+
+    for (uint32_t i = 0; i < pairs.size(); ++i)
+    {
+        btRigidBody* bodyA = pairs[i].mPrimitiveA->GetRigidBody();
+        btRigidBody* bodyB = pairs[i].mPrimitiveB->GetRigidBody();
+        int32_t indexA = (bodyA != nullptr) ? bodyA->getWorldArrayIndex() : -1;
+        int32_t indexB = (bodyB != nullptr) ? bodyB->getWorldArrayIndex() : -1;
+
+        if (indexA >= 0 && indexB >= 0)
+        {
+            outSnapshot.mOverlaps.push_back(indexA);
+            outSnapshot.mOverlaps.push_back(indexB);
+        }
+    }
+
+    outSnapshot.mLocalTime = static_cast<OctaveDynamicsWorld*>(mDynamicsWorld)->GetLocalTime();
+}
+
+void World::RestorePhysicsSnapshot(const PhysicsSnapshot& snapshot)
+{
+    SCOPED_FRAME_STAT("Physics Restore");
+
+    SyncPhysics();
+
+    btCollisionObjectArray& objects = mDynamicsWorld->getCollisionObjectArray();
+    int32_t numObjects = objects.size();
+    int32_t numBodies = int32_t(snapshot.mBodies.size());
+
+    // Only built if bodies were added or removed since the capture.
+    std::unordered_map<const btCollisionObject*, int32_t> objectIndexMap;
+
+    mRestoredPrimitives.clear();
+    mRestoredPrimitives.resize(numBodies, nullptr);
+
+    for (int32_t i = 0; i < numBodies; ++i)
+    {
+        const RigidBodySnapshot& bodySnapshot = snapshot.mBodies[i];
+        int32_t index = i;
+
+        if (index >= numObjects ||
+            objects[index] != bodySnapshot.mObject)
+        {
+            if (objectIndexMap.empty())
+            {
+                objectIndexMap.reserve(numObjects);
+                for (int32_t j = 0; j < numObjects; ++j)
+                {
+                    objectIndexMap.insert({ objects[j], j });
+                }
+            }
+
+            auto it = objectIndexMap.find(bodySnapshot.mObject);
+            index = (it != objectIndexMap.end()) ? it->second : -1;
+        }
+
+        if (index < 0)
+            continue;
+
+        btCollisionObject* object = objects[index];
+        Primitive3D* prim = reinterpret_cast<Primitive3D*>(object->getUserPointer());
+
+        if (prim != bodySnapshot.mPrimitive)
+            continue;
+
+        const glm::vec3& pos = bodySnapshot.mPosition;
+        const glm::quat& rot = bodySnapshot.mRotation;
+        btTransform transform(btQuaternion(rot.x, rot.y, rot.z, rot.w), btVector3(pos.x, pos.y, pos.z));
+        bool moved = !(object->getWorldTransform() == transform);
+
+        object->setWorldTransform(transform);
+        object->setInterpolationWorldTransform(transform);
+        object->forceActivationState(bodySnapshot.mActivationState);
+        object->setDeactivationTime(bodySnapshot.mDeactivationTime);
+
+        btRigidBody* body = btRigidBody::upcast(object);
+
+        if (body != nullptr)
+        {
+            const glm::vec3& linVel = bodySnapshot.mLinearVelocity;
+            const glm::vec3& angVel = bodySnapshot.mAngularVelocity;
+            btVector3 linearVelocity(linVel.x, linVel.y, linVel.z);
+            btVector3 angularVelocity(angVel.x, angVel.y, angVel.z);
+
+            body->setLinearVelocity(linearVelocity);
+            body->setAngularVelocity(angularVelocity);
+            body->setInterpolationLinearVelocity(linearVelocity);
+            body->setInterpolationAngularVelocity(angularVelocity);
+
+            // Bullet reads kinematic transforms from the motion state, but overwrites the motion state
+            // of dynamic bodies on the next step, so only kinematic ones need the extra write.
+            if (body->isKinematicObject() &&
+                body->getMotionState() != nullptr)
+            {
+                body->getMotionState()->setWorldTransform(transform);
+            }
+        }
+
+        // Bodies that are already in place (usually most of the static world) skip the node update.
+        // Broadphase bounds of moved bodies are refreshed by the next step, or by the next query
+        // if one comes first, which is much cheaper than updating them one at a time here.
+        if (moved)
+        {
+            mPhysicsAabbsStale = true;
+
+            if (prim != nullptr)
+            {
+                glm::mat4 physTransform;
+                transform.getOpenGLMatrix(glm::value_ptr(physTransform));
+                prim->ApplyPhysicsTransform(physTransform);
+            }
+        }
+
+        mRestoredPrimitives[i] = prim;
+    }
+
+    // Replace the overlap set without firing begin/end overlap events. The next
+    // physics update will diff against the restored set as usual.
+    FrameVector<PrimitivePair> pairs;
+    mOverlaps.GatherAllPairs(pairs);
+
+    for (uint32_t i = 0; i < pairs.size(); ++i)
+    {
+        OCT_ASSERT(pairs[i].mPrimitiveA->mNumOverlaps > 0);
+        pairs[i].mPrimitiveA->mNumOverlaps--;
     }
+
+    mOverlaps.Clear();
+
+    for (uint32_t i = 0; i + 1 < snapshot.mOverlaps.size(); i += 2)
+    {
+        int32_t indexA = snapshot.mOverlaps[i];
+        int32_t indexB = snapshot.mOverlaps[i + 1];
+        Primitive3D* primA = (indexA < numBodies) ? mRestoredPrimitives[indexA] : nullptr;
+        Primitive3D* primB = (indexB < numBodies) ? mRestoredPrimitives[indexB] : nullptr;
+
+        if (primA != nullptr &&
+            primB != nullptr &&
+            mOverlaps.Mark(PrimitivePair(primA, primB), mOverlapGeneration))
+        {
+            primA->mNumOverlaps++;
+        }
+    }
+
+    static_cast<OctaveDynamicsWorld*>(mDynamicsWorld)->SetLocalTime(snapshot.mLocalTime);
 }
 
-void World::RayTestMulti(glm::vec3 start, glm::vec3 end, uint8_t collisionMask, RayTestMultiResult& outResult)
+void World::PullActiveTransforms()
 {
+    SCOPED_FRAME_STAT("Transform Pull");
+
+    // Static bodies are not in this list, and sleeping bodies haven't moved since they were
+    // last pulled, so only the bodies Bullet is actively simulating are visited.
+    btAlignedObjectArray<btRigidBody*>& bodies = mDynamicsWorld->getNonStaticRigidBodies();
+
+    for (int32_t i = 0; i < bodies.size(); ++i)
+    {
+        btRigidBody* body = bodies[i];
+
+        if (body->isActive() &&
+            body->getMotionState() != nullptr)
+        {
+            Primitive3D* prim = reinterpret_cast<Primitive3D*>(body->getUserPointer());
+
+            if (prim != nullptr)
+            {
+                prim->PullTransformFromPhysics();
+            }
+        }
+    }
+}
+
+void World::KickPhysicsStep(float deltaTime)
+{
+    OCT_ASSERT(!mPhysicsStepInFlight);
+    FlushTransformPushes();
+
+    if (mPhysicsThread == nullptr)
+    {
+        mPhysicsStartSemaphore = SYS_CreateSemaphore(0);
+        mPhysicsDoneSemaphore = SYS_CreateSemaphore(0);
+        mPhysicsThreadExit = false;
+        mPhysicsThread = SYS_CreateThread(PhysicsThreadFunc, this);
+    }
+
+    mPhysicsDeltaTime = deltaTime;
+    mPhysicsStepInFlight = true;
+    SYS_SignalSemaphore(mPhysicsStartSemaphore);
+}
+
+void World::StopPhysicsThread()
+{
+    OCT_ASSERT(!mPhysicsStepInFlight);
+
+    if (mPhysicsThread != nullptr)
+    {
+        mPhysicsThreadExit = true;
+        SYS_SignalSemaphore(mPhysicsStartSemaphore);
+        SYS_JoinThread(mPhysicsThread);
+        SYS_DestroyThread(mPhysicsThread);
+        SYS_DestroySemaphore(mPhysicsStartSemaphore);
+        SYS_DestroySemaphore(mPhysicsDoneSemaphore);
+
+        mPhysicsThread = nullptr;
+        mPhysicsStartSemaphore = nullptr;
+        mPhysicsDoneSemaphore = nullptr;
+    }
+}
+
+void World::StepPhysics(float deltaTime)
+{
+    // May run on the physics thread, so only touch the dynamics world and the step state.
+    OctaveDynamicsWorld* dynamicsWorld = static_cast<OctaveDynamicsWorld*>(mDynamicsWorld);
+
+    uint32_t startCcdSweeps = dynamicsWorld->GetNumCcdSweeps();
+    mPrevCcdSweeps = startCcdSweeps;
+    mStepCcdHits = 0;
+
+    int32_t numSubsteps = mDynamicsWorld->stepSimulation(deltaTime, mPhysicsMaxSubsteps, mPhysicsFixedTimeStep);
+
+    // Every substep updates all AABBs before collision detection.
+    if (numSubsteps > 0)
+    {
+        mPhysicsAabbsStale = false;
+    }
+
+    // Counts both the predictive contact sweep and the integration sweep.
+    mStepSubsteps = uint32_t(numSubsteps);
+    mStepCcdSweeps = dynamicsWorld->GetNumCcdSweeps() - startCcdSweeps;
+}
+
+void World::UpdateStaleAabbs()
+{
+    if (mPhysicsAabbsStale)
+    {
+        SCOPED_FRAME_STAT("Physics Aabbs");
+        mDynamicsWorld->updateAabbs();
+        mPhysicsAabbsStale = false;
+    }
+}
+
+void World::PublishPhysicsStep()
+{
+    // Called on the main thread once the step has finished. The step counts were snapshotted
+    // by StepPhysics, so nothing here touches Bullet state the physics thread may be using.
+    mPhysicsSubstepCount = mStepSubsteps;
+    mCcdSweepCount = mStepCcdSweeps;
+    mCcdHitCount = mStepCcdHits;
+}
+
+void World::UpdatePhysicsCounters()
+{
+    SET_FRAME_COUNTER("Physics Substeps", mPhysicsSubstepCount);
+    SET_FRAME_COUNTER("CCD Sweeps", mCcdSweepCount);
+    SET_FRAME_COUNTER("CCD Hits", mCcdHitCount);
+}
+
+void World::PhysicsTickCallback(btDynamicsWorld* dynamicsWorld, btScalar timeStep)
+{
+    World* world = (World*)dynamicsWorld->getWorldUserInfo();
+    uint32_t numCcdSweeps = static_cast<OctaveDynamicsWorld*>(dynamicsWorld)->GetNumCcdSweeps();
+
+    // A CCD hit either creates a predictive contact for the solver, or if the body still
+    // moves too far, clamps its motion and leaves it with a hit fraction of 0.
+    // Only look for them if a CCD sweep actually happened during the substep.
+    if (numCcdSweeps != world->mPrevCcdSweeps)
+    {
+        world->mPrevCcdSweeps = numCcdSweeps;
+        world->mStepCcdHits += uint32_t(static_cast<OctaveDynamicsWorld*>(dynamicsWorld)->GetNumPredictiveContacts());
+
+        btAlignedObjectArray<btRigidBody*>& bodies = world->mDynamicsWorld->getNonStaticRigidBodies();
+
+        for (int32_t i = 0; i < bodies.size(); ++i)
+        {
+            if (bodies[i]->getHitFraction() == 0.0f)
+            {
+                world->mStepCcdHits++;
+            }
+        }
+    }
+}
+
+void World::ApplyPhysicsCommand(const PhysicsCommand& command)
+{
+    Primitive3D* prim = command.mPrimitive;
+
+    switch (command.mType)
+    {
+    case PhysicsCommandType::AddLinearVelocity: prim->AddLinearVelocity(command.mValue); break;
+    case PhysicsCommandType::AddAngularVelocity: prim->AddAngularVelocity(command.mValue); break;
+    case PhysicsCommandType::SetLinearVelocity: prim->SetLinearVelocity(command.mValue); break;
+    case PhysicsCommandType::SetAngularVelocity: prim->SetAngularVelocity(command.mValue); break;
+    case PhysicsCommandType::AddForce: prim->AddForce(command.mValue); break;
+    case PhysicsCommandType::AddImpulse: prim->AddImpulse(command.mValue); break;
+    case PhysicsCommandType::SyncTransform: prim->SyncRigidBodyTransform(); break;
+    default: OCT_ASSERT(0); break;
+    }
+}
+
+ThreadFuncRet World::PhysicsThreadFunc(void* arg)
+{
+    World* world = (World*)arg;
+
+    while (true)
+    {
+        SYS_WaitSemaphore(world->mPhysicsStartSemaphore);
+
+        if (world->mPhysicsThreadExit)
+        {
+            break;
+        }
+
+        world->StepPhysics(world->mPhysicsDeltaTime);
+        SYS_SignalSemaphore(world->mPhysicsDoneSemaphore);
+    }
+
+    THREAD_RETURN();
+}
+
+bool World::RemoveOverlap(const PrimitivePair& pair)
+{
+    bool removed = mOverlaps.Remove(pair);
+
+    if (removed)
+    {
+        OCT_ASSERT(pair.mPrimitiveA->mNumOverlaps > 0);
+        pair.mPrimitiveA->mNumOverlaps--;
+    }
+
+    return removed;
+}
+
+void World::RayTest(glm::vec3 start, glm::vec3 end, uint32_t collisionMask, RayTestResult& outResult)
+{
+    RayTestQuery query;
+    query.mStart = start;
+    query.mEnd = end;
+    query.mCollisionMask = collisionMask;
+
+    RayTestBatch(1, &query, &outResult, false);
+}
+
+void World::RayTestBatch(uint32_t numQueries, const RayTestQuery* queries, RayTestResult* outResults, bool anyHit)
+{
+    SyncPhysics();
+    UpdateStaleAabbs();
+
+    for (uint32_t i = 0; i < numQueries; ++i)
+    {
+        const RayTestQuery& query = queries[i];
+        RayTestResult& outResult = outResults[i];
+
+        outResult.mStart = query.mStart;
+        outResult.mEnd = query.mEnd;
+
+        btVector3 fromWorld = btVector3(query.mStart.x, query.mStart.y, query.mStart.z);
+        btVector3 toWorld = btVector3(query.mEnd.x, query.mEnd.y, query.mEnd.z);
+
+        AnyHitRayResultCallback result(fromWorld, toWorld, anyHit);
+        result.m_collisionFilterGroup = int(ColGroupAll);
+        result.m_collisionFilterMask = query.mCollisionMask;
+
+        mDynamicsWorld->rayTest(fromWorld, toWorld, result);
+
+        outResult.mHitPosition = { result.m_hitPointWorld.x(), result.m_hitPointWorld.y(), result.m_hitPointWorld.z() };
+        outResult.mHitNormal = { result.m_hitNormalWorld.x(), result.m_hitNormalWorld.y(), result.m_hitNormalWorld.z() };
+        outResult.mHitFraction = result.mHitFraction;
+
+        if (result.m_collisionObject != nullptr)
+        {
+            outResult.mHitComponent = reinterpret_cast<Primitive3D*>(result.m_collisionObject->getUserPointer());
+        }
+        else
+        {
+            outResult.mHitComponent = nullptr;
+        }
+    }
+}
+
+void World::SweepTestBatch(uint32_t numQueries, const SweepTestQuery* queries, SweepTestResult* outResults)
+{
+    SyncPhysics();
+
+    for (uint32_t i = 0; i < numQueries; ++i)
+    {
+        const SweepTestQuery& query = queries[i];
+        SweepTest(query.mPrimitive, query.mStart, query.mEnd, query.mCollisionMask, outResults[i]);
+    }
+}
+
+void World::RayTestMulti(glm::vec3 start, glm::vec3 end, uint32_t collisionMask, RayTestMultiResult& outResult)
+{
+    SyncPhysics();
+    UpdateStaleAabbs();
+
     outResult.mStart = start;
     outResult.mEnd = end;
 
@@ -418,12 +1120,16 @@ void World::RayTestMulti(glm::vec3 start, glm::vec3 end, uint8_t collisionMask,
     btVector3 toWorld = btVector3(end.x, end.y, end.z);
 
     btCollisionWorld::AllHitsRayResultCallback result(fromWorld, toWorld);
-    result.m_collisionFilterGroup = (short)ColGroupAll;
+    result.m_collisionFilterGroup = int(ColGroupAll);
     result.m_collisionFilterMask = collisionMask;
 
     mDynamicsWorld->rayTest(fromWorld, toWorld, result);
 
     outResult.mNumHits = uint32_t(result.m_collisionObjects.size());
+    outResult.mHitPositions.reserve(outResult.mNumHits);
+    outResult.mHitNormals.reserve(outResult.mNumHits);
+    outResult.mHitFractions.reserve(outResult.mNumHits);
+    outResult.mHitComponents.reserve(outResult.mNumHits);
 
     for (uint32_t i = 0; i < outResult.mNumHits; ++i)
     {
@@ -434,7 +1140,7 @@ void World::RayTestMulti(glm::vec3 start, glm::vec3 end, uint8_t collisionMask,
     }
 }
 
-void World::SweepTest(Primitive3D* primComp, glm::vec3 start, glm::vec3 end, uint8_t collisionMask, SweepTestResult& outResult)
+void World::SweepTest(Primitive3D* primComp, glm::vec3 start, glm::vec3 end, uint32_t collisionMask, SweepTestResult& outResult)
 {
     if (primComp->GetCollisionShape() == nullptr ||
         primComp->GetCollisionShape()->isCompound() ||
@@ -455,11 +1161,14 @@ void World::SweepTest(
     glm::vec3 start,
     glm::vec3 end,
     glm::quat rotation,
-    uint8_t collisionMask,
+    uint32_t collisionMask,
     SweepTestResult& outResult,
     uint32_t numIgnoreObjects,
     btCollisionObject** ignoreObjects)
 {
+    SyncPhysics();
+    UpdateStaleAabbs();
+
     if (start == end)
     {
         outResult.mStart = start;
@@ -481,7 +1190,7 @@ void World::SweepTest(
     btTransform endTransform(rot, endPos);
 
     IgnoreConvexResultCallback result(startPos, endPos);
-    result.m_collisionFilterGroup = (short)ColGroupAll;
+    result.m_collisionFilterGroup = int(ColGroupAll);
     result.m_collisionFilterMask = collisionMask;
     result.mNumIgnoreObjects = numIgnoreObjects;
     result.mIgnoreObjects = ignoreObjects;
@@ -667,10 +1376,32 @@ void World::Update(float deltaTime)
         }
     }
 
+    if (gameTickEnabled)
+    {
+        Camera3D* camera = GetActiveCamera();
+        glm::vec3 cameraPosition = camera ? camera->GetAbsolutePosition() : glm::vec3(0.0f);
+        mWorldPartition.Update(mRootNode, camera ? &cameraPosition : nullptr);
+    }
+
     if (gameTickEnabled)
     {
         SCOPED_FRAME_STAT("Physics");
-        mDynamicsWorld->stepSimulation(deltaTime, 2);
+
+        if (mPipelinedPhysics)
+        {
+            // Wait on the step that was kicked off at the end of last frame.
+            // Collisions and node ticks below operate on its results.
+            SyncPhysics();
+        }
+        else
+        {
+            FlushTransformPushes();
+            StepPhysics(deltaTime);
+            PublishPhysicsStep();
+        }
+
+        PullActiveTransforms();
+        UpdatePhysicsCounters();
     }
 
     if (gameTickEnabled)
@@ -681,9 +1412,10 @@ void World::Update(float deltaTime)
             mDynamicsWorld->getDispatchInfo(),
             mCollisionDispatcher);
 
-        // Update collisions
-        mPreviousOverlaps = mCurrentOverlaps;
-        mCurrentOverlaps.clear();
+        // Update collisions. Each overlapping pair is stamped with the current generation,
+        // anything left with an older generation afterwards has stopped overlapping.
+        mOverlapGeneration++;
+        FrameVector<PrimitivePair> beginOverlaps;
 
         int32_t numManifolds = mDynamicsWorld->getDispatcher()->getNumManifolds();
 
@@ -731,31 +1463,44 @@ void World::Update(float deltaTime)
                 prim1->OnCollision(prim1, prim0, avgContactPoint1, -avgNormal, manifold);
             }
 
-            if (prim0->AreOverlapsEnabled() && prim1->AreOverlapsEnabled() &&
-                std::find(mCurrentOverlaps.begin(), mCurrentOverlaps.end(), PrimitivePair(prim0, prim1)) == mCurrentOverlaps.end())
+            if (prim0->AreOverlapsEnabled() && prim1->AreOverlapsEnabled())
             {
-                mCurrentOverlaps.push_back({ prim0, prim1 });
-                mCurrentOverlaps.push_back({ prim1, prim0 });
+                // Both orderings are tracked so each primitive gets its own begin/end callback.
+                if (mOverlaps.Mark(PrimitivePair(prim0, prim1), mOverlapGeneration))
+                {
+                    prim0->mNumOverlaps++;
+                    beginOverlaps.push_back(PrimitivePair(prim0, prim1));
+                }
+
+                if (mOverlaps.Mark(PrimitivePair(prim1, prim0), mOverlapGeneration))
+                {
+                    prim1->mNumOverlaps++;
+                    beginOverlaps.push_back(PrimitivePair(prim1, prim0));
+                }
             }
         }
 
         // Call Begin Overlaps
-        for (auto& pair : mCurrentOverlaps)
+        for (uint32_t i = 0; i < beginOverlaps.size(); ++i)
         {
-            bool beginOverlap = std::find(mPreviousOverlaps.begin(), mPreviousOverlaps.end(), pair) == mPreviousOverlaps.end();
+            const PrimitivePair& pair = beginOverlaps[i];
 
-            if (beginOverlap)
+            // Skip pairs that were purged by an earlier callback.
+            if (mOverlaps.Contains(pair))
             {
                 pair.mPrimitiveA->BeginOverlap(pair.mPrimitiveA, pair.mPrimitiveB);
             }
         }
 
         // Call End Overlaps
-        for (auto& pair : mPreviousOverlaps)
+        FrameVector<PrimitivePair> endOverlaps;
+        mOverlaps.GatherStalePairs(mOverlapGeneration, endOverlaps);
+
+        for (uint32_t i = 0; i < endOverlaps.size(); ++i)
         {
-            bool endOverlap = std::find(mCurrentOverlaps.begin(), mCurrentOverlaps.end(), pair) == mCurrentOverlaps.end();
+            const PrimitivePair& pair = endOverlaps[i];
 
-            if (endOverlap)
+            if (RemoveOverlap(pair))
             {
                 pair.mPrimitiveA->EndOverlap(pair.mPrimitiveA, pair.mPrimitiveB);
             }
@@ -796,6 +1541,15 @@ void World::Update(float deltaTime)
             mRootNode->Traverse(update3dTransform);
         }
     }
+
+    if (gameTickEnabled && mPipelinedPhysics)
+    {
+        KickPhysicsStep(deltaTime);
+    }
+    else
+    {
+        FlushTransformPushes();
+    }
 }
 
 Camera3D* World::GetActiveCamera()
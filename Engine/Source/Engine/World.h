@@ -14,6 +14,9 @@
 #include "Line.h"
 #include "EngineTypes.h"
 #include "ObjectRef.h"
+#include "OverlapSet.h"
+#include "CollisionLayers.h"
+#include "WorldPartition.h"
 #include "Nodes/3D/Camera3d.h"
 #include "Nodes/3D/DirectionalLight3d.h"
 
@@ -54,9 +57,12 @@ public:
     void SetRootNode(Node* node);
     void DestroyRootNode();
     Node* FindNode(const std::string& name);
+    WorldPartition* GetWorldPartition();
     Node* GetNetNode(NetId netId);
     std::vector<Node*> FindNodesWithTag(const char* tag);
     std::vector<Node*> FindNodesWithName(const char* name);
+    void FindNodesWithTag(const char* tag, FrameVector<Node*>& outNodes);
+    void FindNodesWithName(const char* name, FrameVector<Node*>& outNodes);
     std::vector<Node*> GatherNodes();
 
     void Clear();
@@ -82,21 +88,58 @@ public:
 
     btDynamicsWorld* GetDynamicsWorld();
     btDbvtBroadphase* GetBroadphase();
+    CollisionLayers& GetCollisionLayers();
     void PurgeOverlaps(Primitive3D* prim);
 
-    void RayTest(glm::vec3 start, glm::vec3 end, uint8_t collisionMask, RayTestResult& outResult);
-    void RayTestMulti(glm::vec3 start, glm::vec3 end, uint8_t collisionMask, RayTestMultiResult& outResult);
-    void SweepTest(Primitive3D* primComp, glm::vec3 start, glm::vec3 end, uint8_t collisionMask, SweepTestResult& outResult);
+    // When pipelined physics is enabled, the physics step for frame N runs on a worker thread
+    // while the rest of frame N (networking, rendering) and the start of frame N + 1 run on the main thread.
+    void EnablePipelinedPhysics(bool enable);
+    bool IsPipelinedPhysicsEnabled() const;
+    bool IsPhysicsStepInFlight() const;
+    void QueuePhysicsCommand(const PhysicsCommand& command);
+    void SyncPhysics();
+
+    // Physics is simulated in fixed size substeps. If a frame needs more than the max substeps,
+    // the remaining time is dropped (the simulation slows down instead of spiraling).
+    // A max substep count of 0 steps once per frame with the variable frame delta time.
+    void SetPhysicsFixedTimeStep(float timeStep);
+    float GetPhysicsFixedTimeStep() const;
+    void SetPhysicsMaxSubsteps(int32_t maxSubsteps);
+    int32_t GetPhysicsMaxSubsteps() const;
+
+    // Results of the last completed physics step.
+    uint32_t GetPhysicsSubstepCount() const;
+    uint32_t GetCcdSweepCount() const;
+    uint32_t GetCcdHitCount() const;
+
+    // Captures the state of every rigid body (transform, velocities, activation) and the overlap set.
+    // Restoring puts matching bodies back exactly as they were. Bodies that were removed since the
+    // capture are skipped, and bodies added since then are left alone.
+    void CapturePhysicsSnapshot(PhysicsSnapshot& outSnapshot);
+    void RestorePhysicsSnapshot(const PhysicsSnapshot& snapshot);
+
+    // Node transform changes are pushed to rigid bodies in a batch before the next physics step or query.
+    void QueueTransformPush(Primitive3D* prim);
+    void FlushTransformPushes();
+
+    void RayTest(glm::vec3 start, glm::vec3 end, uint32_t collisionMask, RayTestResult& outResult);
+    void RayTestMulti(glm::vec3 start, glm::vec3 end, uint32_t collisionMask, RayTestMultiResult& outResult);
+    void SweepTest(Primitive3D* primComp, glm::vec3 start, glm::vec3 end, uint32_t collisionMask, SweepTestResult& outResult);
     void SweepTest(
         btConvexShape* convexShape, 
         glm::vec3 start,
         glm::vec3 end,
         glm::quat rotation,
-        uint8_t collisionMask,
+        uint32_t collisionMask,
         SweepTestResult& outResult,
         uint32_t numIgnoreObjects = 0,
         btCollisionObject** ignoreObjects = nullptr);
 
+    // Run many queries in one call. With anyHit, each ray stops at the first hit it finds
+    // instead of the closest one, which is all that visibility checks need.
+    void RayTestBatch(uint32_t numQueries, const RayTestQuery* queries, RayTestResult* outResults, bool anyHit = false);
+    void SweepTestBatch(uint32_t numQueries, const SweepTestQuery* queries, SweepTestResult* outResults);
+
     void RegisterNode(Node* node);
     void UnregisterNode(Node* node);
     const std::vector<Audio3D*>& GetAudios() const;
@@ -167,6 +210,19 @@ public:
 private:
 
     void UpdateLines(float deltaTime);
+    bool RemoveOverlap(const PrimitivePair& pair);
+    void KickPhysicsStep(float deltaTime);
+    void StopPhysicsThread();
+    void PullActiveTransforms();
+    void ApplyPhysicsCommand(const PhysicsCommand& command);
+
+    void StepPhysics(float deltaTime);
+    void UpdateStaleAabbs();
+    void PublishPhysicsStep();
+    void UpdatePhysicsCounters();
+
+    static ThreadFuncRet PhysicsThreadFunc(void* arg);
+    static void PhysicsTickCallback(btDynamicsWorld* dynamicsWorld, btScalar timeStep);
 
 private:
 
@@ -175,6 +231,7 @@ private:
     std::vector<class Light3D*> mLights;
     std::vector<class Audio3D*> mAudios;
     NodeRef mQueuedRootNode;
+    WorldPartition mWorldPartition;
     glm::vec4 mAmbientLightColor;
     glm::vec4 mShadowColor;
     FogSettings mFogSettings;
@@ -194,7 +251,35 @@ private:
     btDbvtBroadphase* mBroadphase;
     btSequentialImpulseConstraintSolver* mSolver;
     btDiscreteDynamicsWorld* mDynamicsWorld;
-    std::vector<PrimitivePair> mCurrentOverlaps;
-    std::vector<PrimitivePair> mPreviousOverlaps;
+    struct CollisionLayerFilterCallback* mCollisionLayerFilter = nullptr;
+    CollisionLayers mCollisionLayers;
+    OverlapSet mOverlaps;
+    uint32_t mOverlapGeneration = 0;
+    float mPhysicsFixedTimeStep = 1.0f / 60.0f;
+    int32_t mPhysicsMaxSubsteps = 2;
+
+    uint32_t mPhysicsSubstepCount = 0;
+    uint32_t mCcdSweepCount = 0;
+    uint32_t mCcdHitCount = 0;
+
+    // Written by the physics step (possibly on the physics thread), only read after it is synced.
+    uint32_t mStepSubsteps = 0;
+    uint32_t mStepCcdSweeps = 0;
+    uint32_t mStepCcdHits = 0;
+    uint32_t mPrevCcdSweeps = 0;
+    bool mPhysicsAabbsStale = false;
+
+    // Pipelined physics. The worker thread is started on the first pipelined step and
+    // sleeps on mPhysicsStartSemaphore until the next step is kicked.
+    ThreadObject* mPhysicsThread = nullptr;
+    SemaphoreObject* mPhysicsStartSemaphore = nullptr;
+    SemaphoreObject* mPhysicsDoneSemaphore = nullptr;
+    bool mPhysicsStepInFlight = false;
+    bool mPhysicsThreadExit = false;
+    std::vector<PhysicsCommand> mPhysicsCommands;
+    std::vector<Primitive3D*> mTransformPushes;
+    std::vector<Primitive3D*> mRestoredPrimitives;
+    float mPhysicsDeltaTime = 0.0f;
+    bool mPipelinedPhysics = false;
 
 };
\ No newline at end of file
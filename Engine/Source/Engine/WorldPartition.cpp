@@ -0,0 +1,379 @@
+#include "WorldPartition.h"
+#include "Assertion.h"
+#include "Log.h"
+#include "Profiler.h"
+
+#include "Assets/Scene.h"
+#include "Nodes/Node.h"
+#include "Nodes/3D/Node3d.h"
+
+#include <algorithm>
+#include <float.h>
+
+glm::ivec2 GetPartitionCellCoord(glm::vec3 position, float cellSize)
+{
+    OCT_ASSERT(cellSize > 0.0f);
+    return glm::ivec2(int32_t(floorf(position.x / cellSize)), int32_t(floorf(position.z / cellSize)));
+}
+
+float GetPartitionCellDistance(int32_t x, int32_t z, float cellSize, glm::vec3 position)
+{
+    glm::vec2 cellMin = glm::vec2(float(x), float(z)) * cellSize;
+    glm::vec2 cellMax = cellMin + glm::vec2(cellSize, cellSize);
+    glm::vec2 point = glm::vec2(position.x, position.z);
+
+    return glm::length(point - glm::clamp(point, cellMin, cellMax));
+}
+
+WorldPartition::~WorldPartition()
+{
+    UnloadAllCells();
+}
+
+void WorldPartition::SetScene(Scene* scene)
+{
+    if (scene != nullptr &&
+        !scene->IsPartitioned())
+    {
+        scene = nullptr;
+    }
+
+    if (mScene.Get() == scene)
+        return;
+
+    // Pending loads point at the cells' SceneRefs, so they must be cancelled before the cells go away.
+    UnloadAllCells();
+    mCells.clear();
+    mScene = scene;
+
+    if (scene != nullptr)
+    {
+        mCellSize = scene->GetPartitionCellSize();
+        mLoadDistance = scene->GetPartitionLoadDistance();
+        mUnloadDistance = scene->GetPartitionUnloadDistance();
+
+        const std::vector<ScenePartitionCell>& sceneCells = scene->GetPartitionCells();
+        mCells.resize(sceneCells.size());
+
+        for (uint32_t i = 0; i < sceneCells.size(); ++i)
+        {
+            mCells[i].mSceneName = sceneCells[i].mSceneName;
+            mCells[i].mX = sceneCells[i].mX;
+            mCells[i].mZ = sceneCells[i].mZ;
+        }
+    }
+}
+
+Scene* WorldPartition::GetScene() const
+{
+    return mScene.Get<Scene>();
+}
+
+bool WorldPartition::IsActive() const
+{
+    return mScene != nullptr;
+}
+
+void WorldPartition::AddStreamingSource(Node3D* node)
+{
+    if (node == nullptr)
+        return;
+
+    for (uint32_t i = 0; i < mSources.size(); ++i)
+    {
+        if (mSources[i] == node)
+        {
+            return;
+        }
+    }
+
+    mSources.push_back(node);
+}
+
+void WorldPartition::RemoveStreamingSource(Node3D* node)
+{
+    for (uint32_t i = 0; i < mSources.size(); ++i)
+    {
+        if (mSources[i] == node)
+        {
+            mSources.erase(mSources.begin() + i);
+            break;
+        }
+    }
+}
+
+void WorldPartition::SetUseActiveCamera(bool useCamera)
+{
+    mUseActiveCamera = useCamera;
+}
+
+bool WorldPartition::GetUseActiveCamera() const
+{
+    return mUseActiveCamera;
+}
+
+void WorldPartition::SetMaxPendingLoads(uint32_t maxLoads)
+{
+    mMaxPendingLoads = glm::max(maxLoads, 1u);
+}
+
+uint32_t WorldPartition::GetMaxPendingLoads() const
+{
+    return mMaxPendingLoads;
+}
+
+void WorldPartition::SetMaxInstantiationsPerFrame(uint32_t maxInstantiations)
+{
+    mMaxInstantiations = glm::max(maxInstantiations, 1u);
+}
+
+uint32_t WorldPartition::GetMaxInstantiationsPerFrame() const
+{
+    return mMaxInstantiations;
+}
+
+void WorldPartition::SetMaxUnloadsPerFrame(uint32_t maxUnloads)
+{
+    mMaxUnloads = glm::max(maxUnloads, 1u);
+}
+
+uint32_t WorldPartition::GetMaxUnloadsPerFrame() const
+{
+    return mMaxUnloads;
+}
+
+void WorldPartition::Update(Node* rootNode, const glm::vec3* cameraPosition)
+{
+    if (!IsActive() ||
+        rootNode == nullptr)
+    {
+        return;
+    }
+
+    SCOPED_FRAME_STAT("World Partition");
+
+    mSourcePositions.clear();
+
+    if (mUseActiveCamera &&
+        cameraPosition != nullptr)
+    {
+        mSourcePositions.push_back(*cameraPosition);
+    }
+
+    for (int32_t i = int32_t(mSources.size()) - 1; i >= 0; --i)
+    {
+        Node3D* source = mSources[i].Get<Node3D>();
+
+        if (source == nullptr)
+        {
+            mSources.erase(mSources.begin() + i);
+        }
+        else
+        {
+            mSourcePositions.push_back(source->GetAbsolutePosition());
+        }
+    }
+
+    uint32_t numPending = 0;
+
+    for (uint32_t i = 0; i < mCells.size(); ++i)
+    {
+        PartitionCell& cell = mCells[i];
+
+        cell.mDistance = FLT_MAX;
+        for (uint32_t s = 0; s < mSourcePositions.size(); ++s)
+        {
+            float distance = GetPartitionCellDistance(cell.mX, cell.mZ, mCellSize, mSourcePositions[s]);
+            cell.mDistance = glm::min(cell.mDistance, distance);
+        }
+
+        if (cell.mState == PartitionCellState::Loading)
+        {
+            if (cell.mDistance > mUnloadDistance)
+            {
+                UnloadCell(cell);
+            }
+            else
+            {
+                // Closer cells finish first. Priorities are whole numbers, so this is per world unit.
+                AssetManager::Get()->SetAsyncLoadPriority(cell.mLoadHandle, -int32_t(glm::min(cell.mDistance, 1000000.0f)));
+                numPending++;
+            }
+        }
+        else if (cell.mState == PartitionCellState::Loaded &&
+            cell.mDistance > mUnloadDistance)
+        {
+            UnloadCell(cell);
+        }
+    }
+
+    // Every decision below goes nearest cell first (or farthest first for unloads).
+    mCellOrder.resize(mCells.size());
+    for (uint32_t i = 0; i < mCellOrder.size(); ++i)
+    {
+        mCellOrder[i] = i;
+    }
+
+    std::sort(mCellOrder.begin(), mCellOrder.end(), [this](uint32_t a, uint32_t b)
+    {
+        return (mCells[a].mDistance != mCells[b].mDistance) ? (mCells[a].mDistance < mCells[b].mDistance) : (a < b);
+    });
+
+    // Unload cells that every source has left behind.
+    uint32_t numUnloads = 0;
+    for (int32_t i = int32_t(mCellOrder.size()) - 1; i >= 0 && numUnloads < mMaxUnloads; --i)
+    {
+        PartitionCell& cell = mCells[mCellOrder[i]];
+
+        if (cell.mDistance <= mUnloadDistance)
+            break;
+
+        if (cell.mState == PartitionCellState::Instantiated)
+        {
+            UnloadCell(cell);
+            numUnloads++;
+        }
+    }
+
+    // Instantiate loaded cells in range. Instantiating a large cell is the expensive part,
+    // so only a few happen each frame.
+    uint32_t numInstantiations = 0;
+    for (uint32_t i = 0; i < mCellOrder.size() && numInstantiations < mMaxInstantiations; ++i)
+    {
+        PartitionCell& cell = mCells[mCellOrder[i]];
+
+        if (cell.mDistance > mLoadDistance)
+            break;
+
+        if (cell.mState != PartitionCellState::Loaded)
+            continue;
+
+        Scene* scene = cell.mScene.Get<Scene>();
+        Node* node = scene ? scene->Instantiate() : nullptr;
+
+        if (node == nullptr)
+        {
+            LogError("World partition failed to instantiate cell %s", cell.mSceneName.c_str());
+            cell.mScene = nullptr;
+            cell.mState = PartitionCellState::Failed;
+            continue;
+        }
+
+        // The cell belongs to the partition, it shouldn't be saved into the root scene.
+        node->SetTransient(true);
+        rootNode->AddChild(node);
+
+        cell.mNode = node;
+        cell.mState = PartitionCellState::Instantiated;
+        numInstantiations++;
+    }
+
+    // Request cells in range, keeping only a few loads in flight so the nearest cells
+    // aren't stuck behind ones that were requested earlier but are now farther away.
+    for (uint32_t i = 0; i < mCellOrder.size() && numPending < mMaxPendingLoads; ++i)
+    {
+        uint32_t index = mCellOrder[i];
+        PartitionCell& cell = mCells[index];
+
+        if (cell.mDistance > mLoadDistance)
+            break;
+
+        if (cell.mState != PartitionCellState::Unloaded)
+            continue;
+
+        cell.mState = PartitionCellState::Loading;
+
+        AsyncLoadHandle handle = AssetManager::Get()->AsyncLoadAsset(
+            cell.mSceneName,
+            &cell.mScene,
+            -int32_t(glm::min(cell.mDistance, 1000000.0f)),
+            OnCellLoaded,
+            &cell);
+
+        // The callback has already run if the scene was loaded.
+        if (cell.mState == PartitionCellState::Loading)
+        {
+            cell.mLoadHandle = handle;
+            numPending++;
+        }
+    }
+}
+
+uint32_t WorldPartition::GetNumCells() const
+{
+    return uint32_t(mCells.size());
+}
+
+uint32_t WorldPartition::GetNumCells(PartitionCellState state) const
+{
+    uint32_t count = 0;
+
+    for (uint32_t i = 0; i < mCells.size(); ++i)
+    {
+        if (mCells[i].mState == state)
+        {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+const PartitionCell& WorldPartition::GetCell(uint32_t index) const
+{
+    OCT_ASSERT(index < mCells.size());
+    return mCells[index];
+}
+
+void WorldPartition::OnCellLoaded(Asset* asset, void* userData)
+{
+    PartitionCell* cell = reinterpret_cast<PartitionCell*>(userData);
+    OCT_ASSERT(cell->mState == PartitionCellState::Loading);
+
+    cell->mLoadHandle = INVALID_ASYNC_LOAD_HANDLE;
+
+    if (asset != nullptr &&
+        asset->GetType() == Scene::GetStaticType())
+    {
+        cell->mScene = asset;
+        cell->mState = PartitionCellState::Loaded;
+    }
+    else
+    {
+        LogError("World partition failed to load cell %s", cell->mSceneName.c_str());
+        cell->mScene = nullptr;
+        cell->mState = PartitionCellState::Failed;
+    }
+}
+
+void WorldPartition::UnloadCell(PartitionCell& cell)
+{
+    if (cell.mLoadHandle != INVALID_ASYNC_LOAD_HANDLE)
+    {
+        AssetManager::Get()->CancelAsyncLoad(cell.mLoadHandle);
+        cell.mLoadHandle = INVALID_ASYNC_LOAD_HANDLE;
+    }
+
+    Node* node = cell.mNode.Get();
+    if (node != nullptr)
+    {
+        Node::Destruct(node);
+    }
+
+    // Once nothing else references the cell scene, it's freed by the next asset ref sweep.
+    cell.mNode = nullptr;
+    cell.mScene = nullptr;
+
+    if (cell.mState != PartitionCellState::Failed)
+    {
+        cell.mState = PartitionCellState::Unloaded;
+    }
+}
+
+void WorldPartition::UnloadAllCells()
+{
+    for (uint32_t i = 0; i < mCells.size(); ++i)
+    {
+        UnloadCell(mCells[i]);
+    }
+}
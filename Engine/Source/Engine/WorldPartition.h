@@ -0,0 +1,111 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "glm/glm.hpp"
+
+#include "AssetRef.h"
+#include "ObjectRef.h"
+#include "AssetManager.h"
+
+class Scene;
+class Node3D;
+
+// A partitioned Scene only holds the nodes that should always be loaded (lighting, the player
+// start, game managers...). The rest of the level is split by the editor into a grid of cell
+// Scenes on the XZ plane (see ActionManager::PartitionScene). When a partitioned Scene is the
+// world root, the WorldPartition loads the cells around its streaming sources asynchronously
+// and instantiates them under the root node. Cells are unloaded again once every source is
+// past the unload distance, which is kept larger than the load distance so cells on the edge
+// don't load and unload every frame.
+//
+// Streaming sources are the active camera plus any nodes added with AddStreamingSource().
+// A server should add the node each client controls so the world around remote players stays loaded.
+// Cell nodes are instantiated locally on every host, so replicated nodes belong in the root Scene.
+
+#define WORLD_PARTITION_DEFAULT_MAX_PENDING_LOADS 2
+#define WORLD_PARTITION_DEFAULT_MAX_INSTANTIATIONS 1
+#define WORLD_PARTITION_DEFAULT_MAX_UNLOADS 2
+
+enum class PartitionCellState : uint8_t
+{
+    Unloaded,
+    Loading,
+    Loaded,
+    Instantiated,
+    Failed,
+
+    Count
+};
+
+struct PartitionCell
+{
+    std::string mSceneName;
+    int32_t mX = 0;
+    int32_t mZ = 0;
+
+    SceneRef mScene;
+    NodeRef mNode;
+    AsyncLoadHandle mLoadHandle = INVALID_ASYNC_LOAD_HANDLE;
+    PartitionCellState mState = PartitionCellState::Unloaded;
+    float mDistance = 0.0f;
+};
+
+// Grid math shared with the editor. Cells cover [x * cellSize, (x + 1) * cellSize) on each axis.
+glm::ivec2 GetPartitionCellCoord(glm::vec3 position, float cellSize);
+
+// Distance on the XZ plane from position to the closest point of a cell, 0 if it's inside.
+float GetPartitionCellDistance(int32_t x, int32_t z, float cellSize, glm::vec3 position);
+
+class WorldPartition
+{
+public:
+
+    ~WorldPartition();
+
+    // Starts streaming the cells of a partitioned scene, or stops if scene is null or not partitioned.
+    void SetScene(Scene* scene);
+    Scene* GetScene() const;
+    bool IsActive() const;
+
+    void AddStreamingSource(Node3D* node);
+    void RemoveStreamingSource(Node3D* node);
+    void SetUseActiveCamera(bool useCamera);
+    bool GetUseActiveCamera() const;
+
+    void SetMaxPendingLoads(uint32_t maxLoads);
+    uint32_t GetMaxPendingLoads() const;
+    void SetMaxInstantiationsPerFrame(uint32_t maxInstantiations);
+    uint32_t GetMaxInstantiationsPerFrame() const;
+    void SetMaxUnloadsPerFrame(uint32_t maxUnloads);
+    uint32_t GetMaxUnloadsPerFrame() const;
+
+    // Called by the World once per frame while the game is ticking.
+    void Update(Node* rootNode, const glm::vec3* cameraPosition);
+
+    uint32_t GetNumCells() const;
+    uint32_t GetNumCells(PartitionCellState state) const;
+    const PartitionCell& GetCell(uint32_t index) const;
+
+protected:
+
+    static void OnCellLoaded(Asset* asset, void* userData);
+
+    void UnloadCell(PartitionCell& cell);
+    void UnloadAllCells();
+
+    SceneRef mScene;
+    std::vector<PartitionCell> mCells;
+    std::vector<NodeRef> mSources;
+    std::vector<glm::vec3> mSourcePositions;
+    std::vector<uint32_t> mCellOrder;
+
+    float mCellSize = 0.0f;
+    float mLoadDistance = 0.0f;
+    float mUnloadDistance = 0.0f;
+    uint32_t mMaxPendingLoads = WORLD_PARTITION_DEFAULT_MAX_PENDING_LOADS;
+    uint32_t mMaxInstantiations = WORLD_PARTITION_DEFAULT_MAX_INSTANTIATIONS;
+    uint32_t mMaxUnloads = WORLD_PARTITION_DEFAULT_MAX_UNLOADS;
+    bool mUseActiveCamera = true;
+};
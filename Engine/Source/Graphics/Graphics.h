@@ -72,6 +72,7 @@ void GFX_EndGpuTimestamp(const char* name);
 // Texture
 void GFX_CreateTextureResource(Texture* texture, std::vector<uint8_t>& data);
 void GFX_DestroyTextureResource(Texture* texture);
+void GFX_UpdateTextureResourceMips(Texture* texture, std::vector<uint8_t>& data);
 
 // Material
 void GFX_CreateMaterialResource(Material* material);
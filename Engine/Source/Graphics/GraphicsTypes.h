@@ -30,6 +30,9 @@ enum class PixelFormat
     RGBA8,
     CMPR,
     RGBA5551,
+    BC3,
+    BC5,
+    BC7,
 
     R8,
     R32U,
@@ -93,6 +93,16 @@ void DescriptorSet::Bind(VkCommandBuffer cb, uint32_t index, VkPipelineLayout pi
 {
     uint32_t frameIndex = GetFrameIndex();
 
+    if (mImageVersion[frameIndex] != Image::GetLatestVersion())
+    {
+        if (HasResizedImage(frameIndex))
+        {
+            mDirty[frameIndex] = true;
+        }
+
+        mImageVersion[frameIndex] = Image::GetLatestVersion();
+    }
+
     if (mDirty[frameIndex])
     {
         RefreshBindings(frameIndex);
@@ -129,6 +139,38 @@ void DescriptorSet::MarkDirty()
     }
 }
 
+bool DescriptorSet::HasResizedImage(uint32_t frameIndex) const
+{
+    uint32_t checkedVersion = mImageVersion[frameIndex];
+
+    for (uint32_t i = 0; i < MAX_DESCRIPTORS_PER_SET; ++i)
+    {
+        const DescriptorBinding& binding = mBindings[i];
+
+        if (binding.mType == DescriptorType::Image ||
+            binding.mType == DescriptorType::StorageImage)
+        {
+            const Image* image = reinterpret_cast<const Image*>(binding.mObject);
+            if (image != nullptr && image->GetVersion() > checkedVersion)
+            {
+                return true;
+            }
+        }
+        else if (binding.mType == DescriptorType::ImageArray)
+        {
+            for (uint32_t j = 0; j < binding.mImageArray.size(); ++j)
+            {
+                if (binding.mImageArray[j]->GetVersion() > checkedVersion)
+                {
+                    return true;
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
 void DescriptorSet::RefreshBindings(uint32_t frameIndex)
 {
     VkDevice device = GetVulkanDevice();
@@ -55,12 +55,17 @@ private:
     ~DescriptorSet();
 
     void MarkDirty();
+    bool HasResizedImage(uint32_t frameIndex) const;
     void RefreshBindings(uint32_t frameIndex);
 
     DescriptorBinding mBindings[MAX_DESCRIPTORS_PER_SET] = { };
 
     VkDescriptorSet mDescriptorSets[MAX_FRAMES] = { };
     bool mDirty[MAX_FRAMES] = { };
+
+    // Image::GetLatestVersion() when each frame's descriptor set was last checked, so bound
+    // images that were resized since then (see Image::Resize()) can be rewritten.
+    uint32_t mImageVersion[MAX_FRAMES] = { };
 };
 
 #endif // API_VULKAN
\ No newline at end of file
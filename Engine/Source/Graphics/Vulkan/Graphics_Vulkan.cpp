@@ -269,6 +269,11 @@ void GFX_DestroyTextureResource(Texture* texture)
     DestroyTextureResource(texture);
 }
 
+void GFX_UpdateTextureResourceMips(Texture* texture, std::vector<uint8_t>& data)
+{
+    UpdateTextureResourceMips(texture, data.data());
+}
+
 void GFX_CreateMaterialResource(Material* material)
 {
     CreateMaterialResource(material);
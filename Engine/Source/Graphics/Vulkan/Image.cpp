@@ -9,6 +9,8 @@
 // TODO: Remove the renderer include
 #include "Renderer.h"
 
+uint32_t Image::sLatestVersion = 0;
+
 Image::Image(ImageDesc imageDesc, SamplerDesc samplerDesc, const char* debugObjectName)
 {
     mWidth = imageDesc.mWidth;
@@ -32,6 +34,44 @@ Image::Image(ImageDesc imageDesc, SamplerDesc samplerDesc, const char* debugObje
     mMaxAnisotropy = samplerDesc.mMaxAnisotropy;
     mAnisotropyEnable = samplerDesc.mAnisotropyEnable;
 
+    CreateImage();
+
+    VkDevice device = GetVulkanDevice();
+
+    // Sampler
+    VkSamplerCreateInfo ciSampler = {};
+    ciSampler.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    ciSampler.magFilter = mMagFilter;
+    ciSampler.minFilter = mMinFilter;
+    ciSampler.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+    ciSampler.addressModeU = mAddressMode;
+    ciSampler.addressModeV = mAddressMode;
+    ciSampler.addressModeW = mAddressMode;
+    ciSampler.mipLodBias = 0.0f;
+    ciSampler.compareEnable = VK_FALSE;
+    ciSampler.compareOp = VK_COMPARE_OP_NEVER;
+    ciSampler.minLod = 0.0f;
+    ciSampler.maxLod = VK_LOD_CLAMP_NONE;
+    ciSampler.borderColor = mBorderColor;
+    ciSampler.maxAnisotropy = 1.0;
+    ciSampler.anisotropyEnable = VK_FALSE;
+
+    if (vkCreateSampler(device, &ciSampler, nullptr, &mSampler) != VK_SUCCESS)
+    {
+        LogError("Failed to create sampler");
+        OCT_ASSERT(0);
+    }
+
+    if (debugObjectName != nullptr)
+    {
+        SetDebugObjectName(VK_OBJECT_TYPE_IMAGE, (uint64_t)mImage, debugObjectName);
+        SetDebugObjectName(VK_OBJECT_TYPE_IMAGE_VIEW, (uint64_t)mImageView, debugObjectName);
+        SetDebugObjectName(VK_OBJECT_TYPE_SAMPLER, (uint64_t)mSampler, debugObjectName);
+    }
+}
+
+void Image::CreateImage()
+{
     VkDevice device = GetVulkanDevice();
 
     VkImageAspectFlags aspectFlags = GetFormatImageAspect(mFormat);
@@ -90,37 +130,6 @@ Image::Image(ImageDesc imageDesc, SamplerDesc samplerDesc, const char* debugObje
         LogError("Failed to create image view");
         OCT_ASSERT(0);
     }
-
-    // Sampler
-    VkSamplerCreateInfo ciSampler = {};
-    ciSampler.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
-    ciSampler.magFilter = mMagFilter;
-    ciSampler.minFilter = mMinFilter;
-    ciSampler.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
-    ciSampler.addressModeU = mAddressMode;
-    ciSampler.addressModeV = mAddressMode;
-    ciSampler.addressModeW = mAddressMode;
-    ciSampler.mipLodBias = 0.0f;
-    ciSampler.compareEnable = VK_FALSE;
-    ciSampler.compareOp = VK_COMPARE_OP_NEVER;
-    ciSampler.minLod = 0.0f;
-    ciSampler.maxLod = VK_LOD_CLAMP_NONE;
-    ciSampler.borderColor = mBorderColor;
-    ciSampler.maxAnisotropy = 1.0;
-    ciSampler.anisotropyEnable = VK_FALSE;
-
-    if (vkCreateSampler(device, &ciSampler, nullptr, &mSampler) != VK_SUCCESS)
-    {
-        LogError("Failed to create sampler");
-        OCT_ASSERT(0);
-    }
-
-    if (debugObjectName != nullptr)
-    {
-        SetDebugObjectName(VK_OBJECT_TYPE_IMAGE, (uint64_t)mImage, debugObjectName);
-        SetDebugObjectName(VK_OBJECT_TYPE_IMAGE_VIEW, (uint64_t)mImageView, debugObjectName);
-        SetDebugObjectName(VK_OBJECT_TYPE_SAMPLER, (uint64_t)mSampler, debugObjectName);
-    }
 }
 
 Image::~Image()
@@ -169,22 +178,173 @@ uint32_t Image::GetHeight() const
     return mHeight;
 }
 
-void Image::Update(const void* srcData)
+uint32_t Image::GetMipLevels() const
+{
+    return mMipLevels;
+}
+
+uint32_t Image::GetVersion() const
+{
+    return mVersion;
+}
+
+uint32_t Image::GetLatestVersion()
+{
+    return sLatestVersion;
+}
+
+void Image::Resize(uint32_t width, uint32_t height, uint32_t mipLevels)
+{
+    OCT_ASSERT(width > 0);
+    OCT_ASSERT(height > 0);
+    OCT_ASSERT(mipLevels > 0);
+
+    // The copy takes ownership of the old image, view and memory. The sampler stays with us.
+    Image* oldImage = new Image(*this);
+    oldImage->mSampler = VK_NULL_HANDLE;
+    GetDestroyQueue()->Destroy(oldImage);
+
+    mWidth = width;
+    mHeight = height;
+    mMipLevels = mipLevels;
+    mLayout = VK_IMAGE_LAYOUT_PREINITIALIZED;
+    mImage = VK_NULL_HANDLE;
+    mImageView = VK_NULL_HANDLE;
+
+    CreateImage();
+
+    mVersion = ++sLatestVersion;
+}
+
+void Image::ResizeMips(uint32_t width, uint32_t height, uint32_t mipLevels, int32_t mipShift)
+{
+    OCT_ASSERT(mLayers == 1);
+
+    // Keep the old image alive until the copy below has been submitted, Resize() hands it to the destroy queue.
+    VkImage oldImage = mImage;
+    VkImageLayout oldLayout = mLayout;
+    uint32_t oldMipLevels = mMipLevels;
+
+    Resize(width, height, mipLevels);
+
+    int32_t firstLevel = glm::max(0, -mipShift);
+    int32_t endLevel = glm::min(int32_t(mMipLevels), int32_t(oldMipLevels) - mipShift);
+
+    std::vector<VkImageCopy> regions;
+
+    for (int32_t i = firstLevel; i < endLevel; ++i)
+    {
+        VkImageCopy region = {};
+        region.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.srcSubresource.mipLevel = uint32_t(i + mipShift);
+        region.srcSubresource.layerCount = 1;
+        region.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.dstSubresource.mipLevel = uint32_t(i);
+        region.dstSubresource.layerCount = 1;
+        region.extent = { glm::max(mWidth >> i, 1u), glm::max(mHeight >> i, 1u), 1 };
+        regions.push_back(region);
+    }
+
+    VkCommandBuffer commandBuffer = BeginCommandBuffer();
+
+    VkImageMemoryBarrier barriers[2] = {};
+
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        barriers[i].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barriers[i].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barriers[i].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barriers[i].subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barriers[i].subresourceRange.layerCount = 1;
+    }
+
+    // Old image to transfer source. Nothing samples it after this, it only waits to be destroyed.
+    barriers[0].image = oldImage;
+    barriers[0].subresourceRange.levelCount = oldMipLevels;
+    barriers[0].oldLayout = oldLayout;
+    barriers[0].newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    barriers[0].srcAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+    barriers[0].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+    barriers[1].image = mImage;
+    barriers[1].subresourceRange.levelCount = mMipLevels;
+    barriers[1].oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barriers[1].newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barriers[1].srcAccessMask = 0;
+    barriers[1].dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+    vkCmdPipelineBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+        0, nullptr,
+        0, nullptr,
+        2, barriers);
+
+    if (regions.size() > 0)
+    {
+        vkCmdCopyImage(
+            commandBuffer,
+            oldImage,
+            VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            mImage,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            uint32_t(regions.size()),
+            regions.data());
+    }
+
+    barriers[1].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barriers[1].newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    barriers[1].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barriers[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+    vkCmdPipelineBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
+        0, nullptr,
+        0, nullptr,
+        1, &barriers[1]);
+
+    EndCommandBuffer(commandBuffer);
+
+    mLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+}
+
+void Image::Update(const void* srcData, uint32_t numMips)
 {
     OCT_ASSERT(srcData != nullptr);
     OCT_ASSERT(mImage != VK_NULL_HANDLE);
+    OCT_ASSERT(numMips > 0 && numMips <= mMipLevels);
 
+    std::vector<VkBufferImageCopy> regions;
     uint32_t imageSize = 0;
-    if (IsFormatBlockCompressed(mFormat))
-    {
-        const uint32_t blockSize = 4;
-        uint32_t blockWidth = (mWidth + blockSize - 1) / blockSize;
-        uint32_t blockHeight = (mHeight + blockSize - 1) / blockSize;
-        imageSize = GetFormatBlockSize(mFormat) * blockWidth * blockHeight;
-    }
-    else
+
+    for (uint32_t i = 0; i < numMips; ++i)
     {
-        imageSize = GetFormatPixelSize(mFormat) * mWidth * mHeight;
+        uint32_t mipWidth = glm::max(mWidth >> i, 1u);
+        uint32_t mipHeight = glm::max(mHeight >> i, 1u);
+        uint32_t mipSize = 0;
+
+        if (IsFormatBlockCompressed(mFormat))
+        {
+            const uint32_t blockSize = 4;
+            uint32_t blockWidth = (mipWidth + blockSize - 1) / blockSize;
+            uint32_t blockHeight = (mipHeight + blockSize - 1) / blockSize;
+            mipSize = GetFormatBlockSize(mFormat) * blockWidth * blockHeight;
+        }
+        else
+        {
+            mipSize = GetFormatPixelSize(mFormat) * mipWidth * mipHeight;
+        }
+
+        VkBufferImageCopy region = {};
+        region.bufferOffset = imageSize;
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = i;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount = 1;
+        region.imageOffset = { 0, 0, 0 };
+        region.imageExtent = { mipWidth, mipHeight, 1 };
+        regions.push_back(region);
+
+        imageSize += mipSize;
     }
 
     if (imageSize == 0)
@@ -199,7 +359,17 @@ void Image::Update(const void* srcData)
 
         VkImageLayout savedLayout = mLayout;
         Transition(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-        CopyBufferToImage(stagingBuffer->Get(), mImage, mWidth, mHeight);
+
+        VkCommandBuffer commandBuffer = BeginCommandBuffer();
+        vkCmdCopyBufferToImage(
+            commandBuffer,
+            stagingBuffer->Get(),
+            mImage,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            uint32_t(regions.size()),
+            regions.data());
+        EndCommandBuffer(commandBuffer);
+
         Transition(savedLayout != VK_IMAGE_LAYOUT_PREINITIALIZED ? savedLayout : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 
         GetDestroyQueue()->Destroy(stagingBuffer);
@@ -41,8 +41,23 @@ public:
     VkFormat GetFormat() const;
     uint32_t GetWidth() const;
     uint32_t GetHeight() const;
+    uint32_t GetMipLevels() const;
 
-    void Update(const void* srcData);
+    // srcData holds numMips levels back to back, starting with the base level.
+    void Update(const void* srcData, uint32_t numMips = 1);
+
+    // Replaces the image memory with a new, empty image of a different size. The old image is
+    // handed to the destroy queue, so frames in flight can keep sampling it. Descriptor sets
+    // that reference this Image pick up the new view the next time they are bound.
+    void Resize(uint32_t width, uint32_t height, uint32_t mipLevels);
+
+    // Like Resize(), but the mips both images share are copied over on the GPU, so only new
+    // mips need to be uploaded. Level i of the new image is level i + mipShift of the old one.
+    void ResizeMips(uint32_t width, uint32_t height, uint32_t mipLevels, int32_t mipShift);
+
+    // Incremented whenever the underlying VkImage/VkImageView are recreated.
+    uint32_t GetVersion() const;
+    static uint32_t GetLatestVersion();
 
     void Transition(VkImageLayout layout, VkCommandBuffer commandBuffer = VK_NULL_HANDLE);
     void GenerateMips();
@@ -53,6 +68,8 @@ private:
     friend class DestroyQueue;
     ~Image();
 
+    void CreateImage();
+
     VkImage mImage = VK_NULL_HANDLE;
     VkImageView mImageView = VK_NULL_HANDLE;
     VkSampler mSampler = VK_NULL_HANDLE;
@@ -73,6 +90,9 @@ private:
     bool mAnisotropyEnable = false;
 
     VkImageLayout mLayout = VK_IMAGE_LAYOUT_PREINITIALIZED;
+
+    uint32_t mVersion = 0;
+    static uint32_t sLatestVersion;
 };
 
 #endif
\ No newline at end of file
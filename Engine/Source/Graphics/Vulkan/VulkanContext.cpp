@@ -1110,6 +1110,7 @@ void VulkanContext::PickPhysicalDevice()
     vkGetPhysicalDeviceFeatures(mPhysicalDevice, &deviceFeatures);
     mFeatureWideLines = deviceFeatures.wideLines;
     mFeatureFillModeNonSolid = deviceFeatures.fillModeNonSolid;
+    mFeatureTextureCompressionBC = deviceFeatures.textureCompressionBC;
 
     {
         bool formatFound = false;
@@ -1197,6 +1198,7 @@ void VulkanContext::CreateLogicalDevice()
     VkPhysicalDeviceFeatures deviceFeatures = {};
     deviceFeatures.fillModeNonSolid = mFeatureFillModeNonSolid;
     deviceFeatures.wideLines = mFeatureWideLines;
+    deviceFeatures.textureCompressionBC = mFeatureTextureCompressionBC;
 
     VkDeviceCreateInfo ciDevice = {};
     ciDevice.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
@@ -1929,6 +1931,11 @@ bool VulkanContext::HasFeatureFillModeNonSolid() const
     return mFeatureFillModeNonSolid;
 }
 
+bool VulkanContext::HasFeatureTextureCompressionBC() const
+{
+    return mFeatureTextureCompressionBC;
+}
+
 bool VulkanContext::AreMaterialsEnabled() const
 {
     return mEnableMaterials;
@@ -123,6 +123,7 @@ public:
     bool IsRayTracingSupported() const;
     bool HasFeatureWideLines() const;
     bool HasFeatureFillModeNonSolid() const;
+    bool HasFeatureTextureCompressionBC() const;
 
     bool AreMaterialsEnabled() const;
     void EnableMaterials(bool enable);
@@ -298,6 +299,7 @@ private:
     bool mEnableMaterialPipelineCache = false;
     bool mFeatureWideLines = false;
     bool mFeatureFillModeNonSolid = false;
+    bool mFeatureTextureCompressionBC = false;
     EngineState* mEngineState = nullptr;
     Pipeline* mCurrentlyBoundPipeline = nullptr;
     VkSurfaceTransformFlagBitsKHR mPreTransformFlag = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
@@ -46,6 +46,9 @@ VkFormat ConvertPixelFormat(PixelFormat pixelFormat)
 #else
     case PixelFormat::CMPR: format = VK_FORMAT_BC1_RGBA_UNORM_BLOCK; break;
 #endif
+    case PixelFormat::BC3: format = VK_FORMAT_BC3_UNORM_BLOCK; break;
+    case PixelFormat::BC5: format = VK_FORMAT_BC5_UNORM_BLOCK; break;
+    case PixelFormat::BC7: format = VK_FORMAT_BC7_UNORM_BLOCK; break;
 
     case PixelFormat::R8: format = VK_FORMAT_R8_UNORM; break;
     case PixelFormat::R32U: format = VK_FORMAT_R32_UINT; break;
@@ -418,6 +421,9 @@ uint32_t GetFormatBlockSize(VkFormat format)
     switch (format)
     {
     case VK_FORMAT_BC1_RGBA_UNORM_BLOCK: size = 8; break;
+    case VK_FORMAT_BC3_UNORM_BLOCK: size = 16; break;
+    case VK_FORMAT_BC5_UNORM_BLOCK: size = 16; break;
+    case VK_FORMAT_BC7_UNORM_BLOCK: size = 16; break;
     case VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK: size = 8; break;
     default: break;
     }
@@ -433,12 +439,13 @@ uint32_t GetFormatBlockSize(VkFormat format)
 
 bool IsFormatBlockCompressed(VkFormat format)
 {
-    // Will probably only support BC1 and ETC2 formats.
-    // Trying to keep things simple for now.
-    // Desktop -> BC1
+    // Desktop -> BC1, BC3, BC5, BC7
     // Android -> ETC2
     bool isCompressed =
         format == VK_FORMAT_BC1_RGBA_UNORM_BLOCK ||
+        format == VK_FORMAT_BC3_UNORM_BLOCK ||
+        format == VK_FORMAT_BC5_UNORM_BLOCK ||
+        format == VK_FORMAT_BC7_UNORM_BLOCK ||
         format == VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK;
 
     return isCompressed;
@@ -1011,19 +1018,69 @@ void FullPipelineBarrier()
 }
 #endif
 
+// Returns the data for the texture's resident mips, or nullptr if there is none. Cooked BCn data
+// is decoded to RGBA8 into decodedPixels on devices that can't sample it.
+static uint8_t* GetResidentTextureData(Texture* texture, uint8_t* pixels, std::vector<uint8_t>& decodedPixels, PixelFormat& outFormat)
+{
+    PixelFormat dataFormat = texture->GetDataFormat();
+    uint32_t dataMipLevels = texture->GetDataMipLevels();
+    uint32_t firstMip = texture->GetResidentMip();
+
+    outFormat = dataFormat;
+
+    if (pixels == nullptr)
+    {
+        return nullptr;
+    }
+
+    for (uint32_t i = 0; i < firstMip; ++i)
+    {
+        pixels += GetTextureDataSize(dataFormat, GetMipDimension(texture->GetWidth(), i), GetMipDimension(texture->GetHeight(), i));
+    }
+
+    if (IsBlockCompressedFormat(dataFormat) &&
+        !GetVulkanContext()->HasFeatureTextureCompressionBC())
+    {
+        decodedPixels.clear();
+
+        const uint8_t* src = pixels;
+        for (uint32_t i = firstMip; i < dataMipLevels; ++i)
+        {
+            uint32_t mipWidth = GetMipDimension(texture->GetWidth(), i);
+            uint32_t mipHeight = GetMipDimension(texture->GetHeight(), i);
+            DecodeTexture(dataFormat, src, mipWidth, mipHeight, decodedPixels);
+            src += GetTextureDataSize(dataFormat, mipWidth, mipHeight);
+        }
+
+        pixels = decodedPixels.data();
+        outFormat = PixelFormat::RGBA8;
+    }
+
+    return pixels;
+}
+
 void CreateTextureResource(Texture* texture, uint8_t* pixels)
 {
     TextureResource* resource = texture->GetResource();
 
-    // TODO: Handle other pixel formats
-    VkFormat format = ConvertPixelFormat(PixelFormat::RGBA8 /*texture->GetFormat()*/);
+    uint32_t firstMip = texture->GetResidentMip();
+    uint32_t dataMipLevels = texture->GetDataMipLevels() - firstMip;
+
+    PixelFormat dataFormat = PixelFormat::RGBA8;
+    std::vector<uint8_t> decodedPixels;
+    pixels = GetResidentTextureData(texture, pixels, decodedPixels, dataFormat);
+
+    VkFormat format = ConvertPixelFormat(dataFormat);
+
+    // Compressed images can't be blitted, so they only get the mips that were cooked.
+    bool generateMips = texture->IsMipmapped() && !IsFormatBlockCompressed(format);
 
     ImageDesc imageDesc;
-    imageDesc.mWidth = texture->GetWidth();
-    imageDesc.mHeight = texture->GetHeight();
+    imageDesc.mWidth = GetMipDimension(texture->GetWidth(), firstMip);
+    imageDesc.mHeight = GetMipDimension(texture->GetHeight(), firstMip);
     imageDesc.mFormat = format;
     imageDesc.mUsage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
-    imageDesc.mMipLevels = texture->GetMipLevels();
+    imageDesc.mMipLevels = generateMips ? (texture->GetMipLevels() - firstMip) : dataMipLevels;
     imageDesc.mLayers = texture->GetLayers();
 
     SamplerDesc samplerDesc;
@@ -1062,19 +1119,64 @@ void CreateTextureResource(Texture* texture, uint8_t* pixels)
 
     if (pixels != nullptr)
     {
-        resource->mImage->Update(pixels);
+        resource->mImage->Update(pixels, dataMipLevels);
     }
     else
     {
         resource->mImage->Clear(glm::vec4(0.0f, 0.0f, 0.0f, 0.0f));
     }
 
-    if (texture->IsMipmapped())
+    if (generateMips &&
+        dataMipLevels < imageDesc.mMipLevels)
     {
         resource->mImage->GenerateMips();
     }
 }
 
+void UpdateTextureResourceMips(Texture* texture, uint8_t* pixels)
+{
+    // Only streamed textures change their resident mips, and those always carry their whole cooked chain.
+    TextureResource* resource = texture->GetResource();
+    OCT_ASSERT(resource->mImage != nullptr);
+    OCT_ASSERT(texture->GetDataMipLevels() == texture->GetMipLevels());
+
+    uint32_t firstMip = texture->GetResidentMip();
+    uint32_t numMips = texture->GetMipLevels() - firstMip;
+    uint32_t oldFirstMip = texture->GetMipLevels() - resource->mImage->GetMipLevels();
+    int32_t mipShift = int32_t(firstMip) - int32_t(oldFirstMip);
+
+    if (mipShift == 0)
+    {
+        return;
+    }
+
+    PixelFormat dataFormat = PixelFormat::RGBA8;
+    std::vector<uint8_t> decodedPixels;
+
+    if (mipShift < 0)
+    {
+        pixels = GetResidentTextureData(texture, pixels, decodedPixels, dataFormat);
+
+        if (pixels == nullptr)
+        {
+            LogError("Texture %s has no mip data to stream", texture->GetName().c_str());
+            return;
+        }
+    }
+
+    // Mips that were already resident are copied on the GPU, only the new finer ones are uploaded.
+    resource->mImage->ResizeMips(
+        GetMipDimension(texture->GetWidth(), firstMip),
+        GetMipDimension(texture->GetHeight(), firstMip),
+        numMips,
+        mipShift);
+
+    if (mipShift < 0)
+    {
+        resource->mImage->Update(pixels, uint32_t(-mipShift));
+    }
+}
+
 void DestroyTextureResource(Texture* texture)
 {
     TextureResource* resource = texture->GetResource();
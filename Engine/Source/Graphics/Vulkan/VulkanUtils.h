@@ -94,6 +94,7 @@ void FullPipelineBarrier();
 // Texture
 void CreateTextureResource(Texture* texture, uint8_t* pixels);
 void DestroyTextureResource(Texture* texture);
+void UpdateTextureResourceMips(Texture* texture, uint8_t* pixels);
 
 // Material
 void CreateMaterialResource(Material* material);
@@ -3,7 +3,10 @@
 
 int AssetManager_Lua::RefSweep(lua_State* L)
 {
-    AssetManager::Get()->RefSweep();
+    bool flushCache = false;
+    if (!lua_isnone(L, 1)) { flushCache = CHECK_BOOLEAN(L, 1); }
+
+    AssetManager::Get()->RefSweep(flushCache);
     return 0;
 }
 
@@ -30,6 +33,10 @@ int AssetManager_Lua::LoadAsset(lua_State* L)
 int AssetManager_Lua::AsyncLoadAsset(lua_State* L)
 {
     const char* name = CHECK_STRING(L, 1);
+    int32_t priority = 0;
+    ScriptFunc callback;
+    if (!lua_isnone(L, 2)) { priority = CHECK_INTEGER(L, 2); }
+    if (!lua_isnone(L, 3)) { CHECK_FUNCTION(L, 3); callback = ScriptFunc(L, 3); }
 
     // Create an Asset_Lua object with a null mAsset member.
     // The async load functionality will fill in the null member after the load as finished.
@@ -37,9 +44,40 @@ int AssetManager_Lua::AsyncLoadAsset(lua_State* L)
     Asset_Lua::Create(L, nullptr, true);
     Asset_Lua* assetLua = (Asset_Lua*) lua_touserdata(L, -1);
 
-    AssetManager::Get()->AsyncLoadAsset(name, &assetLua->mAsset);
+    // The handle can be used to change the priority or cancel the load.
+    AsyncLoadHandle handle = AssetManager::Get()->AsyncLoadAsset(name, &assetLua->mAsset, priority, callback);
+    lua_pushinteger(L, (lua_Integer) handle);
+
+    // The newly created Asset_Lua userdata and the handle should be on top of the stack.
+    return 2;
+}
+
+int AssetManager_Lua::SetAsyncLoadPriority(lua_State* L)
+{
+    AsyncLoadHandle handle = (AsyncLoadHandle) CHECK_INTEGER(L, 1);
+    int32_t priority = CHECK_INTEGER(L, 2);
+
+    AssetManager::Get()->SetAsyncLoadPriority(handle, priority);
+
+    return 0;
+}
+
+int AssetManager_Lua::CancelAsyncLoad(lua_State* L)
+{
+    AsyncLoadHandle handle = (AsyncLoadHandle) CHECK_INTEGER(L, 1);
+
+    AssetManager::Get()->CancelAsyncLoad(handle);
+
+    return 0;
+}
 
-    // The newly created Asset_Lua userdata should be on top of the stack.
+int AssetManager_Lua::IsAsyncLoadPending(lua_State* L)
+{
+    AsyncLoadHandle handle = (AsyncLoadHandle) CHECK_INTEGER(L, 1);
+
+    bool ret = AssetManager::Get()->IsAsyncLoadPending(handle);
+
+    lua_pushboolean(L, ret);
     return 1;
 }
 
@@ -52,6 +90,34 @@ int AssetManager_Lua::UnloadAsset(lua_State* L)
     return 0;
 }
 
+int AssetManager_Lua::SetMemoryBudget(lua_State* L)
+{
+    // Budgets are given in megabytes.
+    float cpuMegabytes = CHECK_NUMBER(L, 1);
+    float gpuMegabytes = CHECK_NUMBER(L, 2);
+
+    AssetManager::Get()->SetMemoryBudget(
+        uint64_t(glm::max(cpuMegabytes, 0.0f) * 1024.0f * 1024.0f),
+        uint64_t(glm::max(gpuMegabytes, 0.0f) * 1024.0f * 1024.0f));
+
+    return 0;
+}
+
+int AssetManager_Lua::GetMemoryUsage(lua_State* L)
+{
+    const float kMB = 1024.0f * 1024.0f;
+
+    lua_pushnumber(L, AssetManager::Get()->GetCpuMemoryUsage() / kMB);
+    lua_pushnumber(L, AssetManager::Get()->GetGpuMemoryUsage() / kMB);
+    return 2;
+}
+
+int AssetManager_Lua::LogMemoryStats(lua_State* L)
+{
+    AssetManager::Get()->LogMemoryStats();
+    return 0;
+}
+
 
 void AssetManager_Lua::Bind()
 {
@@ -69,8 +135,20 @@ void AssetManager_Lua::Bind()
 
     REGISTER_TABLE_FUNC(L, tableIdx, AsyncLoadAsset);
 
+    REGISTER_TABLE_FUNC(L, tableIdx, SetAsyncLoadPriority);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, CancelAsyncLoad);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, IsAsyncLoadPending);
+
     REGISTER_TABLE_FUNC(L, tableIdx, UnloadAsset);
 
+    REGISTER_TABLE_FUNC(L, tableIdx, SetMemoryBudget);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, GetMemoryUsage);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, LogMemoryStats);
+
     lua_setglobal(L, ASSET_MANAGER_LUA_NAME);
     OCT_ASSERT(lua_gettop(L) == 0);
 
@@ -94,6 +172,9 @@ void AssetManager_Lua::BindGlobalFunctions()
     lua_pushcfunction(L, AsyncLoadAsset);
     lua_setglobal(L, "AsyncLoadAsset");
 
+    lua_pushcfunction(L, CancelAsyncLoad);
+    lua_setglobal(L, "CancelAsyncLoad");
+
     lua_pushcfunction(L, UnloadAsset);
     lua_setglobal(L, "UnloadAsset");
 
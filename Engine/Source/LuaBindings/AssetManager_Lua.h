@@ -12,7 +12,13 @@ struct AssetManager_Lua
     static int GetAsset(lua_State* L);
     static int LoadAsset(lua_State* L);
     static int AsyncLoadAsset(lua_State* L);
+    static int SetAsyncLoadPriority(lua_State* L);
+    static int CancelAsyncLoad(lua_State* L);
+    static int IsAsyncLoadPending(lua_State* L);
     static int UnloadAsset(lua_State* L);
+    static int SetMemoryBudget(lua_State* L);
+    static int GetMemoryUsage(lua_State* L);
+    static int LogMemoryStats(lua_State* L);
 
     static void Bind();
     static void BindGlobalFunctions();
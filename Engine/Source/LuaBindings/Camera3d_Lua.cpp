@@ -203,8 +203,8 @@ int Camera3D_Lua::TraceScreenToWorld(lua_State* L)
     Camera3D* comp = CHECK_CAMERA_3D(L, 1);
     int32_t x = CHECK_INTEGER(L, 2);
     int32_t y = CHECK_INTEGER(L, 3);
-    uint8_t colMask = 0xff;
-    if (!lua_isnone(L, 4)) { colMask = (uint8_t)CHECK_INTEGER(L, 4); }
+    uint32_t colMask = ColGroupAll;
+    if (!lua_isnone(L, 4)) { colMask = (uint32_t)CHECK_INTEGER(L, 4); }
 
     Primitive3D* hitComp = nullptr;
     glm::vec3 worldPos = comp->TraceScreenToWorld(x, y, colMask, &hitComp);
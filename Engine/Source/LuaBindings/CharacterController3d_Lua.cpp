@@ -0,0 +1,155 @@
+#include "LuaBindings/CharacterController3d_Lua.h"
+#include "LuaBindings/Capsule3d_Lua.h"
+#include "LuaBindings/Vector_Lua.h"
+#include "LuaBindings/LuaUtils.h"
+
+#if LUA_ENABLED
+
+int CharacterController3D_Lua::Move(lua_State* L)
+{
+    CharacterController3D* comp = CHECK_CHARACTER_CONTROLLER_3D(L, 1);
+    glm::vec3 displacement = CHECK_VECTOR(L, 2);
+
+    glm::vec3 ret = comp->Move(displacement);
+
+    Vector_Lua::Create(L, ret);
+    return 1;
+}
+
+int CharacterController3D_Lua::IsGrounded(lua_State* L)
+{
+    CharacterController3D* comp = CHECK_CHARACTER_CONTROLLER_3D(L, 1);
+
+    bool ret = comp->IsGrounded();
+
+    lua_pushboolean(L, ret);
+    return 1;
+}
+
+int CharacterController3D_Lua::GetGroundNormal(lua_State* L)
+{
+    CharacterController3D* comp = CHECK_CHARACTER_CONTROLLER_3D(L, 1);
+
+    glm::vec3 ret = comp->GetGroundNormal();
+
+    Vector_Lua::Create(L, ret);
+    return 1;
+}
+
+int CharacterController3D_Lua::GetMaxSlopeAngle(lua_State* L)
+{
+    CharacterController3D* comp = CHECK_CHARACTER_CONTROLLER_3D(L, 1);
+
+    float ret = comp->GetMaxSlopeAngle();
+
+    lua_pushnumber(L, ret);
+    return 1;
+}
+
+int CharacterController3D_Lua::SetMaxSlopeAngle(lua_State* L)
+{
+    CharacterController3D* comp = CHECK_CHARACTER_CONTROLLER_3D(L, 1);
+    float value = CHECK_NUMBER(L, 2);
+
+    comp->SetMaxSlopeAngle(value);
+
+    return 0;
+}
+
+int CharacterController3D_Lua::GetStepHeight(lua_State* L)
+{
+    CharacterController3D* comp = CHECK_CHARACTER_CONTROLLER_3D(L, 1);
+
+    float ret = comp->GetStepHeight();
+
+    lua_pushnumber(L, ret);
+    return 1;
+}
+
+int CharacterController3D_Lua::SetStepHeight(lua_State* L)
+{
+    CharacterController3D* comp = CHECK_CHARACTER_CONTROLLER_3D(L, 1);
+    float value = CHECK_NUMBER(L, 2);
+
+    comp->SetStepHeight(value);
+
+    return 0;
+}
+
+int CharacterController3D_Lua::GetSnapDistance(lua_State* L)
+{
+    CharacterController3D* comp = CHECK_CHARACTER_CONTROLLER_3D(L, 1);
+
+    float ret = comp->GetSnapDistance();
+
+    lua_pushnumber(L, ret);
+    return 1;
+}
+
+int CharacterController3D_Lua::SetSnapDistance(lua_State* L)
+{
+    CharacterController3D* comp = CHECK_CHARACTER_CONTROLLER_3D(L, 1);
+    float value = CHECK_NUMBER(L, 2);
+
+    comp->SetSnapDistance(value);
+
+    return 0;
+}
+
+int CharacterController3D_Lua::GetRidePlatforms(lua_State* L)
+{
+    CharacterController3D* comp = CHECK_CHARACTER_CONTROLLER_3D(L, 1);
+
+    bool ret = comp->GetRidePlatforms();
+
+    lua_pushboolean(L, ret);
+    return 1;
+}
+
+int CharacterController3D_Lua::SetRidePlatforms(lua_State* L)
+{
+    CharacterController3D* comp = CHECK_CHARACTER_CONTROLLER_3D(L, 1);
+    bool value = CHECK_BOOLEAN(L, 2);
+
+    comp->SetRidePlatforms(value);
+
+    return 0;
+}
+
+void CharacterController3D_Lua::Bind()
+{
+    lua_State* L = GetLua();
+    int mtIndex = CreateClassMetatable(
+        CHARACTER_CONTROLLER_3D_LUA_NAME,
+        CHARACTER_CONTROLLER_3D_LUA_FLAG,
+        CAPSULE_3D_LUA_NAME);
+
+    Node_Lua::BindCommon(L, mtIndex);
+
+    REGISTER_TABLE_FUNC(L, mtIndex, Move);
+
+    REGISTER_TABLE_FUNC(L, mtIndex, IsGrounded);
+
+    REGISTER_TABLE_FUNC(L, mtIndex, GetGroundNormal);
+
+    REGISTER_TABLE_FUNC(L, mtIndex, GetMaxSlopeAngle);
+
+    REGISTER_TABLE_FUNC(L, mtIndex, SetMaxSlopeAngle);
+
+    REGISTER_TABLE_FUNC(L, mtIndex, GetStepHeight);
+
+    REGISTER_TABLE_FUNC(L, mtIndex, SetStepHeight);
+
+    REGISTER_TABLE_FUNC(L, mtIndex, GetSnapDistance);
+
+    REGISTER_TABLE_FUNC(L, mtIndex, SetSnapDistance);
+
+    REGISTER_TABLE_FUNC(L, mtIndex, GetRidePlatforms);
+
+    REGISTER_TABLE_FUNC(L, mtIndex, SetRidePlatforms);
+
+    lua_pop(L, 1);
+    OCT_ASSERT(lua_gettop(L) == 0);
+}
+
+#endif
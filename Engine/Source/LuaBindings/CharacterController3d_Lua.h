@@ -0,0 +1,35 @@
+#pragma once
+
+#include "EngineTypes.h"
+#include "Log.h"
+#include "Engine.h"
+
+#include "Nodes/3D/CharacterController3d.h"
+
+#include "LuaBindings/Node_Lua.h"
+#include "LuaBindings/LuaUtils.h"
+
+#if LUA_ENABLED
+
+#define CHARACTER_CONTROLLER_3D_LUA_NAME "CharacterController3D"
+#define CHARACTER_CONTROLLER_3D_LUA_FLAG "cfCharacterController3D"
+#define CHECK_CHARACTER_CONTROLLER_3D(L, arg) static_cast<CharacterController3D*>(CheckNodeLuaType(L, arg, CHARACTER_CONTROLLER_3D_LUA_NAME, CHARACTER_CONTROLLER_3D_LUA_FLAG));
+
+struct CharacterController3D_Lua
+{
+    static int Move(lua_State* L);
+    static int IsGrounded(lua_State* L);
+    static int GetGroundNormal(lua_State* L);
+    static int GetMaxSlopeAngle(lua_State* L);
+    static int SetMaxSlopeAngle(lua_State* L);
+    static int GetStepHeight(lua_State* L);
+    static int SetStepHeight(lua_State* L);
+    static int GetSnapDistance(lua_State* L);
+    static int SetSnapDistance(lua_State* L);
+    static int GetRidePlatforms(lua_State* L);
+    static int SetRidePlatforms(lua_State* L);
+
+    static void Bind();
+};
+
+#endif
@@ -3,6 +3,8 @@
 #include "Engine.h"
 #include "Clock.h"
 #include "Utilities.h"
+#include "CollisionLayers.h"
+#include "World.h"
 
 #include "System/System.h"
 
@@ -182,6 +184,39 @@ int Engine_Lua::GarbageCollect(lua_State* L)
     return 0;
 }
 
+int Engine_Lua::SetCollisionLayerMask(lua_State* L)
+{
+    uint32_t layer = (uint32_t)CHECK_INTEGER(L, 1);
+    uint32_t mask = (uint32_t)CHECK_INTEGER(L, 2);
+
+    GetProjectCollisionLayers().SetLayerMask(layer, mask);
+    ::GetWorld()->GetCollisionLayers().SetLayerMask(layer, mask);
+
+    return 0;
+}
+
+int Engine_Lua::GetCollisionLayerMask(lua_State* L)
+{
+    uint32_t layer = (uint32_t)CHECK_INTEGER(L, 1);
+
+    uint32_t ret = ::GetWorld()->GetCollisionLayers().GetLayerMask(layer);
+
+    lua_pushinteger(L, (lua_Integer)ret);
+    return 1;
+}
+
+int Engine_Lua::SetCollisionLayersInteract(lua_State* L)
+{
+    uint32_t layerA = (uint32_t)CHECK_INTEGER(L, 1);
+    uint32_t layerB = (uint32_t)CHECK_INTEGER(L, 2);
+    bool interact = CHECK_BOOLEAN(L, 3);
+
+    GetProjectCollisionLayers().SetLayersInteract(layerA, layerB, interact);
+    ::GetWorld()->GetCollisionLayers().SetLayersInteract(layerA, layerB, interact);
+
+    return 0;
+}
+
 void Engine_Lua::Bind()
 {
     lua_State* L = GetLua();
@@ -233,6 +268,12 @@ void Engine_Lua::Bind()
 
     REGISTER_TABLE_FUNC(L, tableIdx, GarbageCollect);
 
+    REGISTER_TABLE_FUNC(L, tableIdx, SetCollisionLayerMask);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, GetCollisionLayerMask);
+
+    REGISTER_TABLE_FUNC(L, tableIdx, SetCollisionLayersInteract);
+
     lua_setglobal(L, "Engine");
 
     OCT_ASSERT(lua_gettop(L) == 0);
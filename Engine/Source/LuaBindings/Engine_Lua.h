@@ -28,6 +28,9 @@ struct Engine_Lua
     static int SetTimeDilation(lua_State* L);
     static int GetTimeDilation(lua_State* L);
     static int GarbageCollect(lua_State* L);
+    static int SetCollisionLayerMask(lua_State* L);
+    static int GetCollisionLayerMask(lua_State* L);
+    static int SetCollisionLayersInteract(lua_State* L);
 
     static void Bind();
 };
@@ -27,6 +27,7 @@
 #include "LuaBindings/Audio3d_Lua.h"
 #include "LuaBindings/Box3d_Lua.h"
 #include "LuaBindings/Capsule3d_Lua.h"
+#include "LuaBindings/CharacterController3d_Lua.h"
 #include "LuaBindings/Particle3d_Lua.h"
 #include "LuaBindings/ShadowMesh3d_Lua.h"
 #include "LuaBindings/TextMesh3d_Lua.h"
@@ -97,6 +98,7 @@ void BindLuaInterface()
     Audio3D_Lua::Bind();
     Box3D_Lua::Bind();
     Capsule3D_Lua::Bind();
+    CharacterController3D_Lua::Bind();
     Particle3D_Lua::Bind();
     ShadowMesh3D_Lua::Bind();
     TextMesh3D_Lua::Bind();
@@ -149,9 +149,9 @@ int Primitive3D_Lua::GetCollisionGroup(lua_State* L)
 {
     Primitive3D* prim = CHECK_PRIMITIVE_3D(L, 1);
 
-    int ret = prim->GetCollisionGroup();
+    uint32_t ret = prim->GetCollisionGroup();
 
-    lua_pushinteger(L, ret);
+    lua_pushinteger(L, (lua_Integer)ret);
     return 1;
 }
 
@@ -159,9 +159,29 @@ int Primitive3D_Lua::GetCollisionMask(lua_State* L)
 {
     Primitive3D* prim = CHECK_PRIMITIVE_3D(L, 1);
 
-    int ret = prim->GetCollisionMask();
+    uint32_t ret = prim->GetCollisionMask();
 
-    lua_pushinteger(L, ret);
+    lua_pushinteger(L, (lua_Integer)ret);
+    return 1;
+}
+
+int Primitive3D_Lua::GetCcdMotionThreshold(lua_State* L)
+{
+    Primitive3D* prim = CHECK_PRIMITIVE_3D(L, 1);
+
+    float ret = prim->GetCcdMotionThreshold();
+
+    lua_pushnumber(L, ret);
+    return 1;
+}
+
+int Primitive3D_Lua::GetCcdSweptSphereRadius(lua_State* L)
+{
+    Primitive3D* prim = CHECK_PRIMITIVE_3D(L, 1);
+
+    float ret = prim->GetCcdSweptSphereRadius();
+
+    lua_pushnumber(L, ret);
     return 1;
 }
 
@@ -248,7 +268,7 @@ int Primitive3D_Lua::SetAngularFactor(lua_State* L)
 int Primitive3D_Lua::SetCollisionGroup(lua_State* L)
 {
     Primitive3D* prim = CHECK_PRIMITIVE_3D(L, 1);
-    uint8_t value = (uint8_t) CHECK_INTEGER(L, 2);
+    uint32_t value = (uint32_t)CHECK_INTEGER(L, 2);
 
     prim->SetCollisionGroup(value);
 
@@ -258,13 +278,33 @@ int Primitive3D_Lua::SetCollisionGroup(lua_State* L)
 int Primitive3D_Lua::SetCollisionMask(lua_State* L)
 {
     Primitive3D* prim = CHECK_PRIMITIVE_3D(L, 1);
-    uint8_t value = (uint8_t)CHECK_INTEGER(L, 2);
+    uint32_t value = (uint32_t)CHECK_INTEGER(L, 2);
 
     prim->SetCollisionMask(value);
 
     return 0;
 }
 
+int Primitive3D_Lua::SetCcdMotionThreshold(lua_State* L)
+{
+    Primitive3D* prim = CHECK_PRIMITIVE_3D(L, 1);
+    float value = CHECK_NUMBER(L, 2);
+
+    prim->SetCcdMotionThreshold(value);
+
+    return 0;
+}
+
+int Primitive3D_Lua::SetCcdSweptSphereRadius(lua_State* L)
+{
+    Primitive3D* prim = CHECK_PRIMITIVE_3D(L, 1);
+    float value = CHECK_NUMBER(L, 2);
+
+    prim->SetCcdSweptSphereRadius(value);
+
+    return 0;
+}
+
 int Primitive3D_Lua::GetLinearVelocity(lua_State* L)
 {
     Primitive3D* prim = CHECK_PRIMITIVE_3D(L, 1);
@@ -418,7 +458,7 @@ int Primitive3D_Lua::SweepToWorldPosition(lua_State* L)
 {
     Primitive3D* prim = CHECK_PRIMITIVE_3D(L, 1);
     glm::vec3 pos = CHECK_VECTOR(L, 2);
-    uint8_t mask = (lua_gettop(L) >= 3) ? (uint8_t)lua_tointeger(L, 3) : 0;
+    uint32_t mask = (lua_gettop(L) >= 3) ? (uint32_t)lua_tointeger(L, 3) : 0;
 
     SweepTestResult result;
     prim->SweepToWorldPosition(pos, result, mask);
@@ -482,6 +522,10 @@ void Primitive3D_Lua::Bind()
 
     REGISTER_TABLE_FUNC(L, mtIndex, GetCollisionMask);
 
+    REGISTER_TABLE_FUNC(L, mtIndex, GetCcdMotionThreshold);
+
+    REGISTER_TABLE_FUNC(L, mtIndex, GetCcdSweptSphereRadius);
+
     REGISTER_TABLE_FUNC(L, mtIndex, SetMass);
 
     REGISTER_TABLE_FUNC(L, mtIndex, SetLinearDamping);
@@ -502,6 +546,10 @@ void Primitive3D_Lua::Bind()
 
     REGISTER_TABLE_FUNC(L, mtIndex, SetCollisionMask);
 
+    REGISTER_TABLE_FUNC(L, mtIndex, SetCcdMotionThreshold);
+
+    REGISTER_TABLE_FUNC(L, mtIndex, SetCcdSweptSphereRadius);
+
     REGISTER_TABLE_FUNC(L, mtIndex, GetLinearVelocity);
 
     REGISTER_TABLE_FUNC(L, mtIndex, GetAngularVelocity);
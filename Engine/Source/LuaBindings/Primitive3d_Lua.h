@@ -34,6 +34,8 @@ struct Primitive3D_Lua
     static int GetAngularFactor(lua_State* L);
     static int GetCollisionGroup(lua_State* L);
     static int GetCollisionMask(lua_State* L);
+    static int GetCcdMotionThreshold(lua_State* L);
+    static int GetCcdSweptSphereRadius(lua_State* L);
 
     static int SetMass(lua_State* L);
     static int SetLinearDamping(lua_State* L);
@@ -45,6 +47,8 @@ struct Primitive3D_Lua
     static int SetAngularFactor(lua_State* L);
     static int SetCollisionGroup(lua_State* L);
     static int SetCollisionMask(lua_State* L);
+    static int SetCcdMotionThreshold(lua_State* L);
+    static int SetCcdSweptSphereRadius(lua_State* L);
 
     static int GetLinearVelocity(lua_State* L);
     static int GetAngularVelocity(lua_State* L);
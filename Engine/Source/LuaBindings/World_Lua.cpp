@@ -13,6 +13,40 @@
 
 #if LUA_ENABLED
 
+static void PushRayTestResult(lua_State* L, const RayTestResult& result)
+{
+    lua_newtable(L);
+    Vector_Lua::Create(L, result.mStart);
+    lua_setfield(L, -2, "start");
+    Vector_Lua::Create(L, result.mEnd);
+    lua_setfield(L, -2, "end");
+    Node_Lua::Create(L, result.mHitComponent);
+    lua_setfield(L, -2, "hitComponent");
+    Vector_Lua::Create(L, result.mHitNormal);
+    lua_setfield(L, -2, "hitNormal");
+    Vector_Lua::Create(L, result.mHitPosition);
+    lua_setfield(L, -2, "hitPosition");
+    lua_pushnumber(L, result.mHitFraction);
+    lua_setfield(L, -2, "hitFraction");
+}
+
+static void PushSweepTestResult(lua_State* L, const SweepTestResult& result)
+{
+    lua_newtable(L);
+    Vector_Lua::Create(L, result.mStart);
+    lua_setfield(L, -2, "start");
+    Vector_Lua::Create(L, result.mEnd);
+    lua_setfield(L, -2, "end");
+    Node_Lua::Create(L, result.mHitComponent);
+    lua_setfield(L, -2, "hitComponent");
+    Vector_Lua::Create(L, result.mHitNormal);
+    lua_setfield(L, -2, "hitNormal");
+    Vector_Lua::Create(L, result.mHitPosition);
+    lua_setfield(L, -2, "hitPosition");
+    lua_pushnumber(L, result.mHitFraction);
+    lua_setfield(L, -2, "hitFraction");
+}
+
 int World_Lua::Create(lua_State* L, World* world)
 {
     if (world != nullptr)
@@ -144,7 +178,8 @@ int World_Lua::FindNodesWithTag(lua_State* L)
     World* world = CHECK_WORLD(L, 1);
     const char* tag = CHECK_STRING(L, 2);
 
-    std::vector<Node*> nodes = world->FindNodesWithTag(tag);
+    FrameVector<Node*> nodes;
+    world->FindNodesWithTag(tag, nodes);
 
     lua_newtable(L);
     int arrayIdx = lua_gettop(L);
@@ -164,7 +199,8 @@ int World_Lua::FindNodesWithName(lua_State* L)
     World* world = CHECK_WORLD(L, 1);
     const char* name = CHECK_STRING(L, 2);
 
-    std::vector<Node*> nodes = world->FindNodesWithName(name);
+    FrameVector<Node*> nodes;
+    world->FindNodesWithName(name, nodes);
 
     lua_newtable(L);
     int arrayIdx = lua_gettop(L);
@@ -275,29 +311,87 @@ int World_Lua::GetGravity(lua_State* L)
     return 1;
 }
 
+int World_Lua::SetPhysicsFixedTimeStep(lua_State* L)
+{
+    World* world = CHECK_WORLD(L, 1);
+    float value = CHECK_NUMBER(L, 2);
+
+    world->SetPhysicsFixedTimeStep(value);
+
+    return 0;
+}
+
+int World_Lua::GetPhysicsFixedTimeStep(lua_State* L)
+{
+    World* world = CHECK_WORLD(L, 1);
+
+    float ret = world->GetPhysicsFixedTimeStep();
+
+    lua_pushnumber(L, ret);
+    return 1;
+}
+
+int World_Lua::SetPhysicsMaxSubsteps(lua_State* L)
+{
+    World* world = CHECK_WORLD(L, 1);
+    int32_t value = (int32_t)CHECK_INTEGER(L, 2);
+
+    world->SetPhysicsMaxSubsteps(value);
+
+    return 0;
+}
+
+int World_Lua::GetPhysicsMaxSubsteps(lua_State* L)
+{
+    World* world = CHECK_WORLD(L, 1);
+
+    int32_t ret = world->GetPhysicsMaxSubsteps();
+
+    lua_pushinteger(L, ret);
+    return 1;
+}
+
+int World_Lua::GetPhysicsSubstepCount(lua_State* L)
+{
+    World* world = CHECK_WORLD(L, 1);
+
+    uint32_t ret = world->GetPhysicsSubstepCount();
+
+    lua_pushinteger(L, (lua_Integer)ret);
+    return 1;
+}
+
+int World_Lua::GetCcdSweepCount(lua_State* L)
+{
+    World* world = CHECK_WORLD(L, 1);
+
+    uint32_t ret = world->GetCcdSweepCount();
+
+    lua_pushinteger(L, (lua_Integer)ret);
+    return 1;
+}
+
+int World_Lua::GetCcdHitCount(lua_State* L)
+{
+    World* world = CHECK_WORLD(L, 1);
+
+    uint32_t ret = world->GetCcdHitCount();
+
+    lua_pushinteger(L, (lua_Integer)ret);
+    return 1;
+}
+
 int World_Lua::RayTest(lua_State* L)
 {
     World* world = CHECK_WORLD(L, 1);
     glm::vec3 start = CHECK_VECTOR(L, 2);
     glm::vec3 end = CHECK_VECTOR(L, 3);
-    uint8_t colMask = (uint8_t) CHECK_INTEGER(L, 4);
+    uint32_t colMask = (uint32_t) CHECK_INTEGER(L, 4);
 
     RayTestResult result;
     world->RayTest(start, end, colMask, result);
 
-    lua_newtable(L);
-    Vector_Lua::Create(L, result.mStart);
-    lua_setfield(L, -2, "start");
-    Vector_Lua::Create(L, result.mEnd);
-    lua_setfield(L, -2, "end");
-    Node_Lua::Create(L, result.mHitComponent);
-    lua_setfield(L, -2, "hitComponent");
-    Vector_Lua::Create(L, result.mHitNormal);
-    lua_setfield(L, -2, "hitNormal");
-    Vector_Lua::Create(L, result.mHitPosition);
-    lua_setfield(L, -2, "hitPosition");
-    lua_pushnumber(L, result.mHitFraction);
-    lua_setfield(L, -2, "hitFraction");
+    PushRayTestResult(L, result);
     return 1;
 }
 
@@ -306,7 +400,7 @@ int World_Lua::RayTestMulti(lua_State* L)
     World* world = CHECK_WORLD(L, 1);
     glm::vec3 start = CHECK_VECTOR(L, 2);
     glm::vec3 end = CHECK_VECTOR(L, 3);
-    uint8_t colMask = (uint8_t)CHECK_INTEGER(L, 4);
+    uint32_t colMask = (uint32_t)CHECK_INTEGER(L, 4);
 
     RayTestMultiResult result;
     world->RayTestMulti(start, end, colMask, result);
@@ -361,24 +455,106 @@ int World_Lua::SweepTest(lua_State* L)
     Primitive3D* primComp = CHECK_PRIMITIVE_3D(L, 2);
     glm::vec3 start = CHECK_VECTOR(L, 3);
     glm::vec3 end = CHECK_VECTOR(L, 4);
-    uint8_t colMask = (uint8_t)CHECK_INTEGER(L, 5);
+    uint32_t colMask = (uint32_t)CHECK_INTEGER(L, 5);
 
     SweepTestResult result;
     world->SweepTest(primComp, start, end, colMask, result);
 
-    lua_newtable(L);
-    Vector_Lua::Create(L, result.mStart);
-    lua_setfield(L, -2, "start");
-    Vector_Lua::Create(L, result.mEnd);
-    lua_setfield(L, -2, "end");
-    Node_Lua::Create(L, result.mHitComponent);
-    lua_setfield(L, -2, "hitComponent");
-    Vector_Lua::Create(L, result.mHitNormal);
-    lua_setfield(L, -2, "hitNormal");
-    Vector_Lua::Create(L, result.mHitPosition);
-    lua_setfield(L, -2, "hitPosition");
-    lua_pushnumber(L, result.mHitFraction);
-    lua_setfield(L, -2, "hitFraction");
+    PushSweepTestResult(L, result);
+    return 1;
+}
+
+int World_Lua::RayTestBatch(lua_State* L)
+{
+    World* world = CHECK_WORLD(L, 1);
+    CHECK_TABLE(L, 2);
+    bool anyHit = false;
+    if (!lua_isnone(L, 3)) { anyHit = CHECK_BOOLEAN(L, 3); }
+
+    uint32_t numQueries = (uint32_t)lua_rawlen(L, 2);
+    FrameVector<RayTestQuery> queries;
+    queries.resize(numQueries);
+
+    // Each query is a table of { start, end, mask }. The mask is optional.
+    for (uint32_t i = 0; i < numQueries; ++i)
+    {
+        lua_geti(L, 2, i + 1);
+        CHECK_TABLE(L, -1);
+
+        lua_getfield(L, -1, "start");
+        queries[i].mStart = CHECK_VECTOR(L, -1);
+        lua_pop(L, 1);
+
+        lua_getfield(L, -1, "end");
+        queries[i].mEnd = CHECK_VECTOR(L, -1);
+        lua_pop(L, 1);
+
+        lua_getfield(L, -1, "mask");
+        if (!lua_isnil(L, -1)) { queries[i].mCollisionMask = (uint32_t)CHECK_INTEGER(L, -1); }
+        lua_pop(L, 1);
+
+        lua_pop(L, 1);
+    }
+
+    FrameVector<RayTestResult> results;
+    results.resize(numQueries);
+    world->RayTestBatch(numQueries, queries.data(), results.data(), anyHit);
+
+    lua_createtable(L, (int)numQueries, 0);
+    for (uint32_t i = 0; i < numQueries; ++i)
+    {
+        PushRayTestResult(L, results[i]);
+        lua_seti(L, -2, i + 1);
+    }
+
+    return 1;
+}
+
+int World_Lua::SweepTestBatch(lua_State* L)
+{
+    World* world = CHECK_WORLD(L, 1);
+    CHECK_TABLE(L, 2);
+
+    uint32_t numQueries = (uint32_t)lua_rawlen(L, 2);
+    FrameVector<SweepTestQuery> queries;
+    queries.resize(numQueries);
+
+    // Each query is a table of { primitive, start, end, mask }. The mask is optional.
+    for (uint32_t i = 0; i < numQueries; ++i)
+    {
+        lua_geti(L, 2, i + 1);
+        CHECK_TABLE(L, -1);
+
+        lua_getfield(L, -1, "primitive");
+        queries[i].mPrimitive = CHECK_PRIMITIVE_3D(L, -1);
+        lua_pop(L, 1);
+
+        lua_getfield(L, -1, "start");
+        queries[i].mStart = CHECK_VECTOR(L, -1);
+        lua_pop(L, 1);
+
+        lua_getfield(L, -1, "end");
+        queries[i].mEnd = CHECK_VECTOR(L, -1);
+        lua_pop(L, 1);
+
+        lua_getfield(L, -1, "mask");
+        if (!lua_isnil(L, -1)) { queries[i].mCollisionMask = (uint32_t)CHECK_INTEGER(L, -1); }
+        lua_pop(L, 1);
+
+        lua_pop(L, 1);
+    }
+
+    FrameVector<SweepTestResult> results;
+    results.resize(numQueries);
+    world->SweepTestBatch(numQueries, queries.data(), results.data());
+
+    lua_createtable(L, (int)numQueries, 0);
+    for (uint32_t i = 0; i < numQueries; ++i)
+    {
+        PushSweepTestResult(L, results[i]);
+        lua_seti(L, -2, i + 1);
+    }
+
     return 1;
 }
 
@@ -424,6 +600,26 @@ int World_Lua::IsInternalEdgeSmoothingEnabled(lua_State* L)
     return 1;
 }
 
+int World_Lua::EnablePipelinedPhysics(lua_State* L)
+{
+    World* world = CHECK_WORLD(L, 1);
+    bool value = CHECK_BOOLEAN(L, 2);
+
+    world->EnablePipelinedPhysics(value);
+
+    return 0;
+}
+
+int World_Lua::IsPipelinedPhysicsEnabled(lua_State* L)
+{
+    World* world = CHECK_WORLD(L, 1);
+
+    bool ret = world->IsPipelinedPhysicsEnabled();
+
+    lua_pushboolean(L, ret);
+    return 1;
+}
+
 int World_Lua::SpawnParticle(lua_State* L)
 {
     World* world = CHECK_WORLD(L, 1);
@@ -436,6 +632,36 @@ int World_Lua::SpawnParticle(lua_State* L)
     return 1;
 }
 
+int World_Lua::AddStreamingSource(lua_State* L)
+{
+    World* world = CHECK_WORLD(L, 1);
+    Node3D* node = CHECK_NODE_3D(L, 2);
+
+    world->GetWorldPartition()->AddStreamingSource(node);
+
+    return 0;
+}
+
+int World_Lua::RemoveStreamingSource(lua_State* L)
+{
+    World* world = CHECK_WORLD(L, 1);
+    Node3D* node = CHECK_NODE_3D(L, 2);
+
+    world->GetWorldPartition()->RemoveStreamingSource(node);
+
+    return 0;
+}
+
+int World_Lua::GetNumLoadedPartitionCells(lua_State* L)
+{
+    World* world = CHECK_WORLD(L, 1);
+
+    uint32_t ret = world->GetWorldPartition()->GetNumCells(PartitionCellState::Instantiated);
+
+    lua_pushinteger(L, ret);
+    return 1;
+}
+
 void World_Lua::Bind()
 {
     lua_State* L = GetLua();
@@ -484,12 +710,30 @@ void World_Lua::Bind()
 
     REGISTER_TABLE_FUNC(L, mtIndex, GetGravity);
 
+    REGISTER_TABLE_FUNC(L, mtIndex, SetPhysicsFixedTimeStep);
+
+    REGISTER_TABLE_FUNC(L, mtIndex, GetPhysicsFixedTimeStep);
+
+    REGISTER_TABLE_FUNC(L, mtIndex, SetPhysicsMaxSubsteps);
+
+    REGISTER_TABLE_FUNC(L, mtIndex, GetPhysicsMaxSubsteps);
+
+    REGISTER_TABLE_FUNC(L, mtIndex, GetPhysicsSubstepCount);
+
+    REGISTER_TABLE_FUNC(L, mtIndex, GetCcdSweepCount);
+
+    REGISTER_TABLE_FUNC(L, mtIndex, GetCcdHitCount);
+
     REGISTER_TABLE_FUNC(L, mtIndex, RayTest);
 
     REGISTER_TABLE_FUNC(L, mtIndex, RayTestMulti);
 
     REGISTER_TABLE_FUNC(L, mtIndex, SweepTest);
 
+    REGISTER_TABLE_FUNC(L, mtIndex, RayTestBatch);
+
+    REGISTER_TABLE_FUNC(L, mtIndex, SweepTestBatch);
+
     REGISTER_TABLE_FUNC(L, mtIndex, LoadScene);
 
     REGISTER_TABLE_FUNC(L, mtIndex, QueueRootNode);
@@ -498,8 +742,18 @@ void World_Lua::Bind()
 
     REGISTER_TABLE_FUNC(L, mtIndex, IsInternalEdgeSmoothingEnabled);
 
+    REGISTER_TABLE_FUNC(L, mtIndex, EnablePipelinedPhysics);
+
+    REGISTER_TABLE_FUNC(L, mtIndex, IsPipelinedPhysicsEnabled);
+
     REGISTER_TABLE_FUNC(L, mtIndex, SpawnParticle);
 
+    REGISTER_TABLE_FUNC(L, mtIndex, AddStreamingSource);
+
+    REGISTER_TABLE_FUNC(L, mtIndex, RemoveStreamingSource);
+
+    REGISTER_TABLE_FUNC(L, mtIndex, GetNumLoadedPartitionCells);
+
     // Set the __index metamethod to itself
     lua_pushvalue(L, mtIndex);
     lua_setfield(L, mtIndex, "__index");
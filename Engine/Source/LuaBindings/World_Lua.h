@@ -42,19 +42,34 @@ struct World_Lua
 
     static int SetGravity(lua_State* L);
     static int GetGravity(lua_State* L);
+    static int SetPhysicsFixedTimeStep(lua_State* L);
+    static int GetPhysicsFixedTimeStep(lua_State* L);
+    static int SetPhysicsMaxSubsteps(lua_State* L);
+    static int GetPhysicsMaxSubsteps(lua_State* L);
+    static int GetPhysicsSubstepCount(lua_State* L);
+    static int GetCcdSweepCount(lua_State* L);
+    static int GetCcdHitCount(lua_State* L);
 
     static int RayTest(lua_State* L);
     static int RayTestMulti(lua_State* L);
     static int SweepTest(lua_State* L);
+    static int RayTestBatch(lua_State* L);
+    static int SweepTestBatch(lua_State* L);
 
     static int LoadScene(lua_State* L);
     static int QueueRootNode(lua_State* L);
 
     static int EnableInternalEdgeSmoothing(lua_State* L);
     static int IsInternalEdgeSmoothingEnabled(lua_State* L);
+    static int EnablePipelinedPhysics(lua_State* L);
+    static int IsPipelinedPhysicsEnabled(lua_State* L);
 
     static int SpawnParticle(lua_State* L);
 
+    static int AddStreamingSource(lua_State* L);
+    static int RemoveStreamingSource(lua_State* L);
+    static int GetNumLoadedPartitionCells(lua_State* L);
+
     static void Bind();
 };
 
@@ -14,6 +14,10 @@
 #include <string>
 #include <assert.h>
 #include <signal.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
 
 #include <android/input.h>
 #include <android/window.h>
@@ -508,6 +512,94 @@ void SYS_ReleaseFileData(char* data)
     }
 }
 
+bool SYS_MapFileData(const char* path, bool isAsset, int32_t maxSize, char*& outData, uint32_t& outSize, bool sequential)
+{
+    outData = nullptr;
+    outSize = 0;
+
+    // Packaged assets live inside the apk and are read through the AAssetManager instead.
+    if (isAsset)
+    {
+        return false;
+    }
+
+    int fd = open(path, O_RDONLY);
+
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat info;
+    int64_t fileSize = 0;
+
+    if (fstat(fd, &info) == 0)
+    {
+        fileSize = int64_t(info.st_size);
+    }
+
+    if (maxSize > 0)
+    {
+        fileSize = glm::min<int64_t>(fileSize, maxSize);
+    }
+
+    if (fileSize > int64_t(UINT32_MAX))
+    {
+        // Sizes are 32 bit throughout the loader, so don't silently wrap.
+        LogError("File is too large to map: %s", path);
+        fileSize = 0;
+    }
+
+    if (fileSize > 0)
+    {
+        void* mapping = mmap(nullptr, size_t(fileSize), PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (mapping != MAP_FAILED)
+        {
+            if (sequential)
+            {
+                // Assets are parsed front to back, so let the kernel read ahead aggressively.
+                madvise(mapping, size_t(fileSize), MADV_SEQUENTIAL);
+                madvise(mapping, size_t(fileSize), MADV_WILLNEED);
+            }
+            else
+            {
+                madvise(mapping, size_t(fileSize), MADV_RANDOM);
+            }
+
+            outData = (char*)mapping;
+            outSize = uint32_t(fileSize);
+        }
+    }
+
+    // The mapping keeps its own reference to the file.
+    close(fd);
+
+    return (outData != nullptr);
+}
+
+void SYS_UnmapFileData(char* data, uint32_t size)
+{
+    if (data != nullptr)
+    {
+        munmap(data, size);
+    }
+}
+
+void SYS_PrefetchFileData(const char* data, uint32_t size)
+{
+    // Hint that a range of a mapped file is about to be read front to back.
+    if (data != nullptr && size > 0)
+    {
+        uintptr_t pageSize = uintptr_t(sysconf(_SC_PAGESIZE));
+        uintptr_t start = uintptr_t(data) & ~(pageSize - 1);
+        size_t length = size_t(uintptr_t(data) + size - start);
+
+        madvise((void*)start, length, MADV_SEQUENTIAL);
+        madvise((void*)start, length, MADV_WILLNEED);
+    }
+}
+
 std::string SYS_GetCurrentDirectoryPath()
 {
     char path[MAX_PATH_SIZE] = {};
@@ -583,6 +675,8 @@ void SYS_OpenDirectory(const std::string& dirPath, DirEntry& outDirEntry)
         stat(fullPath.c_str(), &statbuf);
 
         outDirEntry.mDirectory = S_ISDIR(statbuf.st_mode);
+        outDirEntry.mModifiedTime = uint64_t(statbuf.st_mtim.tv_sec) * 1000000000ull + uint64_t(statbuf.st_mtim.tv_nsec);
+        outDirEntry.mSize = uint64_t(statbuf.st_size);
         outDirEntry.mValid = true;
     }
 }
@@ -603,6 +697,8 @@ void SYS_IterateDirectory(DirEntry& dirEntry)
         stat(fullPath.c_str(), &statbuf);
 
         dirEntry.mDirectory = S_ISDIR(statbuf.st_mode);
+        dirEntry.mModifiedTime = uint64_t(statbuf.st_mtim.tv_sec) * 1000000000ull + uint64_t(statbuf.st_mtim.tv_nsec);
+        dirEntry.mSize = uint64_t(statbuf.st_size);
         dirEntry.mValid = true;
     }
 }
@@ -613,6 +709,17 @@ void SYS_CloseDirectory(DirEntry& dirEntry)
     dirEntry.mDir = nullptr;
 }
 
+bool SYS_WatchDirectory(const char* dirPath)
+{
+    // The file watcher is only implemented on Linux.
+    return false;
+}
+
+void SYS_PollFileChanges(std::vector<FileChange>& outChanges)
+{
+    // The file watcher is only implemented on Linux.
+}
+
 std::string SYS_OpenFileDialog()
 {
     return "";
@@ -698,6 +805,43 @@ void SYS_DestroyMutex(MutexObject* mutex)
     delete mutex;
 }
 
+SemaphoreObject* SYS_CreateSemaphore(uint32_t initialCount)
+{
+    SemaphoreObject* retSemaphore = new SemaphoreObject();
+    int status = sem_init(retSemaphore, 0, initialCount);
+
+    if (status != 0)
+    {
+        LogError("Failed to create Semaphore");
+    }
+
+    return retSemaphore;
+}
+
+void SYS_WaitSemaphore(SemaphoreObject* semaphore)
+{
+    // Retry if a signal interrupts the wait.
+    while (sem_wait(semaphore) != 0 && errno == EINTR)
+    {
+    }
+}
+
+void SYS_SignalSemaphore(SemaphoreObject* semaphore)
+{
+    int status = sem_post(semaphore);
+
+    if (status != 0)
+    {
+        LogError("Failed to signal semaphore");
+    }
+}
+
+void SYS_DestroySemaphore(SemaphoreObject* semaphore)
+{
+    sem_destroy(semaphore);
+    delete semaphore;
+}
+
 void SYS_Sleep(uint32_t milliseconds)
 {
     usleep(milliseconds * 1000);
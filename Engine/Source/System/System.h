@@ -3,6 +3,7 @@
 #include "System/SystemTypes.h"
 
 #include <string>
+#include <vector>
 #include <stdarg.h>
 
 class Stream;
@@ -15,6 +16,9 @@ void SYS_Update();
 bool SYS_DoesFileExist(const char* path, bool isAsset);
 void SYS_AcquireFileData(const char* path, bool isAsset, int32_t maxSize, char*& outData, uint32_t& outSize);
 void SYS_ReleaseFileData(char* data);
+bool SYS_MapFileData(const char* path, bool isAsset, int32_t maxSize, char*& outData, uint32_t& outSize, bool sequential = true);
+void SYS_UnmapFileData(char* data, uint32_t size);
+void SYS_PrefetchFileData(const char* data, uint32_t size);
 std::string SYS_GetCurrentDirectoryPath();
 std::string SYS_GetAbsolutePath(const std::string& relativePath);
 void SYS_SetWorkingDirectory(const std::string& dirPath);
@@ -23,6 +27,8 @@ void SYS_RemoveDirectory(const char* dirPath);
 void SYS_OpenDirectory(const std::string& dirPath, DirEntry& outDirEntry);
 void SYS_IterateDirectory(DirEntry& dirEntry);
 void SYS_CloseDirectory(DirEntry& dirEntry);
+bool SYS_WatchDirectory(const char* dirPath);
+void SYS_PollFileChanges(std::vector<FileChange>& outChanges);
 void SYS_RemoveFile(const char* path);
 bool SYS_Rename(const char* oldPath, const char* newPath);
 std::string SYS_OpenFileDialog();
@@ -37,6 +43,10 @@ MutexObject* SYS_CreateMutex();
 void SYS_LockMutex(MutexObject* mutex);
 void SYS_UnlockMutex(MutexObject* mutex);
 void SYS_DestroyMutex(MutexObject* mutex);
+SemaphoreObject* SYS_CreateSemaphore(uint32_t initialCount);
+void SYS_WaitSemaphore(SemaphoreObject* semaphore);
+void SYS_SignalSemaphore(SemaphoreObject* semaphore);
+void SYS_DestroySemaphore(SemaphoreObject* semaphore);
 void SYS_Sleep(uint32_t milliseconds);
 
 // Time
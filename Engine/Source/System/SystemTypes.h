@@ -3,6 +3,7 @@
 #include "Constants.h"
 #include "Maths.h"
 #include <string>
+#include <unordered_map>
 
 #if PLATFORM_WINDOWS
 #include <Windows.h>
@@ -14,6 +15,7 @@
 #include <unistd.h>
 #include <xcb/xcb.h>
 #include <pthread.h>
+#include <semaphore.h>
 #elif PLATFORM_ANDROID
 #include <stdio.h>
 #include <dirent.h>
@@ -21,6 +23,7 @@
 #include <sys/stat.h>
 #include <unistd.h>
 #include <pthread.h>
+#include <semaphore.h>
 #include <android/native_window.h>
 #include <android/native_activity.h>
 #include <android_native_app_glue.h>
@@ -29,10 +32,12 @@
 #if PLATFORM_WINDOWS
 typedef HANDLE ThreadObject;
 typedef HANDLE MutexObject;
+typedef HANDLE SemaphoreObject;
 typedef DWORD ThreadFuncRet;
 #elif (PLATFORM_LINUX || PLATFORM_ANDROID)
 typedef pthread_t ThreadObject;
 typedef pthread_mutex_t MutexObject;
+typedef sem_t SemaphoreObject;
 typedef void* ThreadFuncRet;
 #endif
 
@@ -53,6 +58,8 @@ struct DirEntry
 {
     char mDirectoryPath[MAX_PATH_SIZE + 1] = { };
     char mFilename[MAX_PATH_SIZE + 1] = { };
+    uint64_t mModifiedTime = 0; // Platform specific units, only meant for comparing
+    uint64_t mSize = 0;
     bool mDirectory = false;
     bool mValid = false;
 
@@ -64,6 +71,21 @@ struct DirEntry
 #endif
 };
 
+enum class FileChangeType : uint8_t
+{
+    Modified,
+    Removed,
+    DirectoryCreated,
+
+    Count
+};
+
+struct FileChange
+{
+    std::string mPath;
+    FileChangeType mType = FileChangeType::Modified;
+};
+
 struct SystemState
 {
 #if PLATFORM_WINDOWS
@@ -78,6 +100,8 @@ struct SystemState
     xcb_window_t mXcbWindow = 0;
     xcb_intern_atom_reply_t* mAtomDeleteWindow = nullptr;
     xcb_cursor_t mNullCursor = XCB_NONE;
+    int32_t mFileWatchFd = -1;
+    std::unordered_map<int32_t, std::string> mWatchedDirs;
     bool mWindowHasFocus = false;
     bool mFullscreen = false;
 #elif PLATFORM_ANDROID
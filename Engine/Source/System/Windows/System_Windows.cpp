@@ -411,6 +411,78 @@ void SYS_ReleaseFileData(char* data)
     }
 }
 
+bool SYS_MapFileData(const char* path, bool isAsset, int32_t maxSize, char*& outData, uint32_t& outSize, bool sequential)
+{
+    outData = nullptr;
+    outSize = 0;
+
+    DWORD accessHint = sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS;
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, accessHint, nullptr);
+
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER largeSize = {};
+    int64_t fileSize = 0;
+
+    if (GetFileSizeEx(file, &largeSize))
+    {
+        fileSize = int64_t(largeSize.QuadPart);
+    }
+
+    if (maxSize > 0)
+    {
+        fileSize = glm::min<int64_t>(fileSize, maxSize);
+    }
+
+    if (fileSize > int64_t(UINT32_MAX))
+    {
+        // Sizes are 32 bit throughout the loader, so don't silently wrap.
+        LogError("File is too large to map: %s", path);
+        fileSize = 0;
+    }
+
+    if (fileSize > 0)
+    {
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+        if (mapping != nullptr)
+        {
+            outData = (char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, SIZE_T(fileSize));
+            outSize = (outData != nullptr) ? uint32_t(fileSize) : 0;
+
+            // The view keeps the mapping object alive.
+            CloseHandle(mapping);
+        }
+    }
+
+    CloseHandle(file);
+
+    return (outData != nullptr);
+}
+
+void SYS_UnmapFileData(char* data, uint32_t size)
+{
+    if (data != nullptr)
+    {
+        UnmapViewOfFile(data);
+    }
+}
+
+void SYS_PrefetchFileData(const char* data, uint32_t size)
+{
+    // Hint that a range of a mapped file is about to be read front to back.
+    if (data != nullptr && size > 0)
+    {
+        WIN32_MEMORY_RANGE_ENTRY range = {};
+        range.VirtualAddress = (PVOID)data;
+        range.NumberOfBytes = SIZE_T(size);
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+    }
+}
+
 std::string SYS_GetCurrentDirectoryPath()
 {
     char path[MAX_PATH_SIZE] = {};
@@ -475,6 +547,8 @@ void SYS_OpenDirectory(const std::string& dirPath, DirEntry& outDirEntry)
     // Init first DirEntry
     memcpy(outDirEntry.mFilename, outDirEntry.mFindData.cFileName, MAX_PATH_SIZE);
     outDirEntry.mDirectory = outDirEntry.mFindData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY;
+    outDirEntry.mModifiedTime = (uint64_t(outDirEntry.mFindData.ftLastWriteTime.dwHighDateTime) << 32) | outDirEntry.mFindData.ftLastWriteTime.dwLowDateTime;
+    outDirEntry.mSize = (uint64_t(outDirEntry.mFindData.nFileSizeHigh) << 32) | outDirEntry.mFindData.nFileSizeLow;
     outDirEntry.mValid = true;
 }
 
@@ -484,6 +558,8 @@ void SYS_IterateDirectory(DirEntry& dirEntry)
     {
         memcpy(dirEntry.mFilename, dirEntry.mFindData.cFileName, MAX_PATH_SIZE);
         dirEntry.mDirectory = dirEntry.mFindData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY;
+        dirEntry.mModifiedTime = (uint64_t(dirEntry.mFindData.ftLastWriteTime.dwHighDateTime) << 32) | dirEntry.mFindData.ftLastWriteTime.dwLowDateTime;
+        dirEntry.mSize = (uint64_t(dirEntry.mFindData.nFileSizeHigh) << 32) | dirEntry.mFindData.nFileSizeLow;
         dirEntry.mValid = true;
     }
     else
@@ -498,6 +574,17 @@ void SYS_CloseDirectory(DirEntry& dirEntry)
     dirEntry.mFindHandle = nullptr;
 }
 
+bool SYS_WatchDirectory(const char* dirPath)
+{
+    // The file watcher is only implemented on Linux.
+    return false;
+}
+
+void SYS_PollFileChanges(std::vector<FileChange>& outChanges)
+{
+    // The file watcher is only implemented on Linux.
+}
+
 std::string SYS_OpenFileDialog()
 {
     std::string retPath = "";
@@ -714,6 +801,40 @@ void SYS_DestroyMutex(MutexObject* mutex)
     delete mutex;
 }
 
+SemaphoreObject* SYS_CreateSemaphore(uint32_t initialCount)
+{
+    SemaphoreObject* retSemaphore = new SemaphoreObject();
+
+    *retSemaphore = CreateSemaphore(
+        NULL,              // default security attributes
+        LONG(initialCount),
+        LONG_MAX,          // maximum count
+        NULL);             // unnamed semaphore
+
+    if (*retSemaphore == 0)
+    {
+        LogError("Failed to create Semaphore");
+    }
+
+    return retSemaphore;
+}
+
+void SYS_WaitSemaphore(SemaphoreObject* semaphore)
+{
+    WaitForSingleObject(*semaphore, INFINITE);
+}
+
+void SYS_SignalSemaphore(SemaphoreObject* semaphore)
+{
+    ReleaseSemaphore(*semaphore, 1, NULL);
+}
+
+void SYS_DestroySemaphore(SemaphoreObject* semaphore)
+{
+    CloseHandle(*semaphore);
+    delete semaphore;
+}
+
 void SYS_Sleep(uint32_t milliseconds)
 {
     Sleep(milliseconds);
@@ -0,0 +1,55 @@
+// Standalone test for reading pre-ASSET_VERSION_COLLISION_LAYERS collision masks.
+// Build and run from the Engine directory:
+//   g++ -std=c++17 -ISource/Engine -I../External Tests/CollisionLayersTest.cpp Source/Engine/CollisionLayers.cpp -o CollisionLayersTest && ./CollisionLayersTest
+
+#include "CollisionLayers.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+void SYS_Assert(const char* exprString, const char* fileString, uint32_t lineNumber)
+{
+    printf("Assert failed: %s (%s:%u)\n", exprString, fileString, lineNumber);
+    abort();
+}
+
+static int32_t sNumFailures = 0;
+
+#define CHECK(expr) if (!(expr)) { printf("FAILED: %s (line %d)\n", #expr, __LINE__); sNumFailures++; }
+
+// Same check Bullet makes in btCollisionWorld before a pair reaches the layer filter.
+static bool DoPrimitivesCollide(const CollisionLayers& layers, uint32_t groupA, uint32_t maskA, uint32_t groupB, uint32_t maskB)
+{
+    return (groupA & maskB) != 0 &&
+        (groupB & maskA) != 0 &&
+        layers.DoGroupsInteract(groupA, groupB);
+}
+
+int main()
+{
+    // A version 5 primitive stores its group and mask as one byte each, as Primitive3D::LoadStream reads them.
+    const uint8_t kVersion5Data[] = { 0x01, 0xff };
+    uint32_t legacyGroup = kVersion5Data[0];
+    uint32_t legacyMask = WidenLegacyCollisionMask(kVersion5Data[1]);
+
+    uint32_t layer20 = (1u << 20);
+    CollisionLayers layers;
+
+    CHECK(legacyMask == 0xffffffff);
+    CHECK(DoPrimitivesCollide(layers, legacyGroup, legacyMask, layer20, 0xffffffff));
+
+    // Still collides once the matrix is in use.
+    layers.SetLayersInteract(3, 20, false);
+    CHECK(DoPrimitivesCollide(layers, legacyGroup, legacyMask, layer20, 0xffffffff));
+
+    // Masks that didn't mean "everything" keep their bits.
+    CHECK(WidenLegacyCollisionMask(0x7f) == 0x7f);
+    CHECK(!DoPrimitivesCollide(layers, legacyGroup, WidenLegacyCollisionMask(0x7f), layer20, 0xffffffff));
+
+    if (sNumFailures == 0)
+    {
+        printf("CollisionLayersTest passed\n");
+    }
+
+    return (sNumFailures == 0) ? 0 : 1;
+}